@@ -12,6 +12,9 @@ import {
     GS1encoder,
     Symbology,
     Validation,
+    BatchInput,
+    BatchOutput,
+    BatchResult,
     GS1encoderGeneralException,
     GS1encoderParameterException,
     GS1encoderDigitalLinkException,
@@ -29,6 +32,11 @@ async function testTypes(): Promise<void> {
     // Test init
     await encoder.init();
 
+    // Test wasmVariant option and property (string | null)
+    const scalar: GS1encoder = await GS1encoder.create({ wasmVariant: "scalar" });
+    const wasmVariant: string | null = scalar.wasmVariant;
+    scalar.free();
+
     // Test version getter (string)
     const version: string = encoder.version;
 
@@ -92,6 +100,15 @@ async function testTypes(): Promise<void> {
     const ignoredParams: string[] = encoder.dlIgnoredQueryParams;
     const firstParam: string = ignoredParams[0];
 
+    // Test processBatch (BatchResult)
+    const batch: BatchResult = encoder.processBatch(["(01)12345678901231"], BatchInput.AIdataStr, BatchOutput.DLuri);
+    const batchDefaults: BatchResult = encoder.processBatch(["(01)12345678901231"]);
+    const batchOk: number = batch.ok[0];
+    const batchOffset: number = batch.offsets[0];
+    const batchLength: number = batch.lengths[0];
+    const batchBuffer: Uint8Array = batch.buffer;
+    const batchOutput: string = batch.get(0);
+
     // Test free
     encoder.free();
 
@@ -159,6 +176,25 @@ async function testTypes(): Promise<void> {
         Validation.UnknownAInotDLattr,
         Validation.NUMVALIDATIONS,
     ];
+
+    // Test all BatchInput enum values
+    const allBatchInputs: BatchInput[] = [
+        BatchInput.AIdataStr,
+        BatchInput.DataStr,
+        BatchInput.ScanData,
+        BatchInput.NUMINPUTS,
+    ];
+
+    // Test all BatchOutput enum values
+    const allBatchOutputs: BatchOutput[] = [
+        BatchOutput.None,
+        BatchOutput.DataStr,
+        BatchOutput.AIdataStr,
+        BatchOutput.DLuri,
+        BatchOutput.ScanData,
+        BatchOutput.HRI,
+        BatchOutput.NUMOUTPUTS,
+    ];
 }
 
 // This function is never executed, only type-checked
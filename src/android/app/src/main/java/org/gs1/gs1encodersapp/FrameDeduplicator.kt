@@ -0,0 +1,48 @@
+/*
+ * GS1 Barcode Syntax Engine example Android app using the Java binding
+ *
+ * @author Copyright (c) 2026 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+package org.gs1.gs1encodersapp
+
+/**
+ * Passes on only the payloads of a camera frame that were not present in the
+ * previous frame, so that a symbol that stays in view is validated once rather
+ * than on every frame. A symbol that leaves the view for a frame and then
+ * returns is passed on again.
+ *
+ * Instances are not thread-safe, so frames must be submitted from one thread.
+ */
+class FrameDeduplicator {
+    private var previous: Set<String> = emptySet()
+
+    /**
+     * Returns the distinct payloads of a frame that were not in the previous
+     * frame, in the order in which they were found.
+     */
+    fun newPayloads(payloads: List<String>): List<String> {
+        val fresh = payloads.filter { it !in previous }.distinct()
+        previous = payloads.toHashSet()
+        return fresh
+    }
+
+    /** Forgets the previous frame, so that every payload of the next is passed on. */
+    fun reset() {
+        previous = emptySet()
+    }
+}
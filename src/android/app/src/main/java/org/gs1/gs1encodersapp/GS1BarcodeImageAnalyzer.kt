@@ -23,20 +23,26 @@ package org.gs1.gs1encodersapp
 import android.annotation.SuppressLint
 import androidx.camera.core.ImageAnalysis
 import androidx.camera.core.ImageProxy
+import com.google.mlkit.vision.barcode.BarcodeScanner
 import com.google.mlkit.vision.barcode.BarcodeScannerOptions
 import com.google.mlkit.vision.barcode.BarcodeScanning
 import com.google.mlkit.vision.barcode.common.Barcode
 import com.google.mlkit.vision.common.InputImage
+import java.io.Closeable
 
+/**
+ * Finds the barcodes in each camera frame and submits the scan data of those
+ * that were not already present in the previous frame to a [ScanValidator].
+ *
+ * The ML Kit scanner client is created once and reused for every frame. Close
+ * the analyzer to release it.
+ */
 class GS1BarcodeImageAnalyzer(
-    private val result: (String) -> Unit,
-) : ImageAnalysis.Analyzer {
-    @SuppressLint("UnsafeOptInUsageError")
-    override fun analyze(imageProxy: ImageProxy) {
-        val image = imageProxy.image ?: return
-        val inputImage =
-            InputImage.fromMediaImage(image, imageProxy.imageInfo.rotationDegrees)
-        val options =
+    private val validator: ScanValidator,
+) : ImageAnalysis.Analyzer,
+    Closeable {
+    private val scanner: BarcodeScanner =
+        BarcodeScanning.getClient(
             BarcodeScannerOptions
                 .Builder()
                 .setBarcodeFormats(
@@ -47,94 +53,107 @@ class GS1BarcodeImageAnalyzer(
                     Barcode.FORMAT_UPC_E,
                     Barcode.FORMAT_QR_CODE,
                     Barcode.FORMAT_DATA_MATRIX,
-                ).build()
-        val scanner = BarcodeScanning.getClient(options)
+                ).build(),
+        )
+
+    // Used only by the listeners, which run on the main thread
+    private val deduplicator = FrameDeduplicator()
+
+    @SuppressLint("UnsafeOptInUsageError")
+    override fun analyze(imageProxy: ImageProxy) {
+        val image = imageProxy.image
+        if (image == null) {
+            imageProxy.close()
+            return
+        }
+        val inputImage =
+            InputImage.fromMediaImage(image, imageProxy.imageInfo.rotationDegrees)
         scanner
             .process(inputImage)
             .addOnSuccessListener { barcodes ->
-                // Return the first scanned barcode
-                if (barcodes.isNotEmpty()) {
-                    with(barcodes.first()) {
-                        /*
-                         *  We do our best to harmonise the result of scanning, but the output of
-                         *  ML Kit leaves a lot to be desired in terms of consistency!
-                         *
-                         */
+                val payloads = barcodes.mapNotNull { harmonise(it.format, it.rawValue ?: "") }
+                validator.submit(deduplicator.newPayloads(payloads))
+            }.addOnCompleteListener {
+                imageProxy.close()
+            }
+    }
 
-                        val raw = this.rawValue ?: ""
-                        var inputData: String
+    override fun close() {
+        scanner.close()
+    }
 
-                        when (this.format) {
-                            // Good: GS1 symbols are returned with AIM symbol identifier ]C1
-                            Barcode.FORMAT_CODE_128 -> {
-                                inputData =
-                                    if (raw.startsWith("]C1")) {
-                                        raw
-                                    } else {
-                                        "Non-GS1 Code 128, without FNC1 in first!"
-                                    }
-                            }
+    companion object {
+        /**
+         * Convert the result of scanning to scan data with an AIM symbology
+         * identifier, or null if the symbol cannot carry GS1 data.
+         */
+        fun harmonise(
+            format: Int,
+            raw: String,
+        ): String? {
+            /*
+             *  We do our best to harmonise the result of scanning, but the output of
+             *  ML Kit leaves a lot to be desired in terms of consistency!
+             *
+             */
 
-                            // Questionable: Returned without AIM symbology identifiers
-                            Barcode.FORMAT_EAN_13,
-                            Barcode.FORMAT_UPC_A,
-                            Barcode.FORMAT_UPC_E,
-                            -> {
-                                inputData = "]E0$raw"
-                            }
+            if (raw.isEmpty()) {
+                return null
+            }
 
-                            // Questionable: Returned without AIM symbology identifiers
-                            Barcode.FORMAT_EAN_8 -> {
-                                inputData = "]E4$raw"
-                            }
+            val isURI =
+                raw.startsWith("http://") or
+                    raw.startsWith("HTTP://") or
+                    raw.startsWith("https://") or
+                    raw.startsWith("HTTPS://")
 
-                            // Bad: Symbols are returned without AIM symbology identifiers, but
-                            // for GS1 symbols we at least have a proxy in the form of GS in
-                            // first position!
-                            Barcode.FORMAT_DATA_MATRIX -> {
-                                inputData =
-                                    if (raw.startsWith("http://") or
-                                        raw.startsWith("HTTP://") or
-                                        raw.startsWith("https://") or
-                                        raw.startsWith("HTTPS://")
-                                    ) {
-                                        "]d1$raw"
-                                    } else if (raw.startsWith("\u001D")) {
-                                        "]d2" + raw.drop(1)
-                                    } else {
-                                        "Non-GS1 Data Matrix, without FNC1 in first!"
-                                    }
-                            }
+            return when (format) {
+                // Good: GS1 symbols are returned with AIM symbol identifier ]C1
+                Barcode.FORMAT_CODE_128 -> {
+                    if (raw.startsWith("]C1")) raw else null // Non-GS1 Code 128, without FNC1 in first
+                }
 
-                            // Really bad: Returned without AIM symbology identifiers, and
-                            // worst of all for GS1 symbols there isn't even a proxy since there
-                            // is no reported GS in first position
-                            Barcode.FORMAT_QR_CODE -> {
-                                inputData =
-                                    if (raw.startsWith("http://") or
-                                        raw.startsWith("HTTP://") or
-                                        raw.startsWith("https://") or
-                                        raw.startsWith("HTTPS://")
-                                    ) {
-                                        "]Q1$raw"
-                                    } else { // Best we can do is to assume GS1 format
-                                        "]Q3$raw"
-                                    }
-                            }
+                // Questionable: Returned without AIM symbology identifiers
+                Barcode.FORMAT_EAN_13,
+                Barcode.FORMAT_UPC_A,
+                Barcode.FORMAT_UPC_E,
+                -> {
+                    "]E0$raw"
+                }
 
-                            else -> {
-                                inputData = "Unrecognised format"
-                            }
-                        }
+                // Questionable: Returned without AIM symbology identifiers
+                Barcode.FORMAT_EAN_8 -> {
+                    "]E4$raw"
+                }
 
-                        result.invoke(inputData)
+                // Bad: Symbols are returned without AIM symbology identifiers, but
+                // for GS1 symbols we at least have a proxy in the form of GS in
+                // first position!
+                Barcode.FORMAT_DATA_MATRIX -> {
+                    if (isURI) {
+                        "]d1$raw"
+                    } else if (raw.startsWith("\u001D")) {
+                        "]d2" + raw.drop(1)
+                    } else {
+                        null // Non-GS1 Data Matrix, without FNC1 in first
                     }
                 }
-                imageProxy.close()
-            }.addOnFailureListener {
-                imageProxy.close()
-            }.addOnCompleteListener {
-                imageProxy.close()
+
+                // Really bad: Returned without AIM symbology identifiers, and
+                // worst of all for GS1 symbols there isn't even a proxy since there
+                // is no reported GS in first position
+                Barcode.FORMAT_QR_CODE -> {
+                    if (isURI) {
+                        "]Q1$raw"
+                    } else { // Best we can do is to assume GS1 format
+                        "]Q3$raw"
+                    }
+                }
+
+                else -> {
+                    null
+                }
             }
+        }
     }
 }
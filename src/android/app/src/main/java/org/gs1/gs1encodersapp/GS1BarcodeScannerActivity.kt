@@ -41,6 +41,10 @@ import java.util.concurrent.Executors
 
 class GS1BarcodeScannerActivity : AppCompatActivity() {
     private lateinit var cameraExecutor: ExecutorService
+    private lateinit var validationExecutor: ExecutorService
+    private lateinit var scanValidator: ScanValidator
+    private lateinit var barcodeAnalyzer: GS1BarcodeImageAnalyzer
+    private var imageAnalysis: ImageAnalysis? = null
     private lateinit var binding: ActivityBarcodeScannerBinding
 
     override fun onCreate(savedInstanceState: Bundle?) {
@@ -50,12 +54,34 @@ class GS1BarcodeScannerActivity : AppCompatActivity() {
 
         cameraExecutor = Executors.newSingleThreadExecutor()
 
+        // Validate scan data on a thread of its own, so that frames continue
+        // to be analysed while the native library is busy
+        validationExecutor = Executors.newSingleThreadExecutor()
+        scanValidator =
+            ScanValidator(validationExecutor, { GS1ScanDataValidator() }) { scanData ->
+                runOnUiThread { scanned(scanData) }
+            }
+        barcodeAnalyzer = GS1BarcodeImageAnalyzer(scanValidator)
+
         checkCameraPermission()
     }
 
     override fun onDestroy() {
         super.onDestroy()
+        imageAnalysis?.clearAnalyzer()
+        barcodeAnalyzer.close()
+        scanValidator.close()
         cameraExecutor.shutdown()
+        validationExecutor.shutdown()
+    }
+
+    private fun scanned(scanData: String) {
+        if (isFinishing) {
+            return
+        }
+        imageAnalysis?.clearAnalyzer()
+        setResult(RESULT_OK, intent.putExtra("INPUT_DATA", scanData))
+        finish()
     }
 
     override fun onRequestPermissionsResult(
@@ -119,16 +145,9 @@ class GS1BarcodeScannerActivity : AppCompatActivity() {
                     .setBackpressureStrategy(ImageAnalysis.STRATEGY_KEEP_ONLY_LATEST)
                     .build()
                     .also {
-                        it.setAnalyzer(
-                            cameraExecutor,
-                            GS1BarcodeImageAnalyzer { result ->
-                                val intent = intent.putExtra("INPUT_DATA", result)
-                                setResult(RESULT_OK, intent)
-                                it.clearAnalyzer()
-                                finish()
-                            },
-                        )
+                        it.setAnalyzer(cameraExecutor, barcodeAnalyzer)
                     }
+            imageAnalysis = imageAnalyzer
 
             try {
                 cameraProvider.unbindAll()
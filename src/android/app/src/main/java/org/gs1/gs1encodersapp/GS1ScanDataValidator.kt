@@ -0,0 +1,51 @@
+/*
+ * GS1 Barcode Syntax Engine example Android app using the Java binding
+ *
+ * @author Copyright (c) 2026 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+package org.gs1.gs1encodersapp
+
+import org.gs1.gs1encoders.GS1Encoder
+import org.gs1.gs1encoders.GS1EncoderScanDataException
+
+/**
+ * Validates scan data with a Syntax Engine instance that is kept for the
+ * lifetime of the validator, so that each frame costs a single call into the
+ * native library rather than the creation of a new instance.
+ */
+class GS1ScanDataValidator : ScanValidator.Validator {
+    private val gs1encoder = GS1Encoder()
+
+    init {
+        // The symbol may be one of several on a label, so the AIs that it
+        // requires may be carried by another
+        gs1encoder.setValidationEnabled(GS1Encoder.Validation.RequisiteAIs, false)
+    }
+
+    override fun validate(scanData: String): Boolean =
+        try {
+            gs1encoder.scanData = scanData
+            true
+        } catch (e: GS1EncoderScanDataException) {
+            false
+        }
+
+    override fun close() {
+        gs1encoder.free()
+    }
+}
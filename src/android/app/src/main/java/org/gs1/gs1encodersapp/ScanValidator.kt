@@ -0,0 +1,116 @@
+/*
+ * GS1 Barcode Syntax Engine example Android app using the Java binding
+ *
+ * @author Copyright (c) 2026 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+package org.gs1.gs1encodersapp
+
+import java.io.Closeable
+import java.util.concurrent.Executor
+
+/**
+ * Validates the scan data found in camera frames on a background executor,
+ * away from the thread that analyses the frames.
+ *
+ * A single [Validator] is created on first use and reused for every frame.
+ * The payloads of frames submitted while a validation is in progress are
+ * merged, so that a slow validation never builds up a backlog of frames.
+ * None may be dropped, because a [FrameDeduplicator] passes on a payload only
+ * in the frame where it appears.
+ *
+ * The executor must run tasks one at a time, in order, such as one created
+ * with `Executors.newSingleThreadExecutor()`. The pending payloads are
+ * validated in the order in which they were submitted, each distinct payload
+ * once, and [onValid] is called on the executor with the first that passes.
+ */
+class ScanValidator(
+    private val executor: Executor,
+    private val createValidator: () -> Validator,
+    private val onValid: (String) -> Unit,
+) : Closeable {
+    /** Validates a single payload. Used only on the executor. */
+    fun interface Validator {
+        fun validate(scanData: String): Boolean
+
+        fun close() {}
+    }
+
+    private val lock = Any()
+
+    // Guarded by lock. Null when no validation task is scheduled
+    private var pending: LinkedHashSet<String>? = null
+
+    @Volatile
+    private var closed = false
+
+    // Accessed only on the executor
+    private var validator: Validator? = null
+
+    /**
+     * Queue the payloads of a frame for validation, along with those of any
+     * earlier frame that have not yet been validated.
+     */
+    fun submit(payloads: List<String>) {
+        if (payloads.isEmpty() || closed) {
+            return
+        }
+        // Only the submission that finds nothing pending schedules a task;
+        // later ones add to the payloads that the task will take
+        val schedule =
+            synchronized(lock) {
+                val queued = pending
+                if (queued == null) {
+                    pending = LinkedHashSet(payloads)
+                    true
+                } else {
+                    queued.addAll(payloads)
+                    false
+                }
+            }
+        if (schedule) {
+            executor.execute(::validatePending)
+        }
+    }
+
+    private fun validatePending() {
+        val payloads = synchronized(lock) { pending.also { pending = null } } ?: return
+        if (closed) {
+            return
+        }
+        val current = validator ?: createValidator().also { validator = it }
+        for (payload in payloads) {
+            if (current.validate(payload)) {
+                onValid(payload)
+                return
+            }
+        }
+    }
+
+    /**
+     * Stop validating. The validator is released on the executor, after any
+     * task that is already running, so the executor should be shut down only
+     * after this is called.
+     */
+    override fun close() {
+        closed = true
+        executor.execute {
+            validator?.close()
+            validator = null
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * GS1 Barcode Syntax Engine example Android app using the Java binding
+ *
+ * @author Copyright (c) 2026 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+package org.gs1.gs1encodersapp
+
+import org.junit.Assert.assertEquals
+import org.junit.Test
+
+class FrameDeduplicatorTest {
+    @Test
+    fun firstFramePassesEveryPayload() {
+        val dedup = FrameDeduplicator()
+        assertEquals(listOf("]Q1A", "]C1B"), dedup.newPayloads(listOf("]Q1A", "]C1B")))
+    }
+
+    @Test
+    fun payloadInConsecutiveFramesIsPassedOnce() {
+        val dedup = FrameDeduplicator()
+        assertEquals(listOf("]Q1A"), dedup.newPayloads(listOf("]Q1A")))
+        assertEquals(emptyList<String>(), dedup.newPayloads(listOf("]Q1A")))
+        assertEquals(emptyList<String>(), dedup.newPayloads(listOf("]Q1A")))
+    }
+
+    @Test
+    fun onlyNewPayloadsOfAFrameArePassed() {
+        val dedup = FrameDeduplicator()
+        dedup.newPayloads(listOf("]Q1A", "]C1B"))
+        assertEquals(listOf("]E0C"), dedup.newPayloads(listOf("]C1B", "]E0C", "]Q1A")))
+    }
+
+    @Test
+    fun duplicatesWithinAFrameAreCollapsed() {
+        val dedup = FrameDeduplicator()
+        assertEquals(listOf("]Q1A", "]C1B"), dedup.newPayloads(listOf("]Q1A", "]C1B", "]Q1A")))
+    }
+
+    @Test
+    fun payloadIsPassedAgainAfterLeavingTheView() {
+        val dedup = FrameDeduplicator()
+        dedup.newPayloads(listOf("]Q1A"))
+        assertEquals(emptyList<String>(), dedup.newPayloads(emptyList()))
+        assertEquals(listOf("]Q1A"), dedup.newPayloads(listOf("]Q1A")))
+    }
+
+    @Test
+    fun resetForgetsThePreviousFrame() {
+        val dedup = FrameDeduplicator()
+        dedup.newPayloads(listOf("]Q1A"))
+        dedup.reset()
+        assertEquals(listOf("]Q1A"), dedup.newPayloads(listOf("]Q1A")))
+    }
+}
@@ -0,0 +1,147 @@
+/*
+ * GS1 Barcode Syntax Engine example Android app using the Java binding
+ *
+ * @author Copyright (c) 2026 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+package org.gs1.gs1encodersapp
+
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import java.util.concurrent.Executor
+
+class ScanValidatorTest {
+    // Runs tasks only when asked, so that the tests control what is pending
+    private class ManualExecutor : Executor {
+        val tasks = ArrayDeque<Runnable>()
+
+        override fun execute(command: Runnable) {
+            tasks.addLast(command)
+        }
+
+        fun runAll() {
+            while (tasks.isNotEmpty()) {
+                tasks.removeFirst().run()
+            }
+        }
+    }
+
+    // Accepts scan data with a GS1 Digital Link URI
+    private class FakeValidator : ScanValidator.Validator {
+        val validated = mutableListOf<String>()
+        var closed = false
+
+        override fun validate(scanData: String): Boolean {
+            validated.add(scanData)
+            return scanData.startsWith("]Q1")
+        }
+
+        override fun close() {
+            closed = true
+        }
+    }
+
+    private val executor = ManualExecutor()
+    private val created = mutableListOf<FakeValidator>()
+    private val reported = mutableListOf<String>()
+    private val scanValidator =
+        ScanValidator(executor, { FakeValidator().also { created.add(it) } }) { reported.add(it) }
+
+    @Test
+    fun validatorIsCreatedOnceAndReused() {
+        for (frame in 1..5) {
+            scanValidator.submit(listOf("]Q3$frame"))
+            executor.runAll()
+        }
+        assertEquals(1, created.size)
+        assertEquals(listOf("]Q31", "]Q32", "]Q33", "]Q34", "]Q35"), created[0].validated)
+    }
+
+    @Test
+    fun validatorIsNotCreatedUntilNeeded() {
+        scanValidator.submit(emptyList())
+        executor.runAll()
+        assertEquals(0, created.size)
+    }
+
+    @Test
+    fun firstValidPayloadOfAFrameIsReported() {
+        scanValidator.submit(listOf("]E0bad", "]Q1first", "]Q1second"))
+        executor.runAll()
+        assertEquals(listOf("]Q1first"), reported)
+        assertEquals(listOf("]E0bad", "]Q1first"), created[0].validated)
+    }
+
+    @Test
+    fun pendingFramesAreMergedIntoOneValidation() {
+        scanValidator.submit(listOf("]Q3one"))
+        scanValidator.submit(listOf("]Q3two", "]Q3one"))
+        scanValidator.submit(listOf("]Q1three"))
+        assertEquals(1, executor.tasks.size)
+        executor.runAll()
+        assertEquals(listOf("]Q3one", "]Q3two", "]Q1three"), created[0].validated)
+        assertEquals(listOf("]Q1three"), reported)
+    }
+
+    @Test
+    fun deduplicatedFramesSubmittedBeforeValidationAreAllValidated() {
+        val dedup = FrameDeduplicator()
+        scanValidator.submit(dedup.newPayloads(listOf("]E0first")))
+        // The first payload is still in view, so it is not submitted again
+        scanValidator.submit(dedup.newPayloads(listOf("]E0first", "]Q1second")))
+        assertEquals(1, executor.tasks.size)
+        executor.runAll()
+        assertEquals(listOf("]E0first", "]Q1second"), created[0].validated)
+        assertEquals(listOf("]Q1second"), reported)
+    }
+
+    @Test
+    fun frameSubmittedWhileValidatingIsValidatedNext() {
+        scanValidator.submit(listOf("]Q3one"))
+        executor.tasks.removeFirst().run()
+        scanValidator.submit(listOf("]Q3two"))
+        executor.runAll()
+        assertEquals(listOf("]Q3one", "]Q3two"), created[0].validated)
+    }
+
+    @Test
+    fun closeReleasesTheValidatorOnTheExecutor() {
+        scanValidator.submit(listOf("]Q3one"))
+        executor.runAll()
+        scanValidator.close()
+        assertFalse(created[0].closed)
+        executor.runAll()
+        assertTrue(created[0].closed)
+
+        scanValidator.submit(listOf("]Q1late"))
+        executor.runAll()
+        assertEquals(listOf("]Q3one"), created[0].validated)
+        assertEquals(1, created.size)
+    }
+
+    @Test
+    fun repeatedFramesAreValidatedOnceWhenDeduplicated() {
+        val dedup = FrameDeduplicator()
+        repeat(30) {
+            scanValidator.submit(dedup.newPayloads(listOf("]Q3steady", "]E0steady")))
+            executor.runAll()
+        }
+        assertEquals(listOf("]Q3steady", "]E0steady"), created[0].validated)
+    }
+}
@@ -41,7 +41,9 @@
  *
  */
 #ifndef EXCLUDE_EMBEDDED_AI_TABLE
+static struct aiEntry embedded_ai_table[] = {
 #include "aitable.inc"
+};
 #endif  /* EXCLUDE_EMBEDDED_AI_TABLE */
 
 
@@ -109,10 +111,81 @@ static inline __ATTR_PURE uint8_t aiLengthByPrefix(const gs1_encoder* const ctx,
 }
 
 
+/*
+ *  Identify a linter by its name, marking those provided by the application
+ *  since they may replace the reference linter of the same name. The
+ *  application's linters are available only while the context is initialised.
+ *
+ */
+static uint64_t fingerprintLinter(const gs1_encoder* const ctx, uint64_t h, const gs1_linter_t fn) {
+
+	const char *name = NULL;
+	uint8_t source = 'R';
+	size_t i;
+
+	for (i = 0; i < ctx->numLinters; i++) {
+		if (ctx->linters[i].fn == fn && ctx->linters[i].name) {
+			name = ctx->linters[i].name;
+			source = 'A';
+			break;
+		}
+	}
+	if (!name)
+		name = gs1_linter_name(fn);
+
+	h = gs1_fnv1a64(h, &source, sizeof(source));
+	return gs1_fnv1a64(h, name ? name : "", name ? strlen(name) + 1 : 1);
+
+}
+
+
+/*
+ *  Identify the AI table by everything that affects the validation of AI
+ *  data: each AI, its components, their linters and its attributes. The
+ *  library version is included to cover the implementation of the reference
+ *  linters.
+ *
+ */
+static uint64_t fingerprintAItable(const gs1_encoder* const ctx) {
+
+	const struct aiEntry *e;
+	const struct aiComponent *part;
+	const gs1_linter_t *l;
+	const char *version = gs1_encoder_getVersion();
+	uint64_t h = GS1_FNV1A64_INIT;
+
+	h = gs1_fnv1a64(h, version, strlen(version) + 1);
+
+	for (e = ctx->aiTable; *e->ai; e++) {
+
+		const uint8_t flags[] = { e->fnc1, e->dlDataAttr };
+
+		h = gs1_fnv1a64(h, e->ai, (size_t)e->ailen + 1);
+		h = gs1_fnv1a64(h, flags, sizeof(flags));
+
+		for (part = e->parts; part->cset; part++) {
+			const uint8_t spec[] = { (uint8_t)part->cset, part->min, part->max, part->opt };
+			h = gs1_fnv1a64(h, spec, sizeof(spec));
+			for (l = part->linters; *l; l++)
+				h = fingerprintLinter(ctx, h, *l);
+			h = gs1_fnv1a64(h, "", 1);		// End of the linters
+		}
+
+		h = gs1_fnv1a64(h, e->attrs ? e->attrs : "", e->attrs ? strlen(e->attrs) + 1 : 1);
+
+	}
+
+	return h;
+
+}
+
+
 bool gs1_setAItable(gs1_encoder* const ctx, struct aiEntry *aiTable) {
 
 	struct aiEntry *e;
 
+	assert(!ctx->sharedTablesRefs || *ctx->sharedTablesRefs == 1);	// Tables are immutable once shared with a clone
+
 #ifndef EXCLUDE_EMBEDDED_AI_TABLE
 redo:
 #endif
@@ -159,6 +232,8 @@ redo:
 	if (!gs1_populateDLkeyQualifiers(ctx))
 		goto fail;
 
+	ctx->aiTableFingerprint = fingerprintAItable(ctx);
+
 	return true;
 
 fail:
@@ -561,7 +636,9 @@ static size_t validate_ai_val(gs1_encoder* const ctx, const char* const ai, cons
 			gs1_lint_err_t err;
 			size_t errpos, errlen;
 
+			STATS_LINTER_BEGIN();
 			err = (*l)(p, complen, &errpos, &errlen);
+			STATS_LINTER_END(*l, err != GS1_LINTER_OK);
 			if (err) {
 				char *m = ctx->linterErrMarkup;
 				size_t rem = sizeof(ctx->linterErrMarkup);
@@ -650,16 +727,20 @@ bool gs1_aiValLengthContentCheck(gs1_encoder* const ctx, const char* const ai, c
 /*
  * Convert bracketed AI syntax data to regular AI data string with ^ = FNC1
  *
+ * The input is a span that is only read, so it need not be NUL-terminated
+ * and may be a view of read-only memory.
+ *
  */
-bool gs1_parseAIdata(gs1_encoder* const ctx, const char* const aiData, char* const dataStr, const size_t dataStrCap) {
+bool gs1_parseAIdata(gs1_encoder* const ctx, const char* const aiData, const size_t aiDataLen, char* const dataStr, const size_t dataStrCap) {
 
 	const char *p = aiData;
+	const char* const end = aiData + aiDataLen;
 	bool fnc1req = true;
 	size_t dataStr_len = 0;
 	size_t outval_len;
 
 	assert(ctx);
-	assert(aiData);
+	assert(aiData || aiDataLen == 0);
 
 	*dataStr = '\0';
 	ctx->err = gs1_encoder_eNO_ERROR;
@@ -667,16 +748,16 @@ bool gs1_parseAIdata(gs1_encoder* const ctx, const char* const aiData, char* con
 	ctx->linterErr = GS1_LINTER_OK;
 	*ctx->linterErrMarkup = '\0';
 
-	DEBUG_PRINT("\nParsing AI data: %s\n", p);
+	DEBUG_PRINT("\nParsing AI data: %.*s\n", (int)aiDataLen, aiData);
 
-	while (*p) {
+	while (p < end) {
 
 		const struct aiEntry *entry;
 		const char *outai, *outval, *r, *ai;
 		size_t ailen;
 
 		if (*p++ != '(') goto fail; 			// Expect start of AI
-		if (!(r = strchr(p, ')'))) goto fail;		// Find end of AI
+		if (!(r = memchr(p, ')', (size_t)(end-p)))) goto fail;	// Find end of AI
 		ailen = (size_t)(r-p);
 		entry = gs1_lookupAIentry(ctx, p, ailen);
 		if (entry == NULL) {
@@ -691,16 +772,16 @@ bool gs1_parseAIdata(gs1_encoder* const ctx, const char* const aiData, char* con
 		writeDataStr(p, ailen, &dataStr_len);		// Might be an "unknown AI"
 		fnc1req = entry->fnc1;				// Record whether FNC1 required before next AI
 
-		if (!*++r) goto fail;				// Advance to start of AI value and fail if at end
+		if (++r == end) goto fail;			// Advance to start of AI value and fail if at end
 
 		outval = dataStr + dataStr_len;			// Record the current start of the output value
 
 again:
 
 		p = r;
-		while (*p && *p != '(') p++;			// Next AI or end if no more AIs
+		while (p < end && *p != '(') p++;		// Next AI or end if no more AIs
 
-		if (*p != '\0' && *(p-1) == '\\') {			// This bracket is an escaped data character
+		if (p < end && *(p-1) == '\\') {			// This bracket is an escaped data character
 			writeDataStr(r, (size_t)(p-r-1), &dataStr_len);	// Write up to the escape character
 			writeDataStr("(", 1, &dataStr_len);		// Write the data bracket
 			r = p+1;					// And keep going
@@ -731,6 +812,7 @@ again:
 			.vallen = (uint16_t)outval_len,
 			.dlPathOrder = DL_PATH_ORDER_ATTRIBUTE
 		};
+		gs1_hashAIvalue(&ctx->aiData[ctx->numAIs - 1]);
 
 	}
 
@@ -854,6 +936,7 @@ bool gs1_processAIdata(gs1_encoder* const ctx, const char* const dataStr, const
 				.vallen = (uint16_t)vallen,
 				.dlPathOrder = DL_PATH_ORDER_ATTRIBUTE
 			};
+			gs1_hashAIvalue(&ctx->aiData[ctx->numAIs - 1]);
 		}
 
 		// After AIs requiring FNC1, we expect to find an FNC1 or be at the end
@@ -1075,8 +1158,16 @@ bool gs1_validateAIs(gs1_encoder* const ctx) {
 	for (i = 0; i < gs1_encoder_vNUMVALIDATIONS; i++) {
 
 		const struct validationEntry v = ctx->validationTable[i];
+		bool ok;
+
+		if (!v.enabled || !v.fn)
+			continue;
+
+		STATS_VALIDATION_BEGIN();
+		ok = v.fn(ctx);
+		STATS_VALIDATION_END(i, !ok);
 
-		if (v.enabled && v.fn && !v.fn(ctx))
+		if (!ok)
 			return false;
 
 	}
@@ -1103,6 +1194,579 @@ void gs1_loadValidationTable(gs1_encoder* const ctx) {
 }
 
 
+/*
+ *  EAN/UPC primary data carries a GTIN rather than AI data. Write it to gtin
+ *  as the 14-digit value of AI (01), if the message has such primary data.
+ *
+ */
+static bool primaryDataGTIN(const gs1_encoder* const ctx, char gtin[14]) {
+
+	size_t primaryLen;
+
+	switch (ctx->sym) {
+	case gs1_encoder_sEAN13:
+		primaryLen = 13;
+		break;
+	case gs1_encoder_sEAN8:
+		primaryLen = 8;
+		break;
+	case gs1_encoder_sUPCA:
+	case gs1_encoder_sUPCE:
+		primaryLen = 12;
+		break;
+	default:
+		return false;
+	}
+
+	if (strcspn(ctx->dataStr, "|") != primaryLen ||
+	    !gs1_allDigits((const uint8_t*)ctx->dataStr, primaryLen))
+		return false;
+
+	memset(gtin, '0', 14 - primaryLen);
+	memcpy(gtin + 14 - primaryLen, ctx->dataStr, primaryLen);
+
+	return true;
+
+}
+
+
+/*
+ *  Multi-read label assembly. The AIs of each read are merged into the
+ *  label as they arrive: an AI already on the label with the same value is
+ *  from a repeated read and is dropped, whereas a different value is a
+ *  conflict that is reported immediately. The association validations are
+ *  deferred until the label is loaded as the message.
+ *
+ */
+static bool addLabelAI(gs1_encoder* const ctx, const struct aiValue* const ai, int* const numAIs, size_t* const len) {
+
+	int i;
+	char *p;
+
+	for (i = 0; i < *numAIs; i++) {
+		const struct aiValue* const lai = &ctx->labelAIs[i];
+		if (lai->ailen != ai->ailen || memcmp(lai->ai, ai->ai, ai->ailen) != 0)
+			continue;
+		if (lai->vallen == ai->vallen && memcmp(lai->value, ai->value, ai->vallen) == 0)
+			return true;	// Repeat
+		SET_ERR_V(INSTANCES_OF_AI_HAVE_DIFFERENT_VALUES, ai->ailen, ai->ai);
+		return false;
+	}
+
+	if (*numAIs >= MAX_AIS) {
+		SET_ERR(TOO_MANY_AIS);
+		return false;
+	}
+
+	if (*len + 1 + ai->ailen + ai->vallen > MAX_DATA) {
+		SET_ERR_V(DATA_TOO_LONG, MAX_DATA);
+		return false;
+	}
+
+	p = ctx->labelStr + *len;
+	*p++ = '^';
+	memcpy(p, ai->ai, ai->ailen);
+	memcpy(p + ai->ailen, ai->value, ai->vallen);
+	*len += 1 + (size_t)ai->ailen + ai->vallen;
+
+	ctx->labelAIs[(*numAIs)++] = (struct aiValue) {
+		.kind = aiValue_aival,
+		.aiEntry = ai->aiEntry,
+		.ai = p,
+		.ailen = ai->ailen,
+		.value = p + ai->ailen,
+		.vallen = ai->vallen,
+		.dlPathOrder = DL_PATH_ORDER_ATTRIBUTE
+	};
+	gs1_hashAIvalue(&ctx->labelAIs[*numAIs - 1]);
+
+	return true;
+
+}
+
+
+/*
+ *  Merge the AIs of the processed scan data into the label. The label is
+ *  only updated if all of them can be merged.
+ *
+ */
+bool gs1_addLabelAIs(gs1_encoder* const ctx) {
+
+	int numAIs = ctx->numLabelAIs;
+	size_t len = ctx->labelLen;
+	char gtin[14];
+	int i;
+
+	assert(ctx);
+	assert(ctx->numAIs <= MAX_AIS);
+
+	// EAN/UPC primary data contributes its GTIN as AI (01)
+	if (primaryDataGTIN(ctx, gtin)) {
+
+		struct aiValue ai = {
+			.kind = aiValue_aival,
+			.ai = "01",
+			.ailen = 2,
+			.value = gtin,
+			.vallen = sizeof(gtin)
+		};
+
+		if ((ai.aiEntry = gs1_lookupAIentry(ctx, "01", 2)) == NULL) {
+			SET_ERR_V(AI_UNRECOGNISED, 2, "01");
+			return false;
+		}
+
+		if (!addLabelAI(ctx, &ai, &numAIs, &len))
+			return false;
+
+	} else if (ctx->numAIs == 0) {
+		SET_ERR(SCAN_DATA_HAS_NO_AIS);
+		return false;
+	}
+
+	for (i = 0; i < ctx->numAIs; i++) {
+		if (ctx->aiData[i].kind != aiValue_aival)
+			continue;
+		if (!addLabelAI(ctx, &ctx->aiData[i], &numAIs, &len))
+			return false;
+	}
+
+	ctx->numLabelAIs = numAIs;
+	ctx->labelLen = len;
+
+	return true;
+
+}
+
+
+/*
+ *  Load the AIs of the label as the message, in the order that they were
+ *  first read, with FNC1 separators only where they are required.
+ *
+ */
+void gs1_loadLabelAIs(gs1_encoder* const ctx) {
+
+	char *p = ctx->dataStr;
+	bool fnc1req = true;
+	int i;
+
+	assert(ctx);
+	assert(ctx->numLabelAIs <= MAX_AIS);
+
+	for (i = 0; i < ctx->numLabelAIs; i++) {
+
+		const struct aiValue* const lai = &ctx->labelAIs[i];
+
+		if (fnc1req)
+			*p++ = '^';
+
+		ctx->aiData[i] = *lai;
+		ctx->aiData[i].ai = p;
+		memcpy(p, lai->ai, lai->ailen);
+		p += lai->ailen;
+		ctx->aiData[i].value = p;
+		memcpy(p, lai->value, lai->vallen);
+		p += lai->vallen;
+
+		fnc1req = lai->aiEntry->fnc1;
+
+	}
+	*p = '\0';
+
+	ctx->numAIs = ctx->numLabelAIs;
+	ctx->numSortedAIs = 0;
+
+}
+
+
+/*
+ *  Identify the AI table together with the settings that affect whether AI
+ *  data is valid, so that a serialised message validated elsewhere can be
+ *  trusted.
+ *
+ */
+uint64_t gs1_validationFingerprint(const gs1_encoder* const ctx) {
+
+	uint8_t settings[3 + gs1_encoder_vNUMVALIDATIONS];
+	size_t i;
+
+	assert(ctx);
+
+	settings[0] = ctx->permitUnknownAIs;
+	settings[1] = ctx->permitZeroSuppressedGTINinDLuris;
+	settings[2] = ctx->permitConvenienceAlphas;
+	for (i = 0; i < gs1_encoder_vNUMVALIDATIONS; i++)
+		settings[3 + i] = ctx->validationTable[i].enabled;
+
+	return gs1_fnv1a64(ctx->aiTableFingerprint, settings, sizeof(settings));
+
+}
+
+
+/*
+ *  The message is an AI element string or a GS1 Digital Link URI
+ *
+ */
+static inline __ATTR_PURE bool isAIdataMessage(const gs1_encoder* const ctx) {
+	return *ctx->dataStr == '^' ||
+	       strncmp(ctx->dataStr, "https://", 8) == 0 ||
+	       strncmp(ctx->dataStr, "HTTPS://", 8) == 0 ||
+	       strncmp(ctx->dataStr, "http://",  7) == 0 ||
+	       strncmp(ctx->dataStr, "HTTP://",  7) == 0;
+}
+
+
+/*
+ *  Fingerprint the semantic content of the message, being each distinct AI
+ *  and value in AI order, regardless of the syntax of the input. Each AI and
+ *  value is hashed as it is extracted, so this only combines those hashes.
+ *
+ */
+bool gs1_messageFingerprint(gs1_encoder* const ctx, uint64_t fingerprint[2]) {
+
+	const struct aiValue *sorted[MAX_AIS + 1];
+	const struct aiValue *run[MAX_AIS + 1];
+	char gtin[14];
+	struct aiValue primary = {
+		.kind = aiValue_aival,
+		.ai = "01",
+		.ailen = 2,
+		.value = gtin,
+		.vallen = sizeof(gtin)
+	};
+	uint64_t h0 = GS1_FNV1A64_INIT, h1 = ~GS1_FNV1A64_INIT;
+	int i, j, k, n, numSorted, count = 0;
+
+	assert(ctx);
+	assert(fingerprint);
+
+	gs1_sortAIs(ctx);
+
+	for (i = 0; i < ctx->numSortedAIs; i++)
+		sorted[i] = ctx->sortedAIs[i];
+	numSorted = ctx->numSortedAIs;
+
+	// EAN/UPC primary data is taken as AI (01), as for a label
+	if (primaryDataGTIN(ctx, gtin)) {
+		const struct aiValue* const ai = &primary;
+		gs1_hashAIvalue(&primary);
+		for (k = numSorted++; k > 0 && compareAIPointers(&sorted[k - 1], &ai) > 0; k--)
+			sorted[k] = sorted[k - 1];
+		sorted[k] = ai;
+	} else if (!isAIdataMessage(ctx)) {
+		SET_ERR(MESSAGE_IS_NOT_AI_DATA);
+		return false;
+	}
+
+	for (i = 0; i < numSorted; i = j) {
+
+		// Instances of an AI are taken in the order of their hashes
+		for (j = i, n = 0; j < numSorted &&
+		     compareAIPointers(&sorted[i], &sorted[j]) == 0; j++) {
+			const struct aiValue* const ai = sorted[j];
+			for (k = n++; k > 0 && (run[k - 1]->hash[0] > ai->hash[0] ||
+			     (run[k - 1]->hash[0] == ai->hash[0] && run[k - 1]->hash[1] > ai->hash[1])); k--)
+				run[k] = run[k - 1];
+			run[k] = ai;
+		}
+
+		for (k = 0; k < n; k++) {
+			if (k > 0 && run[k]->hash[0] == run[k - 1]->hash[0] && run[k]->hash[1] == run[k - 1]->hash[1])
+				continue;		// Repeated AI and value
+			h0 = gs1_fmix64(h0 ^ run[k]->hash[0]);
+			h1 = gs1_fmix64(h1 ^ run[k]->hash[1]);
+			count++;
+		}
+
+	}
+
+	fingerprint[0] = gs1_fmix64(h0 ^ (uint64_t)count);
+	fingerprint[1] = gs1_fmix64(h1 ^ (uint64_t)count);
+
+	return true;
+
+}
+
+
+/*
+ *  Serialised form of the AI list of a message:
+ *
+ *    "G1"          Magic
+ *    version       SERIALISED_VERSION
+ *    fingerprint   8 bytes, little-endian, from gs1_validationFingerprint()
+ *    count         Number of entries
+ *
+ *  Followed by each entry, either a single 0 byte for the separator between
+ *  the linear and composite components, or:
+ *
+ *    tag           AI length, plus SERIALISED_PATH_ORDER if a GS1 DL URI path
+ *                  order follows
+ *    ai            2 bytes, little-endian: the AI as a number
+ *    path order    Only if tagged
+ *    entry         2 bytes, little-endian: index of the AI in the AI table,
+ *                  or SERIALISED_NO_ENTRY
+ *    vallen        Length of the value
+ *    value         vallen bytes
+ *
+ */
+#define SERIALISED_VERSION	1
+#define SERIALISED_HEADER_LEN	12
+#define SERIALISED_PATH_ORDER	0x80
+#define SERIALISED_NO_ENTRY	UINT16_MAX
+
+GS1_ENCODERS_STATIC_ASSERT(MAX_AIS <= UINT8_MAX && MAX_AIS <= 64);
+GS1_ENCODERS_STATIC_ASSERT(MAX_AI_VALUE_LEN <= UINT8_MAX);
+GS1_ENCODERS_STATIC_ASSERT(MAX_AI_LEN <= 4);		// AI fits in 16 bits
+GS1_ENCODERS_STATIC_ASSERT(GS1_ENCODERS_MAX_SERIALISED_MESSAGE_LEN ==
+			   SERIALISED_HEADER_LEN + MAX_AIS * (7 + MAX_AI_VALUE_LEN));
+
+
+size_t gs1_serialiseAIs(gs1_encoder* const ctx, uint8_t* const out, const size_t size) {
+
+	const uint64_t fingerprint = gs1_validationFingerprint(ctx);
+	uint8_t *p = out;
+	int i, count = 0;
+
+	assert(ctx);
+	assert(out || size == 0);
+	assert(ctx->numAIs <= MAX_AIS);
+
+	if (!isAIdataMessage(ctx)) {
+		SET_ERR(MESSAGE_IS_NOT_AI_DATA);
+		return 0;
+	}
+
+	if (size < SERIALISED_HEADER_LEN)
+		goto too_small;
+
+	*p++ = 'G';
+	*p++ = '1';
+	*p++ = SERIALISED_VERSION;
+	for (i = 0; i < 8; i++)
+		*p++ = (uint8_t)(fingerprint >> (8 * i));
+	p++;						// Count, once known
+
+	for (i = 0; i < ctx->numAIs; i++) {
+
+		const struct aiValue* const ai = &ctx->aiData[i];
+		const bool hasPathOrder = ai->dlPathOrder != DL_PATH_ORDER_ATTRIBUTE;
+		unsigned int code = 0;
+		size_t index;
+		uint8_t j;
+
+		if (ai->kind == aiValue_ccsep) {
+			if ((size_t)(out + size - p) < 1)
+				goto too_small;
+			*p++ = 0;
+			count++;
+			continue;
+		}
+
+		if (ai->kind != aiValue_aival)		// Ignored DL query parameters
+			continue;
+
+		assert(ai->ailen >= MIN_AI_LEN && ai->ailen <= MAX_AI_LEN);
+		assert(ai->vallen <= MAX_AI_VALUE_LEN);
+
+		if ((size_t)(out + size - p) < 6u + hasPathOrder + ai->vallen)
+			goto too_small;
+
+		for (j = 0; j < ai->ailen; j++)
+			code = code * 10 + (unsigned int)(ai->ai[j] - '0');
+
+		// Placeholder entries for unknown AIs are not within the table
+		if ((uintptr_t)ai->aiEntry >= (uintptr_t)ctx->aiTable &&
+		    (uintptr_t)ai->aiEntry < (uintptr_t)(ctx->aiTable + ctx->aiTableEntries))
+			index = (size_t)(ai->aiEntry - ctx->aiTable);
+		else
+			index = SERIALISED_NO_ENTRY;
+
+		*p++ = (uint8_t)(ai->ailen | (hasPathOrder ? SERIALISED_PATH_ORDER : 0));
+		*p++ = (uint8_t)code;
+		*p++ = (uint8_t)(code >> 8);
+		if (hasPathOrder)
+			*p++ = ai->dlPathOrder;
+		*p++ = (uint8_t)index;
+		*p++ = (uint8_t)(index >> 8);
+		*p++ = (uint8_t)ai->vallen;
+		memcpy(p, ai->value, ai->vallen);
+		p += ai->vallen;
+		count++;
+
+	}
+
+	out[SERIALISED_HEADER_LEN - 1] = (uint8_t)count;
+
+	return (size_t)(p - out);
+
+too_small:
+
+	SET_ERR(OUTPUT_BUFFER_TOO_SMALL);
+	return 0;
+
+}
+
+
+/*
+ *  Load a serialised AI list as the message. The AI element string is always
+ *  rebuilt, but the AIs are only extracted, without validation, if the AI
+ *  table and settings match those with which the message was serialised.
+ *  Otherwise the caller must process the AI element string afresh.
+ *
+ */
+bool gs1_loadSerialisedAIs(gs1_encoder* const ctx, const uint8_t* const data, const size_t len, bool* const trusted) {
+
+	const uint8_t *p = data;
+	const uint8_t* const end = data + len;
+	char *q = ctx->dataStr;
+	char* const qend = ctx->dataStr + MAX_DATA;
+	uint64_t fingerprint = 0, pathOrders = 0;
+	int i, count, numPathOrders = 0;
+	bool fnc1req = true, ccsep = false;
+
+	assert(ctx);
+	assert(data || len == 0);
+	assert(trusted);
+
+	ctx->numAIs = 0;
+	ctx->numSortedAIs = 0;
+
+	if (len < SERIALISED_HEADER_LEN || p[0] != 'G' || p[1] != '1' || p[2] != SERIALISED_VERSION)
+		goto malformed;
+	for (i = 0; i < 8; i++)
+		fingerprint |= (uint64_t)p[3 + i] << (8 * i);
+	count = p[SERIALISED_HEADER_LEN - 1];
+	p += SERIALISED_HEADER_LEN;
+
+	if (count == 0) {
+		SET_ERR(AI_DATA_EMPTY);
+		goto fail;
+	}
+	if (count > MAX_AIS) {
+		SET_ERR(TOO_MANY_AIS);
+		goto fail;
+	}
+
+	*trusted = fingerprint == gs1_validationFingerprint(ctx);
+
+	for (i = 0; i < count; i++) {
+
+		struct aiValue* const ai = &ctx->aiData[i];
+		char aiStr[MAX_AI_LEN + 1];
+		const struct aiEntry *entry = NULL;
+		unsigned int code;
+		size_t index;
+		uint8_t tag, ailen, vallen, j, pathOrder = DL_PATH_ORDER_ATTRIBUTE;
+
+		if (p == end)
+			goto malformed;
+		tag = *p++;
+
+		if (tag == 0) {				// Composite separator
+			if (ccsep || q == ctx->dataStr || q == qend)
+				goto malformed;
+			*q++ = '|';
+			fnc1req = true;
+			ccsep = true;
+			*ai = (struct aiValue) { .kind = aiValue_ccsep };
+			continue;
+		}
+
+		ailen = (uint8_t)(tag & ~SERIALISED_PATH_ORDER);
+		if (ailen < MIN_AI_LEN || ailen > MAX_AI_LEN || end - p < 5)
+			goto malformed;
+		code = (unsigned int)p[0] | (unsigned int)p[1] << 8;
+		p += 2;
+		if (tag & SERIALISED_PATH_ORDER) {
+			pathOrder = *p++;
+			if (pathOrder >= count || (pathOrders & (UINT64_C(1) << pathOrder)))
+				goto malformed;
+			pathOrders |= UINT64_C(1) << pathOrder;
+			numPathOrders++;
+			if (end - p < 3)
+				goto malformed;
+		}
+		index = (size_t)p[0] | (size_t)p[1] << 8;
+		p += 2;
+		vallen = *p++;
+		if (vallen == 0 || vallen > MAX_AI_VALUE_LEN || (size_t)(end - p) < vallen)
+			goto malformed;
+		if (memchr(p, '^', vallen) || memchr(p, '|', vallen) || memchr(p, '\0', vallen))
+			goto malformed;
+
+		aiStr[ailen] = '\0';
+		for (j = ailen; j > 0; j--, code /= 10)
+			aiStr[j - 1] = (char)('0' + code % 10);
+		if (code != 0)				// More digits than the AI length
+			goto malformed;
+
+		if ((size_t)(qend - q) < (size_t)fnc1req + ailen + vallen)
+			goto malformed;
+
+		if (fnc1req)
+			*q++ = '^';
+
+		// The entry index is only meaningful for the same AI table
+		if (*trusted && index < ctx->aiTableEntries &&
+		    ctx->aiTable[index].ailen == ailen && memcmp(ctx->aiTable[index].ai, aiStr, ailen) == 0)
+			entry = &ctx->aiTable[index];
+		else
+			entry = gs1_lookupAIentry(ctx, aiStr, ailen);
+
+		// Where the AI ends depends upon the value length being valid
+		if (*trusted && entry && (vallen < aiEntryMinLength(entry) || vallen > aiEntryMaxLength(entry)))
+			goto malformed;
+
+		*ai = (struct aiValue) {
+			.kind = aiValue_aival,
+			.aiEntry = entry,
+			.ai = q,
+			.ailen = ailen,
+			.value = q + ailen,
+			.vallen = vallen,
+			.dlPathOrder = pathOrder
+		};
+		memcpy(q, aiStr, ailen);
+		memcpy(q + ailen, p, vallen);
+		gs1_hashAIvalue(ai);
+		q += ailen + vallen;
+		p += vallen;
+
+		if (!ai->aiEntry)
+			*trusted = false;		// For processing afresh to report
+		fnc1req = !ai->aiEntry || ai->aiEntry->fnc1;
+
+	}
+	*q = '\0';
+
+	if (p != end || q[-1] == '|')
+		goto malformed;
+
+	// Path orders must number the path components from the start
+	if (pathOrders != (numPathOrders == 64 ? UINT64_MAX : (UINT64_C(1) << numPathOrders) - 1))
+		goto malformed;
+
+	if (*trusted) {
+		ctx->numAIs = count;
+		gs1_sortAIs(ctx);
+	}
+
+	return true;
+
+malformed:
+
+	SET_ERR(SERIALISED_MESSAGE_IS_MALFORMED);
+
+fail:
+
+	*ctx->dataStr = '\0';
+	ctx->numAIs = 0;
+	ctx->numSortedAIs = 0;
+	return false;
+
+}
+
+
 #ifdef UNIT_TESTS
 
 #define TEST_NO_MAIN
@@ -1369,7 +2033,7 @@ static void do_test_parseAIdata(gs1_encoder* const ctx, const char* const file,
 
 	ctx->numAIs = 0;
 	ctx->numSortedAIs = 0;
-	TEST_CHECK(gs1_parseAIdata(ctx, aiData, out, sizeof(out)-1) ^ (!should_succeed));
+	TEST_CHECK(gs1_parseAIdata(ctx, aiData, strlen(aiData), out, sizeof(out)-1) ^ (!should_succeed));
 	TEST_MSG("Given: %s; Got: %s; Expected: %s; Err: %s", aiData, out, expect, ctx->errMsg);
 	TEST_CHECK(ctx->err == expect_err);
 	TEST_MSG("Given: %s; Expected err: %d; Got err: %d (%s)", aiData, expect_err, ctx->err, ctx->errMsg);
@@ -1479,7 +2143,7 @@ void test_ai_parseAIdata(void) {
 
 		ctx->numAIs = 0;
 		ctx->numSortedAIs = 0;
-		TEST_CHECK(gs1_parseAIdata(ctx, inbuf, outbuf, sizeof(outbuf)-1));	// Exactly 64 AIs
+		TEST_CHECK(gs1_parseAIdata(ctx, inbuf, strlen(inbuf), outbuf, sizeof(outbuf)-1));	// Exactly 64 AIs
 
 		// One more AI pushes over the limit
 		*ip++ = '('; *ip++ = '9'; *ip++ = '9'; *ip++ = ')';
@@ -1488,7 +2152,7 @@ void test_ai_parseAIdata(void) {
 
 		ctx->numAIs = 0;
 		ctx->numSortedAIs = 0;
-		TEST_CHECK(!gs1_parseAIdata(ctx, inbuf, outbuf, sizeof(outbuf)-1));	// 65 AIs, too many
+		TEST_CHECK(!gs1_parseAIdata(ctx, inbuf, strlen(inbuf), outbuf, sizeof(outbuf)-1));	// 65 AIs, too many
 		TEST_CHECK(ctx->err == gs1_encoder_eTOO_MANY_AIS);
 	}
 
@@ -1500,7 +2164,7 @@ void test_ai_parseAIdata(void) {
 		memset(buf, '#', sizeof(buf));			// Canary beyond the cap
 		ctx->numAIs = 0;
 		ctx->numSortedAIs = 0;
-		TEST_CHECK(!gs1_parseAIdata(ctx, "(99)ABCDEFGHIJ", buf, 5));	// Output exceeds cap
+		TEST_CHECK(!gs1_parseAIdata(ctx, "(99)ABCDEFGHIJ", 14, buf, 5));	// Output exceeds cap
 		TEST_CHECK(ctx->err == gs1_encoder_eAI_PARSE_FAILED);
 		for (k = 6; k < sizeof(buf); k++)
 			if (buf[k] != '#') clobbered++;
@@ -1525,7 +2189,7 @@ static void test_linters(gs1_encoder* const ctx, const char* const aiData, gs1_l
 
 	ctx->numAIs = 0;
 	ctx->numSortedAIs = 0;
-	TEST_CHECK(gs1_parseAIdata(ctx, aiData, out, sizeof(out)-1) || ctx->linterErr != GS1_LINTER_OK);
+	TEST_CHECK(gs1_parseAIdata(ctx, aiData, strlen(aiData), out, sizeof(out)-1) || ctx->linterErr != GS1_LINTER_OK);
 	gs1_sortAIs(ctx);
 	TEST_MSG("Parse failed for non-linter reasons. Err: %s", ctx->errMsg);
 
@@ -1932,7 +2596,7 @@ static void do_test_validateAIs(gs1_encoder* const ctx, const char* const file,
 
 	ctx->numAIs = 0;
 	ctx->numSortedAIs = 0;
-	TEST_CHECK((ret = gs1_parseAIdata(ctx, aiData, out, sizeof(out)-1)) == true);
+	TEST_CHECK((ret = gs1_parseAIdata(ctx, aiData, strlen(aiData), out, sizeof(out)-1)) == true);
 	TEST_MSG("Parse failed for non-pair validation reasons. Err: %s", ctx->errMsg);
 	if (!ret)
 		return;
@@ -91,6 +91,7 @@ struct aiValue {
 	uint16_t vallen;			// Length of the AI value; wider than ailen since DL "ignored" query params carry arbitrary-length non-AI data (fits in existing struct padding)
 	aiValueKind_t kind;			// Kind of AI value
 	uint8_t dlPathOrder;			// Denotes the position in a DL URI path component
+	uint64_t hash[2];			// Of the AI and value, for the message fingerprint
 };
 
 
@@ -162,10 +163,16 @@ const struct aiEntry* gs1_lookupAIentry(const gs1_encoder *ctx, const char *ai,
 bool gs1_aiPrefixHasDerivedLength(const char *ai);
 bool existsInAIdata(const gs1_encoder *ctx, const char *ai, size_t ailen, const char *ignoreAI, const struct aiValue **matchedAI);
 bool gs1_aiValLengthContentCheck(gs1_encoder *ctx, const char *ai, const struct aiEntry *entry, const char *aiVal, size_t vallen);
-bool gs1_parseAIdata(gs1_encoder *ctx, const char *aiData, char *dataStr, size_t dataStrCap);
+bool gs1_parseAIdata(gs1_encoder *ctx, const char *aiData, size_t aiDataLen, char *dataStr, size_t dataStrCap);
 bool gs1_processAIdata(gs1_encoder *ctx, const char *dataStr, bool extractAIs);
 bool gs1_validateAIs(gs1_encoder* ctx);
 void gs1_loadValidationTable(gs1_encoder* ctx);
+bool gs1_addLabelAIs(gs1_encoder* ctx);
+void gs1_loadLabelAIs(gs1_encoder* ctx);
+uint64_t gs1_validationFingerprint(const gs1_encoder* ctx);
+size_t gs1_serialiseAIs(gs1_encoder* ctx, uint8_t* out, size_t size);
+bool gs1_loadSerialisedAIs(gs1_encoder* ctx, const uint8_t* data, size_t len, bool* trusted);
+bool gs1_messageFingerprint(gs1_encoder* ctx, uint64_t fingerprint[2]);
 
 
 #ifdef UNIT_TESTS
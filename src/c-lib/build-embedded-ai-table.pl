@@ -2,7 +2,9 @@
 
 #
 #  This script can be used to build the embedded AI table (in ai.c) from the
-#  Syntax Dictionary.
+#  Syntax Dictionary. The output is the list of entries, which is included
+#  within the array initialiser in ai.c and the compile-time table of the
+#  C++ wrapper.
 #
 #      cat gs1-syntax-dictionary.txt | ./build-embedded-ai-table.pl > aitable.inc
 #
@@ -99,8 +101,6 @@ my $entry_rx = qr/
     $
 /x;
 
-print "static struct aiEntry embedded_ai_table[] = {\n";
-
 while (<>) {
 
     chomp;
@@ -173,4 +173,3 @@ while (<>) {
 }
 
 print "\tAI_ENTRY_TERMINATOR\n";
-print "};\n";
@@ -18,6 +18,8 @@
  *
  */
 
+#define GS1_ENCODERS_HEAP_SUBSYSTEM gs1_encoder_hDL_KEY_QUALIFIERS	// For profile-heap.h
+
 // IWYU pragma: no_include <alloca.h>
 
 #include <assert.h>
@@ -214,6 +216,7 @@ static bool addDLkeyQualifiers(gs1_encoder* const ctx, char*** const dlKeyQualif
 			SET_ERR(FAILED_TO_REALLOC_FOR_KEY_QUALIFIERS);
 			return false;
 		}
+		STATS_ALLOC();
 		*dlKeyQualifiers = reallocDLkeyQualifiers;
 		*cap = (*pos + req);
 
@@ -233,6 +236,7 @@ static bool addDLkeyQualifiers(gs1_encoder* const ctx, char*** const dlKeyQualif
 	*addedQualifiers = gs1_strdup_alloc(key);
 	if (!*addedQualifiers)
 		return false;
+	STATS_ALLOC();
 	(*pos)++;
 
 	tok = (gs1_tok_t) { .len = qualifiers_len };
@@ -253,6 +257,7 @@ static bool addDLkeyQualifiers(gs1_encoder* const ctx, char*** const dlKeyQualif
 			q_new = GS1_ENCODERS_MALLOC(total_len);
 			if (!q_new)
 				return false;
+			STATS_ALLOC();
 
 			memcpy(q_new, addedQualifiers[k], q_len);
 			q_new[q_len] = ' ';
@@ -284,6 +289,7 @@ bool gs1_populateDLkeyQualifiers(gs1_encoder* const ctx) {
 		SET_ERR(FAILED_TO_MALLOC_FOR_KEY_QUALIFIERS);
 		return false;
 	}
+	STATS_ALLOC();
 
 	/*
 	 *  Parse "dlpkey" attribute
@@ -739,6 +745,7 @@ bool gs1_parseDLuri(gs1_encoder* const ctx, char* const dlData, char* const data
 			.vallen = (uint16_t)vallen,
 			.dlPathOrder = (uint8_t)numPathAIs
 		};
+		gs1_hashAIvalue(&ctx->aiData[ctx->numAIs - 1]);
 
 		numPathAIs++;
 
@@ -861,6 +868,8 @@ add_query_param_to_ai_data:
 			.vallen = (uint16_t)vallen,
 			.dlPathOrder = DL_PATH_ORDER_ATTRIBUTE
 		};
+		if (kind == aiValue_aival)
+			gs1_hashAIvalue(&ctx->aiData[ctx->numAIs - 1]);
 
 		p = r;
 
@@ -991,10 +1000,11 @@ fail:
 
 
 /*
- *  Generate a DL URI from the AI data
+ *  Generate a DL URI from the AI data into the given buffer. The context is
+ *  not modified, so this may be called concurrently for the same message.
  *
  */
-char* gs1_generateDLuri(gs1_encoder* const ctx, const char* const stem) {
+bool gs1_renderDLuri(const gs1_encoder* const ctx, const char* const stem, char* const out, const size_t size, gs1_renderErr_t* const re) {
 
 	int i, maxQualifiers, numQualifiers = -1;
 	const char *key = NULL;
@@ -1033,6 +1043,11 @@ char* gs1_generateDLuri(gs1_encoder* const ctx, const char* const stem) {
 } while (0)
 
 	assert(ctx);
+	assert(out || size == 0);
+	assert(re);
+
+	if (size == 0)
+		goto too_long;
 
 	/*
 	 *  Check whether we already have path orders for the elements, i.e.
@@ -1087,11 +1102,11 @@ char* gs1_generateDLuri(gs1_encoder* const ctx, const char* const stem) {
 	}
 
 	if (keyEntry == -1) {
-		SET_ERR(CANNOT_CREATE_DL_URI_WITHOUT_PRIMARY_KEY_AI);
-		return NULL;
+		RENDER_ERR(re, CANNOT_CREATE_DL_URI_WITHOUT_PRIMARY_KEY_AI);
+		return false;
 	}
 
-	gs1_sortAIs(ctx);
+	assert(ctx->numSortedAIs > 0);		// By the validation of the message
 
 	/*
 	 *  Pick a maximum length key-qualifier sequence satisfied by the data
@@ -1155,8 +1170,8 @@ output:
 	 *  Now build the output
 	 *
 	 */
-	p = ctx->outStr;
-	avail = sizeof(ctx->outStr);
+	p = out;
+	avail = size;
 	stem_to_use = stem ? stem : CANONICAL_DL_STEM;
 
 	// Emit the caller stem in a single pass, leaving room for a terminating NUL
@@ -1168,7 +1183,7 @@ output:
 		goto too_long;
 
 	// Trim trailing slash (guarding against an empty stem)
-	if (p != ctx->outStr && *(p-1) == '/') {
+	if (p != out && *(p-1) == '/') {
 		p--;
 		avail++;
 	}
@@ -1232,9 +1247,8 @@ again:
 		 */
 		if (ai->aiEntry->dlDataAttr == NO_DATA_ATTR ||
 		    (ai->aiEntry->dlDataAttr == XX_DATA_ATTR && ctx->validationTable[gs1_encoder_vUNKNOWN_AI_NOT_DL_ATTR].enabled)) {
-			SET_ERR_V(AI_IS_NOT_VALID_DATA_ATTRIBUTE, ai->ailen, ai->ai);
-			*ctx->outStr = '\0';
-			return NULL;
+			RENDER_ERR_V(re, AI_IS_NOT_VALID_DATA_ATTRIBUTE, ai->ailen, ai->ai);
+			return false;
 		}
 
 		// Need room for "AI=", the escaped value and a trailing '&'
@@ -1263,13 +1277,12 @@ again:
 	// Trim the final character, either '?' or '&'
 	*(p-1) = '\0';
 
-	return ctx->outStr;
+	return true;
 
 too_long:
 
-	SET_ERR(DL_URI_TOO_LONG);
-	*ctx->outStr = '\0';
-	return NULL;
+	RENDER_ERR(re, DL_URI_TOO_LONG);
+	return false;
 
 #undef GS1_AI_OUTPUT_VAL
 #undef GS1_SET_AI_OUTPUT
@@ -1278,6 +1291,25 @@ too_long:
 }
 
 
+char* gs1_generateDLuri(gs1_encoder* const ctx, const char* const stem) {
+
+	gs1_renderErr_t re = RENDER_ERR_TARGET(ctx->errMsg, sizeof(ctx->errMsg));
+
+	assert(ctx);
+
+	gs1_sortAIs(ctx);
+
+	if (!gs1_renderDLuri(ctx, stem, ctx->outStr, sizeof(ctx->outStr), &re)) {
+		ctx->err = re.err;
+		*ctx->outStr = '\0';
+		return NULL;
+	}
+
+	return ctx->outStr;
+
+}
+
+
 #ifdef UNIT_TESTS
 
 #define TEST_NO_MAIN
@@ -2146,7 +2178,7 @@ static void do_test_testGenerateDLuri(gs1_encoder* const ctx, const char* const
 
 	ctx->numAIs = 0;
 	ctx->numSortedAIs = 0;
-	TEST_CHECK((ret = gs1_parseAIdata(ctx, aiData, out, sizeof(out)-1)) == true);
+	TEST_CHECK((ret = gs1_parseAIdata(ctx, aiData, strlen(aiData), out, sizeof(out)-1)) == true);
 	TEST_MSG("Parse failed for non-pair validation reasons. Err: %s", ctx->errMsg);
 	if (!ret)
 		return;
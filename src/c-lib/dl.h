@@ -33,6 +33,7 @@
 bool gs1_populateDLkeyQualifiers(gs1_encoder *ctx);
 void gs1_freeDLkeyQualifiers(gs1_encoder *ctx);
 bool gs1_parseDLuri(gs1_encoder *ctx, char *dlData, char *dataStr);
+bool gs1_renderDLuri(const gs1_encoder* ctx, const char* stem, char* out, size_t size, gs1_renderErr_t* re);
 char* gs1_generateDLuri(gs1_encoder* ctx, const char* stem);
 
 
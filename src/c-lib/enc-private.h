@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "gs1encoders.h"
@@ -31,6 +32,7 @@
 
 // Implementation limits that can be changed
 #define MAX_DATA	8191	// Maximum input buffer size
+#define STATS_MAX_LINTER_NAME_LEN	63	// Longest linter name retained by the statistics
 
 
 #ifdef _MSC_VER
@@ -78,6 +80,29 @@
 #  define DIAG_DISABLE_ANALYZER
 #endif
 
+/*
+ *  Reference counting for the tables that are shared between cloned
+ *  contexts, which may be freed on different threads.
+ *
+ */
+#if defined(__GNUC__) || defined(__clang__)
+typedef long gs1_refcount_t;
+#define GS1_ATOMIC_INC(p) __atomic_add_fetch((p), 1, __ATOMIC_RELAXED)
+#define GS1_ATOMIC_DEC(p) __atomic_sub_fetch((p), 1, __ATOMIC_ACQ_REL)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+typedef long gs1_refcount_t;
+#define GS1_ATOMIC_INC(p) _InterlockedIncrement(p)
+#define GS1_ATOMIC_DEC(p) _InterlockedDecrement(p)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+typedef atomic_long gs1_refcount_t;
+#define GS1_ATOMIC_INC(p) (atomic_fetch_add_explicit((p), 1, memory_order_relaxed) + 1)
+#define GS1_ATOMIC_DEC(p) (atomic_fetch_sub_explicit((p), 1, memory_order_acq_rel) - 1)
+#else
+#error "Atomic operations are required for the reference count of cloned contexts"
+#endif
+
 
 #ifdef GS1_ENCODERS_CUSTOM_HEAP_MANAGEMENT_H
 #define xstr(s) str(s)
@@ -97,6 +122,15 @@
 #define GS1_ENCODERS_FREE(p) free(p)
 #endif
 
+/*
+ *  Subsystem to which heap usage is attributed by profile-heap.h. Units that
+ *  allocate define this ahead of their includes.
+ *
+ */
+#ifndef GS1_ENCODERS_HEAP_SUBSYSTEM
+#define GS1_ENCODERS_HEAP_SUBSYSTEM gs1_encoder_hOTHER
+#endif
+
 
 /*
  *  The whole gs1_encoder is one allocation, so ASan cannot see an overrun from
@@ -250,10 +284,39 @@ typedef enum {
 	gs1_encoder_eAI_VALUE_LENGTH_EXCEEDS_IMPL,
 	gs1_encoder_eAI_TITLE_TOO_LONG,
 	gs1_encoder_eNO_SYMBOLOGY_SELECTED,
+	gs1_encoder_eUNKNOWN_BATCH_FORMAT,
+	gs1_encoder_eINPUT_CONTAINS_NUL,
+	gs1_encoder_eOUTPUT_BUFFER_TOO_SMALL,
+	gs1_encoder_eSCAN_DATA_HAS_NO_AIS,
+	gs1_encoder_eMESSAGE_IS_NOT_AI_DATA,
+	gs1_encoder_eSERIALISED_MESSAGE_IS_MALFORMED,
 	__GS1_ENCODERS_NUM_ERRS
 } gs1_encoder_err_t;
 
 
+/*
+ *  Where a renderer reports an error, since renderers do not modify the
+ *  context. The getters direct it to the context's error message; the
+ *  gs1_encoder_render*() functions to the caller's output buffer.
+ *
+ */
+typedef struct {
+	gs1_encoder_err_t err;
+	char *msg;
+	size_t msgSize;
+} gs1_renderErr_t;
+
+#define RENDER_ERR_TARGET(m, sz) { .err = gs1_encoder_eNO_ERROR, .msg = (m), .msgSize = (sz) }
+
+
+typedef enum {
+	scanStream_PREFIX = 0,			// Receiving the symbology identifier
+	scanStream_AI,				// Converting AI data as it is received
+	scanStream_RAW,				// Buffering other data, to be processed once terminated
+	scanStream_DISCARD,			// Discarding a symbol that is in error until it is terminated
+} scanStreamState_t;
+
+
 struct gs1_encoder {
 
 	gs1_encoder_symbologies_t sym;		// Symbology type
@@ -285,6 +348,9 @@ struct gs1_encoder {
 	char *outHRI[MAX_AIS];			// Array of AI element string for HRI printing
 	GS1_ENCODERS_ASAN_GUARD(outHRI)
 
+	gs1_encoder_ai_element_t outAIs[MAX_AIS];	// Array of AI elements referring into the input buffers
+	GS1_ENCODERS_ASAN_GUARD(outAIs)
+
 	bool localAlloc;			// True if we malloc()ed this struct
 	FILE *outfp;
 
@@ -292,6 +358,9 @@ struct gs1_encoder {
 	size_t aiTableEntries;			// Number of entries in the AI table
 	bool aiTableIsDynamic;			// True if the AI table is loaded from the Syntax Dictionary
 
+	const struct gs1_encoder_linter *linters;	// Application-provided linters; only set whilst loading the Syntax Dictionary
+	size_t numLinters;			// Number of entries in linters
+
 	struct aiValue aiData[MAX_AIS];		// List of AI components
 	GS1_ENCODERS_ASAN_GUARD(aiData)
 	int numAIs;
@@ -300,14 +369,41 @@ struct gs1_encoder {
 	GS1_ENCODERS_ASAN_GUARD(sortedAIs)
 	int numSortedAIs;			// Number of entries in sortedAIs
 
+	char labelStr[MAX_DATA+1];		// "^AIvalue" of each AI of the label being assembled from multiple reads
+	GS1_ENCODERS_ASAN_GUARD(labelStr)
+	size_t labelLen;			// Length of labelStr
+
+	struct aiValue labelAIs[MAX_AIS];	// AIs of the label, referring into labelStr
+	GS1_ENCODERS_ASAN_GUARD(labelAIs)
+	int numLabelAIs;
+
+	char scanStreamBuf[MAX_DATA+3];		// Symbol being received from a scan data stream; AI data is converted as it arrives
+	GS1_ENCODERS_ASAN_GUARD(scanStreamBuf)
+	size_t scanStreamLen;			// Length of scanStreamBuf
+	scanStreamState_t scanStreamState;
+	gs1_encoder_symbologies_t scanStreamSym;	// Once the symbology identifier is received
+	gs1_encoder_err_t scanStreamErr;	// First error in the symbol, reported once it is terminated
+
 	struct validationEntry validationTable[gs1_encoder_vNUMVALIDATIONS];
 						// Table of all global validation functions
 
 	uint8_t aiLengthByPrefix[100];		// AI length by two-digit prefix
 
+	uint64_t aiTableFingerprint;		// Identifies the AI table, and the library version, for serialised messages
+
 	char** dlKeyQualifiers;			// List of valid DL key qualifier association strings
 	int numDLkeyQualifiers;			// Number of dlKeyQualifiers strings
 
+	gs1_refcount_t *sharedTablesRefs;	// Contexts sharing aiTable and dlKeyQualifiers
+
+#ifdef GS1_ENCODERS_STATS
+	gs1_encoder_stats_t stats;		// Processing statistics
+	gs1_linter_t statsLinterFns[GS1_ENCODERS_STATS_MAX_LINTERS];	// Linter for each stats.linters entry
+	char statsLinterNames[GS1_ENCODERS_STATS_MAX_LINTERS][STATS_MAX_LINTER_NAME_LEN+1];	// Copies of the names of application-provided linters
+	uint64_t statsStart[gs1_encoder_stNUMSTAGES];	// Start time of each stage in progress
+	gs1_encoder_stats_kinds_t statsKind;	// Kind of the message being processed
+#endif
+
 };
 
 
@@ -354,8 +450,12 @@ GS1_ENCODERS_STATIC_ASSERT(MIN_AI_LEN >= 2);
 	GUARD(s, dlAIbuffer)		\
 	GUARD(s, outStr)		\
 	GUARD(s, outHRI)		\
+	GUARD(s, outAIs)		\
 	GUARD(s, aiData)		\
-	GUARD(s, sortedAIs)
+	GUARD(s, sortedAIs)		\
+	GUARD(s, labelStr)		\
+	GUARD(s, labelAIs)		\
+	GUARD(s, scanStreamBuf)
 
 
 /*
@@ -376,6 +476,46 @@ static inline char* gs1_buf_append(char *dst, size_t *rem, const void *src, size
 	return dst;
 }
 
+// Accumulate a 64-bit FNV-1a hash of the buffer
+static inline __ATTR_PURE uint64_t gs1_fnv1a64(uint64_t h, const void* const buf, size_t len) {
+	const uint8_t *p = buf;
+	while (len--) {
+		h ^= *p++;
+		h *= UINT64_C(0x100000001b3);
+	}
+	return h;
+}
+
+#define GS1_FNV1A64_INIT UINT64_C(0xcbf29ce484222325)
+
+// Final avalanche of a 64-bit hash (MurmurHash3 fmix64)
+static inline __ATTR_CONST uint64_t gs1_fmix64(uint64_t h) {
+	h ^= h >> 33;
+	h *= UINT64_C(0xff51afd7ed558ccd);
+	h ^= h >> 33;
+	h *= UINT64_C(0xc4ceb9fe1a85ec53);
+	h ^= h >> 33;
+	return h;
+}
+
+// Hash an extracted AI and its value in two lanes for the message fingerprint
+static inline void gs1_hashAIvalue(struct aiValue* const ai) {
+	uint64_t h0 = GS1_FNV1A64_INIT, h1 = ~GS1_FNV1A64_INIT;
+	size_t i;
+	for (i = 0; i < ai->ailen; i++) {
+		h0 = (h0 ^ (uint8_t)ai->ai[i]) * UINT64_C(0x100000001b3);
+		h1 = (h1 ^ (uint8_t)ai->ai[i]) * UINT64_C(0x9e3779b97f4a7c15);
+	}
+	h0 = (h0 ^ '^') * UINT64_C(0x100000001b3);	// Never within an AI value
+	h1 = (h1 ^ '^') * UINT64_C(0x9e3779b97f4a7c15);
+	for (i = 0; i < ai->vallen; i++) {
+		h0 = (h0 ^ (uint8_t)ai->value[i]) * UINT64_C(0x100000001b3);
+		h1 = (h1 ^ (uint8_t)ai->value[i]) * UINT64_C(0x9e3779b97f4a7c15);
+	}
+	ai->hash[0] = h0;
+	ai->hash[1] = h1;
+}
+
 // Buffer is all digits
 static inline __ATTR_PURE bool gs1_allDigits(const uint8_t* const str, size_t len) {
 	size_t i;
@@ -386,6 +526,66 @@ static inline __ATTR_PURE bool gs1_allDigits(const uint8_t* const str, size_t le
 }
 
 
+/*
+ *  Processing statistics, compiled in only when GS1_ENCODERS_STATS is
+ *  defined. Like SET_ERR, the macros act upon the ctx that is in scope.
+ *
+ */
+#ifdef GS1_ENCODERS_STATS
+
+#include <time.h>
+
+// Monotonic where available; MSVC provides only the C11 calendar clock
+static inline uint64_t gs1_stats_now_ns(void) {
+	struct timespec ts;
+#if defined(_WIN32)
+	timespec_get(&ts, TIME_UTC);
+#else
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void gs1_stats_recordLinter(gs1_encoder *ctx, gs1_linter_t fn, const char *name, uint64_t ns, bool failed);
+
+#define STATS_MESSAGE(k)	do { ctx->statsKind = (k); ctx->stats.messages[k]++; } while (0)
+#define STATS_REJECTED()	do { ctx->stats.rejected[ctx->statsKind]++; } while (0)
+#define STATS_ALLOC()		do { ctx->stats.allocations++; } while (0)
+#define STATS_BEGIN(st)		do { ctx->statsStart[st] = gs1_stats_now_ns(); } while (0)
+#define STATS_END(st)		do { ctx->stats.stageNs[st] += gs1_stats_now_ns() - ctx->statsStart[st]; } while (0)
+#define STATS_RENDER_BEGIN()	do { ctx->stats.renders++; STATS_BEGIN(gs1_encoder_stRENDER); } while (0)
+#define STATS_RENDER_END()	STATS_END(gs1_encoder_stRENDER)
+#define STATS_VALIDATION_BEGIN()	STATS_BEGIN(gs1_encoder_stVALIDATE)
+#define STATS_VALIDATION_END(v, failed) do {						\
+	const uint64_t ns_ = gs1_stats_now_ns() - ctx->statsStart[gs1_encoder_stVALIDATE];	\
+	ctx->stats.validationRuns[v]++;							\
+	ctx->stats.validationNs[v] += ns_;						\
+	ctx->stats.stageNs[gs1_encoder_stVALIDATE] += ns_;				\
+	if (failed) ctx->stats.validationFailures[v]++;					\
+} while (0)
+#define STATS_LINTER_BEGIN()	STATS_BEGIN(gs1_encoder_stLINT)
+#define STATS_LINTER_END(fn, failed)	\
+	gs1_stats_recordLinter(ctx, fn, NULL, gs1_stats_now_ns() - ctx->statsStart[gs1_encoder_stLINT], failed)
+#define STATS_LINTER_NAME(fn, name)	gs1_stats_recordLinter(ctx, fn, name, 0, false)
+
+#else
+
+#define STATS_MESSAGE(k)		do {} while (0)
+#define STATS_REJECTED()		do {} while (0)
+#define STATS_ALLOC()			do {} while (0)
+#define STATS_BEGIN(st)			do {} while (0)
+#define STATS_END(st)			do {} while (0)
+#define STATS_RENDER_BEGIN()		do {} while (0)
+#define STATS_RENDER_END()		do {} while (0)
+#define STATS_VALIDATION_BEGIN()	do {} while (0)
+#define STATS_VALIDATION_END(v, failed)	do {} while (0)
+#define STATS_LINTER_BEGIN()		do {} while (0)
+#define STATS_LINTER_END(fn, failed)	do {} while (0)
+#define STATS_LINTER_NAME(fn, name)	do {} while (0)
+
+#endif
+
+
 /*
  *  Utility functions
  *
@@ -399,7 +599,18 @@ typedef struct {
 
 bool gs1_tokenise(const char *data, char delim, gs1_tok_t *tok);
 
-char* gs1_strdup_alloc(const char *s);
+// Inline so that the allocation is attributed to the caller's subsystem
+static inline char* gs1_strdup_alloc(const char *s) {
+
+	size_t len = strlen(s) + 1;
+	void *d = GS1_ENCODERS_MALLOC(len);
+
+	if (!d)
+		return NULL;
+
+	return memcpy(d, s, len);
+
+}
 
 ssize_t gs1_binarySearch(const void* needle, const void* haystack, const size_t haystack_size,
 			 int (*compare)(const void* key, const void* element, const size_t index),
@@ -415,6 +626,8 @@ void test_api_init_deprecatedFlags(void);
 void test_api_init_opts_layout(void);
 void test_api_init_enum_values(void);
 void test_api_defaults(void);
+void test_api_clone(void);
+void test_api_reset(void);
 void test_api_sym(void);
 void test_api_addCheckDigit(void);
 void test_api_permitUnknownAIs(void);
@@ -426,14 +639,25 @@ void test_api_dataStr(void);
 void test_api_getAIdataStr(void);
 void test_api_getScanData(void);
 void test_api_setScanData(void);
+void test_api_setters_lengthDelimited(void);
 void test_api_getHRI(void);
 void test_api_copyHRI(void);
 void test_api_getDLignoredQueryParams(void);
 void test_api_copyDLignoredQueryParams(void);
+void test_api_getAIelements(void);
+void test_api_label(void);
+void test_api_scanStream(void);
+void test_api_render(void);
+void test_api_serialisedMessage(void);
+void test_api_messageFingerprint(void);
 void test_api_allocFailures(void);
 #ifndef EXCLUDE_SYNTAX_DICTIONARY_LOADER
 void test_api_brokenPrefixSyndict(void);
 void test_api_tooManyDLkeyQualifiersSyndict(void);
+void test_api_customLinters(void);
+void test_api_stats(void);
+void test_api_heapProfile(void);
+void test_api_processBatch(void);
 #endif
 
 #endif
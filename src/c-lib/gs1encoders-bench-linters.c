@@ -0,0 +1,340 @@
+/**
+ * GS1 Barcode Syntax Engine
+ *
+ * @author Copyright (c) 2021-2026 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ *  Microbenchmark driver for the Syntax Dictionary linters.
+ *
+ *  Usage: gs1encoders-bench-linters [-t <min ms per run>] [-j <json file>] [<filter>]
+ *
+ *  Each reference linter is timed separately over a set of valid inputs and
+ *  a set of invalid inputs of realistic length for the AIs that use it, so
+ *  that the effect of optimising any one linter can be measured in isolation.
+ *  Invalid inputs fail late where possible so that the whole value is
+ *  scanned. The inputs are checked against the expected outcome before
+ *  timing.
+ *
+ *  The deprecated stub linters are not timed.
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "syntax/gs1syntaxdictionary.h"
+#include "bench-timer.h"
+
+
+#define DEFAULT_MIN_TIME_MS 50
+#define MAX_INPUTS 4
+
+
+typedef struct {
+	const char *name;
+	gs1_linter_t fn;
+	const char *valid[MAX_INPUTS + 1];
+	const char *invalid[MAX_INPUTS + 1];
+} linterCase;
+
+static const linterCase cases[] = {
+	{ "couponcode", gs1_lint_couponcode,
+		{ "012345612345611110123", "012345612345611110123101101230123456", NULL },
+		{ "01234561234561111012a", "012345612345611110123101101230123x56", NULL } },
+	{ "couponposoffer", gs1_lint_couponposoffer,
+		{ "001234561234560123456", "101234561234560123456", NULL },
+		{ "00123456123456012345a", "201234561234560123456", NULL } },
+	{ "cset39", gs1_lint_cset39,
+		{ "PART-1234/ABC#5678", "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789#-/", NULL },
+		{ "PART-1234/ABC#567_", "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789#-a", NULL } },
+	{ "cset64", gs1_lint_cset64,
+		{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_", "QUJDMTIz", "QUJDMTIzNA==", NULL },
+		{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-+", "QUJDMT==I", NULL } },
+	{ "cset82", gs1_lint_cset82,
+		{ "ABC123-xyz/BATCH.42", "!\"%&'()*+,-./0123456789:;<=>?ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz", NULL },
+		{ "ABC123-xyz/BATCH 42", "!\"%&'()*+,-./0123456789:;<=>?ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxy~", NULL } },
+	{ "csetnumeric", gs1_lint_csetnumeric,
+		{ "09521234543213", "12345678901234567890", NULL },
+		{ "0952123454321A", "1234567890123456789/", NULL } },
+	{ "csum", gs1_lint_csum,
+		{ "09521234543213", "095212345678901235", "9521234543213", NULL },
+		{ "09521234543214", "095212345678901236", "9521234543212", NULL } },
+	{ "csumalpha", gs1_lint_csumalpha,
+		{ "1987654Ad4X4bL5ttr2310c2K", "12345678901234567890123NT", "7907665Bm8v2AB", NULL },
+		{ "1987654Ad4X4bL5ttr2310cXK", "12345678901234567890123NU", "7907665Bm8v2BA", NULL } },
+	{ "gcppos1", gs1_lint_gcppos1,
+		{ "9521234543213", "95212345678901234567890123456789", NULL },
+		{ "952A234543213", "9", NULL } },
+	{ "gcppos2", gs1_lint_gcppos2,
+		{ "09521234543213", "095212345678901234567890123456789", NULL },
+		{ "0952A234543213", "09", NULL } },
+	{ "hasnondigit", gs1_lint_hasnondigit,
+		{ "1234567890123456789A", "A1234567890", NULL },
+		{ "12345678901234567890", "0", NULL } },
+	{ "hh", gs1_lint_hh,
+		{ "00", "23", NULL },
+		{ "24", "2x", NULL } },
+	{ "hhmi", gs1_lint_hhmi,
+		{ "0000", "2359", NULL },
+		{ "2400", "2360", NULL } },
+	{ "hyphen", gs1_lint_hyphen,
+		{ "-", NULL },
+		{ "X", NULL } },
+	{ "iban", gs1_lint_iban,
+		{ "GB82WEST12345698765432", "FR7630006000011234567890189", "LC55HEMM000100010012001200023015", NULL },
+		{ "GB82WEST12345698765433", "FR7630006000011234567890188", "LC55HEMM00010001001200120002301x", NULL } },
+	{ "importeridx", gs1_lint_importeridx,
+		{ "A", "-", NULL },
+		{ "AA", "!", NULL } },
+	{ "iso3166", gs1_lint_iso3166,
+		{ "826", "004", "894", NULL },
+		{ "000", "999", NULL } },
+	{ "iso3166999", gs1_lint_iso3166999,
+		{ "826", "999", NULL },
+		{ "000", "998", NULL } },
+	{ "iso3166alpha2", gs1_lint_iso3166alpha2,
+		{ "GB", "AD", "ZW", NULL },
+		{ "ZZ", "AA", NULL } },
+	{ "iso4217", gs1_lint_iso4217,
+		{ "978", "008", "826", NULL },
+		{ "000", "001", NULL } },
+	{ "iso5218", gs1_lint_iso5218,
+		{ "0", "9", NULL },
+		{ "3", "X", NULL } },
+	{ "latitude", gs1_lint_latitude,
+		{ "0279085848", "1800000000", NULL },
+		{ "1800000001", "027908584X", NULL } },
+	{ "longitude", gs1_lint_longitude,
+		{ "3015297971", "3600000000", NULL },
+		{ "3600000001", "301529797X", NULL } },
+	{ "mediatype", gs1_lint_mediatype,
+		{ "01", "99", NULL },
+		{ "00", "1X", NULL } },
+	{ "mi", gs1_lint_mi,
+		{ "00", "59", NULL },
+		{ "60", "5x", NULL } },
+	{ "nonzero", gs1_lint_nonzero,
+		{ "000001", "100000", NULL },
+		{ "000000", "0", NULL } },
+	{ "nozeroprefix", gs1_lint_nozeroprefix,
+		{ "123456", "1", NULL },
+		{ "0123456", "01", NULL } },
+	{ "packagetype", gs1_lint_packagetype,
+		{ "1A", "BX", "PX", NULL },
+		{ "ZZZ", "0", NULL } },
+	{ "pcenc", gs1_lint_pcenc,
+		{ "ABCDEFGHIJKLMNOPQRSTUVWXYZ", "ABC%20DEF%2Fghi%3A%3Bjkl%25mno", NULL },
+		{ "ABCDEFGHIJKLMNOPQRSTUVWXY%", "ABC%20DEF%2Fghi%3A%3Bjkl%25mn%G0", NULL } },
+	{ "pieceoftotal", gs1_lint_pieceoftotal,
+		{ "0102", "999999", NULL },
+		{ "0201", "0001", NULL } },
+	{ "posinseqslash", gs1_lint_posinseqslash,
+		{ "1/3", "12/345", NULL },
+		{ "3/2", "12/", NULL } },
+	{ "ss", gs1_lint_ss,
+		{ "00", "59", NULL },
+		{ "60", "5x", NULL } },
+	{ "winding", gs1_lint_winding,
+		{ "0", "9", NULL },
+		{ "2", "X", NULL } },
+	{ "yesno", gs1_lint_yesno,
+		{ "0", "1", NULL },
+		{ "2", "X", NULL } },
+	{ "yymmd0", gs1_lint_yymmd0,
+		{ "251231", "251200", "240229", NULL },
+		{ "251232", "251300", "250229", NULL } },
+	{ "yymmdd", gs1_lint_yymmdd,
+		{ "251231", "240229", NULL },
+		{ "251200", "250229", NULL } },
+	{ "yyyymmd0", gs1_lint_yyyymmd0,
+		{ "20251231", "20251200", "20240229", NULL },
+		{ "20251232", "20251300", "20250229", NULL } },
+	{ "yyyymmdd", gs1_lint_yyyymmdd,
+		{ "20251231", "20240229", NULL },
+		{ "20251200", "20250229", NULL } },
+	{ "zero", gs1_lint_zero,
+		{ "0", "0000", NULL },
+		{ "0001", "1", NULL } },
+};
+
+typedef struct {
+	unsigned long iterations;
+	double nsPerOp;
+	double mbPerSec;
+} runResult;
+
+
+static volatile gs1_lint_err_t sink;
+
+
+/*
+ *  Check that each input produces the expected outcome, and that the linter
+ *  is the one registered under the given name.
+ *
+ */
+static bool checkCase(const linterCase *lc) {
+
+	size_t i, errPos, errLen;
+	bool ok = true;
+
+	if (gs1_linter_from_name(lc->name) != lc->fn) {
+		fprintf(stderr, "%s: not the registered linter of that name\n", lc->name);
+		ok = false;
+	}
+
+	for (i = 0; lc->valid[i]; i++) {
+		if (lc->fn(lc->valid[i], strlen(lc->valid[i]), &errPos, &errLen) != GS1_LINTER_OK) {
+			fprintf(stderr, "%s: valid input rejected: %s\n", lc->name, lc->valid[i]);
+			ok = false;
+		}
+	}
+
+	for (i = 0; lc->invalid[i]; i++) {
+		if (lc->fn(lc->invalid[i], strlen(lc->invalid[i]), &errPos, &errLen) == GS1_LINTER_OK) {
+			fprintf(stderr, "%s: invalid input accepted: %s\n", lc->name, lc->invalid[i]);
+			ok = false;
+		}
+	}
+
+	return ok;
+
+}
+
+
+static void runInputs(gs1_linter_t fn, const char* const *inputs, uint64_t minNs, runResult *res) {
+
+	size_t lens[MAX_INPUTS], n, i, errPos, errLen;
+	unsigned long reps = 1, r;
+	uint64_t elapsed, t0, bytes = 0;
+
+	for (n = 0; inputs[n]; n++) {
+		lens[n] = strlen(inputs[n]);
+		bytes += lens[n];
+	}
+
+	for (;;) {
+		t0 = bench_now_ns();
+		for (r = 0; r < reps; r++)
+			for (i = 0; i < n; i++)
+				sink = fn(inputs[i], lens[i], &errPos, &errLen);
+		elapsed = bench_now_ns() - t0;
+
+		if (elapsed >= minNs || reps > (unsigned long)-1 / 2)
+			break;
+
+		reps *= 2;
+	}
+
+	if (elapsed == 0)
+		elapsed = 1;
+
+	res->iterations = reps * n;
+	res->nsPerOp = (double)elapsed / (double)res->iterations;
+	res->mbPerSec = (double)(bytes * reps) * 1e3 / (double)elapsed;
+
+}
+
+
+static void writeJSON(FILE *f, unsigned long minTimeMs, const runResult *valid, const runResult *invalid, const bool *ran) {
+
+	size_t i;
+	bool first = true;
+
+	fprintf(f, "{\n");
+	fprintf(f, "  \"min_time_ms\": %lu,\n", minTimeMs);
+	fprintf(f, "  \"results\": [\n");
+	for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+		if (!ran[i])
+			continue;
+		fprintf(f, "%s    { \"name\": \"%s\", "
+			"\"valid\": { \"iterations\": %lu, \"ns_per_op\": %.2f, \"mb_per_sec\": %.2f }, "
+			"\"invalid\": { \"iterations\": %lu, \"ns_per_op\": %.2f, \"mb_per_sec\": %.2f } }",
+			first ? "" : ",\n", cases[i].name,
+			valid[i].iterations, valid[i].nsPerOp, valid[i].mbPerSec,
+			invalid[i].iterations, invalid[i].nsPerOp, invalid[i].mbPerSec);
+		first = false;
+	}
+	fprintf(f, "\n  ]\n}\n");
+
+}
+
+
+int main(int argc, char *argv[]) {
+
+	runResult valid[sizeof(cases) / sizeof(cases[0])];
+	runResult invalid[sizeof(cases) / sizeof(cases[0])];
+	bool ran[sizeof(cases) / sizeof(cases[0])] = { false };
+	unsigned long minTimeMs = DEFAULT_MIN_TIME_MS;
+	const char *jsonFile = NULL;
+	const char *filter = NULL;
+	bool ok = true;
+	FILE *f;
+	size_t i;
+	int a;
+
+	for (a = 1; a < argc; a++) {
+		if (strcmp(argv[a], "-t") == 0 && a + 1 < argc)
+			minTimeMs = strtoul(argv[++a], NULL, 10);
+		else if (strcmp(argv[a], "-j") == 0 && a + 1 < argc)
+			jsonFile = argv[++a];
+		else if (argv[a][0] != '-' && !filter)
+			filter = argv[a];
+		else {
+			fprintf(stderr, "Usage: %s [-t <min ms per run>] [-j <json file>] [<filter>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+		ok &= checkCase(&cases[i]);
+	if (!ok)
+		return 1;
+
+	printf("%-16s %14s %12s %14s %12s\n", "linter", "valid ns/op", "valid MB/s", "invalid ns/op", "invalid MB/s");
+
+	for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+
+		if (filter && !strstr(cases[i].name, filter))
+			continue;
+
+		runInputs(cases[i].fn, cases[i].valid, (uint64_t)minTimeMs * 1000000u, &valid[i]);
+		runInputs(cases[i].fn, cases[i].invalid, (uint64_t)minTimeMs * 1000000u, &invalid[i]);
+		ran[i] = true;
+
+		printf("%-16s %14.2f %12.2f %14.2f %12.2f\n", cases[i].name,
+			valid[i].nsPerOp, valid[i].mbPerSec, invalid[i].nsPerOp, invalid[i].mbPerSec);
+		fflush(stdout);
+
+	}
+
+	if (jsonFile) {
+		if ((f = fopen(jsonFile, "w")) == NULL) {
+			fprintf(stderr, "Failed to open %s for writing\n", jsonFile);
+			return 1;
+		}
+		writeJSON(f, minTimeMs, valid, invalid, ran);
+		fclose(f);
+		printf("\nJSON results written to %s\n", jsonFile);
+	}
+
+	return 0;
+
+}
@@ -0,0 +1,509 @@
+/**
+ * GS1 Barcode Syntax Engine
+ *
+ * @author Copyright (c) 2021-2026 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ *  Benchmark harness for the public transformation paths.
+ *
+ *  Usage: gs1encoders-bench [-t <min ms per case>] [-j <json file>] [<filter>]
+ *
+ *  Each case runs over a small bundled corpus of representative messages.
+ *  The number of repetitions is doubled until the timed portion of a case
+ *  exceeds the minimum run time. Any per-message preparation (e.g. loading
+ *  the message before timing a getter) is excluded from the timings.
+ *
+ *  The library objects are built with profile-heap.h so that allocations
+ *  made through the library's heap hooks are accounted. Processing a message
+ *  with an initialised context is expected not to allocate, so the benchmark
+ *  fails if any message case does.
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gs1encoders.h"
+#include "bench-timer.h"
+
+#define SYNTAX_DICTIONARY "gs1-syntax-dictionary.txt"
+#define DEFAULT_MIN_TIME_MS 200
+#define MAX_CORPUS 16
+
+
+/*
+ *  Bundled corpus. The element string, GS1 Digital Link URI and scan data
+ *  corpora are derived from the AI data at startup so that each path
+ *  processes the same messages.
+ *
+ */
+static const char *corpusAIdata[] = {
+	"(01)09521234543213(10)ABC123(99)TEST",
+	"(01)09521234543213(17)251231(10)BATCH42(21)SERIAL0001",
+	"(01)09521234543213(3103)000189(15)260101(10)LOT-7",
+	"(01)09521234543213(11)250101(17)271231(10)ABCDEFGHIJKLMNOPQRST(21)12345678901234567890",
+	"(00)095212345678901235(02)09521234543213(37)24",
+	"(414)9521234543213(254)A1B2",
+	"(8004)952123456789012345",
+	NULL
+};
+
+static const char *corpusPlain[] = {
+	"TEST1234",
+	"Hello, world!",
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789abcdefghijklmnopqrstuvwxyz",
+	NULL
+};
+
+static const char *corpusScanDataPlain[] = {
+	"]Q1TEST1234",
+	"]d1Hello, world!",
+	"]J0ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789abcdefghijklmnopqrstuvwxyz",
+	"]E09521234543213",
+	"]E495212340",
+	NULL
+};
+
+static const char *corpusInit[] = { "", NULL };
+static const char *corpusInitSyntaxDictionary[] = { SYNTAX_DICTIONARY, NULL };
+
+static const char *corpusElementString[MAX_CORPUS + 1];
+static const char *corpusDLuri[MAX_CORPUS + 1];
+static const char *corpusScanData[MAX_CORPUS + 1];
+
+static const gs1_encoder_symbologies_t scanDataSyms[] = {
+	gs1_encoder_sDM, gs1_encoder_sQR, gs1_encoder_sGS1_128_CCA, gs1_encoder_sDataBarExpanded
+};
+
+
+/*
+ *  Operations. Each returns false on failure, which aborts the benchmark
+ *  since a failing path would otherwise be timed as a (fast) error path.
+ *
+ */
+static bool op_init(gs1_encoder *ctx, const char *in) {
+	gs1_encoder *c;
+	(void)ctx;
+	(void)in;
+	if ((c = gs1_encoder_init_ex(NULL, NULL)) == NULL)
+		return false;
+	gs1_encoder_free(c);
+	return true;
+}
+
+static bool op_initSyntaxDictionary(gs1_encoder *ctx, const char *in) {
+	gs1_encoder *c;
+	gs1_encoder_init_opts_t opts = {
+		.struct_size		= sizeof(gs1_encoder_init_opts_t),
+		.syntaxDictionary	= in,
+	};
+	(void)ctx;
+	if ((c = gs1_encoder_init_ex(NULL, &opts)) == NULL)
+		return false;
+	gs1_encoder_free(c);
+	return true;
+}
+
+static bool op_clone(gs1_encoder *ctx, const char *in) {
+	gs1_encoder *c;
+	(void)in;
+	if ((c = gs1_encoder_clone(ctx, NULL)) == NULL)
+		return false;
+	gs1_encoder_free(c);
+	return true;
+}
+
+static bool op_reset(gs1_encoder *ctx, const char *in) {
+	(void)in;
+	gs1_encoder_reset(ctx);
+	return true;
+}
+
+static bool op_setAIdataStr(gs1_encoder *ctx, const char *in) {
+	return gs1_encoder_setAIdataStr(ctx, in);
+}
+
+static bool op_setDataStr(gs1_encoder *ctx, const char *in) {
+	return gs1_encoder_setDataStr(ctx, in);
+}
+
+static bool op_setScanData(gs1_encoder *ctx, const char *in) {
+	return gs1_encoder_setScanData(ctx, in);
+}
+
+static bool op_feedScanStream(gs1_encoder *ctx, const char *in) {
+	size_t consumed;
+	return gs1_encoder_feedScanStream(ctx, in, strlen(in), &consumed) == gs1_encoder_fNEED_MORE &&
+	       gs1_encoder_flushScanStream(ctx) == gs1_encoder_fMESSAGE;
+}
+
+static bool op_labelBegin(gs1_encoder *ctx, const char *in) {
+	gs1_encoder_labelBegin(ctx);
+	return gs1_encoder_labelAddScanData(ctx, in);
+}
+
+static bool op_labelAddScanData(gs1_encoder *ctx, const char *in) {
+	return gs1_encoder_labelAddScanData(ctx, in);
+}
+
+static uint8_t serialised[GS1_ENCODERS_MAX_SERIALISED_MESSAGE_LEN];
+static size_t serialisedLen;
+
+static bool op_serialise(gs1_encoder *ctx, const char *in) {
+	if (!gs1_encoder_setAIdataStr(ctx, in))
+		return false;
+	serialisedLen = gs1_encoder_getSerialisedMessage(ctx, serialised, sizeof(serialised));
+	return serialisedLen > 0;
+}
+
+static bool op_getSerialisedMessage(gs1_encoder *ctx, const char *in) {
+	(void)in;
+	return gs1_encoder_getSerialisedMessage(ctx, serialised, sizeof(serialised)) > 0;
+}
+
+static bool op_setSerialisedMessage(gs1_encoder *ctx, const char *in) {
+	(void)in;
+	return gs1_encoder_setSerialisedMessage(ctx, serialised, serialisedLen);
+}
+
+static bool op_getMessageFingerprint(gs1_encoder *ctx, const char *in) {
+	uint64_t fingerprint[2];
+	(void)in;
+	return gs1_encoder_getMessageFingerprint(ctx, fingerprint);
+}
+
+static bool op_getDLuri(gs1_encoder *ctx, const char *in) {
+	(void)in;
+	return gs1_encoder_getDLuri(ctx, NULL) != NULL;
+}
+
+static bool op_getHRI(gs1_encoder *ctx, const char *in) {
+	char **hri;
+	(void)in;
+	return gs1_encoder_getHRI(ctx, &hri) > 0;
+}
+
+static bool op_getAIdataStr(gs1_encoder *ctx, const char *in) {
+	(void)in;
+	return gs1_encoder_getAIdataStr(ctx) != NULL;
+}
+
+static bool op_getScanData(gs1_encoder *ctx, const char *in) {
+	(void)in;
+	return gs1_encoder_getScanData(ctx) != NULL;
+}
+
+
+typedef struct {
+	const char *name;
+	const char **corpus;
+	bool (*prep)(gs1_encoder*, const char*);	// Untimed, loads the message
+	bool (*op)(gs1_encoder*, const char*);
+	bool isMessage;					// Corpus counts towards throughput
+} benchCase;
+
+static const benchCase cases[] = {
+	{ "init_ex",					corpusInit,			NULL,			op_init,			false	},
+	{ "init_ex (syntax dictionary)",		corpusInitSyntaxDictionary,	NULL,			op_initSyntaxDictionary,	false	},
+	{ "clone",					corpusInit,			NULL,			op_clone,			false	},
+	{ "reset",					corpusInit,			NULL,			op_reset,			false	},
+	{ "setAIdataStr",				corpusAIdata,			NULL,			op_setAIdataStr,		true	},
+	{ "setDataStr (plain)",				corpusPlain,			NULL,			op_setDataStr,			true	},
+	{ "setDataStr (element string)",		corpusElementString,		NULL,			op_setDataStr,			true	},
+	{ "setDataStr (DL URI)",			corpusDLuri,			NULL,			op_setDataStr,			true	},
+	{ "setScanData",				corpusScanData,			NULL,			op_setScanData,			true	},
+	{ "setScanData (plain)",			corpusScanDataPlain,		NULL,			op_setScanData,			true	},
+	{ "feedScanStream",				corpusScanData,			NULL,			op_feedScanStream,		true	},
+	{ "labelAddScanData (repeated read)",		corpusScanData,			op_labelBegin,		op_labelAddScanData,		true	},
+	{ "getDLuri",					corpusDLuri,			op_setDataStr,		op_getDLuri,			true	},
+	{ "getHRI",					corpusAIdata,			op_setAIdataStr,	op_getHRI,			true	},
+	{ "getAIdataStr",				corpusElementString,		op_setDataStr,		op_getAIdataStr,		true	},
+	{ "getSerialisedMessage",			corpusAIdata,			op_setAIdataStr,	op_getSerialisedMessage,	true	},
+	{ "setSerialisedMessage (trusted)",		corpusAIdata,			op_serialise,		op_setSerialisedMessage,	true	},
+	{ "getMessageFingerprint",			corpusDLuri,			op_setDataStr,		op_getMessageFingerprint,	true	},
+	{ "getScanData",				corpusScanData,			op_setScanData,		op_getScanData,			true	},
+	{ "getScanData (plain)",			corpusScanDataPlain,		op_setScanData,		op_getScanData,			true	},
+};
+
+static uint64_t heapAllocations(void) {
+	gs1_encoder_heap_profile_t profile;
+	return gs1_encoder_getHeapProfile(&profile) ? profile.total.allocations : 0;
+}
+
+
+typedef struct {
+	unsigned long iterations;
+	double nsPerOp;
+	double opsPerSec;
+	double mbPerSec;
+	double allocsPerOp;
+} benchResult;
+
+
+static const char* dup(const char *s) {
+	char *d = malloc(strlen(s) + 1);
+	if (!d) {
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+	strcpy(d, s);
+	return d;
+}
+
+
+/*
+ *  Derive the element string, GS1 Digital Link URI and scan data corpora
+ *  from the AI data corpus. The scan data is generated for a rotating
+ *  selection of symbologies.
+ *
+ */
+static bool deriveCorpora(gs1_encoder *ctx) {
+
+	size_t i, n = 0, d = 0;
+	const char *out;
+
+	for (i = 0; i < MAX_CORPUS && corpusAIdata[i]; i++) {
+
+		if (!gs1_encoder_setSym(ctx, scanDataSyms[i % (sizeof(scanDataSyms) / sizeof(scanDataSyms[0]))]) ||
+		    !gs1_encoder_setAIdataStr(ctx, corpusAIdata[i])) {
+			fprintf(stderr, "Corpus AI data rejected: %s: %s\n", corpusAIdata[i], gs1_encoder_getErrMsg(ctx));
+			return false;
+		}
+
+		corpusElementString[n] = dup(gs1_encoder_getDataStr(ctx));
+
+		if ((out = gs1_encoder_getScanData(ctx)) == NULL) {
+			fprintf(stderr, "Failed to generate scan data: %s: %s\n", corpusAIdata[i], gs1_encoder_getErrMsg(ctx));
+			return false;
+		}
+		corpusScanData[n++] = dup(out);
+
+		// Not every message has a GS1 Digital Link URI representation
+		if ((out = gs1_encoder_getDLuri(ctx, NULL)) != NULL)
+			corpusDLuri[d++] = dup(out);
+
+	}
+	corpusElementString[n] = NULL;
+	corpusScanData[n] = NULL;
+	corpusDLuri[d] = NULL;
+
+	gs1_encoder_setSym(ctx, gs1_encoder_sNONE);
+
+	return n > 0 && d > 0;
+
+}
+
+
+static bool runCase(const benchCase *bc, gs1_encoder *ctx, uint64_t minNs, benchResult *res) {
+
+	unsigned long reps = 1, r, ops;
+	uint64_t elapsed, t0, bytes;
+	uint64_t allocs;
+	size_t i;
+
+	for (;;) {
+
+		elapsed = 0;
+		bytes = 0;
+		ops = 0;
+		allocs = 0;
+
+		for (i = 0; bc->corpus[i]; i++) {
+			uint64_t a0;
+			size_t len = strlen(bc->corpus[i]);
+
+			if (bc->prep && !bc->prep(ctx, bc->corpus[i])) {
+				fprintf(stderr, "%s: preparation failed for \"%s\": %s\n", bc->name, bc->corpus[i], gs1_encoder_getErrMsg(ctx));
+				return false;
+			}
+
+			a0 = heapAllocations();
+			t0 = bench_now_ns();
+			for (r = 0; r < reps; r++) {
+				if (!bc->op(ctx, bc->corpus[i])) {
+					fprintf(stderr, "%s: failed for \"%s\": %s\n", bc->name, bc->corpus[i], gs1_encoder_getErrMsg(ctx));
+					return false;
+				}
+			}
+			elapsed += bench_now_ns() - t0;
+			allocs += heapAllocations() - a0;
+
+			ops += reps;
+			if (bc->isMessage)
+				bytes += (uint64_t)len * reps;
+		}
+
+		if (elapsed >= minNs || reps > (unsigned long)-1 / 2)
+			break;
+
+		reps *= 2;
+
+	}
+
+	if (elapsed == 0)
+		elapsed = 1;
+
+	res->iterations = ops;
+	res->nsPerOp = (double)elapsed / (double)ops;
+	res->opsPerSec = (double)ops * 1e9 / (double)elapsed;
+	res->mbPerSec = (double)bytes * 1e3 / (double)elapsed;
+	res->allocsPerOp = (double)allocs / (double)ops;
+
+	return true;
+
+}
+
+
+/*
+ *  Report the heap retained by a context, by subsystem.
+ *
+ */
+static void reportContextHeap(const char *label, const char *syntaxDictionary) {
+
+	gs1_encoder *c;
+	gs1_encoder_heap_profile_t before, after;
+	gs1_encoder_init_opts_t opts = {
+		.struct_size		= sizeof(gs1_encoder_init_opts_t),
+		.syntaxDictionary	= syntaxDictionary,
+	};
+
+	if (!gs1_encoder_getHeapProfile(&before) || (c = gs1_encoder_init_ex(NULL, &opts)) == NULL)
+		return;
+	gs1_encoder_getHeapProfile(&after);
+	gs1_encoder_free(c);
+
+#define LIVE(s) (unsigned long)(after.subsystems[s].liveBytes - before.subsystems[s].liveBytes)
+	printf("%-32s %12lu %14lu %14lu\n", label,
+		LIVE(gs1_encoder_hCONTEXT), LIVE(gs1_encoder_hSYNTAX_DICTIONARY), LIVE(gs1_encoder_hDL_KEY_QUALIFIERS));
+#undef LIVE
+
+}
+
+
+static void writeJSON(FILE *f, unsigned long minTimeMs, const benchResult *results, const bool *ran) {
+
+	size_t i;
+	bool first = true;
+
+	fprintf(f, "{\n");
+	fprintf(f, "  \"version\": \"%s\",\n", gs1_encoder_getVersion());
+	fprintf(f, "  \"min_time_ms\": %lu,\n", minTimeMs);
+	fprintf(f, "  \"results\": [\n");
+	for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+		if (!ran[i])
+			continue;
+		fprintf(f, "%s    { \"name\": \"%s\", \"iterations\": %lu, \"ns_per_op\": %.1f, \"ops_per_sec\": %.0f, \"mb_per_sec\": %.2f, \"allocs_per_op\": %.3f }",
+			first ? "" : ",\n", cases[i].name, results[i].iterations, results[i].nsPerOp,
+			results[i].opsPerSec, results[i].mbPerSec, results[i].allocsPerOp);
+		first = false;
+	}
+	fprintf(f, "\n  ]\n}\n");
+
+}
+
+
+int main(int argc, char *argv[]) {
+
+	gs1_encoder *ctx;
+	benchResult results[sizeof(cases) / sizeof(cases[0])];
+	bool ran[sizeof(cases) / sizeof(cases[0])] = { false };
+	unsigned long minTimeMs = DEFAULT_MIN_TIME_MS;
+	const char *jsonFile = NULL;
+	const char *filter = NULL;
+	bool allocating = false;
+	FILE *f;
+	size_t i;
+	int a;
+
+	for (a = 1; a < argc; a++) {
+		if (strcmp(argv[a], "-t") == 0 && a + 1 < argc)
+			minTimeMs = strtoul(argv[++a], NULL, 10);
+		else if (strcmp(argv[a], "-j") == 0 && a + 1 < argc)
+			jsonFile = argv[++a];
+		else if (argv[a][0] != '-' && !filter)
+			filter = argv[a];
+		else {
+			fprintf(stderr, "Usage: %s [-t <min ms per case>] [-j <json file>] [<filter>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if ((ctx = gs1_encoder_init_ex(NULL, NULL)) == NULL) {
+		fprintf(stderr, "Failed to initialise the GS1 Barcode Syntax Engine\n");
+		return 1;
+	}
+
+	if (!deriveCorpora(ctx))
+		return 1;
+
+	printf("%-32s %12s %14s %10s %10s\n", "case", "ns/op", "ops/s", "MB/s", "allocs/op");
+
+	for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+
+		if (filter && !strstr(cases[i].name, filter))
+			continue;
+
+		if (cases[i].corpus == corpusInitSyntaxDictionary) {
+			FILE *sd = fopen(SYNTAX_DICTIONARY, "r");
+			if (!sd) {
+				printf("%-32s (skipped: %s not found)\n", cases[i].name, SYNTAX_DICTIONARY);
+				continue;
+			}
+			fclose(sd);
+		}
+
+		if (!runCase(&cases[i], ctx, (uint64_t)minTimeMs * 1000000u, &results[i]))
+			return 1;
+		ran[i] = true;
+
+		printf("%-32s %12.1f %14.0f %10.2f %10.3f\n", cases[i].name,
+			results[i].nsPerOp, results[i].opsPerSec, results[i].mbPerSec, results[i].allocsPerOp);
+		fflush(stdout);
+
+		if (cases[i].isMessage && results[i].allocsPerOp > 0)
+			allocating = true;
+
+	}
+
+	gs1_encoder_free(ctx);
+
+	printf("\n%-32s %12s %14s %14s\n", "heap retained (bytes)", "context", "syntax dict", "DL key quals");
+	reportContextHeap("init_ex", NULL);
+	reportContextHeap("init_ex (syntax dictionary)", SYNTAX_DICTIONARY);
+
+	if (jsonFile) {
+		if ((f = fopen(jsonFile, "w")) == NULL) {
+			fprintf(stderr, "Failed to open %s for writing\n", jsonFile);
+			return 1;
+		}
+		writeJSON(f, minTimeMs, results, ran);
+		fclose(f);
+		printf("\nJSON results written to %s\n", jsonFile);
+	}
+
+	if (allocating) {
+		fprintf(stderr, "\nProcessing a message made heap allocations\n");
+		return 1;
+	}
+
+	return 0;
+
+}
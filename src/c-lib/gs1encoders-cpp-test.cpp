@@ -19,8 +19,11 @@
  */
 
 #include <cstdio>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 
 /*
@@ -106,6 +109,41 @@ static void test_move_assignment(void) {
 }
 
 
+/* ========================================================================
+ *  Clone and reset
+ * ======================================================================== */
+
+static void test_clone_copies_options_not_message(void) {
+	std::optional<gs1encoders::GS1Encoder> a(std::in_place);
+	a->set_sym(gs1encoders::Symbology::QR);
+	a->set_permit_unknown_ais(true);
+	a->set_validation_enabled(gs1encoders::Validation::RequisiteAIs, false);
+	a->set_ai_data_str("(01)09521234543213");
+
+	gs1encoders::GS1Encoder b = a->clone();
+	TEST_CHECK(b.sym() == gs1encoders::Symbology::QR);
+	TEST_CHECK(b.permit_unknown_ais());
+	TEST_CHECK(!b.validation_enabled(gs1encoders::Validation::RequisiteAIs));
+	TEST_CHECK(b.data_str().empty());
+
+	// The shared tables outlive the original
+	a.reset();
+	b.set_ai_data_str("(01)09521234543213(10)ABC");
+	TEST_CHECK(b.ai_data_str() == "(01)09521234543213(10)ABC");
+}
+
+static void test_reset_restores_defaults(void) {
+	gs1encoders::GS1Encoder gs;
+	gs.set_sym(gs1encoders::Symbology::QR);
+	gs.set_add_check_digit(true);
+	gs.set_ai_data_str("(01)09521234543213");
+	gs.reset();
+	TEST_CHECK(gs.sym() == gs1encoders::Symbology::None);
+	TEST_CHECK(!gs.add_check_digit());
+	TEST_CHECK(gs.data_str().empty());
+}
+
+
 /* ========================================================================
  *  Library accessors
  * ======================================================================== */
@@ -308,6 +346,297 @@ static void test_scan_data_no_sym_throws(void) {
 }
 
 
+/* ========================================================================
+ *  Views
+ * ======================================================================== */
+
+static void test_set_from_string_view(void) {
+	gs1encoders::GS1Encoder gs;
+	std::string_view in = "(01)09521234543213(99)TESTING123XXX";
+	gs.set_ai_data_str(in.substr(0, in.size() - 3));
+	TEST_CHECK(gs.data_str_view() == "^010952123454321399TESTING123");
+	gs.set_scan_data(std::string_view("]Q1TESTINGXXX", 10));
+	TEST_CHECK(gs.data_str_view() == "TESTING");
+}
+
+static void test_set_embedded_nul_throws(void) {
+	gs1encoders::GS1Encoder gs;
+	bool threw = false;
+	try {
+		gs.set_data_str(std::string_view("^0109521234543213\0X", 19));
+	} catch (const gs1encoders::GS1EncoderParameterException &e) {
+		TEST_CHECK(std::string(e.what()).length() > 0);
+		threw = true;
+	}
+	TEST_CHECK(threw);
+}
+
+static void test_views(void) {
+	gs1encoders::GS1Encoder gs;
+	TEST_CHECK(gs.data_str_view().empty());
+	TEST_CHECK(gs.ai_data_str_view().empty());
+	gs.set_sym(gs1encoders::Symbology::QR);
+	gs.set_ai_data_str("(01)09521234543213(99)TESTING123");
+	TEST_CHECK(gs.data_str_view() == "^010952123454321399TESTING123");
+	TEST_CHECK(gs.ai_data_str_view() == "(01)09521234543213(99)TESTING123");
+	TEST_CHECK(gs.scan_data_view() == "]Q3010952123454321399TESTING123");
+	TEST_CHECK(gs.dl_uri_view() ==
+	           "https://id.gs1.org/01/09521234543213?99=TESTING123");
+	TEST_CHECK(gs.dl_uri_view(std::string_view("https://example.comXXX", 19)) ==
+	           "https://example.com/01/09521234543213?99=TESTING123");
+	std::string longStem = "https://example.com/" + std::string(300, 'a');
+	TEST_CHECK(gs.dl_uri_view(longStem) ==
+	           longStem + "/01/09521234543213?99=TESTING123");
+	auto lines = gs.hri_view();
+	TEST_CHECK(lines.size() == 2);
+	TEST_CHECK(lines[0] == "(01) 09521234543213");
+	std::string joined;
+	for (std::string_view line : lines)
+		joined.append(line).append("|");
+	TEST_CHECK(joined == "(01) 09521234543213|(99) TESTING123|");
+}
+
+static void test_dl_ignored_query_params_view(void) {
+	gs1encoders::GS1Encoder gs;
+	gs.set_data_str("https://a/01/09521234543213?singleton&99=ABC&compound=X");
+	auto qp = gs.dl_ignored_query_params_view();
+	TEST_CHECK(qp.size() == 2);
+	TEST_CHECK(qp[0] == "singleton");
+	TEST_CHECK(qp[1] == "compound=X");
+}
+
+static void test_ai_elements(void) {
+	gs1encoders::GS1Encoder gs;
+	TEST_CHECK(gs.ai_elements().empty());
+	gs.set_ai_data_str("(01)09521234543213(3103)000189|(99)TESTING123");
+	auto elements = gs.ai_elements();
+	gs.hri_view();		// Renders into the output buffer
+	TEST_CHECK(elements.size() == 3);
+	std::string joined;
+	for (const gs1encoders::AIElement &e : elements)
+		joined.append(e.ai).append("=").append(e.value).append(";");
+	TEST_CHECK(joined == "01=09521234543213;3103=000189;99=TESTING123;");
+	TEST_MSG("Got: %s", joined.c_str());
+}
+
+static void test_set_from_own_view(void) {
+	gs1encoders::GS1Encoder gs;
+	gs.set_ai_data_str("(01)09521234543213(99)TESTING123");
+	gs.set_ai_data_str(gs.ai_data_str_view().substr(0, 18));
+	TEST_CHECK(gs.data_str_view() == "^0109521234543213");
+	gs.set_data_str(gs.data_str_view().substr(1));
+	TEST_CHECK(gs.data_str_view() == "0109521234543213");
+}
+
+
+#ifdef GS1_ENCODERS_HAVE_PMR
+
+/* ========================================================================
+ *  Polymorphic allocators
+ * ======================================================================== */
+
+/*
+ *  Forwards to the default resource, keeping count of the outstanding
+ *  allocations.
+ *
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+	size_t outstanding = 0;
+	size_t bytes = 0;
+private:
+	void *do_allocate(size_t n, size_t align) override {
+		outstanding++;
+		bytes += n;
+		return std::pmr::new_delete_resource()->allocate(n, align);
+	}
+	void do_deallocate(void *p, size_t n, size_t align) override {
+		outstanding--;
+		bytes -= n;
+		std::pmr::new_delete_resource()->deallocate(p, n, align);
+	}
+	bool do_is_equal(const std::pmr::memory_resource &o) const noexcept override {
+		return this == &o;
+	}
+};
+
+static void test_pmr_context_placement(void) {
+	CountingResource mr;
+	{
+		gs1encoders::GS1Encoder gs(
+			gs1encoders::InitOpts{}.memory_resource(&mr));
+		TEST_CHECK(mr.outstanding == 1);
+		TEST_CHECK(mr.bytes == gs1_encoder_instanceSize());
+		gs.set_ai_data_str("(01)09521234543213(99)TESTING123");
+		TEST_CHECK(gs.ai_data_str() == "(01)09521234543213(99)TESTING123");
+
+		gs1encoders::GS1Encoder moved(std::move(gs));
+		TEST_CHECK(moved.ai_data_str() == "(01)09521234543213(99)TESTING123");
+		TEST_CHECK(mr.outstanding == 1);
+	}
+	TEST_CHECK(mr.outstanding == 0);
+}
+
+static void test_pmr_context_released_on_init_failure(void) {
+	CountingResource mr;
+	bool threw = false;
+	try {
+		gs1encoders::GS1Encoder gs(
+			gs1encoders::InitOpts{}
+				.syntax_dictionary("/nonexistent/path/dict.txt")
+				.memory_resource(&mr));
+	} catch (const gs1encoders::GS1EncoderGeneralException &) {
+		threw = true;
+	}
+	TEST_CHECK(threw);
+	TEST_CHECK(mr.outstanding == 0);
+}
+
+static void test_pmr_outputs(void) {
+	CountingResource upstream;
+	{
+		std::pmr::monotonic_buffer_resource arena(&upstream);
+		gs1encoders::GS1Encoder gs(
+			gs1encoders::InitOpts{}.memory_resource(&arena));
+		gs.set_sym(gs1encoders::Symbology::QR);
+		gs.set_ai_data_str("(01)09521234543213(99)TESTING123");
+
+		std::pmr::string uri = gs.get_dl_uri("https://example.com", &arena);
+		TEST_CHECK(uri == "https://example.com/01/09521234543213?99=TESTING123");
+		TEST_CHECK(uri.get_allocator().resource() == &arena);
+
+		std::pmr::string scan = gs.scan_data(&arena);
+		TEST_CHECK(scan == "]Q3010952123454321399TESTING123");
+		TEST_CHECK(gs.data_str(&arena) == "^010952123454321399TESTING123");
+		TEST_CHECK(gs.ai_data_str(&arena) == "(01)09521234543213(99)TESTING123");
+		TEST_CHECK(gs.err_markup(&arena).empty());
+
+		std::pmr::vector<std::pmr::string> lines = gs.hri(&arena);
+		TEST_CHECK(lines.size() == 2);
+		TEST_CHECK(lines[1] == "(99) TESTING123");
+		TEST_CHECK(lines.get_allocator().resource() == &arena);
+		TEST_CHECK(lines[1].get_allocator().resource() == &arena);
+
+		gs.set_data_str("https://a/01/09521234543213?singleton&99=ABC");
+		std::pmr::vector<std::pmr::string> qp = gs.dl_ignored_query_params(&arena);
+		TEST_CHECK(qp.size() == 1 && qp[0] == "singleton");
+
+		TEST_CHECK(upstream.outstanding > 0);
+	}
+	TEST_CHECK(upstream.outstanding == 0);
+}
+
+#endif
+
+
+#ifdef GS1_ENCODERS_HAVE_AI_LITERALS
+
+/* ========================================================================
+ *  Compile-time AI data literals
+ * ======================================================================== */
+
+static constexpr auto LIT_SIMPLE = gs1encoders::ai_data_literal(
+	"(01)09521234543213(10)ABC123(3103)000189(21)XYZ");
+static_assert(LIT_SIMPLE.str() == "^010952123454321310ABC123^310300018921XYZ",
+              "FNC1 follows only variable-length AIs");
+
+static constexpr auto LIT_COMPOSITE = gs1encoders::ai_data_literal(
+	"(01)09521234543213|(99)A\\(B");
+static_assert(LIT_COMPOSITE.str() == "^0109521234543213|^99A(B",
+              "Composite separator and escaped bracket");
+
+/*
+ *  Whether a literal converts at compile time; an invalid literal is not a
+ *  constant expression, which makes the specialisation a substitution failure.
+ *
+ */
+template <const auto &S, typename = void>
+struct is_constant_ai_literal : std::false_type {};
+
+template <const auto &S>
+struct is_constant_ai_literal<S, std::void_t<std::integral_constant<size_t,
+	gs1encoders::ai_data_literal(S).size()>>> : std::true_type {};
+
+static constexpr char LIT_ONE_SEPARATOR[] = "(01)09521234543213|(99)X";
+static constexpr char LIT_DOUBLED_SEPARATOR[] = "(01)09521234543213||(99)X";
+static constexpr char LIT_SECOND_SEPARATOR[] = "(01)09521234543213|(99)X|(98)Y";
+static constexpr char LIT_TRAILING_SEPARATOR[] = "(01)09521234543213|";
+static_assert(is_constant_ai_literal<LIT_ONE_SEPARATOR>::value,
+              "A single composite separator is accepted");
+static_assert(!is_constant_ai_literal<LIT_DOUBLED_SEPARATOR>::value,
+              "A doubled composite separator fails the build");
+static_assert(!is_constant_ai_literal<LIT_SECOND_SEPARATOR>::value,
+              "A second composite separator fails the build");
+static_assert(!is_constant_ai_literal<LIT_TRAILING_SEPARATOR>::value,
+              "An empty composite component fails the build");
+
+static void test_ai_literal_matches_runtime(void) {
+	gs1encoders::GS1Encoder gs;
+	static constexpr auto LIT_MULTIPART = gs1encoders::ai_data_literal(
+		"(01)09521234543213(8001)12345678901291(253)9521234543213XYZ");
+	const std::pair<std::string_view, std::string_view> cases[] = {
+		{ "(01)09521234543213(10)ABC123(3103)000189(21)XYZ", LIT_SIMPLE },
+		{ "(01)09521234543213|(99)A\\(B", LIT_COMPOSITE },
+		{ "(01)09521234543213(8001)12345678901291(253)9521234543213XYZ", LIT_MULTIPART },
+	};
+	for (const auto &c : cases) {
+		gs.set_ai_data_str(c.first);
+		TEST_CHECK(gs.data_str_view() == c.second);
+		TEST_MSG("Input: %.*s", (int)c.first.size(), c.first.data());
+	}
+	gs.set_data_str(LIT_SIMPLE);
+	TEST_CHECK(gs.ai_data_str() == "(01)09521234543213(10)ABC123(3103)000189(21)XYZ");
+	TEST_CHECK(std::string(LIT_SIMPLE.c_str()) == LIT_SIMPLE.str());
+}
+
+static void test_ai_literal_composite_separator_errors(void) {
+	const std::pair<std::string_view, std::string_view> cases[] = {
+		{ LIT_DOUBLED_SEPARATOR, "AI data contains more than one composite separator" },
+		{ LIT_SECOND_SEPARATOR, "AI data contains more than one composite separator" },
+		{ LIT_TRAILING_SEPARATOR, "AI data has an empty composite component" },
+	};
+	for (const auto &c : cases) {
+		std::string err;
+		try {
+			char buf[64] = { 0 };
+			(void)gs1encoders::detail::parse_ai_literal(c.first, buf);
+		} catch (const gs1encoders::GS1EncoderParameterException &e) {
+			err = e.what();
+		}
+		TEST_CHECK(err == c.second);
+		TEST_MSG("Input: %.*s; Got: %s", (int)c.first.size(), c.first.data(), err.c_str());
+	}
+}
+
+#ifndef __cpp_consteval
+static void test_ai_literal_invalid_throws_at_runtime(void) {
+	const char *bad[] = {
+		"(01)09521234543214",		// Check digit
+		"(01)0952123454321",		// Too short
+		"(10)AB C",			// CSET 82
+		"(9999)X",			// Unknown AI
+		"(10)",				// Empty value
+		"10ABC",			// Not bracketed
+	};
+	for (const char *b : bad) {
+		bool threw = false;
+		try {
+			char buf[32] = { 0 };
+			std::string_view(b).copy(buf, sizeof(buf) - 1);
+			(void)gs1encoders::ai_data_literal(buf);
+		} catch (const gs1encoders::GS1EncoderParameterException &e) {
+			TEST_CHECK(std::string(e.what()).length() > 0);
+			threw = true;
+		}
+		TEST_CHECK(threw);
+		TEST_MSG("Input: %s", b);
+	}
+}
+#endif
+
+#endif
+
+
 /* ========================================================================
  *  Test list
  * ======================================================================== */
@@ -324,6 +653,8 @@ TEST_LIST = {
 	/* Move semantics */
 	{ "move_constructor",                   test_move_constructor },
 	{ "move_assignment",                    test_move_assignment },
+	{ "clone_copies_options_not_message",   test_clone_copies_options_not_message },
+	{ "reset_restores_defaults",            test_reset_restores_defaults },
 
 	/* Library accessors */
 	{ "version_nonempty",                   test_version_nonempty },
@@ -362,5 +693,32 @@ TEST_LIST = {
 	{ "scan_data",                          test_scan_data },
 	{ "scan_data_no_sym_throws",            test_scan_data_no_sym_throws },
 
+	/* Views */
+	{ "set_from_string_view",               test_set_from_string_view },
+	{ "set_embedded_nul_throws",            test_set_embedded_nul_throws },
+	{ "views",                              test_views },
+	{ "dl_ignored_query_params_view",       test_dl_ignored_query_params_view },
+	{ "ai_elements",                        test_ai_elements },
+	{ "set_from_own_view",                  test_set_from_own_view },
+
+#ifdef GS1_ENCODERS_HAVE_PMR
+	/* Polymorphic allocators */
+	{ "pmr_context_placement",              test_pmr_context_placement },
+	{ "pmr_context_released_on_init_failure",
+	                                        test_pmr_context_released_on_init_failure },
+	{ "pmr_outputs",                        test_pmr_outputs },
+#endif
+
+#ifdef GS1_ENCODERS_HAVE_AI_LITERALS
+	/* Compile-time AI data literals */
+	{ "ai_literal_matches_runtime",         test_ai_literal_matches_runtime },
+	{ "ai_literal_composite_separator_errors",
+	                                        test_ai_literal_composite_separator_errors },
+#ifndef __cpp_consteval
+	{ "ai_literal_invalid_throws_at_runtime",
+	                                        test_ai_literal_invalid_throws_at_runtime },
+#endif
+#endif
+
 	{ NULL, NULL }
 };
@@ -63,6 +63,8 @@ TEST_LIST = {
     { "api_init_opts_layout", test_api_init_opts_layout },
     { "api_init_enum_values", test_api_init_enum_values },
     { "api_defaults", test_api_defaults },
+    { "api_clone", test_api_clone },
+    { "api_reset", test_api_reset },
     { "api_sym", test_api_sym },
     { "api_addCheckDigit", test_api_addCheckDigit },
     { "api_permitUnknownAIs", test_api_permitUnknownAIs },
@@ -74,14 +76,25 @@ TEST_LIST = {
     { "api_getAIdataStr", test_api_getAIdataStr },
     { "api_getScanData", test_api_getScanData },
     { "api_setScanData", test_api_setScanData },
+    { "api_setters_lengthDelimited", test_api_setters_lengthDelimited },
     { "api_getHRI", test_api_getHRI },
     { "api_copyHRI", test_api_copyHRI },
     { "api_getDLignoredQueryParams", test_api_getDLignoredQueryParams },
     { "api_copyDLignoredQueryParams", test_api_copyDLignoredQueryParams },
+    { "api_getAIelements", test_api_getAIelements },
+    { "api_label", test_api_label },
+    { "api_scanStream", test_api_scanStream },
+    { "api_render", test_api_render },
+    { "api_serialisedMessage", test_api_serialisedMessage },
+    { "api_messageFingerprint", test_api_messageFingerprint },
     { "api_allocFailures", test_api_allocFailures },
 #ifndef EXCLUDE_SYNTAX_DICTIONARY_LOADER
     { "api_brokenPrefixSyndict", test_api_brokenPrefixSyndict },
     { "api_tooManyDLkeyQualifiersSyndict", test_api_tooManyDLkeyQualifiersSyndict },
+    { "api_customLinters", test_api_customLinters },
+    { "api_stats", test_api_stats },
+    { "api_heapProfile", test_api_heapProfile },
+    { "api_processBatch", test_api_processBatch },
 #endif
 
 
@@ -139,6 +152,7 @@ TEST_LIST = {
      */
     { "scandata_validateParity", test_scandata_validateParity },
     { "scandata_generateScanData", test_scandata_generateScanData },
+    { "scandata_symIdTables", test_scandata_symIdTables },
     { "scandata_processScanData", test_scandata_processScanData },
 
     { NULL, NULL }
@@ -18,6 +18,8 @@
  *
  */
 
+#define GS1_ENCODERS_HEAP_SUBSYSTEM gs1_encoder_hCONTEXT	// For profile-heap.h
+
 #include <assert.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -65,6 +67,8 @@ gs1_encoder* gs1_encoder_init_ex(void *mem, const gs1_encoder_init_opts_t *opts)
 	char *msgBuf				= NULL;
 	size_t msgBufSize			= 0;
 	const char *syntaxDictionary		= NULL;
+	const struct gs1_encoder_linter *linters = NULL;
+	size_t numLinters			= 0;
 
 	bool fallbackOnError;
 #ifndef EXCLUDE_EMBEDDED_AI_TABLE
@@ -85,6 +89,8 @@ gs1_encoder* gs1_encoder_init_ex(void *mem, const gs1_encoder_init_opts_t *opts)
 	EXTRACT_OPT(msgBuf);
 	EXTRACT_OPT(msgBufSize);
 	EXTRACT_OPT(syntaxDictionary);
+	EXTRACT_OPT(linters);
+	EXTRACT_OPT(numLinters);
 
 #undef EXTRACT_OPT
 
@@ -127,8 +133,11 @@ gs1_encoder* gs1_encoder_init_ex(void *mem, const gs1_encoder_init_opts_t *opts)
 		.aiTable = NULL,
 		.aiTableEntries = 0,
 		.aiTableIsDynamic = false,
+		.linters = NULL,
+		.numLinters = 0,
 		.dlKeyQualifiers = NULL,
 		.numDLkeyQualifiers = 0,
+		.sharedTablesRefs = NULL,
 		.numAIs = 0,
 		.numSortedAIs = 0,
 		.dataStr = { 0 },
@@ -139,12 +148,20 @@ gs1_encoder* gs1_encoder_init_ex(void *mem, const gs1_encoder_init_opts_t *opts)
 
 	GS1_ENCODERS_POISON_GUARDS(GS1_ENCODER_GUARDS, ctx);
 
+	if (!mem)
+		STATS_ALLOC();
+
 	if (status) *status = GS1_ENCODERS_INIT_SUCCESS;
 	if (msgBuf && msgBufSize > 0)
 		msgBuf[0] = '\0';
 
 #ifndef EXCLUDE_SYNTAX_DICTIONARY_LOADER
 	if (syntaxDictionary) {
+		// Linter names are resolved to functions during loading, and
+		// identify them in the fingerprint of the AI table, so the
+		// caller's array is held only until the table is set
+		ctx->linters = linters;
+		ctx->numLinters = linters ? numLinters : 0;
 		sd = gs1_loadSyntaxDictionary(ctx, syntaxDictionary);
 		if (!sd) {
 			if (!fallbackOnError)
@@ -157,6 +174,8 @@ gs1_encoder* gs1_encoder_init_ex(void *mem, const gs1_encoder_init_opts_t *opts)
 #else
 	(void)syntaxDictionary;
 	(void)fallbackOnError;
+	(void)linters;
+	(void)numLinters;
 #endif
 
 	if (!sd) {
@@ -198,8 +217,20 @@ gs1_encoder* gs1_encoder_init_ex(void *mem, const gs1_encoder_init_opts_t *opts)
 		RETURN_FAIL(localStatus, ctx->errMsg);
 
 	}
+	ctx->linters = NULL;
+	ctx->numLinters = 0;
 	gs1_loadValidationTable(ctx);
 
+	// Created here so that cloning only reads the original
+	ctx->sharedTablesRefs = GS1_ENCODERS_MALLOC(sizeof(gs1_refcount_t));
+	if (unlikely(!ctx->sharedTablesRefs)) {
+		gs1_encoder_free(ctx);
+		ctx = NULL;			// Released along with the tables
+		RETURN_FAIL(GS1_ENCODERS_INIT_FAILED_NO_MEM, "Failed to allocate memory for encoder context");
+	}
+	STATS_ALLOC();
+	*ctx->sharedTablesRefs = 1;
+
 	return ctx;
 
 #undef RETURN_FAIL
@@ -225,18 +256,120 @@ gs1_encoder* gs1_encoder_init(void* const mem) {
 }
 
 
+static void clear_message(gs1_encoder* const ctx) {
+	assert(ctx);
+	*ctx->dataStr = '\0';
+	*ctx->dlAIbuffer = '\0';
+	ctx->numAIs = 0;
+	ctx->numSortedAIs = 0;
+	ctx->labelLen = 0;			// And any label being assembled
+	ctx->numLabelAIs = 0;
+	gs1_resetScanStream(ctx);		// Or symbol being received
+}
+
+
+gs1_encoder* gs1_encoder_clone(const gs1_encoder* const ctx, void *mem) {
+
+	gs1_encoder *clone = NULL;
+
+	/*
+	 *  The original is only read, other than for the atomic update of the
+	 *  reference count, so may be cloned concurrently.
+	 *
+	 */
+	assert(ctx);
+	assert(ctx->sharedTablesRefs);
+
+	if (!mem) {
+#ifndef NOMALLOC
+		clone = GS1_ENCODERS_MALLOC(sizeof(gs1_encoder));
+#endif
+		if (unlikely(!clone))
+			return NULL;
+	} else {
+		clone = mem;
+	}
+
+	GS1_ENCODERS_UNPOISON_GUARDS(GS1_ENCODER_GUARDS, clone);
+
+	clone->localAlloc = !mem;
+	clone->outfp = NULL;
+
+	clone->sym = ctx->sym;
+	clone->addCheckDigit = ctx->addCheckDigit;
+	clone->permitUnknownAIs = ctx->permitUnknownAIs;
+	clone->permitZeroSuppressedGTINinDLuris = ctx->permitZeroSuppressedGTINinDLuris;
+	clone->permitConvenienceAlphas = ctx->permitConvenienceAlphas;
+	clone->includeDataTitlesInHRI = ctx->includeDataTitlesInHRI;
+	memcpy(clone->validationTable, ctx->validationTable, sizeof(ctx->validationTable));
+
+	clone->aiTable = ctx->aiTable;
+	clone->aiTableEntries = ctx->aiTableEntries;
+	clone->aiTableIsDynamic = ctx->aiTableIsDynamic;
+	clone->aiTableFingerprint = ctx->aiTableFingerprint;
+	memcpy(clone->aiLengthByPrefix, ctx->aiLengthByPrefix, sizeof(ctx->aiLengthByPrefix));
+	clone->linters = NULL;
+	clone->numLinters = 0;
+	clone->dlKeyQualifiers = ctx->dlKeyQualifiers;
+	clone->numDLkeyQualifiers = ctx->numDLkeyQualifiers;
+	clone->sharedTablesRefs = ctx->sharedTablesRefs;
+
+	clear_message(clone);
+	reset_error(clone);
+
+#ifdef GS1_ENCODERS_STATS
+	memset(&clone->stats, 0, sizeof(clone->stats));
+	clone->stats.allocations = mem ? 0 : 1;		// As counted by init_ex
+	memset(clone->statsLinterFns, 0, sizeof(clone->statsLinterFns));
+	memset(clone->statsStart, 0, sizeof(clone->statsStart));
+	clone->statsKind = gs1_encoder_kAI_DATA;
+#endif
+
+	GS1_ENCODERS_POISON_GUARDS(GS1_ENCODER_GUARDS, clone);
+
+	GS1_ATOMIC_INC(ctx->sharedTablesRefs);
+
+	return clone;
+
+}
+
+
+void gs1_encoder_reset(gs1_encoder* const ctx) {
+	assert(ctx);
+	reset_error(ctx);
+
+	ctx->sym = gs1_encoder_sNONE;
+	ctx->addCheckDigit = false;
+	ctx->permitUnknownAIs = false;
+	ctx->permitZeroSuppressedGTINinDLuris = false;
+	ctx->permitConvenienceAlphas = false;
+	ctx->includeDataTitlesInHRI = false;
+	gs1_loadValidationTable(ctx);
+
+	clear_message(ctx);
+}
+
+
 void gs1_encoder_free(gs1_encoder* const ctx) {
 	assert(ctx);
 	reset_error(ctx);
 
+	// Tables that are shared with clones are released by the last user
+	if (!ctx->sharedTablesRefs || GS1_ATOMIC_DEC(ctx->sharedTablesRefs) == 0) {
+
+		GS1_ENCODERS_FREE(ctx->sharedTablesRefs);
+
 #ifndef EXCLUDE_SYNTAX_DICTIONARY_LOADER
-	if (ctx->aiTable && ctx->aiTableIsDynamic) {
-		gs1_freeSyntaxDictionaryEntries(ctx, ctx->aiTable);
-		GS1_ENCODERS_FREE(ctx->aiTable);
-	}
+		if (ctx->aiTable && ctx->aiTableIsDynamic) {
+			gs1_freeSyntaxDictionaryEntries(ctx, ctx->aiTable);
+			GS1_ENCODERS_FREE(ctx->aiTable);
+		}
 #endif
 
-	gs1_freeDLkeyQualifiers(ctx);
+		gs1_freeDLkeyQualifiers(ctx);
+
+	}
+
 	GS1_ENCODERS_UNPOISON_GUARDS(GS1_ENCODER_GUARDS, ctx);
 	if (ctx->localAlloc)
 		GS1_ENCODERS_FREE(ctx);
@@ -381,10 +514,12 @@ bool gs1_encoder_setDataStr(gs1_encoder* const ctx, const char* const dataStr) {
 	// Validate and process data, including extraction of HRI
 	ctx->numAIs = 0;
 	ctx->numSortedAIs = 0;
+	STATS_BEGIN(gs1_encoder_stPARSE);
 	if (strncmp(ctx->dataStr, "https://", 8) == 0 ||	// GS1 Digital Link URI
 	    strncmp(ctx->dataStr, "HTTPS://", 8) == 0 ||
 	    strncmp(ctx->dataStr, "http://",  7) == 0 ||
 	    strncmp(ctx->dataStr, "HTTP://",  7) == 0) {
+		STATS_MESSAGE(gs1_encoder_kDL_URI);
 		// We extract AIs with the element string stored in dlAIbuffer
 		if (!gs1_parseDLuri(ctx, ctx->dataStr, ctx->dlAIbuffer))
 			goto fail;
@@ -393,6 +528,7 @@ bool gs1_encoder_setDataStr(gs1_encoder* const ctx, const char* const dataStr) {
 
 		*cc = '\0';						// Delimit end of linear component
 
+		STATS_MESSAGE(*ctx->dataStr == '^' ? gs1_encoder_kELEMENT_STRING : gs1_encoder_kPLAIN);
 		if (*ctx->dataStr == '^' && !gs1_processAIdata(ctx, ctx->dataStr, true))
 			goto fail;
 
@@ -412,17 +548,24 @@ bool gs1_encoder_setDataStr(gs1_encoder* const ctx, const char* const dataStr) {
 
 	}
 	else {								// Linear-only symbol
+		STATS_MESSAGE(*ctx->dataStr == '^' ? gs1_encoder_kELEMENT_STRING : gs1_encoder_kPLAIN);
 		if (*ctx->dataStr == '^' && !gs1_processAIdata(ctx, ctx->dataStr, true))
 			goto fail;
 	}
+	STATS_END(gs1_encoder_stPARSE);
 
 	if (!gs1_validateAIs(ctx))
-		goto fail;
+		goto invalid;
 
 	return true;
 
 fail:
 
+	STATS_END(gs1_encoder_stPARSE);
+
+invalid:
+
+	STATS_REJECTED();
 	*ctx->dataStr = '\0';
 	ctx->numAIs = 0;
 	ctx->numSortedAIs = 0;
@@ -431,25 +574,38 @@ fail:
 }
 
 
-bool gs1_encoder_setAIdataStr(gs1_encoder* const ctx, const char* const aiData) {
+/*
+ *  Parse bracketed AI data from a span that is only read. The linear and
+ *  composite components are parsed as subspans rather than by delimiting
+ *  the input.
+ *
+ */
+static bool setAIdata(gs1_encoder* const ctx, const char* aiData, const size_t len) {
 
-	char *cc;
+	const char *cc;
 
 	assert(ctx);
-	assert(aiData);
-	reset_error(ctx);
+	assert(aiData || len == 0);
+
+	// The parser writes dataStr as it reads, so stage any input that is a
+	// view of it
+	if (len > 0 && (uintptr_t)aiData >= (uintptr_t)ctx->dataStr &&
+	    (uintptr_t)aiData < (uintptr_t)ctx->dataStr + sizeof(ctx->dataStr)) {
+		memmove(ctx->outStr, aiData, len);
+		aiData = ctx->outStr;
+	}
 
 	// Validate AI data
 	ctx->numAIs = 0;
 	ctx->numSortedAIs = 0;
-	if ((cc = strchr((char*)aiData, '|')) != NULL)	// Composite symbol
+	STATS_MESSAGE(gs1_encoder_kAI_DATA);
+	STATS_BEGIN(gs1_encoder_stPARSE);
+	if (len > 0 && (cc = memchr(aiData, '|', len)) != NULL)	// Composite symbol
 	{
 
 		char* p;
 
-		*cc = '\0';					// Delimit end of linear component
-
-		if (!gs1_parseAIdata(ctx, aiData, ctx->dataStr, MAX_DATA))
+		if (!gs1_parseAIdata(ctx, aiData, (size_t)(cc - aiData), ctx->dataStr, MAX_DATA))
 			goto fail;
 
 		if (ctx->numAIs >= MAX_AIS) {
@@ -470,24 +626,28 @@ bool gs1_encoder_setAIdataStr(gs1_encoder* const ctx, const char* const aiData)
 		ctx->aiData[ctx->numAIs].kind = aiValue_ccsep;
 		ctx->numAIs++;
 
-		if (!gs1_parseAIdata(ctx, cc+1, p, MAX_DATA - (size_t)(p - ctx->dataStr)))
+		if (!gs1_parseAIdata(ctx, cc+1, len - (size_t)(cc+1 - aiData), p, MAX_DATA - (size_t)(p - ctx->dataStr)))
 			goto fail;
 
-		*cc = '|';					// Restore original "|"
-
 	}
 	else {							// Linear-only symbol
-		if (!gs1_parseAIdata(ctx, aiData, ctx->dataStr, MAX_DATA))
+		if (!gs1_parseAIdata(ctx, aiData, len, ctx->dataStr, MAX_DATA))
 			goto fail;
 	}
+	STATS_END(gs1_encoder_stPARSE);
 
 	if (!gs1_validateAIs(ctx))
-		goto fail;
+		goto invalid;
 
 	return true;
 
 fail:
 
+	STATS_END(gs1_encoder_stPARSE);
+
+invalid:
+
+	STATS_REJECTED();
 	*ctx->dataStr = '\0';
 	ctx->numAIs = 0;
 	ctx->numSortedAIs = 0;
@@ -496,26 +656,48 @@ fail:
 }
 
 
-char* gs1_encoder_getAIdataStr(gs1_encoder* const ctx) {
+bool gs1_encoder_setAIdataStr(gs1_encoder* const ctx, const char* const aiData) {
+
+	assert(ctx);
+	assert(aiData);
+	reset_error(ctx);
+
+	return setAIdata(ctx, aiData, strlen(aiData));
+
+}
+
+
+/*
+ *  Render the bracketed AI element string, failing if it and its NUL
+ *  terminator would not fit.
+ *
+ */
+static bool renderAIdataStr(const gs1_encoder* const ctx, char* const out, const size_t size) {
 
 	int i, j;
-	char *p = ctx->outStr;
+	char *p = out;
 	size_t len;
 
-	assert(ctx);
 	assert(ctx->numAIs <= MAX_AIS);
-	reset_error(ctx);
 
-	if (ctx->numAIs == 0)		// Not GS1 data
-		return NULL;
+	if (size == 0)
+		return false;
 
 	for (i = 0; i < ctx->numAIs; i++) {
 		const struct aiValue *ai = &ctx->aiData[i];
 		if (ai->kind == aiValue_aival) {
 			// Worst case write for this AI: "(AI)" plus every value byte
-			// escaped as "\(", with the '<' leaving room for the trailing NUL
+			// escaped as "\(", which is counted exactly only if it
+			// matters
 			len = (size_t)ai->ailen + 2 + 2*(size_t)ai->vallen;
-			assert(len < sizeof(ctx->outStr) - (size_t)(p - ctx->outStr));
+			if (len >= size - (size_t)(p - out)) {
+				len = (size_t)ai->ailen + 2 + (size_t)ai->vallen;
+				for (j = 0; j < ai->vallen; j++)
+					if (ai->value[j] == '(')
+						len++;
+				if (len >= size - (size_t)(p - out))
+					return false;
+			}
 			*p++ = '(';
 			memcpy(p, ai->ai, ai->ailen);
 			p += ai->ailen;
@@ -526,25 +708,56 @@ char* gs1_encoder_getAIdataStr(gs1_encoder* const ctx) {
 				*p++ = ai->value[j];
 			}
 		} else if (ai->kind == aiValue_ccsep) {
+			if (size - (size_t)(p - out) < 2)
+				return false;
 			*p++ = '|';
 		}	// Otherwise ignored parameters
 	}
 	*p = '\0';
 
+	return true;
+
+}
+
+
+char* gs1_encoder_getAIdataStr(gs1_encoder* const ctx) {
+
+	bool ok;
+
+	assert(ctx);
+	reset_error(ctx);
+
+	if (ctx->numAIs == 0)		// Not GS1 data
+		return NULL;
+
+	STATS_RENDER_BEGIN();
+	ok = renderAIdataStr(ctx, ctx->outStr, sizeof(ctx->outStr));
+	assert(ok);			// outStr is sized for the worst case
+	(void)ok;
+	STATS_RENDER_END();
+
 	return ctx->outStr;
 
 }
 
 
 char* gs1_encoder_getDLuri(gs1_encoder* const ctx, const char* const stem) {
+	char *out;
 	assert(ctx);
-	return gs1_generateDLuri(ctx, stem);
+	STATS_RENDER_BEGIN();
+	out = gs1_generateDLuri(ctx, stem);
+	STATS_RENDER_END();
+	return out;
 }
 
 
 char* gs1_encoder_getScanData(gs1_encoder* const ctx) {
+	char *out;
 	assert(ctx);
-	return gs1_generateScanData(ctx);
+	STATS_RENDER_BEGIN();
+	out = gs1_generateScanData(ctx);
+	STATS_RENDER_END();
+	return out;
 }
 
 
@@ -552,21 +765,254 @@ bool gs1_encoder_setScanData(gs1_encoder* const ctx, const char* const scanData)
 	assert(ctx);
 	assert(scanData);
 
+	STATS_MESSAGE(gs1_encoder_kSCAN_DATA);
+	STATS_BEGIN(gs1_encoder_stPARSE);
 	if (!gs1_processScanData(ctx, scanData))
 		goto fail;
+	STATS_END(gs1_encoder_stPARSE);
 
 	if (!gs1_validateAIs(ctx))
+		goto invalid;
+
+	return true;
+
+fail:
+
+	STATS_END(gs1_encoder_stPARSE);
+
+invalid:
+
+	STATS_REJECTED();
+	return false;
+
+}
+
+
+/*
+ *  Length-delimited input is staged NUL-terminated for the setters, except
+ *  for bracketed AI data which is parsed in place. Input parsing does not
+ *  use outStr, so it serves for staging any but raw data, which is staged
+ *  directly in dataStr as for file input.
+ *
+ */
+static bool checkInput(gs1_encoder* const ctx, const size_t size, const char* const in, const size_t len) {
+
+	assert(in || len == 0);
+	reset_error(ctx);
+
+	if (len >= size) {
+		SET_ERR_V(DATA_TOO_LONG, MAX_DATA);
+		return false;
+	}
+	if (len > 0 && memchr(in, '\0', len) != NULL) {
+		SET_ERR(INPUT_CONTAINS_NUL);
+		return false;
+	}
+	return true;
+
+}
+
+
+static bool stageInput(gs1_encoder* const ctx, char* const buf, const size_t size, const char* const in, const size_t len) {
+
+	if (!checkInput(ctx, size, in, len))
+		return false;
+	if (len > 0)
+		memmove(buf, in, len);		// Input may be a view of a context buffer
+	buf[len] = '\0';
+	return true;
+
+}
+
+
+bool gs1_encoder_setDataStrN(gs1_encoder* const ctx, const char* const dataStr, const size_t len) {
+	assert(ctx);
+	if (!stageInput(ctx, ctx->dataStr, sizeof(ctx->dataStr), dataStr, len))
+		return false;
+	return gs1_encoder_setDataStr(ctx, ctx->dataStr);
+}
+
+
+bool gs1_encoder_setAIdataStrN(gs1_encoder* const ctx, const char* const aiData, const size_t len) {
+	assert(ctx);
+	if (!checkInput(ctx, sizeof(ctx->outStr), aiData, len))
+		return false;
+	return setAIdata(ctx, aiData, len);	// Parsed in place, without staging
+}
+
+
+bool gs1_encoder_setScanDataN(gs1_encoder* const ctx, const char* const scanData, const size_t len) {
+	assert(ctx);
+	if (!stageInput(ctx, ctx->outStr, sizeof(ctx->outStr), scanData, len))
+		return false;
+	return gs1_encoder_setScanData(ctx, ctx->outStr);
+}
+
+
+void gs1_encoder_labelBegin(gs1_encoder* const ctx) {
+	assert(ctx);
+	reset_error(ctx);
+
+	ctx->labelLen = 0;
+	ctx->numLabelAIs = 0;
+}
+
+
+bool gs1_encoder_labelAddScanData(gs1_encoder* const ctx, const char* const scanData) {
+
+	assert(ctx);
+	assert(scanData);
+
+	STATS_MESSAGE(gs1_encoder_kSCAN_DATA);
+	STATS_BEGIN(gs1_encoder_stPARSE);
+	if (!gs1_processScanData(ctx, scanData) || !gs1_addLabelAIs(ctx))
 		goto fail;
+	STATS_END(gs1_encoder_stPARSE);
+
+	// The message is the read, whose AIs have only been validated alone
+	gs1_sortAIs(ctx);
 
 	return true;
 
 fail:
 
+	STATS_END(gs1_encoder_stPARSE);
+	STATS_REJECTED();
+	*ctx->dataStr = '\0';
+	ctx->sym = gs1_encoder_sNONE;
+	ctx->numAIs = 0;
+	ctx->numSortedAIs = 0;
 	return false;
 
 }
 
 
+bool gs1_encoder_labelFinish(gs1_encoder* const ctx) {
+
+	assert(ctx);
+	reset_error(ctx);
+
+	if (ctx->numLabelAIs == 0) {
+		SET_ERR(AI_DATA_EMPTY);
+		return false;
+	}
+
+	ctx->sym = gs1_encoder_sNONE;
+	gs1_loadLabelAIs(ctx);
+
+	// The label is kept on failure so that further reads may complete it
+	if (!gs1_validateAIs(ctx)) {
+		*ctx->dataStr = '\0';
+		ctx->numAIs = 0;
+		ctx->numSortedAIs = 0;
+		return false;
+	}
+
+	ctx->labelLen = 0;
+	ctx->numLabelAIs = 0;
+
+	return true;
+
+}
+
+
+static gs1_encoder_feed_status_t processScanStream(gs1_encoder* const ctx) {
+
+	STATS_MESSAGE(gs1_encoder_kSCAN_DATA);
+	STATS_BEGIN(gs1_encoder_stPARSE);
+	if (!gs1_processScanStream(ctx))
+		goto fail;
+	STATS_END(gs1_encoder_stPARSE);
+
+	if (!gs1_validateAIs(ctx))
+		goto invalid;
+
+	return gs1_encoder_fMESSAGE;
+
+fail:
+
+	STATS_END(gs1_encoder_stPARSE);
+
+invalid:
+
+	STATS_REJECTED();
+	return gs1_encoder_fERROR;
+
+}
+
+
+gs1_encoder_feed_status_t gs1_encoder_feedScanStream(gs1_encoder* const ctx, const char* const data, const size_t len, size_t* const consumed) {
+
+	assert(ctx);
+	assert(data || len == 0);
+	assert(consumed);
+
+	if (!gs1_feedScanStream(ctx, data, len, consumed))
+		return gs1_encoder_fNEED_MORE;
+
+	return processScanStream(ctx);
+
+}
+
+
+gs1_encoder_feed_status_t gs1_encoder_flushScanStream(gs1_encoder* const ctx) {
+
+	assert(ctx);
+
+	if (!gs1_endScanStream(ctx))
+		return gs1_encoder_fNEED_MORE;
+
+	return processScanStream(ctx);
+
+}
+
+
+void gs1_encoder_resetScanStream(gs1_encoder* const ctx) {
+	assert(ctx);
+	gs1_resetScanStream(ctx);
+}
+
+
+static size_t hriTitleLength(const gs1_encoder* const ctx, const struct aiValue* const ai) {
+	assert(ai->aiEntry);
+	return ctx->includeDataTitlesInHRI ? strlen(ai->aiEntry->title) : 0;
+}
+
+
+static size_t hriLineLength(const gs1_encoder* const ctx, const struct aiValue* const ai) {
+	const size_t title_len = hriTitleLength(ctx, ai);
+	return (title_len > 0 ? title_len + 1 : 0) + (size_t)ai->ailen + 3 + (size_t)ai->vallen;
+}
+
+
+/*
+ *  Write "data_title (AI) VALUE" or "(AI) VALUE" without a terminator,
+ *  returning the end of the line.
+ *
+ */
+static char* writeHRIline(const gs1_encoder* const ctx, const struct aiValue* const ai, char *p) {
+
+	const size_t title_len = hriTitleLength(ctx, ai);
+
+	if (title_len > 0) {
+		memcpy(p, ai->aiEntry->title, title_len);
+		p += title_len;
+		*p++ = ' ';
+	}
+
+	*p++ = '(';
+	memcpy(p, ai->ai, ai->ailen);
+	p += ai->ailen;
+	*p++ = ')';
+	*p++ = ' ';
+	memcpy(p, ai->value, ai->vallen);
+	p += ai->vallen;
+
+	return p;
+
+}
+
+
 int gs1_encoder_getHRI(gs1_encoder* const ctx, char*** const out) {
 
 	int i, j;
@@ -576,42 +1022,23 @@ int gs1_encoder_getHRI(gs1_encoder* const ctx, char*** const out) {
 	assert(ctx->numAIs <= MAX_AIS);
 	reset_error(ctx);
 
+	STATS_RENDER_BEGIN();
 	*p = '\0';
 	for (i = 0, j = 0; i < ctx->numAIs; i++) {
 
 		const struct aiValue* const ai = &ctx->aiData[i];
-		size_t title_len = 0;
 
 		if (ai->kind != aiValue_aival)
 			continue;
 
-		assert(ai->aiEntry);
-
-		if (ctx->includeDataTitlesInHRI && *ai->aiEntry->title != '\0')
-			title_len = strlen(ai->aiEntry->title);
-
 		/*
-		 *  "data_title (AI) VALUE" or "(AI) VALUE". The AI value, data title
-		 *  and AI count limits guarantee (see the outStr line-budget assert)
-		 *  that each line fits its share of outStr, so MAX_AIS lines cannot
-		 *  overrun it.
+		 *  The AI value, data title and AI count limits guarantee (see the
+		 *  outStr line-budget assert) that each line fits its share of
+		 *  outStr, so MAX_AIS lines cannot overrun it.
 		 *
 		 */
 		ctx->outHRI[j] = p;
-
-		if (title_len > 0) {
-			memcpy(p, ai->aiEntry->title, title_len);
-			p += title_len;
-			*p++ = ' ';
-		}
-
-		*p++ = '(';
-		memcpy(p, ai->ai, ai->ailen);
-		p += ai->ailen;
-		*p++ = ')';
-		*p++ = ' ';
-		memcpy(p, ai->value, ai->vallen);
-		p += ai->vallen;
+		p = writeHRIline(ctx, ai, p);
 		*p++ = '\0';
 
 		j++;
@@ -619,6 +1046,7 @@ int gs1_encoder_getHRI(gs1_encoder* const ctx, char*** const out) {
 	}
 
 	*out = ctx->outHRI;
+	STATS_RENDER_END();
 
 	return j;
 
@@ -762,21 +1190,608 @@ void gs1_encoder_copyDLignoredQueryParams(gs1_encoder* const ctx, void* const bu
 }
 
 
-__ATTR_PURE char* gs1_encoder_getErrMsg(gs1_encoder* const ctx) {
-	assert(ctx);
-	return ctx->errMsg;
-}
+int gs1_encoder_getAIelements(gs1_encoder* const ctx, const gs1_encoder_ai_element_t** const out) {
 
+	int i, j;
 
-__ATTR_PURE char* gs1_encoder_getErrMarkup(gs1_encoder* const ctx) {
 	assert(ctx);
-	return ctx->linterErrMarkup;
-}
+	assert(ctx->numAIs <= MAX_AIS);
+	reset_error(ctx);
 
+	for (i = 0, j = 0; i < ctx->numAIs; i++) {
 
-/*
- *  Utility functions
- *
+		const struct aiValue* const ai = &ctx->aiData[i];
+
+		if (ai->kind != aiValue_aival)
+			continue;
+
+		ctx->outAIs[j].ai = ai->ai;
+		ctx->outAIs[j].aiLen = ai->ailen;
+		ctx->outAIs[j].value = ai->value;
+		ctx->outAIs[j].valueLen = ai->vallen;
+		j++;
+
+	}
+
+	*out = ctx->outAIs;
+	return j;
+
+}
+
+
+/*
+ *  Read-only renderers. These leave the context untouched, reporting any
+ *  error in the caller's buffer, so that several threads may render the
+ *  same message at once.
+ *
+ */
+bool gs1_encoder_renderDataStr(const gs1_encoder* const ctx, char* const buf, const size_t bufSize) {
+
+	gs1_renderErr_t re = RENDER_ERR_TARGET(buf, bufSize);
+	size_t len;
+
+	assert(ctx);
+	assert(buf || bufSize == 0);
+
+	len = strlen(ctx->dataStr);
+	if (len >= bufSize) {
+		RENDER_ERR(&re, OUTPUT_BUFFER_TOO_SMALL);
+		return false;
+	}
+	memcpy(buf, ctx->dataStr, len + 1);
+
+	return true;
+
+}
+
+
+bool gs1_encoder_renderAIdataStr(const gs1_encoder* const ctx, char* const buf, const size_t bufSize) {
+
+	gs1_renderErr_t re = RENDER_ERR_TARGET(buf, bufSize);
+
+	assert(ctx);
+	assert(buf || bufSize == 0);
+
+	if (!renderAIdataStr(ctx, buf, bufSize)) {
+		RENDER_ERR(&re, OUTPUT_BUFFER_TOO_SMALL);
+		return false;
+	}
+
+	return true;
+
+}
+
+
+bool gs1_encoder_renderDLuri(const gs1_encoder* const ctx, const char* const stem, char* const buf, const size_t bufSize) {
+
+	gs1_renderErr_t re = RENDER_ERR_TARGET(buf, bufSize);
+
+	assert(ctx);
+	assert(buf || bufSize == 0);
+
+	return gs1_renderDLuri(ctx, stem, buf, bufSize, &re);
+
+}
+
+
+bool gs1_encoder_renderScanData(const gs1_encoder* const ctx, char* const buf, const size_t bufSize) {
+
+	gs1_renderErr_t re = RENDER_ERR_TARGET(buf, bufSize);
+
+	assert(ctx);
+	assert(buf || bufSize == 0);
+
+	return gs1_renderScanData(ctx, buf, bufSize, &re);
+
+}
+
+
+bool gs1_encoder_renderHRI(const gs1_encoder* const ctx, char* const buf, const size_t bufSize) {
+
+	gs1_renderErr_t re = RENDER_ERR_TARGET(buf, bufSize);
+	char *p = buf;
+	size_t len;
+	int i;
+
+	assert(ctx);
+	assert(ctx->numAIs <= MAX_AIS);
+	assert(buf || bufSize == 0);
+
+	if (bufSize == 0)
+		return false;
+
+	for (i = 0; i < ctx->numAIs; i++) {
+
+		const struct aiValue* const ai = &ctx->aiData[i];
+
+		if (ai->kind != aiValue_aival)
+			continue;
+
+		len = hriLineLength(ctx, ai) + (p != buf ? 1 : 0);
+		if (len >= bufSize - (size_t)(p - buf)) {
+			RENDER_ERR(&re, OUTPUT_BUFFER_TOO_SMALL);
+			return false;
+		}
+
+		if (p != buf)
+			*p++ = '|';
+		p = writeHRIline(ctx, ai, p);
+
+	}
+	*p = '\0';
+
+	return true;
+
+}
+
+
+size_t gs1_encoder_getSerialisedMessage(gs1_encoder* const ctx, uint8_t* const buf, const size_t bufSize) {
+
+	assert(ctx);
+	assert(buf || bufSize == 0);
+	reset_error(ctx);
+
+	return gs1_serialiseAIs(ctx, buf, bufSize);
+
+}
+
+
+bool gs1_encoder_setSerialisedMessage(gs1_encoder* const ctx, const uint8_t* const data, const size_t len) {
+
+	bool trusted = false;
+
+	assert(ctx);
+	assert(data || len == 0);
+	reset_error(ctx);
+
+	STATS_BEGIN(gs1_encoder_stPARSE);
+	if (!gs1_loadSerialisedAIs(ctx, data, len, &trusted)) {
+		STATS_MESSAGE(gs1_encoder_kELEMENT_STRING);
+		STATS_END(gs1_encoder_stPARSE);
+		STATS_REJECTED();
+		return false;
+	}
+
+	// Validated with a different AI table or settings, so process afresh
+	if (!trusted)
+		return gs1_encoder_setDataStr(ctx, ctx->dataStr);
+
+	STATS_MESSAGE(gs1_encoder_kELEMENT_STRING);
+	STATS_END(gs1_encoder_stPARSE);
+
+	return true;
+
+}
+
+
+bool gs1_encoder_getMessageFingerprint(gs1_encoder* const ctx, uint64_t fingerprint[2]) {
+
+	assert(ctx);
+	assert(fingerprint);
+	reset_error(ctx);
+
+	return gs1_messageFingerprint(ctx, fingerprint);
+
+}
+
+
+/*
+ *  Set the input for a batch entry and, if successful, render the requested
+ *  output. Returns the output, which is then copied out by the caller, or
+ *  NULL with the error set.
+ *
+ */
+static const char* processBatchItem(gs1_encoder* const ctx, const gs1_encoder_batch_inputs_t input, const gs1_encoder_batch_outputs_t output, const char* const in) {
+
+	const char *rendered;
+	char **hri;
+	int numhri, i;
+	char *p;
+
+	switch (input) {
+	case gs1_encoder_bAI_DATA_STR:
+		if (!gs1_encoder_setAIdataStr(ctx, in))
+			return NULL;
+		break;
+	case gs1_encoder_bDATA_STR:
+		if (!gs1_encoder_setDataStr(ctx, in))
+			return NULL;
+		break;
+	case gs1_encoder_bSCAN_DATA:
+		if (!gs1_encoder_setScanData(ctx, in))
+			return NULL;
+		break;
+	default:
+		assert(0);
+		return NULL;
+	}
+
+	switch (output) {
+	case gs1_encoder_oNONE:
+		return "";
+	case gs1_encoder_oDATA_STR:
+		return gs1_encoder_getDataStr(ctx);
+	case gs1_encoder_oAI_DATA_STR:
+		rendered = gs1_encoder_getAIdataStr(ctx);
+		return rendered ? rendered : "";	// Not GS1 data
+	case gs1_encoder_oDL_URI:
+		return gs1_encoder_getDLuri(ctx, NULL);
+	case gs1_encoder_oSCAN_DATA:
+		return gs1_encoder_getScanData(ctx);
+	case gs1_encoder_oHRI:
+		/*
+		 *  The HRI lines are consecutive in outStr, so joining them is a
+		 *  matter of replacing the intermediate NUL terminators.
+		 *
+		 */
+		numhri = gs1_encoder_getHRI(ctx, &hri);
+		if (numhri == 0)
+			return "";
+		for (i = 1; i < numhri; i++) {
+			p = hri[i] - 1;
+			assert(*p == '\0');
+			*p = '|';
+		}
+		return hri[0];
+	default:
+		assert(0);
+		return NULL;
+	}
+
+}
+
+
+size_t gs1_encoder_processBatch(gs1_encoder* const ctx, const gs1_encoder_batch_inputs_t input, const gs1_encoder_batch_outputs_t output, const char* const in, const size_t num, char* const out, const size_t outSize, gs1_encoder_batch_result_t* const results) {
+
+	const char *p = in, *next;
+	const char *rendered;
+	size_t i, len, pos = 0;
+	const size_t max = outSize < UINT32_MAX ? outSize : UINT32_MAX;  // Offsets are 32-bit
+
+	assert(ctx);
+	assert(in || num == 0);
+	assert(out || outSize == 0);
+	assert(results || num == 0);
+	reset_error(ctx);
+
+	if ((signed int)input < 0 || input >= gs1_encoder_bNUMINPUTS ||  // Cast satisfies "unsigned enum < 0" checks
+	    (signed int)output < 0 || output >= gs1_encoder_oNUMOUTPUTS) {
+		SET_ERR(UNKNOWN_BATCH_FORMAT);
+		return 0;
+	}
+
+	for (i = 0; i < num; i++) {
+
+		next = p + strlen(p) + 1;	// Before the input is processed, which may not restore a composite's "|" upon failure
+
+		rendered = processBatchItem(ctx, input, output, p);
+		results[i].ok = rendered != NULL;
+		if (!rendered)
+			rendered = ctx->errMsg;
+
+		len = strlen(rendered);
+		if (len >= max - pos)
+			break;
+
+		memcpy(out + pos, rendered, len + 1);
+		results[i].offset = (uint32_t)pos;
+		results[i].length = (uint32_t)len;
+		pos += len + 1;
+
+		p = next;
+
+	}
+
+	return i;
+
+}
+
+
+__ATTR_PURE char* gs1_encoder_getErrMsg(gs1_encoder* const ctx) {
+	assert(ctx);
+	return ctx->errMsg;
+}
+
+
+__ATTR_PURE char* gs1_encoder_getErrMarkup(gs1_encoder* const ctx) {
+	assert(ctx);
+	return ctx->linterErrMarkup;
+}
+
+
+#ifdef GS1_ENCODERS_STATS
+
+/*
+ *  Account for a run of a linter, or with name set just register the name of
+ *  a custom linter so that it is labelled when it is later run.
+ *
+ */
+void gs1_stats_recordLinter(gs1_encoder* const ctx, const gs1_linter_t fn, const char* const name, const uint64_t ns, const bool failed) {
+
+	gs1_encoder_stats_t* const stats = &ctx->stats;
+	struct gs1_encoder_linter_stats *ls = NULL;
+	size_t i;
+
+	for (i = 0; i < stats->numLinters; i++) {
+		if (ctx->statsLinterFns[i] == fn) {
+			ls = &stats->linters[i];
+			break;
+		}
+	}
+
+	if (!ls && stats->numLinters < GS1_ENCODERS_STATS_MAX_LINTERS) {
+		ctx->statsLinterFns[stats->numLinters] = fn;
+		if (name) {		// The application's name need not outlive init_ex
+			char* const copy = ctx->statsLinterNames[stats->numLinters];
+			strncpy(copy, name, STATS_MAX_LINTER_NAME_LEN);
+			copy[STATS_MAX_LINTER_NAME_LEN] = '\0';
+			stats->linters[stats->numLinters].name = copy;
+		} else {
+			stats->linters[stats->numLinters].name = gs1_linter_name(fn);
+		}
+		ls = &stats->linters[stats->numLinters++];
+	}
+
+	if (name)
+		return;
+
+	stats->linterInvocations++;
+	stats->stageNs[gs1_encoder_stLINT] += ns;
+	if (failed)
+		stats->linterFailures++;
+
+	if (ls) {
+		ls->invocations++;
+		ls->ns += ns;
+		if (failed)
+			ls->failures++;
+	}
+
+}
+
+#endif  /* GS1_ENCODERS_STATS */
+
+
+bool gs1_encoder_getStats(gs1_encoder* const ctx, gs1_encoder_stats_t* const stats) {
+	assert(ctx);
+	assert(stats);
+#ifdef GS1_ENCODERS_STATS
+	memcpy(stats, &ctx->stats, sizeof(gs1_encoder_stats_t));
+	return true;
+#else
+	(void)ctx;
+	(void)stats;
+	return false;
+#endif
+}
+
+
+void gs1_encoder_resetStats(gs1_encoder* const ctx) {
+
+#ifdef GS1_ENCODERS_STATS
+	size_t i;
+#endif
+
+	assert(ctx);
+
+#ifdef GS1_ENCODERS_STATS
+	// Retain the known linters, since custom linter names are only registered on load
+	for (i = 0; i < ctx->stats.numLinters; i++) {
+		ctx->stats.linters[i].invocations = 0;
+		ctx->stats.linters[i].failures = 0;
+		ctx->stats.linters[i].ns = 0;
+	}
+	memset(ctx->stats.messages, 0, offsetof(gs1_encoder_stats_t, numLinters));
+	ctx->stats.allocations = 0;
+#else
+	(void)ctx;
+#endif
+
+}
+
+
+void gs1_encoder_addStats(gs1_encoder_stats_t* const total, const gs1_encoder_stats_t* const stats) {
+
+	size_t i, j;
+
+	assert(total);
+	assert(stats);
+
+	for (i = 0; i < gs1_encoder_kNUMKINDS; i++) {
+		total->messages[i] += stats->messages[i];
+		total->rejected[i] += stats->rejected[i];
+	}
+	for (i = 0; i < gs1_encoder_stNUMSTAGES; i++)
+		total->stageNs[i] += stats->stageNs[i];
+	total->renders += stats->renders;
+	for (i = 0; i < gs1_encoder_vNUMVALIDATIONS; i++) {
+		total->validationRuns[i] += stats->validationRuns[i];
+		total->validationFailures[i] += stats->validationFailures[i];
+		total->validationNs[i] += stats->validationNs[i];
+	}
+	total->linterInvocations += stats->linterInvocations;
+	total->linterFailures += stats->linterFailures;
+	total->allocations += stats->allocations;
+
+	for (i = 0; i < stats->numLinters; i++) {
+		const struct gs1_encoder_linter_stats* const ls = &stats->linters[i];
+		for (j = 0; j < total->numLinters; j++) {
+			const char* const name = total->linters[j].name;
+			if (name == ls->name || (name && ls->name && strcmp(name, ls->name) == 0))
+				break;
+		}
+		if (j == total->numLinters) {
+			if (j == GS1_ENCODERS_STATS_MAX_LINTERS)
+				continue;		// Reflected only in the totals
+			total->linters[j].name = ls->name;
+			total->numLinters++;
+		}
+		total->linters[j].invocations += ls->invocations;
+		total->linters[j].failures += ls->failures;
+		total->linters[j].ns += ls->ns;
+	}
+
+}
+
+
+#ifdef GS1_ENCODERS_HEAP_PROFILE
+
+/*
+ *  Profiling heap management, selected by profile-heap.h. Each block carries
+ *  a header recording its size and subsystem so that releases are attributed.
+ *
+ */
+typedef union {
+	struct {
+		size_t size;
+		int subsystem;
+	} h;
+	max_align_t align;		// Keep the user block suitably aligned
+} heapProfileHeader;
+
+static gs1_encoder_heap_profile_t heapProfile;
+
+static void heapProfileAdd(const int subsystem, const size_t size) {
+	struct gs1_encoder_heap_usage* const usage[] = { &heapProfile.total, &heapProfile.subsystems[subsystem] };
+	size_t i;
+	for (i = 0; i < SIZEOF_ARRAY(usage); i++) {
+		usage[i]->allocations++;
+		usage[i]->bytes += size;
+		usage[i]->liveBytes += size;
+		if (usage[i]->liveBytes > usage[i]->peakBytes)
+			usage[i]->peakBytes = usage[i]->liveBytes;
+	}
+}
+
+static void heapProfileRemove(const int subsystem, const size_t size, const bool isFree) {
+	struct gs1_encoder_heap_usage* const usage[] = { &heapProfile.total, &heapProfile.subsystems[subsystem] };
+	size_t i;
+	for (i = 0; i < SIZEOF_ARRAY(usage); i++) {
+		usage[i]->liveBytes -= size;
+		if (isFree)
+			usage[i]->frees++;
+	}
+}
+
+static void heapProfileResetUsage(struct gs1_encoder_heap_usage* const usage) {
+	usage->allocations = 0;
+	usage->frees = 0;
+	usage->bytes = 0;
+	usage->peakBytes = usage->liveBytes;
+}
+
+void* gs1_heapProfileMalloc(const size_t sz, const int subsystem) {
+
+	heapProfileHeader *hdr;
+
+	assert(subsystem >= 0 && subsystem < gs1_encoder_hNUMSUBSYSTEMS);
+
+#ifdef UNIT_TESTS
+	if (test_should_fail())
+		return NULL;
+#endif
+
+	if (sz > SIZE_MAX - sizeof(heapProfileHeader) ||
+	    (hdr = malloc(sizeof(heapProfileHeader) + sz)) == NULL)
+		return NULL;
+
+	hdr->h.size = sz;
+	hdr->h.subsystem = subsystem;
+	heapProfileAdd(subsystem, sz);
+
+	return hdr + 1;
+
+}
+
+void* gs1_heapProfileCalloc(const size_t nm, const size_t sz, const int subsystem) {
+
+	void *p;
+
+	if (sz != 0 && nm > SIZE_MAX / sz)
+		return NULL;
+
+	if ((p = gs1_heapProfileMalloc(nm * sz, subsystem)) != NULL)
+		memset(p, 0, nm * sz);
+
+	return p;
+
+}
+
+void* gs1_heapProfileRealloc(void* const p, const size_t sz, const int subsystem) {
+
+	heapProfileHeader *hdr, *newHdr;
+	size_t oldSize;
+	int oldSubsystem;
+
+	if (!p)
+		return gs1_heapProfileMalloc(sz, subsystem);
+
+#ifdef UNIT_TESTS
+	if (test_should_fail())
+		return NULL;
+#endif
+
+	hdr = (heapProfileHeader*)p - 1;
+	oldSize = hdr->h.size;
+	oldSubsystem = hdr->h.subsystem;
+
+	if (sz > SIZE_MAX - sizeof(heapProfileHeader) ||
+	    (newHdr = realloc(hdr, sizeof(heapProfileHeader) + sz)) == NULL)
+		return NULL;
+
+	newHdr->h.size = sz;
+	newHdr->h.subsystem = subsystem;
+	heapProfileRemove(oldSubsystem, oldSize, false);
+	heapProfileAdd(subsystem, sz);
+
+	return newHdr + 1;
+
+}
+
+void gs1_heapProfileFree(void* const p) {
+
+	heapProfileHeader *hdr;
+
+	if (!p)
+		return;
+
+	hdr = (heapProfileHeader*)p - 1;
+	heapProfileRemove(hdr->h.subsystem, hdr->h.size, true);
+	free(hdr);
+
+}
+
+#endif  /* GS1_ENCODERS_HEAP_PROFILE */
+
+
+bool gs1_encoder_getHeapProfile(gs1_encoder_heap_profile_t* const profile) {
+	assert(profile);
+#ifdef GS1_ENCODERS_HEAP_PROFILE
+	memcpy(profile, &heapProfile, sizeof(gs1_encoder_heap_profile_t));
+	return true;
+#else
+	(void)profile;
+	return false;
+#endif
+}
+
+
+void gs1_encoder_resetHeapProfile(void) {
+
+#ifdef GS1_ENCODERS_HEAP_PROFILE
+	size_t i;
+
+	heapProfileResetUsage(&heapProfile.total);
+	for (i = 0; i < gs1_encoder_hNUMSUBSYSTEMS; i++)
+		heapProfileResetUsage(&heapProfile.subsystems[i]);
+#endif
+
+}
+
+
+/*
+ *  Utility functions
+ *
  */
 
 /*
@@ -848,18 +1863,6 @@ bool gs1_tokenise(const char *data, char delim, gs1_tok_t *tok) {
 }
 
 
-char* gs1_strdup_alloc(const char *s) {
-
-	size_t len = strlen(s) + 1;
-	void *d = GS1_ENCODERS_MALLOC(len);
-
-	if (!d)
-		return NULL;
-
-	return memcpy(d, s, len);
-
-}
-
 /*
  *  Implements a binarySearch for needle within haystack array, followed by
  *  optional validation of the result.
@@ -1060,17 +2063,21 @@ void test_api_init_opts_layout(void) {
 	TEST_CHECK(offsetof(gs1_encoder_init_opts_t, msgBuf)           == 24);
 	TEST_CHECK(offsetof(gs1_encoder_init_opts_t, msgBufSize)       == 32);
 	TEST_CHECK(offsetof(gs1_encoder_init_opts_t, syntaxDictionary) == 40);
+	TEST_CHECK(offsetof(gs1_encoder_init_opts_t, linters)          == 48);
+	TEST_CHECK(offsetof(gs1_encoder_init_opts_t, numLinters)       == 56);
 #else
 	TEST_CHECK(offsetof(gs1_encoder_init_opts_t, flags)            ==  4);
 	TEST_CHECK(offsetof(gs1_encoder_init_opts_t, status)           ==  8);
 	TEST_CHECK(offsetof(gs1_encoder_init_opts_t, msgBuf)           == 12);
 	TEST_CHECK(offsetof(gs1_encoder_init_opts_t, msgBufSize)       == 16);
 	TEST_CHECK(offsetof(gs1_encoder_init_opts_t, syntaxDictionary) == 20);
+	TEST_CHECK(offsetof(gs1_encoder_init_opts_t, linters)          == 24);
+	TEST_CHECK(offsetof(gs1_encoder_init_opts_t, numLinters)       == 28);
 #endif
 
 	TEST_CHECK(sizeof(gs1_encoder_init_opts_t) ==
-	           offsetof(gs1_encoder_init_opts_t, syntaxDictionary)
-	           + sizeof(((gs1_encoder_init_opts_t *)0)->syntaxDictionary));
+	           offsetof(gs1_encoder_init_opts_t, numLinters)
+	           + sizeof(((gs1_encoder_init_opts_t *)0)->numLinters));
 
 }
 
@@ -1118,6 +2125,147 @@ void test_api_defaults(void) {
 }
 
 
+void test_api_clone(void) {
+
+	gs1_encoder *ctx, *clone, *clone2;
+	void *heap;
+	char *out;
+
+	TEST_ASSERT((ctx = gs1_encoder_unit_test_init()) != NULL);
+	assert(ctx);
+	TEST_CHECK(*ctx->sharedTablesRefs == 1);
+
+	TEST_CHECK(gs1_encoder_setSym(ctx, gs1_encoder_sDM));
+	TEST_CHECK(gs1_encoder_setPermitUnknownAIs(ctx, true));
+	TEST_CHECK(gs1_encoder_setIncludeDataTitlesInHRI(ctx, true));
+	TEST_CHECK(gs1_encoder_setValidationEnabled(ctx, gs1_encoder_vREQUISITE_AIS, false));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)09521234543213(10)ABC"));
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(01)12345678901234"));	// Leaves an error
+
+	// Options and validations are copied; message and error state are not
+	TEST_ASSERT((clone = gs1_encoder_clone(ctx, NULL)) != NULL);
+	assert(clone);
+	TEST_CHECK(*gs1_encoder_getErrMsg(ctx) != '\0');			// Original is not modified
+	TEST_CHECK(gs1_encoder_getSym(clone) == gs1_encoder_sDM);
+	TEST_CHECK(gs1_encoder_getPermitUnknownAIs(clone));
+	TEST_CHECK(gs1_encoder_getIncludeDataTitlesInHRI(clone));
+	TEST_CHECK(!gs1_encoder_getValidationEnabled(clone, gs1_encoder_vREQUISITE_AIS));
+	TEST_CHECK(gs1_encoder_getValidationEnabled(clone, gs1_encoder_vUNKNOWN_AI_NOT_DL_ATTR));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(clone), "") == 0);
+	TEST_CHECK(clone->numAIs == 0);
+	TEST_CHECK(*gs1_encoder_getErrMsg(clone) == '\0');
+	TEST_CHECK(clone->localAlloc);
+
+	// Tables are shared
+	TEST_CHECK(clone->aiTable == ctx->aiTable);
+	TEST_CHECK(clone->dlKeyQualifiers == ctx->dlKeyQualifiers);
+	TEST_CHECK(clone->sharedTablesRefs == ctx->sharedTablesRefs);
+	TEST_CHECK(*ctx->sharedTablesRefs == 2);
+
+	// Later changes to either context are independent
+	TEST_CHECK(gs1_encoder_setSym(clone, gs1_encoder_sQR));
+	TEST_CHECK(gs1_encoder_getSym(ctx) == gs1_encoder_sDM);
+	TEST_CHECK(gs1_encoder_setAIdataStr(clone, "(01)09521234543213(10)DEF"));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)09521234543213(10)ABC"));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(clone), "^010952123454321310DEF") == 0);
+
+	// A clone of a clone shares the same tables
+	TEST_ASSERT((clone2 = gs1_encoder_clone(clone, NULL)) != NULL);
+	assert(clone2);
+	TEST_CHECK(clone2->aiTable == ctx->aiTable);
+	TEST_CHECK(*ctx->sharedTablesRefs == 3);
+	TEST_CHECK(gs1_encoder_getSym(clone2) == gs1_encoder_sQR);
+
+	// The tables outlive the original
+	gs1_encoder_free(ctx);
+	TEST_CHECK(*clone->sharedTablesRefs == 2);
+	TEST_CHECK(gs1_encoder_setDataStr(clone, "https://id.gs1.org/01/09521234543213/22/ABC/10/DEF/21/GHI"));
+	TEST_ASSERT((out = gs1_encoder_getDLuri(clone, NULL)) != NULL);
+	TEST_CHECK(strcmp(out, "https://id.gs1.org/01/09521234543213/22/ABC/10/DEF/21/GHI") == 0);
+	gs1_encoder_free(clone);
+
+	TEST_CHECK(gs1_encoder_setAIdataStr(clone2, "(01)09521234543213(21)XYZ"));
+	gs1_encoder_free(clone2);
+
+	// Storage provided by the caller
+#ifndef __clang_analyzer__
+	TEST_ASSERT((ctx = gs1_encoder_unit_test_init()) != NULL);
+	assert(ctx);
+	TEST_ASSERT((heap = GS1_ENCODERS_MALLOC(gs1_encoder_instanceSize())) != NULL);
+	TEST_CHECK((clone = gs1_encoder_clone(ctx, heap)) == heap);
+	assert(clone);
+	TEST_CHECK(!clone->localAlloc);
+	gs1_encoder_free(ctx);
+	TEST_CHECK(gs1_encoder_setAIdataStr(clone, "(01)09521234543213"));
+	gs1_encoder_free(clone);
+	GS1_ENCODERS_FREE(heap);
+#else
+	(void)heap;
+#endif
+
+	// Clone released before the original, sharing tables loaded from a Syntax Dictionary
+	{
+		gs1_encoder_init_opts_t opts = {
+			.struct_size		= sizeof(gs1_encoder_init_opts_t),
+			.syntaxDictionary	= "gs1-syntax-dictionary.txt",
+		};
+
+		TEST_ASSERT((ctx = gs1_encoder_init_ex(NULL, &opts)) != NULL);
+		assert(ctx);
+		TEST_CHECK(ctx->aiTableIsDynamic);
+		TEST_ASSERT((clone = gs1_encoder_clone(ctx, NULL)) != NULL);
+		assert(clone);
+		TEST_CHECK(clone->aiTableIsDynamic);
+		TEST_CHECK(gs1_encoder_setAIdataStr(clone, "(01)09521234543213(10)ABC"));
+		gs1_encoder_free(clone);
+		TEST_CHECK(*ctx->sharedTablesRefs == 1);
+		TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)09521234543213(10)ABC"));
+		gs1_encoder_free(ctx);
+	}
+
+}
+
+
+void test_api_reset(void) {
+
+	gs1_encoder *ctx;
+	const struct aiEntry *aiTable;
+
+	TEST_ASSERT((ctx = gs1_encoder_unit_test_init()) != NULL);
+	assert(ctx);
+	aiTable = ctx->aiTable;
+
+	TEST_CHECK(gs1_encoder_setSym(ctx, gs1_encoder_sDM));
+	TEST_CHECK(gs1_encoder_setAddCheckDigit(ctx, true));
+	TEST_CHECK(gs1_encoder_setPermitUnknownAIs(ctx, true));
+	TEST_CHECK(gs1_encoder_setPermitZeroSuppressedGTINinDLuris(ctx, true));
+	TEST_CHECK(gs1_encoder_setIncludeDataTitlesInHRI(ctx, true));
+	TEST_CHECK(gs1_encoder_setValidationEnabled(ctx, gs1_encoder_vREQUISITE_AIS, false));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)09521234543213(10)ABC"));
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(01)12345678901234"));
+
+	gs1_encoder_reset(ctx);
+
+	TEST_CHECK(gs1_encoder_getSym(ctx) == gs1_encoder_sNONE);
+	TEST_CHECK(!gs1_encoder_getAddCheckDigit(ctx));
+	TEST_CHECK(!gs1_encoder_getPermitUnknownAIs(ctx));
+	TEST_CHECK(!gs1_encoder_getPermitZeroSuppressedGTINinDLuris(ctx));
+	TEST_CHECK(!gs1_encoder_getIncludeDataTitlesInHRI(ctx));
+	TEST_CHECK(gs1_encoder_getValidationEnabled(ctx, gs1_encoder_vREQUISITE_AIS));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "") == 0);
+	TEST_CHECK(ctx->numAIs == 0);
+	TEST_CHECK(*gs1_encoder_getErrMsg(ctx) == '\0');
+	TEST_CHECK(ctx->aiTable == aiTable);
+
+	// Still usable
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(10)ABC"));		// Requisite AIs are validated again
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)09521234543213(10)ABC"));
+
+	gs1_encoder_free(ctx);
+
+}
+
+
 void test_api_sym(void) {
 
 	gs1_encoder* ctx;
@@ -1888,6 +3036,79 @@ void test_api_setScanData(void) {
 }
 
 
+void test_api_setters_lengthDelimited(void) {
+
+	gs1_encoder *ctx;
+	char longIn[2 * MAX_DATA + 2];
+
+	TEST_ASSERT((ctx = gs1_encoder_unit_test_init()) != NULL);
+	assert(ctx);
+
+	// Only the given length is read
+	TEST_CHECK(gs1_encoder_setAIdataStrN(ctx, "(01)12312312312333(10)ABC123XXX", 28));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^011231231231233310ABC123") == 0);
+
+	TEST_CHECK(gs1_encoder_setDataStrN(ctx, "^0112312312312333|^99XYZ...", 24));
+	TEST_CHECK(strcmp(gs1_encoder_getAIdataStr(ctx), "(01)12312312312333|(99)XYZ") == 0);
+
+	TEST_CHECK(gs1_encoder_setDataStrN(ctx, "https://id.gs1.org/01/12312312312333/10/ABC", 41));
+	TEST_CHECK(strcmp(gs1_encoder_getAIdataStr(ctx), "(01)12312312312333(10)A") == 0);
+
+	TEST_CHECK(gs1_encoder_setScanDataN(ctx, "]Q3011231231231233310ABC123", 24));
+	TEST_CHECK(strcmp(gs1_encoder_getAIdataStr(ctx), "(01)12312312312333(10)ABC") == 0);
+
+	// Input may refer into the library's own buffers
+	TEST_CHECK(gs1_encoder_setAIdataStrN(ctx, gs1_encoder_getAIdataStr(ctx), 18));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^0112312312312333") == 0);
+	TEST_CHECK(gs1_encoder_setDataStrN(ctx, gs1_encoder_getDataStr(ctx) + 1, 10));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "0112312312") == 0);
+
+	// Composite input is not modified in place
+	TEST_CHECK(gs1_encoder_setAIdataStrN(ctx, "(01)12312312312333|(99)XYZ", 26));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^0112312312312333|^99XYZ") == 0);
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)12312312312333(10)AB\\(C|(99)XYZ"));	// Read-only literal
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^011231231231233310AB(C|^99XYZ") == 0);
+
+	// Spans end before the separator or within an escape
+	TEST_CHECK(gs1_encoder_setAIdataStrN(ctx, "(01)12312312312333|(99)XYZ", 18));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^0112312312312333") == 0);
+	TEST_CHECK(gs1_encoder_setAIdataStrN(ctx, "(99)AB\\(C", 8));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^99AB(") == 0);
+	TEST_CHECK(!gs1_encoder_setAIdataStrN(ctx, "(01)12312312312333", 3));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Failed to parse AI data") == 0);
+	TEST_CHECK(!gs1_encoder_setAIdataStrN(ctx, "(01)12312312312333|(99)XYZ", 19));
+	TEST_CHECK(!gs1_encoder_setAIdataStrN(ctx, "(99)XYZ", 4));
+
+	// Input that is a view of the data being written
+	TEST_CHECK(gs1_encoder_setDataStr(ctx, "(01)12312312312333(99)XYZ"));
+	TEST_CHECK(gs1_encoder_setAIdataStrN(ctx, gs1_encoder_getDataStr(ctx), 25));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^011231231231233399XYZ") == 0);
+	TEST_CHECK(gs1_encoder_setDataStr(ctx, "(01)12312312312333"));
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, gs1_encoder_getDataStr(ctx)));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^0112312312312333") == 0);
+
+	TEST_CHECK(gs1_encoder_setDataStrN(ctx, NULL, 0));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "") == 0);
+
+	// Rejections
+	TEST_CHECK(!gs1_encoder_setAIdataStrN(ctx, "(01)12312312312334", 18));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "AI (01): The numeric check digit is incorrect.") == 0);
+
+	TEST_CHECK(!gs1_encoder_setAIdataStrN(ctx, "(01)12312312312333\0(99)X", 24));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Input contains a NUL character") == 0);
+
+	memset(longIn, 'A', sizeof(longIn));
+	TEST_CHECK(!gs1_encoder_setDataStrN(ctx, longIn, MAX_DATA + 1));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Maximum data length is 8191 characters") == 0);
+	TEST_CHECK(!gs1_encoder_setAIdataStrN(ctx, longIn, sizeof(longIn)));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Maximum data length is 8191 characters") == 0);
+	TEST_CHECK(!gs1_encoder_setScanDataN(ctx, longIn, sizeof(longIn)));
+
+	gs1_encoder_free(ctx);
+
+}
+
+
 void test_api_getHRI(void) {
 
 	gs1_encoder* ctx;
@@ -2182,6 +3403,620 @@ DIAG_POP
 }
 
 
+void test_api_getAIelements(void) {
+
+	gs1_encoder* ctx;
+	int numAIs;
+	const gs1_encoder_ai_element_t *el;
+	char **hri;
+	char buf[64];
+
+	TEST_ASSERT((ctx = gs1_encoder_unit_test_init()) != NULL);
+	assert(ctx);
+
+	// No input
+	TEST_ASSERT((numAIs = gs1_encoder_getAIelements(ctx, &el)) == 0);
+	TEST_ASSERT(el != NULL);
+
+	// Composite separator is omitted
+	strcpy(buf, "(01)12312312312333(10)ABC123|(99)COMPOSITE");
+	TEST_ASSERT(gs1_encoder_setAIdataStr(ctx, buf));
+	TEST_ASSERT((numAIs = gs1_encoder_getAIelements(ctx, &el)) == 3);
+	assert(el);
+	TEST_CHECK(el[0].aiLen == 2 && memcmp(el[0].ai, "01", 2) == 0);
+	TEST_CHECK(el[0].valueLen == 14 && memcmp(el[0].value, "12312312312333", 14) == 0);
+	TEST_CHECK(el[1].aiLen == 2 && memcmp(el[1].ai, "10", 2) == 0);
+	TEST_CHECK(el[1].valueLen == 6 && memcmp(el[1].value, "ABC123", 6) == 0);
+	TEST_CHECK(el[2].aiLen == 2 && memcmp(el[2].ai, "99", 2) == 0);
+	TEST_CHECK(el[2].valueLen == 9 && memcmp(el[2].value, "COMPOSITE", 9) == 0);
+
+	// Not invalidated by rendering into the output buffer
+	TEST_ASSERT(gs1_encoder_getHRI(ctx, &hri) == 3);
+	TEST_CHECK(el[2].valueLen == 9 && memcmp(el[2].value, "COMPOSITE", 9) == 0);
+
+	// Ignored DL URI query parameters are omitted
+	TEST_ASSERT(gs1_encoder_setDataStr(ctx, "https://a/01/12312312312333/22/TESTING?singleton&99=ABC%2d123&compound=X"));
+	TEST_ASSERT((numAIs = gs1_encoder_getAIelements(ctx, &el)) == 3);
+	TEST_CHECK(el[0].aiLen == 2 && memcmp(el[0].ai, "01", 2) == 0);
+	TEST_CHECK(el[1].aiLen == 2 && memcmp(el[1].ai, "22", 2) == 0);
+	TEST_CHECK(el[1].valueLen == 7 && memcmp(el[1].value, "TESTING", 7) == 0);
+	TEST_CHECK(el[2].aiLen == 2 && memcmp(el[2].ai, "99", 2) == 0);
+	TEST_CHECK(el[2].valueLen == 7 && memcmp(el[2].value, "ABC-123", 7) == 0);
+
+	// Four-digit AI from scan data
+	TEST_ASSERT(gs1_encoder_setScanData(ctx, "]Q3011231231231233331030001892110ABC"));
+	TEST_ASSERT((numAIs = gs1_encoder_getAIelements(ctx, &el)) == 3);
+	TEST_CHECK(el[1].aiLen == 4 && memcmp(el[1].ai, "3103", 4) == 0);
+	TEST_CHECK(el[1].valueLen == 6 && memcmp(el[1].value, "000189", 6) == 0);
+	TEST_CHECK(el[2].aiLen == 2 && memcmp(el[2].ai, "21", 2) == 0);
+	TEST_CHECK(el[2].valueLen == 5 && memcmp(el[2].value, "10ABC", 5) == 0);
+
+	// Non-AI data
+	TEST_ASSERT(gs1_encoder_setDataStr(ctx, "TESTING"));
+	TEST_ASSERT((numAIs = gs1_encoder_getAIelements(ctx, &el)) == 0);
+
+	gs1_encoder_free(ctx);
+
+}
+
+
+void test_api_label(void) {
+
+	gs1_encoder* ctx;
+	char **hri;
+	int i;
+
+	TEST_ASSERT((ctx = gs1_encoder_unit_test_init()) != NULL);
+	assert(ctx);
+
+	// Reads of the symbols of a label, with repeats
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]E09501101530003"));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "9501101530003") == 0);
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]C110ABC123" "\x1D" "11210630"));
+	TEST_CHECK(strcmp(gs1_encoder_getAIdataStr(ctx), "(10)ABC123(11)210630") == 0);	// The read alone
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]E09501101530003"));
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]C111210630" "10ABC123"));
+	TEST_CHECK(ctx->numLabelAIs == 3);
+	TEST_CHECK(gs1_encoder_labelFinish(ctx));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^010950110153000310ABC123^11210630") == 0);
+	TEST_CHECK(strcmp(gs1_encoder_getAIdataStr(ctx), "(01)09501101530003(10)ABC123(11)210630") == 0);
+	TEST_CHECK(gs1_encoder_getHRI(ctx, &hri) == 3);
+	TEST_CHECK(strcmp(gs1_encoder_getDLuri(ctx, NULL), "https://id.gs1.org/01/09501101530003/10/ABC123?11=210630") == 0);
+	TEST_CHECK(gs1_encoder_getSym(ctx) == gs1_encoder_sNONE);
+
+	// A new label is begun
+	TEST_CHECK(ctx->numLabelAIs == 0);
+	TEST_CHECK(!gs1_encoder_labelFinish(ctx));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "The AI data is empty") == 0);
+
+	// Composite and DL URI reads
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]E09501101530003|]e010ABC123"));
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]Q1https://id.gs1.org/01/09501101530003/10/ABC123?99=XYZ"));
+	TEST_CHECK(gs1_encoder_labelFinish(ctx));
+	TEST_CHECK(strcmp(gs1_encoder_getAIdataStr(ctx), "(01)09501101530003(10)ABC123(99)XYZ") == 0);
+
+	// Conflicts are reported as they arrive, leaving the label unchanged
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]C10109501101530003"));
+	TEST_CHECK(!gs1_encoder_labelAddScanData(ctx, "]C110XYZ" "\x1D" "0112312312312333"));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Multiple instances of AI (01) have different values") == 0);
+	TEST_CHECK(*gs1_encoder_getDataStr(ctx) == '\0');
+	TEST_CHECK(!gs1_encoder_labelAddScanData(ctx, "]C110ABC" "\x1D" "10XYZ"));	// Within a read
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Multiple instances of AI (10) have different values") == 0);
+	TEST_CHECK(ctx->numLabelAIs == 1);
+
+	// Other failed reads
+	TEST_CHECK(!gs1_encoder_labelAddScanData(ctx, "]E09501101530004"));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Primary message check digit is incorrect") == 0);
+	TEST_CHECK(!gs1_encoder_labelAddScanData(ctx, "]d1TESTING"));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Scan data does not contain GS1 AI data") == 0);
+	TEST_CHECK(ctx->numLabelAIs == 1);
+
+	// The association validations apply to the label, not each read
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]C121ABC123"));	// (21) requires (01), from another read
+	TEST_CHECK(gs1_encoder_labelFinish(ctx));
+
+	gs1_encoder_labelBegin(ctx);
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]C121ABC123"));
+	TEST_CHECK(!gs1_encoder_labelFinish(ctx));
+	TEST_CHECK(strncmp(gs1_encoder_getErrMsg(ctx), "Required AIs for AI (21) are not satisfied", 42) == 0);
+	TEST_CHECK(*gs1_encoder_getDataStr(ctx) == '\0');
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]E09501101530003"));	// Label is kept
+	TEST_CHECK(gs1_encoder_labelFinish(ctx));
+	TEST_CHECK(strcmp(gs1_encoder_getAIdataStr(ctx), "(21)ABC123(01)09501101530003") == 0);
+
+	// Capacity
+	gs1_encoder_labelBegin(ctx);
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]C191X"));
+	for (i = 1; i < MAX_AIS; i++)
+		ctx->labelAIs[i] = ctx->labelAIs[0];
+	ctx->numLabelAIs = MAX_AIS;
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]C191X"));
+	TEST_CHECK(!gs1_encoder_labelAddScanData(ctx, "]C199X"));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Too many AIs") == 0);
+	ctx->numLabelAIs = 1;
+	ctx->labelLen = MAX_DATA - 3;
+	TEST_CHECK(!gs1_encoder_labelAddScanData(ctx, "]C199X"));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Maximum data length is 8191 characters") == 0);
+	ctx->labelLen = MAX_DATA - 4;
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]C199X"));		// "^99X" fills the label
+	gs1_encoder_labelBegin(ctx);
+
+	// Abandoning a label
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]C121ABC123"));
+	gs1_encoder_labelBegin(ctx);
+	TEST_CHECK(gs1_encoder_labelAddScanData(ctx, "]C121XYZ"));
+	TEST_CHECK(ctx->numLabelAIs == 1);
+	gs1_encoder_reset(ctx);
+	TEST_CHECK(ctx->numLabelAIs == 0);
+
+	gs1_encoder_free(ctx);
+
+}
+
+
+void test_api_scanStream(void) {
+
+	static const char* const scanData[] = {
+		"]C1011231231231233310ABC123" "\x1D" "99TESTING",
+		"]e0011231231231233310ABC123" "\x1D" "99TESTING",
+		"]d2011231231231233310ABC123",
+		"]Q3011231231231233310ABC123" "\x1D",
+		"]E09501101530003",
+		"]E09501101530003|]e010ABC123",
+		"]E40123456700051",
+		"]d1TESTING",
+		"]Q1https://id.gs1.org/01/09501101530003/10/ABC123",
+		"]C1",
+		"]C1011231231231233410ABC123",	// Bad check digit
+		"]C10112312312312333^10ABC123",	// Illegal "^"
+		"]C121ABC123",			// Requisite AIs
+		"]E09501101530004",
+		"]X1TESTING",
+		"]C",
+		"TESTING",
+	};
+
+	gs1_encoder* ctx;
+	char expectDataStr[MAX_DATA+1];
+	char expectErrMsg[sizeof(ctx->errMsg)];
+	char in[MAX_DATA+16];
+	gs1_encoder_symbologies_t expectSym;
+	bool expectOk;
+	size_t i, j, len, consumed;
+	int chunk;
+
+	TEST_ASSERT((ctx = gs1_encoder_unit_test_init()) != NULL);
+	assert(ctx);
+
+	/*
+	 *  Same result as gs1_encoder_setScanData(), whether fed whole or one
+	 *  byte at a time
+	 *
+	 */
+	for (i = 0; i < SIZEOF_ARRAY(scanData); i++) {
+
+		expectOk = gs1_encoder_setScanData(ctx, scanData[i]);
+		strcpy(expectDataStr, gs1_encoder_getDataStr(ctx));
+		strcpy(expectErrMsg, gs1_encoder_getErrMsg(ctx));
+		expectSym = gs1_encoder_getSym(ctx);
+
+		len = (size_t)snprintf(in, sizeof(in), "%s\r\n", scanData[i]);
+
+		for (chunk = 0; chunk < 2; chunk++) {
+
+			gs1_encoder_feed_status_t status = gs1_encoder_fNEED_MORE;
+
+			TEST_CASE_("%s, %s", scanData[i], chunk == 0 ? "whole" : "bytewise");
+
+			TEST_CHECK(gs1_encoder_setDataStr(ctx, "STALE"));
+			if (chunk == 0) {
+				status = gs1_encoder_feedScanStream(ctx, in, len, &consumed);
+				TEST_CHECK(consumed == len - 1);		// Up to CR
+			} else {
+				for (j = 0; j < len - 2; j++) {
+					TEST_CHECK(gs1_encoder_feedScanStream(ctx, in + j, 1, &consumed) == gs1_encoder_fNEED_MORE);
+					TEST_CHECK(consumed == 1);
+				}
+				TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "STALE") == 0);
+				status = gs1_encoder_feedScanStream(ctx, in + j, 1, &consumed);
+			}
+			TEST_CHECK(status == (expectOk ? gs1_encoder_fMESSAGE : gs1_encoder_fERROR));
+			TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), expectDataStr) == 0);
+			TEST_MSG("Got: %s; Expected: %s", gs1_encoder_getDataStr(ctx), expectDataStr);
+			TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), expectErrMsg) == 0);
+			TEST_MSG("Got: %s; Expected: %s", gs1_encoder_getErrMsg(ctx), expectErrMsg);
+			TEST_CHECK(gs1_encoder_getSym(ctx) == expectSym);
+
+			// The LF of the CR LF pair is an empty line
+			TEST_CHECK(gs1_encoder_feedScanStream(ctx, in + len - 1, 1, &consumed) == gs1_encoder_fNEED_MORE);
+			TEST_CHECK(consumed == 1);
+			TEST_CHECK(gs1_encoder_flushScanStream(ctx) == gs1_encoder_fNEED_MORE);
+
+		}
+
+	}
+	TEST_CASE(NULL);
+
+	// Several symbols in one chunk
+	strcpy(in, "\n]C10112312312312333\n\n]d2" "10ABC\r]d1XYZ");
+	len = strlen(in);
+	TEST_CHECK(gs1_encoder_feedScanStream(ctx, in, len, &consumed) == gs1_encoder_fMESSAGE);
+	TEST_CHECK(consumed == 21);
+	TEST_CHECK(strcmp(gs1_encoder_getAIdataStr(ctx), "(01)12312312312333") == 0);
+	TEST_CHECK(gs1_encoder_feedScanStream(ctx, in + 21, len - 21, &consumed) == gs1_encoder_fERROR);	// (10) requires (01)
+	TEST_CHECK(consumed == 10);
+	TEST_CHECK(strncmp(gs1_encoder_getErrMsg(ctx), "Required AIs for AI (10)", 24) == 0);
+	TEST_CHECK(gs1_encoder_feedScanStream(ctx, in + 31, len - 31, &consumed) == gs1_encoder_fNEED_MORE);
+	TEST_CHECK(consumed == len - 31);
+	TEST_CHECK(gs1_encoder_flushScanStream(ctx) == gs1_encoder_fMESSAGE);	// No terminator
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "XYZ") == 0);
+	TEST_CHECK(gs1_encoder_getSym(ctx) == gs1_encoder_sDM);
+
+	// Errors in the stream discard the rest of the symbol
+	TEST_CHECK(gs1_encoder_feedScanStream(ctx, "]C10112312312312333\0XYZ\n", 24, &consumed) == gs1_encoder_fERROR);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Input contains a NUL character") == 0);
+	TEST_CHECK(consumed == 24);
+	memset(in, 'A', sizeof(in));
+	memcpy(in, "]C199", 5);
+	TEST_CHECK(gs1_encoder_feedScanStream(ctx, in, MAX_DATA + 3, &consumed) == gs1_encoder_fNEED_MORE);
+	TEST_CHECK(gs1_encoder_feedScanStream(ctx, "\n", 1, &consumed) == gs1_encoder_fERROR);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Maximum data length is 8190 characters") == 0);
+	memcpy(in, "]d1", 3);
+	TEST_CHECK(gs1_encoder_feedScanStream(ctx, in, MAX_DATA + 3, &consumed) == gs1_encoder_fNEED_MORE);
+	TEST_CHECK(gs1_encoder_flushScanStream(ctx) == gs1_encoder_fERROR);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Maximum data length is 8190 characters") == 0);
+	TEST_CHECK(gs1_encoder_feedScanStream(ctx, in, MAX_DATA + 2, &consumed) == gs1_encoder_fNEED_MORE);
+	TEST_CHECK(gs1_encoder_flushScanStream(ctx) == gs1_encoder_fMESSAGE);		// Longest
+	TEST_CHECK(strlen(gs1_encoder_getDataStr(ctx)) == MAX_DATA - 1);
+
+	// Reset discards a partly received symbol
+	TEST_CHECK(gs1_encoder_feedScanStream(ctx, "]C10112", 7, &consumed) == gs1_encoder_fNEED_MORE);
+	gs1_encoder_resetScanStream(ctx);
+	TEST_CHECK(gs1_encoder_flushScanStream(ctx) == gs1_encoder_fNEED_MORE);
+	TEST_CHECK(gs1_encoder_feedScanStream(ctx, "]C10112", 7, &consumed) == gs1_encoder_fNEED_MORE);
+	gs1_encoder_reset(ctx);
+	TEST_CHECK(gs1_encoder_flushScanStream(ctx) == gs1_encoder_fNEED_MORE);
+	TEST_CHECK(gs1_encoder_feedScanStream(ctx, NULL, 0, &consumed) == gs1_encoder_fNEED_MORE);
+	TEST_CHECK(consumed == 0);
+
+	gs1_encoder_free(ctx);
+
+}
+
+
+void test_api_render(void) {
+
+	gs1_encoder* ctx;
+	char buf[256], expect[256];
+	const char *out;
+	size_t len;
+	char **hri;
+	int i, numhri;
+
+	TEST_ASSERT((ctx = gs1_encoder_unit_test_init()) != NULL);
+	assert(ctx);
+
+	TEST_ASSERT(gs1_encoder_setSym(ctx, gs1_encoder_sGS1_128_CCA));
+	TEST_ASSERT(gs1_encoder_setIncludeDataTitlesInHRI(ctx, true));
+	strcpy(expect, "(01)12312312312333(10)ABC\\(123|(99)COMPOSITE");
+	TEST_ASSERT(gs1_encoder_setAIdataStr(ctx, expect));
+
+	/*
+	 *  The context is untouched: the output buffer, error state and input
+	 *  data (whose composite delimiter the scan data getter once replaced)
+	 *
+	 */
+	strcpy(ctx->outStr, "UNTOUCHED");
+	strcpy(ctx->errMsg, "UNTOUCHED");
+	ctx->err = gs1_encoder_eAI_PARSE_FAILED;
+
+	TEST_CHECK(gs1_encoder_renderDataStr(ctx, buf, sizeof(buf)));
+	TEST_CHECK(strcmp(buf, "^011231231231233310ABC(123|^99COMPOSITE") == 0);
+	TEST_CHECK(gs1_encoder_renderAIdataStr(ctx, buf, sizeof(buf)));
+	TEST_CHECK(strcmp(buf, "(01)12312312312333(10)ABC\\(123|(99)COMPOSITE") == 0);
+	TEST_CHECK(gs1_encoder_renderDLuri(ctx, "https://example.com/", buf, sizeof(buf)));
+	TEST_CHECK(strcmp(buf, "https://example.com/01/12312312312333/10/ABC%28123?99=COMPOSITE") == 0);
+	TEST_CHECK(gs1_encoder_renderScanData(ctx, buf, sizeof(buf)));
+	TEST_CHECK(strcmp(buf, "]e0011231231231233310ABC(123" "\x1D" "99COMPOSITE") == 0);
+	TEST_CHECK(gs1_encoder_renderHRI(ctx, buf, sizeof(buf)));
+	TEST_CHECK(strcmp(buf, "GTIN (01) 12312312312333|BATCH/LOT (10) ABC(123|INTERNAL (99) COMPOSITE") == 0);
+
+	TEST_CHECK(strcmp(ctx->outStr, "UNTOUCHED") == 0);
+	TEST_CHECK(strcmp(ctx->errMsg, "UNTOUCHED") == 0);
+	TEST_CHECK(ctx->err == gs1_encoder_eAI_PARSE_FAILED);
+	TEST_CHECK(strcmp(ctx->dataStr, "^011231231231233310ABC(123|^99COMPOSITE") == 0);
+
+	// Same output as the getters
+	TEST_CHECK(gs1_encoder_renderScanData(ctx, buf, sizeof(buf)));
+	TEST_ASSERT((out = gs1_encoder_getScanData(ctx)) != NULL);
+	TEST_CHECK(strcmp(buf, out) == 0);
+	TEST_CHECK(gs1_encoder_renderAIdataStr(ctx, buf, sizeof(buf)));
+	TEST_ASSERT((out = gs1_encoder_getAIdataStr(ctx)) != NULL);
+	TEST_CHECK(strcmp(buf, out) == 0);
+	TEST_CHECK(gs1_encoder_renderDLuri(ctx, NULL, buf, sizeof(buf)));
+	TEST_ASSERT((out = gs1_encoder_getDLuri(ctx, NULL)) != NULL);
+	TEST_CHECK(strcmp(buf, out) == 0);
+	TEST_CHECK(gs1_encoder_renderHRI(ctx, buf, sizeof(buf)));
+	numhri = gs1_encoder_getHRI(ctx, &hri);
+	TEST_ASSERT(numhri == 3);
+	*expect = '\0';
+	for (i = 0; i < numhri; i++) {
+		if (i > 0)
+			strcat(expect, "|");
+		strcat(expect, hri[i]);
+	}
+	TEST_CHECK(strcmp(buf, expect) == 0);
+
+	/*
+	 *  A buffer that is too small fails with the error message, truncated,
+	 *  rather than truncating the output
+	 *
+	 */
+	TEST_ASSERT(gs1_encoder_renderDLuri(ctx, NULL, buf, sizeof(buf)));
+	len = strlen(buf);
+	TEST_CHECK(gs1_encoder_renderDLuri(ctx, NULL, buf, len + 1));
+	TEST_CHECK(!gs1_encoder_renderDLuri(ctx, NULL, buf, len));
+	TEST_CHECK(strncmp(buf, "Generated DL URI is too long", len - 1) == 0);
+
+#define test_renderFits(fn) do {								\
+	TEST_ASSERT(fn(ctx, buf, sizeof(buf)));							\
+	len = strlen(buf);									\
+	TEST_CHECK(fn(ctx, buf, len + 1));							\
+	TEST_CHECK(!fn(ctx, buf, len));								\
+	TEST_CHECK(strlen(buf) < len);								\
+} while (0)
+	test_renderFits(gs1_encoder_renderDataStr);
+	test_renderFits(gs1_encoder_renderAIdataStr);		// Exact length with an escaped "("
+	test_renderFits(gs1_encoder_renderScanData);
+	test_renderFits(gs1_encoder_renderHRI);
+#undef test_renderFits
+
+	TEST_CHECK(!gs1_encoder_renderHRI(ctx, buf, 10));
+	TEST_CHECK(strcmp(buf, "Output bu") == 0);
+	TEST_CHECK(!gs1_encoder_renderHRI(ctx, NULL, 0));
+	TEST_CHECK(!gs1_encoder_renderDLuri(ctx, NULL, NULL, 0));
+	TEST_CHECK(!gs1_encoder_renderScanData(ctx, NULL, 0));
+	TEST_CHECK(!gs1_encoder_renderAIdataStr(ctx, NULL, 0));
+
+	// Errors are reported in the buffer
+	TEST_ASSERT(gs1_encoder_setAIdataStr(ctx, "(99)COMPOSITE"));
+	TEST_CHECK(!gs1_encoder_renderDLuri(ctx, NULL, buf, sizeof(buf)));
+	TEST_CHECK(strcmp(buf, "Cannot create a DL URI without a primary key AI") == 0);
+	TEST_ASSERT(gs1_encoder_setSym(ctx, gs1_encoder_sNONE));
+	TEST_CHECK(!gs1_encoder_renderScanData(ctx, buf, sizeof(buf)));
+	TEST_CHECK(strcmp(buf, "No symbology selected") == 0);
+	TEST_CHECK(*gs1_encoder_getErrMsg(ctx) == '\0');
+
+	// Non-AI data
+	TEST_ASSERT(gs1_encoder_setDataStr(ctx, "TESTING"));
+	TEST_CHECK(gs1_encoder_renderAIdataStr(ctx, buf, sizeof(buf)));
+	TEST_CHECK(*buf == '\0');
+	TEST_CHECK(gs1_encoder_renderHRI(ctx, buf, sizeof(buf)));
+	TEST_CHECK(*buf == '\0');
+
+	gs1_encoder_free(ctx);
+
+}
+
+
+void test_api_serialisedMessage(void) {
+
+	gs1_encoder *ctx, *ctx2;
+	uint8_t buf[GS1_ENCODERS_MAX_SERIALISED_MESSAGE_LEN], bad[GS1_ENCODERS_MAX_SERIALISED_MESSAGE_LEN];
+	char dlURI[256];
+	char **qp;
+	size_t len;
+
+	TEST_ASSERT((ctx = gs1_encoder_unit_test_init()) != NULL);
+	assert(ctx);
+	TEST_ASSERT((ctx2 = gs1_encoder_unit_test_init()) != NULL);
+	assert(ctx2);
+
+	// AI element string with a composite component
+	TEST_ASSERT(gs1_encoder_setDataStr(ctx, "^011231231231233310ABC123|^99XYZ"));
+	TEST_CHECK((len = gs1_encoder_getSerialisedMessage(ctx, buf, sizeof(buf))) == 54);
+	TEST_CHECK(memcmp(buf, "G1\x01", 3) == 0);
+	TEST_CHECK(buf[11] == 4);						// (01), (10), separator, (99)
+	TEST_CHECK(memcmp(buf + 12, "\x02\x01\x00", 3) == 0);			// (01)
+	TEST_CHECK(memcmp(buf + 17, "\x0e" "12312312312333", 15) == 0);
+	TEST_CHECK(buf[44] == 0);						// Separator
+	TEST_CHECK(gs1_encoder_setSerialisedMessage(ctx2, buf, len));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx2), "^011231231231233310ABC123|^99XYZ") == 0);
+	TEST_CHECK(strcmp(gs1_encoder_getAIdataStr(ctx2), "(01)12312312312333(10)ABC123|(99)XYZ") == 0);
+	TEST_CHECK(ctx2->numSortedAIs == 3);
+
+	// Output buffer must fit the whole message
+	TEST_CHECK(gs1_encoder_getSerialisedMessage(ctx, buf, len - 1) == 0);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Output buffer is too small") == 0);
+	TEST_CHECK(gs1_encoder_getSerialisedMessage(ctx, buf, 11) == 0);
+	TEST_CHECK(gs1_encoder_getSerialisedMessage(ctx, buf, len) == len);
+
+	// The path order of a GS1 DL URI is retained
+	TEST_ASSERT(gs1_encoder_setDataStr(ctx, "https://example.com/01/09521234543213/10/DEF/21/GHI?99=XYZ&singleton"));
+	strcpy(dlURI, gs1_encoder_getDLuri(ctx, NULL));
+	TEST_CHECK(strcmp(dlURI, "https://id.gs1.org/01/09521234543213/10/DEF/21/GHI?99=XYZ") == 0);
+	TEST_ASSERT((len = gs1_encoder_getSerialisedMessage(ctx, buf, sizeof(buf))) > 0);
+	TEST_CHECK(gs1_encoder_setSerialisedMessage(ctx2, buf, len));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx2), "^010952123454321310DEF^21GHI^99XYZ") == 0);
+	TEST_CHECK(ctx2->aiData[2].dlPathOrder == 2 && ctx2->aiData[3].dlPathOrder == DL_PATH_ORDER_ATTRIBUTE);
+	TEST_CHECK(strcmp(gs1_encoder_getDLuri(ctx2, NULL), dlURI) == 0);
+	TEST_CHECK(gs1_encoder_getDLignoredQueryParams(ctx2, &qp) == 0);
+
+	// Otherwise validated afresh, without the path order
+	TEST_ASSERT(gs1_encoder_setPermitUnknownAIs(ctx2, true));
+	TEST_CHECK(gs1_encoder_setSerialisedMessage(ctx2, buf, len));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx2), "^010952123454321310DEF^21GHI^99XYZ") == 0);
+	TEST_CHECK(ctx2->aiData[2].dlPathOrder == DL_PATH_ORDER_ATTRIBUTE);
+	TEST_CHECK(strcmp(gs1_encoder_getDLuri(ctx2, NULL), dlURI) == 0);
+
+	// Content is only validated afresh
+	TEST_ASSERT(gs1_encoder_setDataStr(ctx, "^0112312312312333"));
+	TEST_ASSERT((len = gs1_encoder_getSerialisedMessage(ctx, buf, sizeof(buf))) > 0);
+	buf[len - 1] = '4';							// Bad check digit
+	TEST_CHECK(!gs1_encoder_setSerialisedMessage(ctx2, buf, len));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx2), "AI (01): The numeric check digit is incorrect.") == 0);
+	TEST_CHECK(*gs1_encoder_getDataStr(ctx2) == '\0');
+	TEST_CHECK(gs1_encoder_setSerialisedMessage(ctx, buf, len));		// Trusted
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^0112312312312334") == 0);
+
+	// Unrecognised AIs are validated afresh, to be reported
+	TEST_ASSERT(gs1_encoder_setAIdataStr(ctx2, "(89)ABC"));
+	TEST_ASSERT((len = gs1_encoder_getSerialisedMessage(ctx2, buf, sizeof(buf))) > 0);
+	TEST_CHECK(!gs1_encoder_setSerialisedMessage(ctx, buf, len));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "No known AI is a prefix of: 89AB...") == 0);
+
+	// Only AI data can be serialised
+	TEST_ASSERT(gs1_encoder_setDataStr(ctx, "TESTING"));
+	TEST_CHECK(gs1_encoder_getSerialisedMessage(ctx, buf, sizeof(buf)) == 0);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "The message does not consist of GS1 AI data") == 0);
+	TEST_ASSERT(gs1_encoder_setDataStr(ctx, "TESTING|^99XYZ"));
+	TEST_CHECK(gs1_encoder_getSerialisedMessage(ctx, buf, sizeof(buf)) == 0);
+
+	// Malformed
+	TEST_ASSERT(gs1_encoder_setDataStr(ctx, "https://id.gs1.org/01/09521234543213/10/DEF"));
+	TEST_ASSERT((len = gs1_encoder_getSerialisedMessage(ctx, buf, sizeof(buf))) == 43);
+	TEST_CHECK(buf[12] == (0x80 | 2) && buf[15] == 0);			// (01) is path component 0
+	TEST_CHECK(gs1_encoder_setSerialisedMessage(ctx, buf, len));
+	memcpy(bad, buf, len);
+	bad[16] = bad[17] = 0xff;						// Entries are looked up if not given...
+	TEST_CHECK(gs1_encoder_setSerialisedMessage(ctx, bad, len));
+	TEST_CHECK(strcmp(ctx->aiData[0].aiEntry->ai, "01") == 0);
+	bad[16]++;								// ... or mismatched
+	TEST_CHECK(gs1_encoder_setSerialisedMessage(ctx, bad, len));
+	TEST_CHECK(strcmp(ctx->aiData[0].aiEntry->ai, "01") == 0);
+
+#define test_malformed(n, ...) do {								\
+	memcpy(bad, buf, len);									\
+	__VA_ARGS__;										\
+	TEST_CHECK(!gs1_encoder_setSerialisedMessage(ctx, bad, n));				\
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Serialised message is malformed") == 0);	\
+	TEST_CHECK(*gs1_encoder_getDataStr(ctx) == '\0');					\
+} while (0)
+
+	test_malformed(0, (void)0);
+	test_malformed(11, (void)0);						// Short header
+	test_malformed(len, bad[0] = 'X');					// Magic
+	test_malformed(len, bad[2] = 2);					// Version
+	test_malformed(len - 1, (void)0);					// Truncated
+	test_malformed(len, bad[11]++);						// Count exceeds entries
+	test_malformed(len, bad[12] = 5);					// AI length
+	test_malformed(len, bad[13] = 0x10; bad[14] = 0x27);			// 10000 is more than 4 digits
+	test_malformed(len, bad[15] = 1);					// Duplicate path order
+	test_malformed(len, bad[15] = 2);					// Path order beyond entries
+	test_malformed(len, bad[18] = 0);					// Empty value
+	test_malformed(len, bad[22] = '^');					// Value contains FNC1
+	test_malformed(len, bad[22] = '|');
+	test_malformed(len, bad[11]--; bad[len - 1] = 0; bad[len - 2] = 0);	// Trailing data
+	test_malformed(len + 1, bad[11]++; bad[len] = 0);			// Trailing separator
+	test_malformed(13, bad[11] = 1; bad[12] = 0);				// Only a separator
+	test_malformed(len + 2, bad[11] += 2; bad[33] = bad[34] = 0;		// Second separator
+		       memcpy(bad + 35, buf + 33, len - 33));
+	test_malformed(len - 1, bad[18] = 13; memcpy(bad + 32, buf + 33, len - 33));	// Fixed-length AI too short
+	test_malformed(len + 18, bad[39] = 21; memset(bad + 43, 'X', 18));	// Variable-length AI too long
+
+#undef test_malformed
+
+	buf[11] = 0;
+	TEST_CHECK(!gs1_encoder_setSerialisedMessage(ctx, buf, 12));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "The AI data is empty") == 0);
+	buf[11] = MAX_AIS + 1;
+	TEST_CHECK(!gs1_encoder_setSerialisedMessage(ctx, buf, 12));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Too many AIs") == 0);
+
+	gs1_encoder_free(ctx2);
+	gs1_encoder_free(ctx);
+
+}
+
+
+void test_api_messageFingerprint(void) {
+
+	gs1_encoder* ctx;
+	uint8_t buf[GS1_ENCODERS_MAX_SERIALISED_MESSAGE_LEN];
+	uint64_t expect[2], fp[2];
+	size_t len;
+
+	TEST_ASSERT((ctx = gs1_encoder_unit_test_init()) != NULL);
+	assert(ctx);
+
+	TEST_ASSERT(gs1_encoder_setAIdataStr(ctx, "(01)09521234543213(3103)000195(10)ABC(99)XYZ"));
+	TEST_ASSERT(gs1_encoder_getMessageFingerprint(ctx, expect));
+	TEST_CHECK(expect[0] != expect[1]);
+
+#define test_sameFingerprint(f, s, same) do {					\
+	TEST_ASSERT(f(ctx, s));							\
+	TEST_ASSERT(gs1_encoder_getMessageFingerprint(ctx, fp));		\
+	TEST_CHECK((fp[0] == expect[0] && fp[1] == expect[1]) == (same));	\
+	TEST_MSG("Given: %s", s);						\
+} while (0)
+
+	test_sameFingerprint(gs1_encoder_setDataStr, "^0109521234543213310300019510ABC^99XYZ", true);
+	test_sameFingerprint(gs1_encoder_setAIdataStr, "(99)XYZ(10)ABC(3103)000195(01)09521234543213", true);
+	test_sameFingerprint(gs1_encoder_setAIdataStr, "(01)09521234543213(10)ABC(3103)000195(99)XYZ(10)ABC", true);
+	test_sameFingerprint(gs1_encoder_setDataStr, "https://id.gs1.org/01/09521234543213/10/ABC?3103=000195&99=XYZ", true);
+	test_sameFingerprint(gs1_encoder_setDataStr, "https://example.com/a/stem/01/09521234543213/10/ABC?99=XYZ&foo=bar&3103=000195", true);
+	test_sameFingerprint(gs1_encoder_setScanData, "]Q30109521234543213310300019510ABC\x1D" "99XYZ", true);
+	test_sameFingerprint(gs1_encoder_setScanData, "]d2310300019599XYZ\x1D" "0109521234543213" "10ABC", true);
+
+	test_sameFingerprint(gs1_encoder_setAIdataStr, "(01)09521234543213(3103)000195(10)ABD(99)XYZ", false);
+	test_sameFingerprint(gs1_encoder_setAIdataStr, "(01)09521234543213(3103)000195(10)XYZ(99)ABC", false);
+	test_sameFingerprint(gs1_encoder_setAIdataStr, "(01)09521234543213(3103)000195(10)ABC", false);
+	test_sameFingerprint(gs1_encoder_setAIdataStr, "(01)09521234543213(3103)000195(10)ABC(99)XYZ(98)XYZ", false);
+
+	// A serialised message has the fingerprint of the message loaded from it
+	TEST_ASSERT(gs1_encoder_setDataStr(ctx, "https://id.gs1.org/01/09521234543213/10/ABC?3103=000195&99=XYZ"));
+	TEST_ASSERT((len = gs1_encoder_getSerialisedMessage(ctx, buf, sizeof(buf))) > 0);
+	TEST_ASSERT(gs1_encoder_setAIdataStr(ctx, "(01)09521234543213"));
+	TEST_ASSERT(gs1_encoder_setSerialisedMessage(ctx, buf, len));
+	TEST_ASSERT(gs1_encoder_getMessageFingerprint(ctx, fp));
+	TEST_CHECK(fp[0] == expect[0] && fp[1] == expect[1]);
+
+	// As does the AI data of a label that is assembled from several reads
+	gs1_encoder_labelBegin(ctx);
+	TEST_ASSERT(gs1_encoder_labelAddScanData(ctx, "]E09521234543213"));
+	TEST_ASSERT(gs1_encoder_labelAddScanData(ctx, "]C1310300019510ABC\x1D" "99XYZ"));
+	TEST_ASSERT(gs1_encoder_labelFinish(ctx));
+	TEST_ASSERT(gs1_encoder_getMessageFingerprint(ctx, fp));
+	TEST_CHECK(fp[0] == expect[0] && fp[1] == expect[1]);
+
+	// EAN/UPC primary data is taken as AI (01)
+	TEST_ASSERT(gs1_encoder_setAIdataStr(ctx, "(01)09521234543213"));
+	TEST_ASSERT(gs1_encoder_getMessageFingerprint(ctx, expect));
+	test_sameFingerprint(gs1_encoder_setScanData, "]E09521234543213", true);
+	TEST_CHECK(gs1_encoder_getSym(ctx) == gs1_encoder_sEAN13);
+	test_sameFingerprint(gs1_encoder_setDataStr, "9521234543213", true);
+	test_sameFingerprint(gs1_encoder_setDataStr, "^0109521234543213", true);
+	test_sameFingerprint(gs1_encoder_setScanData, "]E4" "95212340", false);
+
+	TEST_ASSERT(gs1_encoder_setAIdataStr(ctx, "(01)09521234543213(99)XYZ"));
+	TEST_ASSERT(gs1_encoder_getMessageFingerprint(ctx, expect));
+	TEST_ASSERT(gs1_encoder_setSym(ctx, gs1_encoder_sEAN13));
+	test_sameFingerprint(gs1_encoder_setDataStr, "9521234543213|^99XYZ", true);
+	test_sameFingerprint(gs1_encoder_setScanData, "]E09521234543213|]e099XYZ", true);
+
+	TEST_ASSERT(gs1_encoder_setAIdataStr(ctx, "(01)00416000336108"));
+	TEST_ASSERT(gs1_encoder_getMessageFingerprint(ctx, expect));
+	TEST_ASSERT(gs1_encoder_setSym(ctx, gs1_encoder_sUPCA));
+	test_sameFingerprint(gs1_encoder_setDataStr, "416000336108", true);
+	test_sameFingerprint(gs1_encoder_setScanData, "]E00416000336108", true);
+
+#undef test_sameFingerprint
+
+	TEST_ASSERT(gs1_encoder_setSym(ctx, gs1_encoder_sEAN13));
+	TEST_ASSERT(gs1_encoder_setAddCheckDigit(ctx, true));
+	TEST_ASSERT(gs1_encoder_setDataStr(ctx, "952123454321"));		// Not yet a GTIN
+	TEST_CHECK(!gs1_encoder_getMessageFingerprint(ctx, fp));
+	TEST_ASSERT(gs1_encoder_setAddCheckDigit(ctx, false));
+
+	TEST_ASSERT(gs1_encoder_setDataStr(ctx, "TEST"));
+	TEST_CHECK(!gs1_encoder_getMessageFingerprint(ctx, fp));
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "The message does not consist of GS1 AI data") == 0);
+
+	gs1_encoder_free(ctx);
+
+}
+
+
 void test_api_allocFailures(void) {
 
 	const gs1_encoder* ctx;
@@ -2249,6 +4084,27 @@ void test_api_allocFailures(void) {
 		ctx = gs1_encoder_init_ex(NULL, &opts);
 		TEST_CHECK(ctx == NULL);
 		test_alloc_fail_at = 0;
+
+	}
+
+	/*
+	 *  Whichever allocation fails, the last being the reference count of
+	 *  the tables shared with clones, nothing is leaked.
+	 *
+	 */
+	{
+		gs1_encoder *full;
+		int n;
+
+		for (n = 1; ; n++) {
+			test_alloc_fail_at = n;
+			if ((full = gs1_encoder_init_ex(NULL, NULL)) != NULL)
+				break;
+		}
+		test_alloc_fail_at = 0;
+		TEST_CHECK(n > 2);
+		TEST_CHECK(*full->sharedTablesRefs == 1);
+		gs1_encoder_free(full);
 	}
 
 	/*
@@ -2267,6 +4123,28 @@ void test_api_allocFailures(void) {
 		test_alloc_fail_at = 0;
 	}
 
+	/*
+	 *  gs1_encoder_clone: the only allocation is the new context, whose
+	 *  failure leaves the original untouched.
+	 *
+	 */
+	{
+		gs1_encoder *orig, *clone;
+
+		TEST_ASSERT((orig = gs1_encoder_unit_test_init()) != NULL);
+		assert(orig);
+		TEST_CHECK(!gs1_encoder_setAIdataStr(orig, "(01)12345678901234"));
+
+		test_alloc_fail_at = 1;
+		clone = gs1_encoder_clone(orig, NULL);
+		TEST_CHECK(clone == NULL);
+		TEST_CHECK(*gs1_encoder_getErrMsg(orig) != '\0');
+		TEST_CHECK(*orig->sharedTablesRefs == 1);
+		test_alloc_fail_at = 0;
+
+		gs1_encoder_free(orig);
+	}
+
 }
 
 
@@ -2313,6 +4191,124 @@ void test_api_brokenPrefixSyndict(void) {
 }
 
 
+static gs1_lint_err_t test_lint_nox(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len) {
+	const char* const p = memchr(data, 'X', data_len);
+	if (p) {
+		if (err_pos) *err_pos = (size_t)(p - data);
+		if (err_len) *err_len = 1;
+		return GS1_LINTER_INVALID_CSET82_CHARACTER;
+	}
+	return GS1_LINTER_OK;
+}
+
+static gs1_lint_err_t test_lint_pass(const char* const data, const size_t data_len, size_t* const err_pos, size_t* const err_len) {
+	(void)data;
+	(void)data_len;
+	(void)err_pos;
+	(void)err_len;
+	return GS1_LINTER_OK;
+}
+
+void test_api_customLinters(void) {
+
+	const char* const path = "test-syndict-custom-linters.txt";
+	FILE *fp;
+	gs1_encoder *ctx;
+	gs1_encoder_init_status_t status;
+	char noxName[] = "nox";		// Need not outlive init_ex
+
+	const struct gs1_encoder_linter linters[] = {
+		{ .name = NULL,		.fn = test_lint_pass },		// Ignored
+		{ .name = "nox",	.fn = NULL },			// Ignored
+		{ .name = noxName,	.fn = test_lint_nox },
+		{ .name = "yesno",	.fn = test_lint_pass },		// Replaces the reference linter
+	};
+
+	gs1_encoder_init_opts_t opts = {
+		.struct_size		= sizeof(gs1_encoder_init_opts_t),
+		.status			= &status,
+		.syntaxDictionary	= path,
+	};
+
+	fp = fopen(path, "w");
+	TEST_ASSERT(fp != NULL);
+	if (!fp) return;
+	fputs("90   ?  X..30,nox    # INTERNAL\n", fp);
+	fputs("91   ?  N1,yesno     # INTERNAL\n", fp);
+	fclose(fp);
+
+	// Without the registry the dictionary refers to an unknown linter
+	TEST_CHECK(gs1_encoder_init_ex(NULL, &opts) == NULL);
+	TEST_CHECK(status == GS1_ENCODERS_INIT_FAILED_LOADING_SYNDICT);
+
+	opts.linters = linters;
+	opts.numLinters = SIZEOF_ARRAY(linters);
+	TEST_ASSERT((ctx = gs1_encoder_init_ex(NULL, &opts)) != NULL);
+	assert(ctx);
+	TEST_CHECK(status == GS1_ENCODERS_INIT_SUCCESS);
+
+	// Resolved at load time; the registry is not retained
+	TEST_CHECK(ctx->linters == NULL && ctx->numLinters == 0);
+	strcpy(noxName, "xxx");
+	TEST_CHECK(gs1_lookupAIentry(ctx, "90", 2)->parts[0].linters[0] == test_lint_nox);
+
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(90)ABC"));
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(90)AXC"));
+	TEST_CHECK(ctx->linterErr == GS1_LINTER_INVALID_CSET82_CHARACTER);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMarkup(ctx), "(90)A|X|C") == 0);
+
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(91)5"));		// Reference yesno would reject
+
+#ifdef GS1_ENCODERS_STATS
+	{
+		gs1_encoder_stats_t stats;
+		size_t i;
+
+		// Labelled with the application's name
+		TEST_ASSERT(gs1_encoder_getStats(ctx, &stats));
+		for (i = 0; i < stats.numLinters; i++)
+			if (stats.linters[i].name && strcmp(stats.linters[i].name, "nox") == 0)
+				break;
+		TEST_ASSERT(i < stats.numLinters);
+		TEST_CHECK(stats.linters[i].invocations == 2);
+		TEST_CHECK(stats.linters[i].failures == 1);
+		TEST_CHECK(stats.linters[i].name != linters[2].name);	// A copy owned by the context
+	}
+#endif
+
+	/*
+	 *  The linters are part of the fingerprint, so a serialised message is
+	 *  trusted only by a context whose linters resolve in the same way
+	 *
+	 */
+	{
+		gs1_encoder *other;
+		uint8_t buf[GS1_ENCODERS_MAX_SERIALISED_MESSAGE_LEN];
+		size_t len;
+
+		strcpy(noxName, "nox");
+		TEST_ASSERT((other = gs1_encoder_init_ex(NULL, &opts)) != NULL);
+		assert(other);
+		TEST_CHECK(other->aiTableFingerprint == ctx->aiTableFingerprint);
+		gs1_encoder_free(other);
+
+		opts.numLinters = 3;		// Without the replacement for yesno
+		TEST_ASSERT((other = gs1_encoder_init_ex(NULL, &opts)) != NULL);
+		assert(other);
+		TEST_CHECK(other->aiTableFingerprint != ctx->aiTableFingerprint);
+
+		TEST_ASSERT((len = gs1_encoder_getSerialisedMessage(ctx, buf, sizeof(buf))) > 0);
+		TEST_CHECK(!gs1_encoder_setSerialisedMessage(other, buf, len));		// Validated, so rejected by yesno
+		gs1_encoder_free(other);
+	}
+
+	gs1_encoder_free(ctx);
+
+	remove(path);
+
+}
+
+
 void test_api_tooManyDLkeyQualifiersSyndict(void) {
 
 	const char* const path = "test-syndict-dlpkey-limit.txt";
@@ -2341,4 +4337,247 @@ void test_api_tooManyDLkeyQualifiersSyndict(void) {
 }
 
 
+
+void test_api_stats(void) {
+
+	gs1_encoder *ctx;
+	gs1_encoder_stats_t stats, total = { 0 };
+
+#ifdef GS1_ENCODERS_STATS
+	size_t i;
+	const struct gs1_encoder_linter_stats *csum = NULL;
+#endif
+
+	TEST_ASSERT((ctx = gs1_encoder_unit_test_init()) != NULL);
+	assert(ctx);
+
+#ifndef GS1_ENCODERS_STATS
+
+	TEST_CHECK(!gs1_encoder_getStats(ctx, &stats));
+	gs1_encoder_resetStats(ctx);		// Harmless
+	(void)total;
+
+#else
+
+	TEST_ASSERT(gs1_encoder_getStats(ctx, &stats));
+	TEST_CHECK(stats.allocations > 0);	// Context and DL key-qualifiers
+	TEST_CHECK(stats.messages[gs1_encoder_kAI_DATA] == 0);
+
+	gs1_encoder_resetStats(ctx);
+	TEST_ASSERT(gs1_encoder_getStats(ctx, &stats));
+	TEST_CHECK(stats.allocations == 0);
+
+	TEST_CHECK(gs1_encoder_setAIdataStr(ctx, "(01)12312312312333"));
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(01)12312312312334"));	// Bad check digit
+	TEST_CHECK(!gs1_encoder_setAIdataStr(ctx, "(02)12312312312333"));	// Requires (37)
+	TEST_CHECK(gs1_encoder_setDataStr(ctx, "^0112312312312333"));
+	TEST_CHECK(gs1_encoder_setDataStr(ctx, "https://id.gs1.org/01/12312312312333"));
+	TEST_CHECK(gs1_encoder_setDataStr(ctx, "TESTING"));
+	TEST_CHECK(gs1_encoder_setScanData(ctx, "]e0011231231231233310ABC123" "\x1D" "99XYZ"));
+
+	TEST_CHECK(gs1_encoder_getAIdataStr(ctx) != NULL);
+	TEST_CHECK(gs1_encoder_getDLuri(ctx, NULL) != NULL);
+
+	TEST_ASSERT(gs1_encoder_getStats(ctx, &stats));
+	TEST_CHECK(stats.messages[gs1_encoder_kAI_DATA] == 3);
+	TEST_CHECK(stats.rejected[gs1_encoder_kAI_DATA] == 2);
+	TEST_CHECK(stats.messages[gs1_encoder_kELEMENT_STRING] == 1);
+	TEST_CHECK(stats.messages[gs1_encoder_kDL_URI] == 1);
+	TEST_CHECK(stats.messages[gs1_encoder_kPLAIN] == 1);
+	TEST_CHECK(stats.messages[gs1_encoder_kSCAN_DATA] == 1);
+	TEST_CHECK(stats.rejected[gs1_encoder_kSCAN_DATA] == 0);
+	TEST_CHECK(stats.renders == 2);
+	TEST_CHECK(stats.validationRuns[gs1_encoder_vREQUISITE_AIS] == 6);	// Not reached for the bad check digit
+	TEST_CHECK(stats.validationFailures[gs1_encoder_vREQUISITE_AIS] == 1);
+	TEST_CHECK(stats.linterFailures == 1);
+	TEST_CHECK(stats.linterInvocations > stats.linterFailures);
+
+	for (i = 0; i < stats.numLinters; i++)
+		if (stats.linters[i].name && strcmp(stats.linters[i].name, "csum") == 0)
+			csum = &stats.linters[i];
+	TEST_ASSERT(csum != NULL);
+	assert(csum);
+	TEST_CHECK(csum->invocations == 6);
+	TEST_CHECK(csum->failures == 1);
+
+	// Accumulation, with linters combined by name
+	gs1_encoder_addStats(&total, &stats);
+	gs1_encoder_addStats(&total, &stats);
+	TEST_CHECK(total.messages[gs1_encoder_kAI_DATA] == 6);
+	TEST_CHECK(total.linterInvocations == 2 * stats.linterInvocations);
+	TEST_CHECK(total.numLinters == stats.numLinters);
+	TEST_CHECK(total.linters[csum - stats.linters].invocations == 12);
+
+	// Reset clears the counts but retains the known linters
+	gs1_encoder_resetStats(ctx);
+	TEST_ASSERT(gs1_encoder_getStats(ctx, &stats));
+	TEST_CHECK(stats.messages[gs1_encoder_kAI_DATA] == 0);
+	TEST_CHECK(stats.linterInvocations == 0);
+	TEST_CHECK(stats.numLinters == total.numLinters);
+	TEST_CHECK(stats.linters[0].invocations == 0);
+
+#endif
+
+	gs1_encoder_free(ctx);
+
+}
+
+
+void test_api_heapProfile(void) {
+
+	gs1_encoder_heap_profile_t profile;
+
+#ifndef GS1_ENCODERS_HEAP_PROFILE
+
+	// Unit tests bring their own heap management, unless PROFILE_HEAP=yes
+	TEST_CHECK(!gs1_encoder_getHeapProfile(&profile));
+	gs1_encoder_resetHeapProfile();		// Harmless
+
+#else
+
+	const struct gs1_encoder_heap_usage* const total = &profile.total;
+	const struct gs1_encoder_heap_usage* const context = &profile.subsystems[gs1_encoder_hCONTEXT];
+	const struct gs1_encoder_heap_usage* const synDict = &profile.subsystems[gs1_encoder_hSYNTAX_DICTIONARY];
+	const struct gs1_encoder_heap_usage* const dlKeyQuals = &profile.subsystems[gs1_encoder_hDL_KEY_QUALIFIERS];
+	uint64_t live, contextLive, synDictLive, dlKeyQualsLive;
+	gs1_encoder *ctx;
+	void *p, *q;
+
+	/*
+	 *  The accounting is process-wide, so the usage retained by earlier
+	 *  tests is carried through the reset and taken as the baseline
+	 *
+	 */
+	gs1_encoder_resetHeapProfile();
+	TEST_ASSERT(gs1_encoder_getHeapProfile(&profile));
+	TEST_CHECK(total->allocations == 0 && total->frees == 0 && total->bytes == 0);
+	TEST_CHECK(total->peakBytes == total->liveBytes);
+	live = total->liveBytes;
+	contextLive = context->liveBytes;
+	synDictLive = synDict->liveBytes;
+	dlKeyQualsLive = dlKeyQuals->liveBytes;
+
+	p = gs1_heapProfileMalloc(100, gs1_encoder_hCONTEXT);
+	q = gs1_heapProfileCalloc(10, 20, gs1_encoder_hDL_KEY_QUALIFIERS);
+	TEST_ASSERT(p && q);
+	assert(p && q);
+	TEST_CHECK(((char*)q)[0] == 0 && ((char*)q)[199] == 0);
+	TEST_ASSERT(gs1_encoder_getHeapProfile(&profile));
+	TEST_CHECK(context->allocations == 1 && context->bytes == 100 && context->liveBytes == contextLive + 100);
+	TEST_CHECK(dlKeyQuals->allocations == 1 && dlKeyQuals->bytes == 200 && dlKeyQuals->liveBytes == dlKeyQualsLive + 200);
+	TEST_CHECK(total->allocations == 2 && total->frees == 0 && total->bytes == 300);
+	TEST_CHECK(total->liveBytes == live + 300 && total->peakBytes == live + 300);
+
+	// Reallocation moves the block's usage to the reallocating subsystem
+	p = gs1_heapProfileRealloc(p, 300, gs1_encoder_hSYNTAX_DICTIONARY);
+	TEST_ASSERT(p != NULL);
+	q = gs1_heapProfileRealloc(q, 50, gs1_encoder_hDL_KEY_QUALIFIERS);
+	TEST_ASSERT(q != NULL);
+	TEST_ASSERT(gs1_encoder_getHeapProfile(&profile));
+	TEST_CHECK(context->allocations == 1 && context->frees == 0 && context->liveBytes == contextLive);
+	TEST_CHECK(synDict->allocations == 1 && synDict->bytes == 300 && synDict->liveBytes == synDictLive + 300);
+	TEST_CHECK(dlKeyQuals->allocations == 2 && dlKeyQuals->bytes == 250 && dlKeyQuals->liveBytes == dlKeyQualsLive + 50);
+	TEST_CHECK(total->allocations == 4 && total->frees == 0 && total->bytes == 650);
+	TEST_CHECK(total->liveBytes == live + 350 && total->peakBytes == live + 500);
+
+	// Failed allocations are not counted
+	TEST_CHECK(gs1_heapProfileCalloc(SIZE_MAX, 2, gs1_encoder_hCONTEXT) == NULL);
+	test_alloc_fail_at = 1;
+	TEST_CHECK(gs1_heapProfileRealloc(p, 1000, gs1_encoder_hCONTEXT) == NULL);
+	TEST_ASSERT(gs1_encoder_getHeapProfile(&profile));
+	TEST_CHECK(total->allocations == 4 && context->allocations == 1);
+
+	gs1_heapProfileFree(p);
+	gs1_heapProfileFree(q);
+	gs1_heapProfileFree(NULL);
+	TEST_ASSERT(gs1_encoder_getHeapProfile(&profile));
+	TEST_CHECK(context->frees == 0 && synDict->frees == 1 && dlKeyQuals->frees == 1 && total->frees == 2);
+	TEST_CHECK(synDict->liveBytes == synDictLive && dlKeyQuals->liveBytes == dlKeyQualsLive);
+	TEST_CHECK(total->liveBytes == live && total->peakBytes == live + 500);
+
+	// The library's own allocations are attributed through the hooks
+	TEST_ASSERT((ctx = gs1_encoder_unit_test_init()) != NULL);
+	assert(ctx);
+	TEST_ASSERT(gs1_encoder_getHeapProfile(&profile));
+	TEST_CHECK(context->allocations > 1 && context->liveBytes > contextLive);
+	gs1_encoder_free(ctx);
+	TEST_ASSERT(gs1_encoder_getHeapProfile(&profile));
+	TEST_CHECK(context->frees == context->allocations - 1);
+	TEST_CHECK(total->liveBytes == live);
+
+	// Resetting clears the counts and brings the peak down to the live usage
+	gs1_encoder_resetHeapProfile();
+	TEST_ASSERT(gs1_encoder_getHeapProfile(&profile));
+	TEST_CHECK(total->allocations == 0 && total->frees == 0 && total->bytes == 0);
+	TEST_CHECK(total->liveBytes == live && total->peakBytes == live);
+	TEST_CHECK(context->allocations == 0 && context->peakBytes == contextLive);
+
+#endif
+
+}
+
+
+void test_api_processBatch(void) {
+
+	gs1_encoder *ctx;
+	gs1_encoder_batch_result_t res[4];
+	char out[256];
+	char in[] =
+		"(01)12312312312333(10)ABC123\0"
+		"(01)12312312312334\0"			// Bad check digit
+		"(01)12312312312333|(99)XYZ\0"
+		"(99)TESTING\0";
+
+	TEST_ASSERT((ctx = gs1_encoder_unit_test_init()) != NULL);
+	assert(ctx);
+
+	TEST_CHECK(gs1_encoder_processBatch(ctx, gs1_encoder_bAI_DATA_STR, gs1_encoder_oDATA_STR, in, 4, out, sizeof(out), res) == 4);
+	TEST_CHECK(res[0].ok && strcmp(out + res[0].offset, "^011231231231233310ABC123") == 0);
+	TEST_CHECK(res[0].length == strlen(out + res[0].offset));
+	TEST_CHECK(!res[1].ok && strcmp(out + res[1].offset, "AI (01): The numeric check digit is incorrect.") == 0);
+	TEST_CHECK(res[2].ok && strcmp(out + res[2].offset, "^0112312312312333|^99XYZ") == 0);
+	TEST_CHECK(res[3].ok && strcmp(out + res[3].offset, "^99TESTING") == 0);
+	TEST_CHECK(res[3].offset + res[3].length + 1 <= sizeof(out));
+	TEST_CHECK(strcmp(gs1_encoder_getDataStr(ctx), "^99TESTING") == 0);	// Final input
+
+	TEST_CHECK(gs1_encoder_processBatch(ctx, gs1_encoder_bAI_DATA_STR, gs1_encoder_oNONE, in, 4, out, sizeof(out), res) == 4);
+	TEST_CHECK(res[0].ok && res[0].length == 0);
+	TEST_CHECK(!res[1].ok && res[1].length > 0);
+
+	TEST_CHECK(gs1_encoder_processBatch(ctx, gs1_encoder_bAI_DATA_STR, gs1_encoder_oDL_URI, in, 1, out, sizeof(out), res) == 1);
+	TEST_CHECK(res[0].ok && strcmp(out + res[0].offset, "https://id.gs1.org/01/12312312312333/10/ABC123") == 0);
+
+	TEST_CHECK(gs1_encoder_processBatch(ctx, gs1_encoder_bAI_DATA_STR, gs1_encoder_oHRI, in, 1, out, sizeof(out), res) == 1);
+	TEST_CHECK(res[0].ok && strcmp(out + res[0].offset, "(01) 12312312312333|(10) ABC123") == 0);
+
+	// Data that is not GS1 has no AI element string, HRI or DL URI
+	TEST_CHECK(gs1_encoder_processBatch(ctx, gs1_encoder_bDATA_STR, gs1_encoder_oAI_DATA_STR, "TESTING\0^0112312312312333\0", 2, out, sizeof(out), res) == 2);
+	TEST_CHECK(res[0].ok && strcmp(out + res[0].offset, "") == 0);
+	TEST_CHECK(res[1].ok && strcmp(out + res[1].offset, "(01)12312312312333") == 0);
+	TEST_CHECK(gs1_encoder_processBatch(ctx, gs1_encoder_bDATA_STR, gs1_encoder_oDL_URI, "TESTING\0", 1, out, sizeof(out), res) == 1);
+	TEST_CHECK(!res[0].ok);
+
+	// Scan data requires a symbology to be selected for output
+	TEST_CHECK(gs1_encoder_processBatch(ctx, gs1_encoder_bSCAN_DATA, gs1_encoder_oSCAN_DATA, "]Q3011231231231233310ABC123\0", 1, out, sizeof(out), res) == 1);
+	TEST_CHECK(res[0].ok && strcmp(out + res[0].offset, "]Q3011231231231233310ABC123") == 0);
+	TEST_CHECK(gs1_encoder_setSym(ctx, gs1_encoder_sNONE));
+	TEST_CHECK(gs1_encoder_processBatch(ctx, gs1_encoder_bDATA_STR, gs1_encoder_oSCAN_DATA, "^0112312312312333\0", 1, out, sizeof(out), res) == 1);
+	TEST_CHECK(!res[0].ok && strcmp(out + res[0].offset, "No symbology selected") == 0);
+
+	// Processing stops when the output buffer is exhausted
+	TEST_CHECK(gs1_encoder_processBatch(ctx, gs1_encoder_bAI_DATA_STR, gs1_encoder_oDATA_STR, in, 4, out, 26, res) == 1);
+	TEST_CHECK(gs1_encoder_processBatch(ctx, gs1_encoder_bAI_DATA_STR, gs1_encoder_oDATA_STR, in, 4, out, 25, res) == 0);
+	TEST_CHECK(gs1_encoder_processBatch(ctx, gs1_encoder_bAI_DATA_STR, gs1_encoder_oDATA_STR, in, 4, NULL, 0, res) == 0);
+	TEST_CHECK(gs1_encoder_processBatch(ctx, gs1_encoder_bAI_DATA_STR, gs1_encoder_oDATA_STR, NULL, 0, out, sizeof(out), NULL) == 0);
+	TEST_CHECK(*gs1_encoder_getErrMsg(ctx) == '\0');
+
+	TEST_CHECK(gs1_encoder_processBatch(ctx, gs1_encoder_bNUMINPUTS, gs1_encoder_oNONE, in, 4, out, sizeof(out), res) == 0);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Unknown batch input or output format") == 0);
+	TEST_CHECK(gs1_encoder_processBatch(ctx, gs1_encoder_bAI_DATA_STR, gs1_encoder_oNUMOUTPUTS, in, 4, out, sizeof(out), res) == 0);
+	TEST_CHECK(strcmp(gs1_encoder_getErrMsg(ctx), "Unknown batch input or output format") == 0);
+
+	gs1_encoder_free(ctx);
+
+}
+
 #endif  /* UNIT_TESTS */
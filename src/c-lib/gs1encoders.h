@@ -50,6 +50,7 @@
 /// \cond
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
@@ -184,6 +185,8 @@ struct gs1_encoder_init_opts {
 	char *msgBuf;				///< Optional buffer to receive error message (may be NULL)
 	size_t msgBufSize;			///< Size of msgBuf in bytes (0 if no buffer)
 	const char *syntaxDictionary;		///< Optional path to a Syntax Dictionary file. NULL (default) uses the embedded AI table.
+	const struct gs1_encoder_linter *linters;	///< Optional array of application-provided linters that the @ref gs1_encoder_init_opts::syntaxDictionary may refer to by name (may be NULL). See ::gs1_encoder_linter.
+	size_t numLinters;			///< Number of entries in @ref gs1_encoder_init_opts::linters (0 if none)
 };
 
 
@@ -194,6 +197,283 @@ struct gs1_encoder_init_opts {
 typedef struct gs1_encoder_init_opts gs1_encoder_init_opts_t;
 
 
+/**
+ * @struct gs1_encoder_linter
+ * @brief An application-provided linter that may be referred to by name from
+ * a Syntax Dictionary.
+ *
+ * A Syntax Dictionary names the linters that are applied to each AI
+ * component, for example `N13,csum,gcppos1`. By default these names are
+ * resolved against the reference linters that are built into the library.
+ * An array of ::gs1_encoder_linter supplied via
+ * @ref gs1_encoder_init_opts::linters extends that set for the dictionary
+ * being loaded, so that additional linters (for example enterprise code list
+ * checks) can be deployed without rebuilding the library.
+ *
+ * An entry whose name matches a reference linter replaces that linter, which
+ * permits an optimised implementation to be substituted.
+ *
+ * Names are resolved once, when the Syntax Dictionary is loaded, into direct
+ * function pointers. The array is not referenced after gs1_encoder_init_ex()
+ * returns, but the functions must remain valid for the lifetime of the
+ * context. The names also identify the linters in the fingerprint carried by
+ * gs1_encoder_getSerialisedMessage().
+ *
+ * The function has the ::gs1_linter_t signature and must return one of the
+ * ::gs1_lint_err_t codes, so this structure is defined only once
+ * `syntax/gs1syntaxdictionary.h` has been included. That header is installed
+ * alongside this one by `make install`, at the same relative path:
+ *
+ * \code{.c}
+ * #include "syntax/gs1syntaxdictionary.h"
+ * #include "gs1encoders.h"
+ *
+ * static gs1_lint_err_t lint_nox(const char *data, size_t data_len, size_t *err_pos, size_t *err_len) {
+ * 	const char *p = memchr(data, 'X', data_len);
+ * 	if (p) {
+ * 		if (err_pos) *err_pos = (size_t)(p - data);
+ * 		if (err_len) *err_len = 1;
+ * 		return GS1_LINTER_INVALID_CSET82_CHARACTER;
+ * 	}
+ * 	return GS1_LINTER_OK;
+ * }
+ *
+ * static const struct gs1_encoder_linter linters[] = {
+ * 	{ .name = "nox", .fn = lint_nox },	// e.g. "91  X..90,nox  # INTERNAL"
+ * };
+ *
+ * gs1_encoder_init_opts_t opts = {
+ * 	.struct_size      = sizeof(gs1_encoder_init_opts_t),
+ * 	.syntaxDictionary = "gs1-syntax-dictionary.txt",
+ * 	.linters          = linters,
+ * 	.numLinters       = sizeof(linters) / sizeof(linters[0]),
+ * };
+ * \endcode
+ *
+ * \note
+ * The linters of the embedded AI table are fixed at build time, so the
+ * application-provided linters apply only when a Syntax Dictionary is loaded.
+ *
+ */
+struct gs1_encoder_linter;
+
+
+/// Kinds of input message counted by the statistics returned by gs1_encoder_getStats().
+enum gs1_encoder_stats_kinds {
+	gs1_encoder_kAI_DATA = 0,		///< Bracketed AI element string provided with gs1_encoder_setAIdataStr()
+	gs1_encoder_kELEMENT_STRING,		///< Unbracketed AI element string ("^...") provided with gs1_encoder_setDataStr()
+	gs1_encoder_kDL_URI,			///< GS1 Digital Link URI provided with gs1_encoder_setDataStr()
+	gs1_encoder_kPLAIN,			///< Non-GS1 data provided with gs1_encoder_setDataStr()
+	gs1_encoder_kSCAN_DATA,			///< Scan data provided with gs1_encoder_setScanData()
+	gs1_encoder_kNUMKINDS,
+};
+
+/**
+ * @brief Equivalent to the `enum gs1_encoder_stats_kinds` type.
+ *
+ */
+typedef enum gs1_encoder_stats_kinds gs1_encoder_stats_kinds_t;
+
+
+/// Processing stages timed by the statistics returned by gs1_encoder_getStats().
+enum gs1_encoder_stats_stages {
+	gs1_encoder_stPARSE = 0,		///< Parsing the input into AI data, including linting
+	gs1_encoder_stLINT,			///< Running the linters (included within ::gs1_encoder_stPARSE)
+	gs1_encoder_stVALIDATE,			///< Running the enabled AI validation procedures
+	gs1_encoder_stRENDER,			///< Generating output: AI data, GS1 Digital Link URI, scan data and HRI
+	gs1_encoder_stNUMSTAGES,
+};
+
+/**
+ * @brief Equivalent to the `enum gs1_encoder_stats_stages` type.
+ *
+ */
+typedef enum gs1_encoder_stats_stages gs1_encoder_stats_stages_t;
+
+
+/// Maximum number of distinct linters for which gs1_encoder_getStats() reports individual counts.
+#define GS1_ENCODERS_STATS_MAX_LINTERS 64
+
+
+/**
+ * @brief Invocation counts for a single linter.
+ *
+ */
+struct gs1_encoder_linter_stats {
+	const char *name;			///< Linter name, or NULL if the linter is not known by name
+	uint64_t invocations;			///< Number of times that the linter was run
+	uint64_t failures;			///< Number of those runs that reported an error
+	uint64_t ns;				///< Time spent in the linter, in nanoseconds
+};
+
+
+/**
+ * @brief Processing statistics for a ::gs1_encoder context.
+ *
+ * Populated by gs1_encoder_getStats() when the library is built with
+ * `GS1_ENCODERS_STATS` defined. Every field is a cumulative counter, so the
+ * statistics of several contexts (for example a pool of worker threads) may be
+ * combined with gs1_encoder_addStats().
+ *
+ * Times are reported in nanoseconds.
+ *
+ */
+struct gs1_encoder_stats {
+	uint64_t messages[gs1_encoder_kNUMKINDS];		///< Messages processed, indexed by ::gs1_encoder_stats_kinds
+	uint64_t rejected[gs1_encoder_kNUMKINDS];		///< Messages that failed processing, indexed by ::gs1_encoder_stats_kinds
+	uint64_t stageNs[gs1_encoder_stNUMSTAGES];		///< Time per stage, indexed by ::gs1_encoder_stats_stages
+	uint64_t renders;					///< Number of output generation calls
+	uint64_t validationRuns[gs1_encoder_vNUMVALIDATIONS];	///< Runs of each AI validation procedure, indexed by ::gs1_encoder_validations
+	uint64_t validationFailures[gs1_encoder_vNUMVALIDATIONS];	///< Failures of each AI validation procedure
+	uint64_t validationNs[gs1_encoder_vNUMVALIDATIONS];	///< Time spent in each AI validation procedure
+	uint64_t linterInvocations;				///< Total linter runs
+	uint64_t linterFailures;				///< Total linter runs that reported an error
+	size_t numLinters;					///< Number of entries in @ref gs1_encoder_stats::linters
+	struct gs1_encoder_linter_stats linters[GS1_ENCODERS_STATS_MAX_LINTERS];	///< Counts for each distinct linter, in order of first use
+	uint64_t allocations;					///< Heap allocations made by the library on behalf of the context
+};
+
+/**
+ * @brief Equivalent to the `struct gs1_encoder_stats` type.
+ *
+ */
+typedef struct gs1_encoder_stats gs1_encoder_stats_t;
+
+
+/// Subsystems to which heap usage is attributed by gs1_encoder_getHeapProfile().
+enum gs1_encoder_heap_subsystems {
+	gs1_encoder_hCONTEXT = 0,		///< The ::gs1_encoder context itself
+	gs1_encoder_hSYNTAX_DICTIONARY,		///< AI table loaded from a Syntax Dictionary
+	gs1_encoder_hDL_KEY_QUALIFIERS,		///< GS1 Digital Link key-qualifier associations
+	gs1_encoder_hOTHER,			///< Any other allocation
+	gs1_encoder_hNUMSUBSYSTEMS,
+};
+
+/**
+ * @brief Equivalent to the `enum gs1_encoder_heap_subsystems` type.
+ *
+ */
+typedef enum gs1_encoder_heap_subsystems gs1_encoder_heap_subsystems_t;
+
+
+/**
+ * @brief Heap usage for a subsystem, or in total.
+ *
+ */
+struct gs1_encoder_heap_usage {
+	uint64_t allocations;			///< Successful malloc, calloc and realloc calls
+	uint64_t frees;				///< Blocks released
+	uint64_t bytes;				///< Total bytes requested
+	uint64_t liveBytes;			///< Bytes currently allocated
+	uint64_t peakBytes;			///< Greatest value of liveBytes
+};
+
+
+/**
+ * @brief Heap usage of the library, as reported by gs1_encoder_getHeapProfile().
+ *
+ */
+struct gs1_encoder_heap_profile {
+	struct gs1_encoder_heap_usage total;	///< Usage by all subsystems
+	struct gs1_encoder_heap_usage subsystems[gs1_encoder_hNUMSUBSYSTEMS];	///< Usage indexed by ::gs1_encoder_heap_subsystems
+};
+
+/**
+ * @brief Equivalent to the `struct gs1_encoder_heap_profile` type.
+ *
+ */
+typedef struct gs1_encoder_heap_profile gs1_encoder_heap_profile_t;
+
+
+/// Input formats accepted by gs1_encoder_processBatch().
+enum gs1_encoder_batch_inputs {
+	gs1_encoder_bAI_DATA_STR = 0,		///< Bracketed AI element strings, as for gs1_encoder_setAIdataStr()
+	gs1_encoder_bDATA_STR,			///< Barcode message data, as for gs1_encoder_setDataStr()
+	gs1_encoder_bSCAN_DATA,			///< Scan data, as for gs1_encoder_setScanData()
+	gs1_encoder_bNUMINPUTS,
+};
+
+/**
+ * @brief Equivalent to the `enum gs1_encoder_batch_inputs` type.
+ *
+ */
+typedef enum gs1_encoder_batch_inputs gs1_encoder_batch_inputs_t;
+
+
+/// Output formats generated by gs1_encoder_processBatch().
+enum gs1_encoder_batch_outputs {
+	gs1_encoder_oNONE = 0,			///< No output: inputs are only validated
+	gs1_encoder_oDATA_STR,			///< Barcode message data, as for gs1_encoder_getDataStr()
+	gs1_encoder_oAI_DATA_STR,		///< Bracketed AI element string, as for gs1_encoder_getAIdataStr()
+	gs1_encoder_oDL_URI,			///< GS1 Digital Link URI with the default stem, as for gs1_encoder_getDLuri()
+	gs1_encoder_oSCAN_DATA,			///< Scan data, as for gs1_encoder_getScanData()
+	gs1_encoder_oHRI,			///< HRI lines separated by "|", as for gs1_encoder_getHRI()
+	gs1_encoder_oNUMOUTPUTS,
+};
+
+/**
+ * @brief Equivalent to the `enum gs1_encoder_batch_outputs` type.
+ *
+ */
+typedef enum gs1_encoder_batch_outputs gs1_encoder_batch_outputs_t;
+
+
+/// Outcome of feeding a scan data stream to gs1_encoder_feedScanStream().
+enum gs1_encoder_feed_status {
+	gs1_encoder_fNEED_MORE = 0,		///< All of the input was consumed without terminating a symbol
+	gs1_encoder_fMESSAGE,			///< A symbol was terminated and its scan data processed, as for gs1_encoder_setScanData()
+	gs1_encoder_fERROR,			///< A symbol was terminated but its scan data is invalid; an error message is set
+};
+
+/**
+ * @brief Equivalent to the `enum gs1_encoder_feed_status` type.
+ *
+ */
+typedef enum gs1_encoder_feed_status gs1_encoder_feed_status_t;
+
+
+/**
+ * @brief Outcome of processing one input with gs1_encoder_processBatch().
+ *
+ * The layout is fixed at three 32-bit fields so that an array of results can
+ * be read directly from foreign memory, such as a WebAssembly heap.
+ *
+ */
+struct gs1_encoder_batch_result {
+	uint32_t offset;			///< Offset of the NUL-terminated output within the output buffer
+	uint32_t length;			///< Length of the output, excluding the NUL terminator
+	int32_t ok;				///< 1 if the input was processed successfully, otherwise 0 and the output is the error message
+};
+
+/**
+ * @brief Equivalent to the `struct gs1_encoder_batch_result` type.
+ *
+ */
+typedef struct gs1_encoder_batch_result gs1_encoder_batch_result_t;
+
+
+/**
+ * @brief An AI element extracted from the input data, as returned by
+ * gs1_encoder_getAIelements().
+ *
+ * The AI and value refer into the library's buffers and are not
+ * NUL-terminated.
+ *
+ */
+struct gs1_encoder_ai_element {
+	const char *ai;				///< The AI
+	size_t aiLen;				///< Length of the AI
+	const char *value;			///< The AI value
+	size_t valueLen;			///< Length of the AI value
+};
+
+/**
+ * @brief Equivalent to the `struct gs1_encoder_ai_element` type.
+ *
+ */
+typedef struct gs1_encoder_ai_element gs1_encoder_ai_element_t;
+
+
 /**
  * @brief A gs1_encoder context.
  *
@@ -389,6 +669,50 @@ GS1_ENCODERS_API GS1_ENCODERS_DEPRECATED gs1_encoder* gs1_encoder_init(void *mem
 GS1_ENCODERS_API gs1_encoder* gs1_encoder_init_ex(void *mem, const gs1_encoder_init_opts_t *opts);
 
 
+/**
+ * @brief Create a new ::gs1_encoder context that is a copy of an existing one.
+ *
+ * The new context has the same options and AI validation settings as the
+ * original, and shares its AI table and GS1 Digital Link key-qualifier data,
+ * which are not modified after initialisation. This is much cheaper than
+ * initialising a new context, so is suited to creating a context for each
+ * worker thread from one that has been fully configured, particularly when
+ * the AI table was loaded from a Syntax Dictionary.
+ *
+ * The message data and error state of the original are not copied.
+ *
+ * Contexts that share tables may be used, and freed, on different threads
+ * and in any order: the tables are released with the last of them.
+ *
+ * The original is not modified, so several threads may clone the same
+ * context at once, provided that none of them is otherwise using it.
+ *
+ * @param [in] ctx ::gs1_encoder context to copy
+ * @param [in,out] mem buffer of at least gs1_encoder_instanceSize() bytes to use for storage, or NULL for automatic allocation
+ * @return ::gs1_encoder context on success, else NULL if storage for the context could not be allocated
+ *
+ * @see gs1_encoder_init_ex()
+ * @see gs1_encoder_reset()
+ */
+GS1_ENCODERS_API gs1_encoder* gs1_encoder_clone(const gs1_encoder *ctx, void *mem);
+
+
+/**
+ * @brief Return a ::gs1_encoder context to the state that it had immediately
+ * after initialisation.
+ *
+ * The options and AI validation settings are restored to their defaults,
+ * and the message data and error state are cleared, without reloading the
+ * AI table. Processing statistics are retained; use gs1_encoder_resetStats()
+ * to clear them.
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ *
+ * @see gs1_encoder_clone()
+ */
+GS1_ENCODERS_API void gs1_encoder_reset(gs1_encoder *ctx);
+
+
 /**
  * @brief Read an error message generated by the library.
  *
@@ -837,6 +1161,9 @@ GS1_ENCODERS_API bool gs1_encoder_setDataStr(gs1_encoder *ctx, const char *dataS
  * (01)12345678901231|(10)ABC123(11)210630
  * \endcode
  *
+ * The input is only read, so it may be a string literal or held in read-only
+ * memory.
+ *
  * \note
  * The ultimate length of the encoded data must be less that the value returned by
  * gs1_encoder_getMaxDataStrLength().
@@ -978,6 +1305,198 @@ GS1_ENCODERS_API char* gs1_encoder_getDLuri(gs1_encoder *ctx, const char *stem);
 GS1_ENCODERS_API bool gs1_encoder_setScanData(gs1_encoder* ctx, const char *scanData);
 
 
+/**
+ * @brief Length-delimited form of gs1_encoder_setDataStr().
+ *
+ * Reads exactly `len` bytes of input, which need not be NUL-terminated, for
+ * callers that hold the input as a pointer and length, such as a slice of a
+ * larger buffer or a string view. The input must not contain a NUL character.
+ *
+ * @see gs1_encoder_setDataStr()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] dataStr the barcode input data; may be NULL if `len` is 0
+ * @param [in] len the length of the input in bytes
+ * @return true on success, otherwise false and an error message is set
+ */
+GS1_ENCODERS_API bool gs1_encoder_setDataStrN(gs1_encoder *ctx, const char *dataStr, size_t len);
+
+
+/**
+ * @brief Length-delimited form of gs1_encoder_setAIdataStr().
+ *
+ * Reads exactly `len` bytes of input, which need not be NUL-terminated. The
+ * input must not contain a NUL character. The input is parsed where it lies,
+ * without being copied, so it may be a view of read-only memory such as a
+ * mapped file.
+ *
+ * @see gs1_encoder_setAIdataStr()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] dataStr the barcode input data in GS1 Application Identifier syntax; may be NULL if `len` is 0
+ * @param [in] len the length of the input in bytes
+ * @return true on success, otherwise false and an error message is set
+ */
+GS1_ENCODERS_API bool gs1_encoder_setAIdataStrN(gs1_encoder *ctx, const char *dataStr, size_t len);
+
+
+/**
+ * @brief Length-delimited form of gs1_encoder_setScanData().
+ *
+ * Reads exactly `len` bytes of input, which need not be NUL-terminated. The
+ * input must not contain a NUL character.
+ *
+ * @see gs1_encoder_setScanData()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] scanData the scan data input; may be NULL if `len` is 0
+ * @param [in] len the length of the input in bytes
+ * @return true on success, otherwise false and an error message is set
+ */
+GS1_ENCODERS_API bool gs1_encoder_setScanDataN(gs1_encoder *ctx, const char *scanData, size_t len);
+
+
+/**
+ * @brief Start assembling the AI data of a label from the reads of each of its
+ * symbols, discarding any label that is partly assembled.
+ *
+ * The AI data of several symbols on the same label may be combined into a
+ * single message by passing the scan data of each read to
+ * gs1_encoder_labelAddScanData() and then calling gs1_encoder_labelFinish().
+ * A label is empty initially and after it is finished, so calling this
+ * function is only necessary to abandon a label.
+ *
+ * @see gs1_encoder_labelAddScanData()
+ * @see gs1_encoder_labelFinish()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ */
+GS1_ENCODERS_API void gs1_encoder_labelBegin(gs1_encoder *ctx);
+
+
+/**
+ * @brief Add the scan data of a read to the label being assembled.
+ *
+ * The scan data is processed as by gs1_encoder_setScanData(), except that
+ * only the checks on individual AIs are performed, and its AIs are merged into
+ * the label. An AI that is already on the label with the same value, such as
+ * from a repeated read of a symbol, is not added again. An AI that is already
+ * on the label with a different value is a conflict that is reported
+ * immediately. EAN/UPC primary data contributes its GTIN as AI (01).
+ *
+ * A read that fails leaves the label unchanged. Otherwise the message is the
+ * read alone until the label is finished.
+ *
+ * \code
+ * gs1_encoder_labelAddScanData(ctx, "]E09501101530003");
+ * gs1_encoder_labelAddScanData(ctx, "]C110ABC123" "\x1D" "11210630");
+ * gs1_encoder_labelAddScanData(ctx, "]E09501101530003");    // Repeated read
+ * if (gs1_encoder_labelFinish(ctx))
+ *     printf("%s\n", gs1_encoder_getAIdataStr(ctx));        // (01)09501101530003(10)ABC123(11)210630
+ * \endcode
+ *
+ * @see gs1_encoder_labelFinish()
+ * @see gs1_encoder_setScanData()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] scanData the scan data input as read by a reader with AIM symbology identifiers enabled
+ * @return true on success, otherwise false and an error message is set
+ */
+GS1_ENCODERS_API bool gs1_encoder_labelAddScanData(gs1_encoder *ctx, const char *scanData);
+
+
+/**
+ * @brief Finish the label, setting the message to its AI data.
+ *
+ * The AIs of the label are set as the message in the order in which they were
+ * first read and the validations of the associations between AIs, such as
+ * requisite AIs, are performed once for the whole label. The result is then
+ * available as for gs1_encoder_setAIdataStr(), and a new label is begun.
+ *
+ * If the validations fail then the label is kept so that the reads of further
+ * symbols may be added before it is finished again.
+ *
+ * @see gs1_encoder_labelAddScanData()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @return true on success, otherwise false and an error message is set
+ */
+GS1_ENCODERS_API bool gs1_encoder_labelFinish(gs1_encoder *ctx);
+
+
+/**
+ * @brief Process scan data that arrives as a stream of characters, such as
+ * from a keyboard-wedge scanner, in chunks of any size.
+ *
+ * Each symbol is expected to be received as its scan data, with the AIM
+ * symbology identifier and GS separators, followed by a CR or LF terminator.
+ * Empty lines are ignored. The symbology identifier is recognised as soon as it
+ * is received and AI data is converted as it arrives, so that little remains
+ * to be done once the terminator is received.
+ *
+ * Input is consumed up to and including the terminator of the next symbol, if
+ * there is one. The scan data of that symbol is then processed as by
+ * gs1_encoder_setScanData() and the number of bytes consumed is returned
+ * so that the caller may feed the remainder of the input after handling the
+ * message. Otherwise all of the input is consumed and the symbol is
+ * completed by subsequent calls.
+ *
+ * \code
+ * size_t consumed;
+ * while (len > 0) {
+ *     switch (gs1_encoder_feedScanStream(ctx, buf, len, &consumed)) {
+ *     case gs1_encoder_fMESSAGE:
+ *         printf("%s\n", gs1_encoder_getAIdataStr(ctx));
+ *         break;
+ *     case gs1_encoder_fERROR:
+ *         printf("%s\n", gs1_encoder_getErrMsg(ctx));
+ *         break;
+ *     default:
+ *         break;
+ *     }
+ *     buf += consumed;
+ *     len -= consumed;
+ * }
+ * \endcode
+ *
+ * @see gs1_encoder_flushScanStream()
+ * @see gs1_encoder_resetScanStream()
+ * @see gs1_encoder_setScanData()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] data the next chunk of the stream; may be NULL if `len` is 0
+ * @param [in] len the length of the chunk in bytes
+ * @param [out] consumed the number of bytes of the chunk that were consumed
+ * @return ::gs1_encoder_fMESSAGE or ::gs1_encoder_fERROR if a symbol was
+ *         terminated, otherwise ::gs1_encoder_fNEED_MORE
+ */
+GS1_ENCODERS_API gs1_encoder_feed_status_t gs1_encoder_feedScanStream(gs1_encoder *ctx, const char *data, size_t len, size_t *consumed);
+
+
+/**
+ * @brief Terminate any symbol that is partly received from a scan data stream,
+ * for scanners that are not configured to send a terminator.
+ *
+ * @see gs1_encoder_feedScanStream()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @return ::gs1_encoder_fMESSAGE or ::gs1_encoder_fERROR if a symbol was
+ *         terminated, otherwise ::gs1_encoder_fNEED_MORE
+ */
+GS1_ENCODERS_API gs1_encoder_feed_status_t gs1_encoder_flushScanStream(gs1_encoder *ctx);
+
+
+/**
+ * @brief Discard any symbol that is partly received from a scan data stream,
+ * such as when the scanner is reconnected.
+ *
+ * @see gs1_encoder_feedScanStream()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ */
+GS1_ENCODERS_API void gs1_encoder_resetScanStream(gs1_encoder *ctx);
+
+
 /**
  * @brief Returns the string that should be returned by scanners when reading a
  * symbol that is an instance of the selected symbology and contains the same
@@ -1188,6 +1707,375 @@ GS1_ENCODERS_API GS1_ENCODERS_DEPRECATED size_t gs1_encoder_getDLignoredQueryPar
 GS1_ENCODERS_API GS1_ENCODERS_DEPRECATED void gs1_encoder_copyDLignoredQueryParams(gs1_encoder *ctx, void *buf, size_t max);
 
 
+/**
+ * @brief Update a given pointer towards an array of the AI elements extracted
+ * from the input data.
+ *
+ * For example, if the input data buffer were to contain:
+ *
+ *     ^011231231231233310ABC123|^99XYZ(TM) CORP
+ *
+ * Then this function would return the following elements, each referring to
+ * its AI and value without copying:
+ *
+ *     { "01", "12312312312333" }
+ *     { "10", "ABC123" }
+ *     { "99", "XYZ(TM) CORP" }
+ *
+ * Unlike gs1_encoder_getHRI(), no text is rendered, so the elements are not
+ * invalidated by subsequent calls to the other getters. The separator between
+ * the linear and composite components and any ignored GS1 Digital Link URI
+ * query parameters are not included.
+ *
+ * \note
+ * The return data does not need to be free()ed and the content should be
+ * copied if it must persist in user code after subsequent calls to functions
+ * that modify the input data buffer such as gs1_encoder_setDataStr(),
+ * gs1_encoder_setAIdataStr() or gs1_encoder_setScanData().
+ *
+ * @see gs1_encoder_getHRI()
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [out] elements Pointer to an array of AI elements
+ * @return the number of AI elements
+ */
+GS1_ENCODERS_API int gs1_encoder_getAIelements(gs1_encoder* ctx, const gs1_encoder_ai_element_t **elements);
+
+
+/**
+ * @brief Render the input data buffer into a caller-provided buffer, without
+ * modifying the context.
+ *
+ * This and the other gs1_encoder_render*() functions are read-only
+ * counterparts to the getters: they neither use the context's output buffers
+ * nor update its error state, and do not contribute to its processing
+ * statistics. Once a message has been set, any number of threads may
+ * therefore render it at once, for instance the HRI for a printer, the GS1
+ * Digital Link URI for a web service and the scan data for an audit log,
+ * provided that no thread modifies the context meanwhile.
+ *
+ * On success the buffer receives the NUL-terminated output. On failure it
+ * receives the error message, truncated to fit, as for the outputs of
+ * gs1_encoder_processBatch(). A buffer that is too small for the output is a
+ * failure, never a truncation.
+ *
+ * @param [in] ctx ::gs1_encoder context
+ * @param [out] buf buffer to receive the output or error message
+ * @param [in] bufSize size of buf in bytes
+ * @return true on success, otherwise false
+ *
+ * @see gs1_encoder_getDataStr()
+ */
+GS1_ENCODERS_API bool gs1_encoder_renderDataStr(const gs1_encoder *ctx, char *buf, size_t bufSize);
+
+
+/**
+ * @brief Render the AI data as a bracketed AI element string into a
+ * caller-provided buffer, without modifying the context.
+ *
+ * The output is empty if the input data is not GS1 AI data.
+ *
+ * @param [in] ctx ::gs1_encoder context
+ * @param [out] buf buffer to receive the output or error message
+ * @param [in] bufSize size of buf in bytes
+ * @return true on success, otherwise false
+ *
+ * @see gs1_encoder_renderDataStr()
+ * @see gs1_encoder_getAIdataStr()
+ */
+GS1_ENCODERS_API bool gs1_encoder_renderAIdataStr(const gs1_encoder *ctx, char *buf, size_t bufSize);
+
+
+/**
+ * @brief Render a GS1 Digital Link URI for the AI data into a caller-provided
+ * buffer, without modifying the context.
+ *
+ * @param [in] ctx ::gs1_encoder context
+ * @param [in] stem a URI "stem" used as a prefix for the URI, or NULL for the GS1 canonical stem
+ * @param [out] buf buffer to receive the output or error message
+ * @param [in] bufSize size of buf in bytes
+ * @return true on success, otherwise false
+ *
+ * @see gs1_encoder_renderDataStr()
+ * @see gs1_encoder_getDLuri()
+ */
+GS1_ENCODERS_API bool gs1_encoder_renderDLuri(const gs1_encoder *ctx, const char *stem, char *buf, size_t bufSize);
+
+
+/**
+ * @brief Render the expected result of scanning a symbol of the selected
+ * symbology containing the input data into a caller-provided buffer, without
+ * modifying the context.
+ *
+ * @param [in] ctx ::gs1_encoder context
+ * @param [out] buf buffer to receive the output or error message
+ * @param [in] bufSize size of buf in bytes
+ * @return true on success, otherwise false
+ *
+ * @see gs1_encoder_renderDataStr()
+ * @see gs1_encoder_getScanData()
+ */
+GS1_ENCODERS_API bool gs1_encoder_renderScanData(const gs1_encoder *ctx, char *buf, size_t bufSize);
+
+
+/**
+ * @brief Render the Human-Readable Interpretation ("HRI") text for the AI
+ * data into a caller-provided buffer, without modifying the context.
+ *
+ * The lines are separated by "|", so that for the input data given in the
+ * example for gs1_encoder_getHRI() the output is:
+ *
+ *     (01) 12312312312333|(10) ABC123|(99) XYZ(TM) CORP
+ *
+ * @param [in] ctx ::gs1_encoder context
+ * @param [out] buf buffer to receive the output or error message
+ * @param [in] bufSize size of buf in bytes
+ * @return true on success, otherwise false
+ *
+ * @see gs1_encoder_renderDataStr()
+ * @see gs1_encoder_getHRI()
+ */
+GS1_ENCODERS_API bool gs1_encoder_renderHRI(const gs1_encoder *ctx, char *buf, size_t bufSize);
+
+
+/// Maximum length of a message serialised by gs1_encoder_getSerialisedMessage().
+#define GS1_ENCODERS_MAX_SERIALISED_MESSAGE_LEN 6220
+
+
+/**
+ * @brief Serialise the AI data of the message into a compact binary form
+ * that can be loaded with gs1_encoder_setSerialisedMessage().
+ *
+ * The serialised form holds each AI and its value, together with the
+ * position of the separator between the linear and composite components and
+ * the order of any GS1 Digital Link URI path components. It is intended for
+ * passing validated messages between services without the cost of rendering
+ * and re-parsing them. Any ignored GS1 Digital Link URI query parameters are
+ * not included.
+ *
+ * The serialised form also carries a fingerprint of the AI table, including
+ * the names of its linters, the library version and the settings that affect
+ * validation, such as gs1_encoder_setPermitUnknownAIs() and
+ * gs1_encoder_setValidationEnabled(). Application-provided linters (see
+ * ::gs1_encoder_linter) are identified only by name, so applications that
+ * exchange serialised messages must give the same name to the same check.
+ *
+ * The message must consist of AI data, which includes a GS1 Digital Link URI.
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [out] buf buffer to receive the serialised message
+ * @param [in] bufSize size of buf in bytes; a buffer of
+ *             ::GS1_ENCODERS_MAX_SERIALISED_MESSAGE_LEN bytes is always
+ *             sufficient
+ * @return the length of the serialised message, or 0 on failure, in which
+ *         case the error message is available from gs1_encoder_getErrMsg()
+ *
+ * @see gs1_encoder_setSerialisedMessage()
+ */
+GS1_ENCODERS_API size_t gs1_encoder_getSerialisedMessage(gs1_encoder *ctx, uint8_t *buf, size_t bufSize);
+
+
+/**
+ * @brief Load a message serialised by gs1_encoder_getSerialisedMessage() as
+ * the input data.
+ *
+ * The input data buffer receives the AI data as an unbracketed AI element
+ * string, e.g. `^011231231231233310ABC123|^99XYZ`.
+ *
+ * If the fingerprint of the serialised message matches that of this context,
+ * i.e. the message was validated by the same library version, using the same
+ * AI table and settings, then the AIs are loaded without being validated
+ * again. Otherwise the AI element string is processed as if by
+ * gs1_encoder_setDataStr(), in which case the order of any GS1 Digital Link
+ * URI path components is not retained.
+ *
+ * \note
+ * A matching fingerprint is not a proof of authenticity. A serialised message
+ * must only be loaded from a trusted source, since the content of an altered
+ * message that retains its fingerprint is not validated. Only the length of
+ * each value is checked against the AI table.
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] data serialised message
+ * @param [in] len length of the serialised message in bytes
+ * @return true on success, otherwise false and an error message is set
+ *
+ * @see gs1_encoder_getSerialisedMessage()
+ */
+GS1_ENCODERS_API bool gs1_encoder_setSerialisedMessage(gs1_encoder *ctx, const uint8_t *data, size_t len);
+
+
+/**
+ * @brief Compute a 128-bit fingerprint of the AI data of the message.
+ *
+ * The fingerprint covers the AIs and their values in AI order, so it does
+ * not depend upon the syntax in which the message was given, e.g. a
+ * bracketed AI element string, an unbracketed AI element string, scan data
+ * or a GS1 Digital Link URI with any stem and order of query parameters. It
+ * is suitable for identifying repeated scans of the same data.
+ *
+ * Repeated instances of an AI with the same value count once. The separator
+ * between the linear and composite components and any ignored GS1 Digital
+ * Link URI query parameters are not included.
+ *
+ * The primary data of an EAN/UPC symbol is taken as AI (01), so that, for
+ * example, the scan data `]E09521234543213` has the same fingerprint as
+ * `(01)09521234543213`.
+ *
+ * Each AI and value is hashed as the AI data is extracted, so computing the
+ * fingerprint does not involve rendering the message.
+ *
+ * The message must consist of AI data, which includes a GS1 Digital Link URI,
+ * or of EAN/UPC primary data that includes its check digit.
+ *
+ * \note
+ * The fingerprint is not a cryptographic hash and must not be relied upon
+ * where the input may be chosen to collide. Either 64-bit half may be used
+ * alone where a shorter fingerprint is sufficient.
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [out] fingerprint array of two elements to receive the fingerprint
+ * @return true on success, otherwise false and an error message is set
+ */
+GS1_ENCODERS_API bool gs1_encoder_getMessageFingerprint(gs1_encoder *ctx, uint64_t fingerprint[2]);
+
+
+/**
+ * @brief Process a batch of inputs, packing the outputs into a single buffer.
+ *
+ * This is equivalent to calling the setter for the given input format on
+ * each input in turn and then the getter for the given output format, but
+ * requires only a single call. It is intended for bindings for which each
+ * call into the library, and each string passed across, is expensive, such
+ * as the WebAssembly build.
+ *
+ * The inputs are given as `num` consecutive NUL-terminated strings. For each
+ * input, the output is written NUL-terminated into the output buffer, and its
+ * position recorded in the corresponding entry of `results`. When an input
+ * is rejected the output is instead the error message.
+ *
+ * Processing stops early when the output buffer has insufficient space for
+ * the next output, in which case the caller may continue with the remaining
+ * inputs, using a larger buffer if no inputs were processed.
+ *
+ * The context is left holding the last input that was set.
+ *
+ * Example:
+ *
+ * \code{.c}
+ * const char in[] = "(01)12345678901231\0(01)12345678901234\0";
+ * char out[1024];
+ * gs1_encoder_batch_result_t res[2];
+ * size_t i, n;
+ *
+ * n = gs1_encoder_processBatch(ctx, gs1_encoder_bAI_DATA_STR, gs1_encoder_oDL_URI,
+ *                              in, 2, out, sizeof(out), res);
+ * for (i = 0; i < n; i++)
+ *         printf("%s: %s\n", res[i].ok ? "OK" : "ERROR", out + res[i].offset);
+ * \endcode
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [in] input Format of the inputs, one of ::gs1_encoder_batch_inputs
+ * @param [in] output Format of the outputs, one of ::gs1_encoder_batch_outputs
+ * @param [in] in Buffer containing the NUL-terminated inputs
+ * @param [in] num Number of inputs
+ * @param [out] out Buffer to receive the NUL-terminated outputs
+ * @param [in] outSize Size of the output buffer
+ * @param [out] results Array of at least `num` entries to receive the result for each input
+ * @return number of inputs processed, or 0 if the formats are invalid, in
+ *         which case the error is available with gs1_encoder_getErrMsg()
+ */
+GS1_ENCODERS_API size_t gs1_encoder_processBatch(gs1_encoder *ctx, gs1_encoder_batch_inputs_t input, gs1_encoder_batch_outputs_t output, const char *in, size_t num, char *out, size_t outSize, gs1_encoder_batch_result_t *results);
+
+
+/**
+ * @brief Get the processing statistics for a context.
+ *
+ * Statistics are gathered only when the library is built with
+ * `GS1_ENCODERS_STATS` defined, for example with `make STATS=yes`. Otherwise
+ * no instrumentation is compiled in, so there is no runtime cost, and this
+ * function returns false.
+ *
+ * Statistics accumulate from the time that the context is created, or since
+ * the most recent call to gs1_encoder_resetStats().
+ *
+ * \note
+ * Linter names point to storage owned by the library, or to a copy owned by
+ * the context for linters provided with @ref gs1_encoder_init_opts::linters,
+ * and remain valid for the lifetime of the context. Copied names are
+ * truncated to 63 characters.
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ * @param [out] stats Structure to receive the statistics
+ * @return true if statistics are available, otherwise false
+ */
+GS1_ENCODERS_API bool gs1_encoder_getStats(gs1_encoder *ctx, gs1_encoder_stats_t *stats);
+
+
+/**
+ * @brief Reset the processing statistics for a context.
+ *
+ * @param [in,out] ctx ::gs1_encoder context
+ */
+GS1_ENCODERS_API void gs1_encoder_resetStats(gs1_encoder *ctx);
+
+
+/**
+ * @brief Accumulate one set of statistics into another.
+ *
+ * Counts for linters are combined by name. Linters beyond
+ * ::GS1_ENCODERS_STATS_MAX_LINTERS distinct entries are reflected only in the
+ * totals.
+ *
+ * Example of aggregating the statistics of a pool of contexts:
+ *
+ * \code{.c}
+ * gs1_encoder_stats_t total = { 0 }, stats;
+ * for (i = 0; i < numWorkers; i++) {
+ * 	if (gs1_encoder_getStats(workers[i], &stats))
+ * 		gs1_encoder_addStats(&total, &stats);
+ * }
+ * \endcode
+ *
+ * @param [in,out] total Statistics to accumulate into
+ * @param [in] stats Statistics to add
+ */
+GS1_ENCODERS_API void gs1_encoder_addStats(gs1_encoder_stats_t *total, const gs1_encoder_stats_t *stats);
+
+
+/**
+ * @brief Get the heap usage of the library.
+ *
+ * Heap usage is accounted only when the library is built with the bundled
+ * profiling heap management, for example with `make PROFILE_HEAP=yes`, which
+ * sets `GS1_ENCODERS_CUSTOM_HEAP_MANAGEMENT_H=profile-heap.h`. Otherwise this
+ * function returns false.
+ *
+ * The usage is for all contexts within the process, broken down by the
+ * subsystem that made each allocation. Taking a profile either side of some
+ * processing shows whether it allocated, for example to confirm that
+ * processing messages with an initialised context makes no allocations.
+ *
+ * \note
+ * The accounting is not thread-safe, so profiling should be performed from a
+ * single thread.
+ *
+ * @param [out] profile Structure to receive the heap usage
+ * @return true if heap usage is available, otherwise false
+ */
+GS1_ENCODERS_API bool gs1_encoder_getHeapProfile(gs1_encoder_heap_profile_t *profile);
+
+
+/**
+ * @brief Reset the heap usage counts of the library.
+ *
+ * The number of live bytes is retained, since outstanding allocations are
+ * accounted when they are later released, and the peak restarts from it.
+ *
+ */
+GS1_ENCODERS_API void gs1_encoder_resetHeapProfile(void);
+
+
 /**
  *  @brief Destroy a ::gs1_encoder instance.
  *
@@ -1211,3 +2099,28 @@ GS1_ENCODERS_API void gs1_encoder_free(gs1_encoder *ctx);
 
 
 #endif /* GS1_ENCODERS_H */
+
+
+/*
+ *  Defined outside of the include guard since it depends upon gs1_linter_t,
+ *  which is available only once gs1syntaxdictionary.h has been included,
+ *  possibly after this header.
+ *
+ */
+#if defined(GS1_SYNTAXDICTIONARY_H) && !defined(GS1_ENCODERS_LINTER_DEFINED)
+#define GS1_ENCODERS_LINTER_DEFINED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct gs1_encoder_linter {
+	const char *name;			///< Linter name, as referred to in the Syntax Dictionary
+	gs1_linter_t fn;			///< Linter function
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* GS1_ENCODERS_LINTER_DEFINED */
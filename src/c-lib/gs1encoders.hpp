@@ -24,8 +24,8 @@
  * @endlicenseblock
  *
  * Header-based C++ wrapper for the GS1 Barcode Syntax Engine (requires
- * C++17 or later). Provides idiomatic C++ types (std::string, std::vector,
- * std::optional) and a typed exception hierarchy over the underlying
+ * C++17 or later). Provides idiomatic C++ types (std::string,
+ * std::string_view, std::vector, std::optional) and a typed exception hierarchy over the underlying
  * [C API](@ref capi); the native context is freed automatically when the
  * gs1encoders::GS1Encoder object is destroyed, whether that is at
  * end-of-scope or as part of a longer-lived holder. For an overview,
@@ -66,6 +66,16 @@
  *                                .syntax_dictionary("dict.txt")
  *                                .fallback_on_syndict_error(true));
  * \endcode
+ *
+ * To keep a request's GS1 work within a per-request arena, place the
+ * context in the arena and have the outputs allocated from it:
+ *
+ * \code{.cpp}
+ * std::pmr::monotonic_buffer_resource arena;
+ * gs1encoders::GS1Encoder gs(gs1encoders::InitOpts{}.memory_resource(&arena));
+ * gs.set_ai_data_str("(01)09521234543213(99)TESTING123");
+ * std::pmr::string uri = gs.get_dl_uri("https://example.com", &arena);
+ * \endcode
  */
 
 #ifndef GS1ENCODERS_HPP
@@ -73,11 +83,32 @@
 
 #include "gs1encoders.h"
 
+#include <cstddef>
+#include <iterator>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
+/// @brief Defined as 1 when the wrapper provides the polymorphic allocator
+/// (`std::pmr`) overloads, which require the `<memory_resource>` header.
+/// Define `GS1_ENCODERS_NO_PMR` before including this header to omit them
+/// on platforms whose standard library lacks them.
+#if !defined(GS1_ENCODERS_NO_PMR) && __has_include(<memory_resource>)
+#  include <memory_resource>
+#  define GS1_ENCODERS_HAVE_PMR 1
+#endif
+
+/// @brief Defined as 1 when the wrapper provides compile-time AI data
+/// literals, which require the embedded AI table (`aitable.inc`) alongside
+/// this header, as installed by `make install`. Without it any use of
+/// ai_data_literal() fails the build. Define `GS1_ENCODERS_NO_AI_LITERALS`
+/// before including this header to omit them.
+#if !defined(GS1_ENCODERS_NO_AI_LITERALS) && __has_include("aitable.inc")
+#  define GS1_ENCODERS_HAVE_AI_LITERALS 1
+#endif
+
 /// @addtogroup cppapi
 /// @{
 
@@ -235,15 +266,121 @@ struct InitOpts {
 		return *this;
 	}
 
+#ifdef GS1_ENCODERS_HAVE_PMR
+	/// @brief Place the native context in storage obtained from the
+	/// given memory resource, which must outlive the encoder.
+	///
+	/// The storage is returned to the resource when the encoder is
+	/// destroyed, so with a monotonic resource it is reclaimed when the
+	/// resource is released. The AI table loaded from a Syntax Dictionary
+	/// and the GS1 Digital Link key qualifiers are allocated through the
+	/// library's heap-management functions as usual.
+	///
+	/// @param mr the memory resource, or nullptr to have the library
+	///           allocate the context itself (the default).
+	/// @return reference to this InitOpts, for chaining.
+	InitOpts &memory_resource(std::pmr::memory_resource *mr) {
+		memory_resource_ = mr;
+		return *this;
+	}
+#endif
+
 private:
 	friend class GS1Encoder;
 	std::string syntax_dictionary_;
 	bool has_syntax_dictionary_ = false;
 	bool fallback_on_syndict_error_ = false;
 	bool no_embedded_ = false;
+#ifdef GS1_ENCODERS_HAVE_PMR
+	std::pmr::memory_resource *memory_resource_ = nullptr;
+#endif
+
+};
+
+
+/* ========================================================================
+ *  Views
+ * ======================================================================== */
+
+/// @ingroup cppapi
+/// @brief An AI element extracted from the input data.
+///
+/// Both members refer into the buffers of the gs1encoders::GS1Encoder
+/// that produced the element.
+///
+/// @see gs1encoders::GS1Encoder::ai_elements()
+struct AIElement {
+	std::string_view ai;		///< The AI, e.g. `"01"`.
+	std::string_view value;		///< The AI value.
+};
 
+namespace detail {
+
+inline std::string_view view_of(char *const &s) {
+	return s;
+}
+
+inline AIElement view_of(const gs1_encoder_ai_element_t &e) {
+	return { { e.ai, e.aiLen }, { e.value, e.valueLen } };
+}
+
+/// @brief A read-only range over an array held by the native context,
+/// whose items are converted to views as they are accessed.
+template <typename Raw, typename Value>
+class NativeArrayView {
+public:
+
+	/// @brief Iterator yielding each item by value.
+	class iterator {
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = Value;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = Value;
+
+		explicit iterator(const Raw *p) : p_(p) {}
+		Value operator*() const { return view_of(*p_); }
+		iterator &operator++() { ++p_; return *this; }
+		iterator operator++(int) { iterator t = *this; ++p_; return t; }
+		bool operator==(const iterator &o) const { return p_ == o.p_; }
+		bool operator!=(const iterator &o) const { return p_ != o.p_; }
+
+	private:
+		const Raw *p_;
+	};
+
+	NativeArrayView(const Raw *items, int n)
+		: items_(items), size_(n > 0 ? static_cast<size_t>(n) : 0) {}
+
+	iterator begin() const { return iterator(items_); }
+	iterator end() const { return iterator(items_ + size_); }
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+	Value operator[](size_t i) const { return view_of(items_[i]); }
+
+private:
+	const Raw *items_;
+	size_t size_;
 };
 
+} /* namespace detail */
+
+/// @ingroup cppapi
+/// @brief A read-only range of the strings held by an encoder, yielded
+/// as `std::string_view`.
+///
+/// @see gs1encoders::GS1Encoder::hri_view()
+/// @see gs1encoders::GS1Encoder::dl_ignored_query_params_view()
+using StringListView = detail::NativeArrayView<char *, std::string_view>;
+
+/// @ingroup cppapi
+/// @brief A read-only range of the AI elements extracted by an encoder,
+/// yielded as gs1encoders::AIElement.
+///
+/// @see gs1encoders::GS1Encoder::ai_elements()
+using AIElementRange = detail::NativeArrayView<gs1_encoder_ai_element_t, AIElement>;
+
 
 /* ========================================================================
  *  GS1Encoder wrapper
@@ -262,6 +399,18 @@ private:
 /// The library is thread-safe provided that each thread operates on its
 /// own GS1Encoder instance. This applies also to the const accessors,
 /// which mutate internal buffers of the native context.
+///
+/// The accessors returning std::string copy the result out of the native
+/// context. Each has a counterpart returning `std::string_view` (or a
+/// range of them) that refers directly into the native context instead,
+/// for callers that want to avoid the allocation:
+///
+///   * data_str_view() and ai_elements() are valid until the next
+///     setter is called;
+///   * ai_data_str_view(), dl_uri_view(), scan_data_view(), hri_view()
+///     and dl_ignored_query_params_view() share an output buffer, so are
+///     valid only until the next setter or the next call to any of these;
+///   * err_markup_view() is valid until the next call to any method.
 class GS1Encoder {
 public:
 
@@ -308,10 +457,21 @@ public:
 		                                   ? opts.syntax_dictionary_.c_str()
 		                                   : nullptr;
 
-		ctx_ = gs1_encoder_init_ex(nullptr, &native_opts);
-		if (!ctx_)
+		void *mem = nullptr;
+#ifdef GS1_ENCODERS_HAVE_PMR
+		if (opts.memory_resource_) {
+			mem = opts.memory_resource_->allocate(
+				gs1_encoder_instanceSize(), CONTEXT_ALIGN);
+			memory_resource_ = opts.memory_resource_;
+		}
+#endif
+
+		ctx_ = gs1_encoder_init_ex(mem, &native_opts);
+		if (!ctx_) {
+			release_storage(mem);
 			throw GS1EncoderGeneralException(
 				*msg ? msg : "Failed to initialise the native library");
+		}
 
 		if (status == GS1_ENCODERS_INIT_FALLBACK_TO_EMBEDDED_TABLE && *msg)
 			init_fallback_warning_ = msg;
@@ -322,8 +482,7 @@ public:
 	/// Safe to invoke on a moved-from object (which holds no context).
 	///
 	~GS1Encoder() {
-		if (ctx_)
-			gs1_encoder_free(ctx_);
+		free_context();
 	}
 
 	/// @brief Copy construction is deleted: the underlying native
@@ -342,6 +501,9 @@ public:
 	/// other than destruction or move-assignment.
 	GS1Encoder(GS1Encoder &&other) noexcept
 		: ctx_(other.ctx_),
+#ifdef GS1_ENCODERS_HAVE_PMR
+		  memory_resource_(other.memory_resource_),
+#endif
 		  init_fallback_warning_(std::move(other.init_fallback_warning_)) {
 		other.ctx_ = nullptr;
 	}
@@ -356,15 +518,63 @@ public:
 	/// no-op.
 	GS1Encoder &operator=(GS1Encoder &&other) noexcept {
 		if (this != &other) {
-			if (ctx_)
-				gs1_encoder_free(ctx_);
+			free_context();
 			ctx_                   = other.ctx_;
+#ifdef GS1_ENCODERS_HAVE_PMR
+			memory_resource_       = other.memory_resource_;
+#endif
 			init_fallback_warning_ = std::move(other.init_fallback_warning_);
 			other.ctx_             = nullptr;
 		}
 		return *this;
 	}
 
+	/// @brief Create a new encoder that is a copy of this one.
+	///
+	/// The new encoder has the same options and validation settings, and
+	/// shares the AI table and GS1 Digital Link key-qualifier data rather
+	/// than loading them again, so this is much cheaper than constructing a
+	/// new encoder. The message data and error state are not copied. The
+	/// encoders may then be used and destroyed independently, including on
+	/// different threads. This encoder is not modified, so may be cloned by
+	/// several threads at once provided that none of them is otherwise
+	/// using it.
+	///
+	/// Any memory resource given by gs1encoders::InitOpts::memory_resource()
+	/// is also used for the new encoder.
+	///
+	/// @return the new encoder.
+	/// @throws GS1EncoderGeneralException if the copy cannot be allocated.
+	/// @see reset()
+	GS1Encoder clone() const {
+		void *mem = nullptr;
+#ifdef GS1_ENCODERS_HAVE_PMR
+		if (memory_resource_)
+			mem = memory_resource_->allocate(
+				gs1_encoder_instanceSize(), CONTEXT_ALIGN);
+#endif
+		gs1_encoder *ctx = gs1_encoder_clone(ctx_, mem);
+		if (!ctx) {
+			release_storage(mem);
+			throw GS1EncoderGeneralException("Failed to allocate memory for encoder context");
+		}
+		GS1Encoder copy(ctx);
+#ifdef GS1_ENCODERS_HAVE_PMR
+		copy.memory_resource_ = memory_resource_;
+#endif
+		copy.init_fallback_warning_ = init_fallback_warning_;
+		return copy;
+	}
+
+	/// @brief Restore the default options and validation settings, and
+	/// clear the message data and error state, without reloading the AI
+	/// table.
+	///
+	/// @see clone()
+	void reset() noexcept {
+		gs1_encoder_reset(ctx_);
+	}
+
 
 	/* ----------------------------------------------------------------
 	 *  Initialisation outcome
@@ -623,8 +833,18 @@ public:
 	/// @see set_ai_data_str()
 	/// @see set_scan_data()
 	std::string data_str() const {
+		return std::string(data_str_view());
+	}
+	/// @brief Get the raw barcode message data as a view.
+	///
+	/// As data_str(), but without copying. The view is valid until the
+	/// next setter is called.
+	///
+	/// @return a view of the raw barcode data input buffer.
+	/// @see data_str()
+	std::string_view data_str_view() const {
 		const char *s = gs1_encoder_getDataStr(ctx_);
-		return s ? s : std::string();
+		return s ? s : std::string_view();
 	}
 	/// @brief Set the raw barcode message data.
 	///
@@ -654,15 +874,16 @@ public:
 	///       set_ai_data_str(), which inserts FNC1 characters
 	///       automatically.
 	///
-	/// @param v the raw barcode data to be set.
+	/// @param v the raw barcode data to be set, which must not contain
+	///          a NUL character.
 	/// @throws GS1EncoderParameterException if the data is invalid;
 	///         err_markup() identifies the offending AI on a linting
 	///         failure.
 	/// @see data_str()
 	/// @see set_ai_data_str()
 	/// @see err_markup()
-	void set_data_str(const std::string &v) {
-		check_param(gs1_encoder_setDataStr(ctx_, v.c_str()));
+	void set_data_str(std::string_view v) {
+		check_param(gs1_encoder_setDataStrN(ctx_, v.data(), v.size()));
 	}
 
 	/// @brief Get the barcode data input rendered as a bracketed AI
@@ -677,8 +898,20 @@ public:
 	/// @see set_ai_data_str()
 	/// @see data_str()
 	std::string ai_data_str() const {
+		return std::string(ai_data_str_view());
+	}
+	/// @brief Get the barcode data input rendered as a bracketed AI
+	/// element string, as a view.
+	///
+	/// As ai_data_str(), but without copying. The view refers into the
+	/// shared output buffer.
+	///
+	/// @return a view of the bracketed AI element string, or an empty
+	///         view when no AI data is set.
+	/// @see ai_data_str()
+	std::string_view ai_data_str_view() const {
 		const char *s = gs1_encoder_getAIdataStr(ctx_);
-		return s ? s : std::string();
+		return s ? s : std::string_view();
 	}
 	/// @brief Set the barcode data input from a bracketed GS1 AI
 	/// element string.
@@ -708,15 +941,16 @@ public:
 	/// can be separated with a `"|"` character, e.g.
 	/// `(01)12345678901231|(10)ABC123(11)210630`.
 	///
-	/// @param v the bracketed AI element string to be parsed.
+	/// @param v the bracketed AI element string to be parsed, which
+	///          must not contain a NUL character.
 	/// @throws GS1EncoderParameterException if the data is invalid;
 	///         err_markup() identifies the offending AI on a linting
 	///         failure.
 	/// @see ai_data_str()
 	/// @see set_data_str()
 	/// @see err_markup()
-	void set_ai_data_str(const std::string &v) {
-		check_param(gs1_encoder_setAIdataStr(ctx_, v.c_str()));
+	void set_ai_data_str(std::string_view v) {
+		check_param(gs1_encoder_setAIdataStrN(ctx_, v.data(), v.size()));
 	}
 
 	/// @brief Render the current AI-based input data as a GS1 Digital
@@ -736,8 +970,31 @@ public:
 	/// @see set_ai_data_str()
 	/// @see set_data_str()
 	std::string get_dl_uri(const std::string &stem) const {
-		const char *uri = gs1_encoder_getDLuri(
-			ctx_, stem.empty() ? nullptr : stem.c_str());
+		return std::string(dl_uri_view(stem));
+	}
+	/// @brief Render the current AI-based input data as a GS1 Digital
+	/// Link URI, as a view.
+	///
+	/// As get_dl_uri(), but without copying the result. The view refers
+	/// into the shared output buffer.
+	///
+	/// @param stem URI stem used as a prefix; pass an empty view to use
+	///             the GS1 canonical stem.
+	/// @return a view of the GS1 Digital Link URI for the current data.
+	/// @throws GS1EncoderDigitalLinkException if the current data
+	///         cannot be expressed as a GS1 Digital Link URI.
+	/// @see get_dl_uri()
+	std::string_view dl_uri_view(std::string_view stem = {}) const {
+		const char *uri;
+		if (stem.empty()) {
+			uri = gs1_encoder_getDLuri(ctx_, nullptr);
+		} else if (stem.size() < STEM_BUF_SIZE) {
+			char buf[STEM_BUF_SIZE];
+			buf[stem.copy(buf, stem.size())] = '\0';
+			uri = gs1_encoder_getDLuri(ctx_, buf);
+		} else {
+			uri = gs1_encoder_getDLuri(ctx_, std::string(stem).c_str());
+		}
 		if (!uri)
 			throw GS1EncoderDigitalLinkException(get_err_msg());
 		return uri;
@@ -759,6 +1016,20 @@ public:
 	/// @see set_scan_data()
 	/// @see sym()
 	std::string scan_data() const {
+		return std::string(scan_data_view());
+	}
+	/// @brief Get the scan data string a reader would return for the
+	/// current data and symbology, as a view.
+	///
+	/// As scan_data(), but without copying. The view refers into the
+	/// shared output buffer.
+	///
+	/// @return a view of the scan data string.
+	/// @throws GS1EncoderScanDataException if no symbology is selected
+	///         or the current data cannot be represented in the
+	///         selected symbology.
+	/// @see scan_data()
+	std::string_view scan_data_view() const {
 		const char *s = gs1_encoder_getScanData(ctx_);
 		if (!s)
 			throw GS1EncoderScanDataException(get_err_msg());
@@ -791,14 +1062,15 @@ public:
 	///       such.
 	///
 	/// @param v the normalised scan data string, including the AIM
-	///          Symbology Identifier prefix.
+	///          Symbology Identifier prefix, which must not contain a
+	///          NUL character.
 	/// @throws GS1EncoderScanDataException if the scan data cannot be
 	///         processed (for example because the AIM identifier is
 	///         missing or the embedded data fails validation).
 	/// @see scan_data()
 	/// @see sym()
-	void set_scan_data(const std::string &v) {
-		if (!gs1_encoder_setScanData(ctx_, v.c_str()))
+	void set_scan_data(std::string_view v) {
+		if (!gs1_encoder_setScanDataN(ctx_, v.data(), v.size()))
 			throw GS1EncoderScanDataException(get_err_msg());
 	}
 
@@ -831,6 +1103,38 @@ public:
 			result.emplace_back(lines[i]);
 		return result;
 	}
+	/// @brief Get the Human-Readable Interpretation ("HRI") text for
+	/// the current input data, as a range of views.
+	///
+	/// As hri(), but without copying. The range refers into the shared
+	/// output buffer.
+	///
+	/// @return a range yielding one `std::string_view` per HRI line.
+	/// @see hri()
+	StringListView hri_view() const {
+		char **lines = nullptr;
+		int n = gs1_encoder_getHRI(ctx_, &lines);
+		return StringListView(lines, n);
+	}
+
+	/// @brief Get the AI elements extracted from the current input data.
+	///
+	/// Yields a gs1encoders::AIElement for each AI in the order they
+	/// appear in the data, for example for input
+	/// `(01)12312312312333(10)ABC123` the elements are `{"01",
+	/// "12312312312333"}` and `{"10", "ABC123"}`. No text is rendered and
+	/// nothing is copied: the views refer into the input data buffers, so
+	/// remain valid until the next setter is called.
+	///
+	/// The range is empty when the input does not contain AI data.
+	///
+	/// @return a range yielding each AI element.
+	/// @see hri()
+	AIElementRange ai_elements() const {
+		const gs1_encoder_ai_element_t *elements = nullptr;
+		int n = gs1_encoder_getAIelements(ctx_, &elements);
+		return AIElementRange(elements, n);
+	}
 
 	/// @brief Get the non-numeric (ignored) query parameters from a
 	/// GS1 Digital Link URI.
@@ -864,6 +1168,20 @@ public:
 			result.emplace_back(qp[i]);
 		return result;
 	}
+	/// @brief Get the non-numeric (ignored) query parameters from a
+	/// GS1 Digital Link URI, as a range of views.
+	///
+	/// As dl_ignored_query_params(), but without copying. The range
+	/// refers into the shared output buffer.
+	///
+	/// @return a range yielding one `std::string_view` per ignored query
+	///         parameter.
+	/// @see dl_ignored_query_params()
+	StringListView dl_ignored_query_params_view() const {
+		char **qp = nullptr;
+		int n = gs1_encoder_getDLignoredQueryParams(ctx_, &qp);
+		return StringListView(qp, n);
+	}
 
 	/// @brief Get the marked-up offending AI from the most recent
 	/// linting failure.
@@ -882,17 +1200,141 @@ public:
 	/// @see set_data_str()
 	/// @see set_ai_data_str()
 	std::string err_markup() const {
+		return std::string(err_markup_view());
+	}
+	/// @brief Get the marked-up offending AI from the most recent
+	/// linting failure, as a view.
+	///
+	/// As err_markup(), but without copying. The view is valid until
+	/// the next call to any method of this instance.
+	///
+	/// @return a view of the marked-up offending AI, or an empty view.
+	/// @see err_markup()
+	std::string_view err_markup_view() const {
 		const char *s = gs1_encoder_getErrMarkup(ctx_);
-		return s ? s : std::string();
+		return s ? s : std::string_view();
+	}
+
+#ifdef GS1_ENCODERS_HAVE_PMR
+
+	/* ----------------------------------------------------------------
+	 *  Outputs allocated from a memory resource
+	 *
+	 *  Each of these is as the accessor of the same name, except that
+	 *  the result is allocated from the given std::pmr::memory_resource
+	 *  rather than the global heap. Only the messages of any exceptions
+	 *  thrown are allocated from the global heap.
+	 * ---------------------------------------------------------------- */
+
+	/// @brief As data_str(), with the result allocated from `mr`.
+	/// @param mr memory resource from which to allocate the result.
+	/// @return the raw barcode data input buffer.
+	std::pmr::string data_str(std::pmr::memory_resource *mr) const {
+		return std::pmr::string(data_str_view(), mr);
+	}
+
+	/// @brief As ai_data_str(), with the result allocated from `mr`.
+	/// @param mr memory resource from which to allocate the result.
+	/// @return the bracketed AI element string, or an empty string when
+	///         no AI data is set.
+	std::pmr::string ai_data_str(std::pmr::memory_resource *mr) const {
+		return std::pmr::string(ai_data_str_view(), mr);
+	}
+
+	/// @brief As get_dl_uri(), with the result allocated from `mr`.
+	/// @param stem URI stem used as a prefix; pass an empty string to
+	///             use the GS1 canonical stem.
+	/// @param mr memory resource from which to allocate the result.
+	/// @return the GS1 Digital Link URI for the current data.
+	/// @throws GS1EncoderDigitalLinkException if the current data
+	///         cannot be expressed as a GS1 Digital Link URI.
+	std::pmr::string get_dl_uri(std::string_view stem,
+	                            std::pmr::memory_resource *mr) const {
+		return std::pmr::string(dl_uri_view(stem), mr);
+	}
+
+	/// @brief As scan_data(), with the result allocated from `mr`.
+	/// @param mr memory resource from which to allocate the result.
+	/// @return the scan data string.
+	/// @throws GS1EncoderScanDataException if no symbology is selected
+	///         or the current data cannot be represented in the
+	///         selected symbology.
+	std::pmr::string scan_data(std::pmr::memory_resource *mr) const {
+		return std::pmr::string(scan_data_view(), mr);
+	}
+
+	/// @brief As hri(), with the result allocated from `mr`.
+	/// @param mr memory resource from which to allocate the result.
+	/// @return one string per HRI line.
+	std::pmr::vector<std::pmr::string> hri(std::pmr::memory_resource *mr) const {
+		return to_pmr_vector(hri_view(), mr);
+	}
+
+	/// @brief As dl_ignored_query_params(), with the result allocated
+	/// from `mr`.
+	/// @param mr memory resource from which to allocate the result.
+	/// @return one string per ignored query parameter.
+	std::pmr::vector<std::pmr::string> dl_ignored_query_params(
+			std::pmr::memory_resource *mr) const {
+		return to_pmr_vector(dl_ignored_query_params_view(), mr);
+	}
+
+	/// @brief As err_markup(), with the result allocated from `mr`.
+	/// @param mr memory resource from which to allocate the result.
+	/// @return the marked-up offending AI, or an empty string.
+	std::pmr::string err_markup(std::pmr::memory_resource *mr) const {
+		return std::pmr::string(err_markup_view(), mr);
 	}
 
+#endif
+
 private:
 
 	static constexpr size_t MSG_BUF_SIZE = 256;
+	static constexpr size_t STEM_BUF_SIZE = 256;
+	static constexpr size_t CONTEXT_ALIGN = alignof(std::max_align_t);
 
 	gs1_encoder *ctx_ = nullptr;
+#ifdef GS1_ENCODERS_HAVE_PMR
+	std::pmr::memory_resource *memory_resource_ = nullptr;
+#endif
 	std::string init_fallback_warning_;
 
+	// Takes ownership of a context created by clone()
+	explicit GS1Encoder(gs1_encoder *ctx) noexcept : ctx_(ctx) {}
+
+	void release_storage(void *mem) const noexcept {
+#ifdef GS1_ENCODERS_HAVE_PMR
+		if (mem)
+			memory_resource_->deallocate(
+				mem, gs1_encoder_instanceSize(), CONTEXT_ALIGN);
+#else
+		(void)mem;
+#endif
+	}
+
+#ifdef GS1_ENCODERS_HAVE_PMR
+	static std::pmr::vector<std::pmr::string> to_pmr_vector(
+			const StringListView &items, std::pmr::memory_resource *mr) {
+		std::pmr::vector<std::pmr::string> result(mr);
+		result.reserve(items.size());
+		for (std::string_view item : items)
+			result.emplace_back(item);
+		return result;
+	}
+#endif
+
+	void free_context() noexcept {
+		if (!ctx_)
+			return;
+		gs1_encoder_free(ctx_);
+#ifdef GS1_ENCODERS_HAVE_PMR
+		if (memory_resource_)
+			release_storage(ctx_);
+#endif
+		ctx_ = nullptr;
+	}
+
 	std::string get_err_msg() const {
 		const char *m = gs1_encoder_getErrMsg(ctx_);
 		return m ? m : std::string();
@@ -905,6 +1347,313 @@ private:
 
 };
 
+
+#ifdef GS1_ENCODERS_HAVE_AI_LITERALS
+
+/* ========================================================================
+ *  Compile-time AI data literals
+ * ======================================================================== */
+
+/// @brief `consteval` where supported (C++20), so that an invalid literal
+/// is always a compile-time error, otherwise `constexpr`.
+#if defined(__cpp_consteval)
+#  define GS1_ENCODERS_CONSTEVAL consteval
+#else
+#  define GS1_ENCODERS_CONSTEVAL constexpr
+#endif
+
+namespace detail {
+
+struct LiteralAIcomponent {
+	char cset;				// 'N', 'X', 'Y', 'Z', or '\0' for none
+	unsigned char min;
+	unsigned char max;
+	bool opt;
+	bool csum;				// Has the csum linter
+};
+
+struct LiteralAIentry {
+	std::string_view ai;
+	bool fnc1;
+	LiteralAIcomponent parts[5];
+};
+
+/*
+ *  The embedded AI table is included with its entries converted to
+ *  LiteralAIentry, keeping the parts of the specification that can be
+ *  checked at compile time. Each AI_ENTRY argument is stringised, so the
+ *  table's symbolic names (N, MAN, csum, etc.) need no definitions.
+ *
+ */
+#define GS1_ENCODERS_LITERAL_PASS_ON(...) __VA_ARGS__
+#define GS1_ENCODERS_LITERAL_PART(c, mn, mx, o, l0, l1, l2) {			\
+		#c[0] == '0' ? '\0' : #c[0], mn, mx, #o[0] == 'O',		\
+		std::string_view(#l0) == "csum" ||				\
+		std::string_view(#l1) == "csum" ||				\
+		std::string_view(#l2) == "csum" }
+#define GS1_ENCODERS_LITERAL_AI(a, f, d,					\
+		c1,mn1,mx1,o1,l00,l01,l02, c2,mn2,mx2,o2,l10,l11,l12,		\
+		c3,mn3,mx3,o3,l20,l21,l22, c4,mn4,mx4,o4,l30,l31,l32,		\
+		c5,mn5,mx5,o5,l40,l41,l42, k, t) { a, #f[0] == 'D', {		\
+		GS1_ENCODERS_LITERAL_PART(c1,mn1,mx1,o1,l00,l01,l02),		\
+		GS1_ENCODERS_LITERAL_PART(c2,mn2,mx2,o2,l10,l11,l12),		\
+		GS1_ENCODERS_LITERAL_PART(c3,mn3,mx3,o3,l20,l21,l22),		\
+		GS1_ENCODERS_LITERAL_PART(c4,mn4,mx4,o4,l30,l31,l32),		\
+		GS1_ENCODERS_LITERAL_PART(c5,mn5,mx5,o5,l40,l41,l42) } }
+
+#pragma push_macro("AI_ENTRY")
+#pragma push_macro("AI_ENTRY_TERMINATOR")
+#pragma push_macro("__")
+#undef AI_ENTRY
+#undef AI_ENTRY_TERMINATOR
+#undef __
+#define AI_ENTRY(...) GS1_ENCODERS_LITERAL_PASS_ON(GS1_ENCODERS_LITERAL_AI(__VA_ARGS__))
+#define AI_ENTRY_TERMINATOR
+#define __ 0,0,0,0,_,_,_
+
+inline constexpr LiteralAIentry literal_ai_table[] = {
+#include "aitable.inc"
+};
+
+#undef AI_ENTRY
+#undef AI_ENTRY_TERMINATOR
+#undef __
+#pragma pop_macro("AI_ENTRY")
+#pragma pop_macro("AI_ENTRY_TERMINATOR")
+#pragma pop_macro("__")
+#undef GS1_ENCODERS_LITERAL_AI
+#undef GS1_ENCODERS_LITERAL_PART
+#undef GS1_ENCODERS_LITERAL_PASS_ON
+
+// The table is sorted, as for the library's own binary search
+constexpr const LiteralAIentry *lookup_literal_ai(std::string_view ai) {
+	size_t lo = 0, hi = std::size(literal_ai_table);
+	while (lo < hi) {
+		const size_t mid = lo + (hi - lo) / 2;
+		const int cmp = literal_ai_table[mid].ai.compare(ai);
+		if (cmp == 0)
+			return &literal_ai_table[mid];
+		if (cmp < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return nullptr;
+}
+
+constexpr bool in_literal_cset(char cset, char c) {
+	const bool digit = c >= '0' && c <= '9';
+	const bool alpha = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+	switch (cset) {
+		case 'N':
+			return digit;
+		case 'X':
+			return digit || alpha ||
+			       std::string_view("!\"%&'()*+,-./:;<=>?_").find(c) != std::string_view::npos;
+		case 'Y':
+			return digit || (c >= 'A' && c <= 'Z') || c == '#' || c == '-' || c == '/';
+		case 'Z':
+			return digit || alpha || c == '-' || c == '_';
+		default:
+			return false;
+	}
+}
+
+constexpr bool literal_csum_valid(std::string_view v) {
+	int sum = 0;
+	int weight = v.size() % 2 == 0 ? 3 : 1;
+	for (size_t i = 0; i < v.size() - 1; i++) {
+		sum += (v[i] - '0') * weight;
+		weight = 4 - weight;
+	}
+	return (sum + v.back() - '0') % 10 == 0;
+}
+
+/*
+ *  Check an AI value against the components of its entry, in the manner of
+ *  the library's own component-based validation.
+ *
+ */
+constexpr void check_literal_ai_value(const LiteralAIentry &entry, std::string_view value) {
+	size_t min = 0, max = 0;
+	for (const LiteralAIcomponent &part : entry.parts) {
+		if (!part.cset)
+			break;
+		min += part.opt ? 0 : part.min;
+		max += part.max;
+	}
+	if (value.empty())
+		throw GS1EncoderParameterException("AI data is empty");
+	if (value.size() < min)
+		throw GS1EncoderParameterException("AI value is too short");
+	if (value.size() > max)
+		throw GS1EncoderParameterException("AI value is too long");
+	if (value.find('^') != std::string_view::npos)
+		throw GS1EncoderParameterException("AI contains illegal ^ character");
+
+	for (const LiteralAIcomponent &part : entry.parts) {
+		if (!part.cset)
+			break;
+		const size_t complen = value.size() < part.max ? value.size() : part.max;
+		if (part.opt && complen == 0)
+			continue;
+		if (complen < part.min)
+			throw GS1EncoderParameterException("AI data has incorrect length");
+		std::string_view comp = value.substr(0, complen);
+		if (part.cset == 'Z') {		// Up to two "=" padding characters
+			size_t pads = 0;
+			while (pads < comp.size() && comp[comp.size() - pads - 1] == '=')
+				pads++;
+			if (pads > 2 || (pads > 0 && comp.size() % 3 != 0))
+				throw GS1EncoderParameterException("AI value has invalid CSET 64 padding");
+			comp.remove_suffix(pads);
+		}
+		for (char c : comp)
+			if (!in_literal_cset(part.cset, c))
+				throw GS1EncoderParameterException("AI value contains an invalid character");
+		if (part.csum && !literal_csum_valid(comp))
+			throw GS1EncoderParameterException("AI value has an incorrect check digit");
+		value.remove_prefix(complen);
+	}
+}
+
+/*
+ *  Convert bracketed AI data to the unbracketed form with "^" = FNC1, in the
+ *  manner of gs1_encoder_setAIdataStr(), writing to out which has room for
+ *  at least in.size() + 1 characters.
+ *
+ */
+constexpr size_t parse_ai_literal(std::string_view in, char *out) {
+	size_t i = 0, o = 0;
+	bool fnc1req = true;
+	bool composite = false;
+
+	for (;;) {
+		if (i >= in.size() || in[i] != '(')
+			throw GS1EncoderParameterException("Expected ( at the start of an AI");
+		const size_t aiStart = ++i;
+		while (i < in.size() && in[i] != ')')
+			i++;
+		if (i >= in.size())
+			throw GS1EncoderParameterException("Expected ) at the end of an AI");
+		const std::string_view ai = in.substr(aiStart, i++ - aiStart);
+		const LiteralAIentry *entry = lookup_literal_ai(ai);
+		if (!entry)
+			throw GS1EncoderParameterException("Unrecognised AI");
+
+		if (fnc1req)
+			out[o++] = '^';
+		for (char c : ai)
+			out[o++] = c;
+		fnc1req = entry->fnc1;
+
+		const size_t valStart = o;
+		for (; i < in.size() && in[i] != '|'; i++) {
+			if (in[i] == '(') {
+				if (in[i - 1] != '\\')
+					break;				// Start of the next AI
+				out[o - 1] = '(';			// Escaped data bracket
+				continue;
+			}
+			out[o++] = in[i];
+		}
+		check_literal_ai_value(*entry, std::string_view(out + valStart, o - valStart));
+
+		if (i == in.size())
+			break;
+		if (in[i] == '|') {
+			if (composite || (i + 1 < in.size() && in[i + 1] == '|'))
+				throw GS1EncoderParameterException("AI data contains more than one composite separator");
+			if (i + 1 == in.size())
+				throw GS1EncoderParameterException("AI data has an empty composite component");
+			composite = true;
+			fnc1req = true;
+			out[o++] = '|';
+			i++;
+		}
+	}
+
+	out[o] = '\0';
+	return o;
+}
+
+} /* namespace detail */
+
+/// @ingroup cppapi
+/// @brief An unbracketed GS1 AI element string produced from a bracketed
+/// literal by gs1encoders::ai_data_literal().
+///
+/// @tparam N capacity, including the NUL terminator.
+template <size_t N>
+class AIdataLiteral {
+public:
+
+	/// @brief Get the unbracketed AI element string, with `"^"`
+	/// representing FNC1, as accepted by GS1Encoder::set_data_str().
+	constexpr std::string_view str() const { return { data_, size_ }; }
+
+	/// @brief Get the NUL-terminated unbracketed AI element string.
+	constexpr const char *c_str() const { return data_; }
+
+	/// @brief Get the length of the unbracketed AI element string.
+	constexpr size_t size() const { return size_; }
+
+	/// @brief Convert to the unbracketed AI element string.
+	constexpr operator std::string_view() const { return str(); }
+
+private:
+	template <size_t M>
+	friend GS1_ENCODERS_CONSTEVAL AIdataLiteral<M> ai_data_literal(const char (&)[M]);
+
+	char data_[N] = {};
+	size_t size_ = 0;
+};
+
+/// @ingroup cppapi
+/// @brief Validate a bracketed GS1 AI element string literal and convert
+/// it to the unbracketed form at compile time.
+///
+/// The literal is given in the syntax accepted by
+/// GS1Encoder::set_ai_data_str(), including escaped `"\("` data characters
+/// and a `"|"` separating a composite component. Each AI must be present
+/// in the embedded AI table, and each AI value is checked against the
+/// components of the AI's specification: length, character set and check
+/// digit. An invalid literal fails the build:
+///
+/// \code{.cpp}
+/// constexpr auto label = gs1encoders::ai_data_literal("(01)09521234543213(10)ABC123");
+/// static_assert(label.str() == "^010952123454321310ABC123");
+/// gs.set_data_str(label);
+/// \endcode
+///
+/// The other linters and the validations between AIs, such as requisite
+/// AIs, are applied when the data is set at runtime. Before C++20 the
+/// conversion only happens at compile time when the result initialises a
+/// `constexpr` variable; otherwise it happens at runtime, and an invalid
+/// literal throws gs1encoders::GS1EncoderParameterException.
+///
+/// @param aiData the bracketed AI element string literal.
+/// @return the unbracketed AI element string.
+template <size_t N>
+GS1_ENCODERS_CONSTEVAL AIdataLiteral<N> ai_data_literal(const char (&aiData)[N]) {
+	static_assert(N > 1, "AI data literal must not be empty");
+	AIdataLiteral<N> lit;
+	lit.size_ = detail::parse_ai_literal(std::string_view(aiData, N - 1), lit.data_);
+	return lit;
+}
+
+#elif !defined(GS1_ENCODERS_NO_AI_LITERALS)
+
+/// \cond
+// Report a missing AI table where a literal is requested, rather than as an unknown name
+template <size_t N>
+void ai_data_literal(const char (&)[N]) {
+	static_assert(N == 0, "ai_data_literal() requires the embedded AI table, aitable.inc, alongside gs1encoders.hpp");
+}
+/// \endcond
+
+#endif /* GS1_ENCODERS_HAVE_AI_LITERALS */
+
 } /* namespace gs1encoders */
 
 /// @}  // end of cppapi group
@@ -0,0 +1,51 @@
+/*
+ *  Profiling heap management: accounts for the library's heap usage.
+ *
+ *  Select with -DGS1_ENCODERS_CUSTOM_HEAP_MANAGEMENT_H=profile-heap.h (or
+ *  "make PROFILE_HEAP=yes") to have every allocation made through the
+ *  library's heap hooks counted, along with the bytes requested, the bytes
+ *  live and the peak. Usage is attributed to the subsystem that made the
+ *  allocation, as given by GS1_ENCODERS_HEAP_SUBSYSTEM at the call site.
+ *
+ *  The figures are read with gs1_encoder_getHeapProfile(). The accounting is
+ *  process-wide and is not thread-safe, so profile from a single thread.
+ *
+ *  Each block is prefixed with a small header recording its size and
+ *  subsystem, so memory allocated through these hooks must only be released
+ *  through them. The definitions live in gs1encoders.c.
+ *
+ *  Unit tests built with these hooks ("make test PROFILE_HEAP=yes") keep the
+ *  allocation failure injection of test-heap.h.
+ */
+#ifndef PROFILE_HEAP_H
+#define PROFILE_HEAP_H
+
+#include <stddef.h>
+
+#ifdef UNIT_TESTS
+#include "test-heap.h"
+#undef GS1_ENCODERS_CUSTOM_MALLOC
+#undef GS1_ENCODERS_CUSTOM_CALLOC
+#undef GS1_ENCODERS_CUSTOM_REALLOC
+#undef GS1_ENCODERS_CUSTOM_FREE
+#endif
+
+#define GS1_ENCODERS_HEAP_PROFILE
+
+void* gs1_heapProfileMalloc(size_t sz, int subsystem);
+void* gs1_heapProfileCalloc(size_t nm, size_t sz, int subsystem);
+void* gs1_heapProfileRealloc(void *p, size_t sz, int subsystem);
+void gs1_heapProfileFree(void *p);
+
+#define GS1_ENCODERS_CUSTOM_MALLOC(sz) \
+	gs1_heapProfileMalloc(sz, GS1_ENCODERS_HEAP_SUBSYSTEM)
+
+#define GS1_ENCODERS_CUSTOM_CALLOC(nm, sz) \
+	gs1_heapProfileCalloc(nm, sz, GS1_ENCODERS_HEAP_SUBSYSTEM)
+
+#define GS1_ENCODERS_CUSTOM_REALLOC(p, sz) \
+	gs1_heapProfileRealloc(p, sz, GS1_ENCODERS_HEAP_SUBSYSTEM)
+
+#define GS1_ENCODERS_CUSTOM_FREE(p) gs1_heapProfileFree(p)
+
+#endif
@@ -37,52 +37,58 @@ typedef enum {
 } aiMode_t;
 
 
+/*
+ *  Symbology identifiers are looked up directly by symbology and AI mode, and
+ *  in reverse by the two characters of the AIM identifier.
+ *
+ *  Where several symbologies share an identifier the reverse table holds the
+ *  default, which is the symbology assumed when processing scan data.
+ *
+ */
+static const char symIdBySym[gs1_encoder_sNUMSYMS][2][3] = {
+	[gs1_encoder_sDataBarOmni]        = { [aiMode_AI] = "e0", [aiMode_NON_AI] = "e0" },
+	[gs1_encoder_sDataBarTruncated]   = { [aiMode_AI] = "e0", [aiMode_NON_AI] = "e0" },
+	[gs1_encoder_sDataBarStacked]     = { [aiMode_AI] = "e0", [aiMode_NON_AI] = "e0" },
+	[gs1_encoder_sDataBarStackedOmni] = { [aiMode_AI] = "e0", [aiMode_NON_AI] = "e0" },
+	[gs1_encoder_sDataBarLimited]     = { [aiMode_AI] = "e0", [aiMode_NON_AI] = "e0" },
+	[gs1_encoder_sDataBarExpanded]    = { [aiMode_AI] = "e0"                         },
+	[gs1_encoder_sUPCA]               = { [aiMode_AI] = "E0", [aiMode_NON_AI] = "E0" },
+	[gs1_encoder_sUPCE]               = { [aiMode_AI] = "E0", [aiMode_NON_AI] = "E0" },
+	[gs1_encoder_sEAN13]              = { [aiMode_AI] = "E0", [aiMode_NON_AI] = "E0" },
+	[gs1_encoder_sEAN8]               = { [aiMode_AI] = "E4", [aiMode_NON_AI] = "E4" },
+	[gs1_encoder_sGS1_128_CCA]        = { [aiMode_AI] = "C1"                         },
+	[gs1_encoder_sGS1_128_CCC]        = { [aiMode_AI] = "C1"                         },
+	[gs1_encoder_sQR]                 = { [aiMode_AI] = "Q3", [aiMode_NON_AI] = "Q1" },
+	[gs1_encoder_sDM]                 = { [aiMode_AI] = "d2", [aiMode_NON_AI] = "d1" },
+	[gs1_encoder_sDotCode]            = { [aiMode_AI] = "J1", [aiMode_NON_AI] = "J0" },
+};
+
+
 struct symIdEntry {
-	char symId[3];
-	aiMode_t aiMode;
-	gs1_encoder_symbologies_t sym;
+	bool known;
+	uint8_t aiMode;
+	uint8_t sym;
 };
 
+#define SYMID_KEY(c, m) ((size_t)((c) - 'A') * 10 + (size_t)((m) - '0'))
 
-#define SYM(i, a, s) {		\
-	.symId = i,		\
-	.aiMode = aiMode_##a,	\
-	.sym = s,		\
+#define SYM(c, m, a, s) [SYMID_KEY(c, m)] = {	\
+	.known = true,				\
+	.aiMode = aiMode_##a,			\
+	.sym = s,				\
 }
 
-/*
- *  First matching instance in a lookup is the default
- *
- */
-static const struct symIdEntry symIdTable[] = {
-	SYM( "C1", AI,     gs1_encoder_sGS1_128_CCA        ),
-	SYM( "C1", AI,     gs1_encoder_sGS1_128_CCC        ),
-	SYM( "E0", NON_AI, gs1_encoder_sEAN13              ),
-	SYM( "E0", AI,     gs1_encoder_sEAN13              ),
-	SYM( "E0", NON_AI, gs1_encoder_sUPCA               ),
-	SYM( "E0", AI,     gs1_encoder_sUPCA               ),
-	SYM( "E0", NON_AI, gs1_encoder_sUPCE               ),
-	SYM( "E0", AI,     gs1_encoder_sUPCE               ),
-	SYM( "E4", NON_AI, gs1_encoder_sEAN8               ),
-	SYM( "E4", AI,     gs1_encoder_sEAN8               ),
-	SYM( "e0", AI,     gs1_encoder_sDataBarExpanded    ),
-	SYM( "e0", AI,     gs1_encoder_sDataBarOmni        ),
-	SYM( "e0", NON_AI, gs1_encoder_sDataBarOmni        ),
-	SYM( "e0", AI,     gs1_encoder_sDataBarTruncated   ),
-	SYM( "e0", NON_AI, gs1_encoder_sDataBarTruncated   ),
-	SYM( "e0", AI,     gs1_encoder_sDataBarStacked     ),
-	SYM( "e0", NON_AI, gs1_encoder_sDataBarStacked     ),
-	SYM( "e0", AI,     gs1_encoder_sDataBarStackedOmni ),
-	SYM( "e0", NON_AI, gs1_encoder_sDataBarStackedOmni ),
-	SYM( "e0", AI,     gs1_encoder_sDataBarLimited     ),
-	SYM( "e0", NON_AI, gs1_encoder_sDataBarLimited     ),
-	// e0 is also shared with GS1-128 with CC
-	SYM( "d1", NON_AI, gs1_encoder_sDM                 ),
-	SYM( "d2", AI,     gs1_encoder_sDM                 ),
-	SYM( "Q1", NON_AI, gs1_encoder_sQR                 ),
-	SYM( "Q3", AI,     gs1_encoder_sQR                 ),
-	SYM( "J0", NON_AI, gs1_encoder_sDotCode            ),
-	SYM( "J1", AI,     gs1_encoder_sDotCode            ),
+static const struct symIdEntry symIdIndex[SYMID_KEY('z', '9') + 1] = {
+	SYM( 'C', '1', AI,     gs1_encoder_sGS1_128_CCA        ),	// Also GS1-128 with CC-C
+	SYM( 'E', '0', NON_AI, gs1_encoder_sEAN13              ),	// Also UPC-A and UPC-E
+	SYM( 'E', '4', NON_AI, gs1_encoder_sEAN8               ),
+	SYM( 'e', '0', AI,     gs1_encoder_sDataBarExpanded    ),	// Also other DataBar and GS1-128 with CC
+	SYM( 'd', '1', NON_AI, gs1_encoder_sDM                 ),
+	SYM( 'd', '2', AI,     gs1_encoder_sDM                 ),
+	SYM( 'Q', '1', NON_AI, gs1_encoder_sQR                 ),
+	SYM( 'Q', '3', AI,     gs1_encoder_sQR                 ),
+	SYM( 'J', '0', NON_AI, gs1_encoder_sDotCode            ),
+	SYM( 'J', '1', AI,     gs1_encoder_sDotCode            ),
 };
 
 #undef SYM
@@ -92,19 +98,13 @@ static const struct symIdEntry symIdTable[] = {
 
 static const __ATTR_PURE char* lookupSymId(const gs1_encoder* const ctx) {
 
-	size_t i;
-	const char *symId = NULL;
+	const char *symId;
 
-	for (i = 0; i < SIZEOF_ARRAY(symIdTable); i++) {
-		const struct symIdEntry* const entry = &symIdTable[i];
-		if (entry->sym != ctx->sym ||
-		    entry->aiMode != (*ctx->dataStr == '^' ? aiMode_AI : aiMode_NON_AI))
-			continue;
-		symId = entry->symId;
-		break;
-	}
+	assert(ctx->sym > gs1_encoder_sNONE && ctx->sym < gs1_encoder_sNUMSYMS);
 
-	assert(symId);
+	symId = symIdBySym[ctx->sym][*ctx->dataStr == '^' ? aiMode_AI : aiMode_NON_AI];
+
+	assert(*symId);
 
 	return symId;
 
@@ -113,50 +113,83 @@ static const __ATTR_PURE char* lookupSymId(const gs1_encoder* const ctx) {
 
 static void lookupSymAndModeBySymId(const char* const symId, gs1_encoder_symbologies_t* const sym, aiMode_t* const aiMode) {
 
-	size_t i;
+	const struct symIdEntry *entry;
 
 	*sym = gs1_encoder_sNONE;
 	*aiMode = aiMode_NON_AI;
 
-	for (i = 0; i < SIZEOF_ARRAY(symIdTable); i++) {
-		const struct symIdEntry* const entry = &symIdTable[i];
-		if (memcmp(symId, entry->symId, 2) != 0)
-			continue;
-		*sym = entry->sym;
-		*aiMode = entry->aiMode;
-		break;
-	}
+	if (symId[0] < 'A' || symId[0] > 'z' || symId[1] < '0' || symId[1] > '9')
+		return;
+
+	entry = &symIdIndex[SYMID_KEY(symId[0], symId[1])];
+	if (!entry->known)
+		return;
+
+	*sym = (gs1_encoder_symbologies_t)entry->sym;
+	*aiMode = (aiMode_t)entry->aiMode;
 
 }
 
 
-static size_t scancat(char* const out, const char* const in, const size_t out_len) {
+/*
+ *  Append to the output, which must have room for the data and a NUL
+ *  terminator.
+ *
+ */
+static bool scanput(char* const out, const size_t size, size_t* const out_len, const char* const in, const size_t in_len) {
+
+	assert(*out_len < size);
+
+	if (in_len >= size - *out_len)
+		return false;
 
-	const char *p = in;
-	char *q = out + out_len;
+	memcpy(out + *out_len, in, in_len);
+	*out_len += in_len;
+	out[*out_len] = '\0';
 
-	if (*p == '^') {					// GS1 mode
+	return true;
+
+}
+
+
+static bool scanputSymId(const gs1_encoder* const ctx, char* const out, const size_t size, size_t* const out_len) {
+	char symId[3] = { ']' };
+	memcpy(symId + 1, lookupSymId(ctx), 2);
+	return scanput(out, size, out_len, symId, sizeof(symId));
+}
+
+
+static bool scancat(char* const out, const size_t size, size_t* const out_len, const char* const in, const size_t in_len) {
+
+	const char *p = in, *r;
+	const char* const end = in + in_len;
+	char *q;
+
+	assert(*out_len < size);
+
+	if (p != end && *p == '^') {				// GS1 mode
 
 		// Skip the leading FNC1 since we are following a symbology identifier
-		while (*++p)
-			*q++ = (*p == '^') ? '\x1D' : *p;	// Convert encoded FNC1 to GS
+		if ((size_t)(end - ++p) >= size - *out_len)
+			return false;
 
-	}
-	else {
+		for (q = out + *out_len; p != end; p++)
+			*q++ = (*p == '^') ? '\x1D' : *p;	// Convert encoded FNC1 to GS
+		*q = '\0';
+		*out_len = (size_t)(q - out);
 
-		// Unescape leading sequence "\\...^" -> "\...^"
-		const char *r = p;
-		while (*r == '\\')
-			r++;
-		if (*r == '^')
-			p++;
+		return true;
 
-		while (*p)
-			*q++ = *p++;
 	}
-	*q = '\0';
 
-	return (size_t)(q - out);
+	// Unescape leading sequence "\\...^" -> "\...^"
+	r = p;
+	while (r != end && *r == '\\')
+		r++;
+	if (r != end && *r == '^')
+		p++;
+
+	return scanput(out, size, out_len, p, (size_t)(end - p));
 
 }
 
@@ -183,37 +216,35 @@ static bool validateParity(uint8_t *str, size_t len) {
 }
 
 
-static bool checkAndNormalisePrimaryData(gs1_encoder* const ctx, const char *dataStr,
-					 char* const outStr, size_t *outStr_len, int length) {
+static bool checkAndNormalisePrimaryData(const gs1_encoder* const ctx, const char *dataStr, const size_t dataStr_len,
+					 char* const out, const size_t size, size_t* const out_len, const int length,
+					 gs1_renderErr_t* const re) {
 
-	size_t dataStr_len = strlen(dataStr);
 	char *primary_out;
 
 	if (dataStr_len != (size_t)(ctx->addCheckDigit ? length-1 : length)) {
 		if (ctx->addCheckDigit)
-			SET_ERR_V(PRIMARY_DATA_MUST_BE_N_DIGITS_WITHOUT_CHECK_DIGIT, length - 1);
+			RENDER_ERR_V(re, PRIMARY_DATA_MUST_BE_N_DIGITS_WITHOUT_CHECK_DIGIT, length - 1);
 		else
-			SET_ERR_V(PRIMARY_DATA_MUST_BE_N_DIGITS, length);
+			RENDER_ERR_V(re, PRIMARY_DATA_MUST_BE_N_DIGITS, length);
 		return false;
 	}
 
-	if (!gs1_allDigits((uint8_t*)dataStr, dataStr_len)) {
-		SET_ERR(PRIMARY_DATA_MUST_BE_ALL_DIGITS);
+	if (!gs1_allDigits((const uint8_t*)dataStr, dataStr_len)) {
+		RENDER_ERR(re, PRIMARY_DATA_MUST_BE_ALL_DIGITS);
 		return false;
 	}
 
-	primary_out = outStr + *outStr_len;
-	memcpy(primary_out, dataStr, dataStr_len);
-	*outStr_len += dataStr_len;
-
-	if (ctx->addCheckDigit)
-		outStr[(*outStr_len)++] = '-';
-
-	outStr[*outStr_len] = '\0';
+	primary_out = out + *out_len;
+	if (!scanput(out, size, out_len, dataStr, dataStr_len) ||
+	    (ctx->addCheckDigit && !scanput(out, size, out_len, "-", 1))) {
+		RENDER_ERR(re, OUTPUT_BUFFER_TOO_SMALL);
+		return false;
+	}
 
-	if (!validateParity((uint8_t*)primary_out, (size_t)(outStr + *outStr_len - primary_out)) &&
+	if (!validateParity((uint8_t*)primary_out, (size_t)(out + *out_len - primary_out)) &&
 	    !ctx->addCheckDigit) {
-		SET_ERR(PRIMARY_DATA_CHECK_DIGIT_IS_INCORRECT);
+		RENDER_ERR(re, PRIMARY_DATA_CHECK_DIGIT_IS_INCORRECT);
 		return false;
 	}
 
@@ -222,22 +253,37 @@ static bool checkAndNormalisePrimaryData(gs1_encoder* const ctx, const char *dat
 }
 
 
-char* gs1_generateScanData(gs1_encoder* const ctx) {
+/*
+ *  Render the scan data for the message into the given buffer. The context is
+ *  not modified, so this may be called concurrently for the same message.
+ *
+ */
+bool gs1_renderScanData(const gs1_encoder* const ctx, char* const out, const size_t size, gs1_renderErr_t* const re) {
 
-	char* cc = NULL;
+	const char *cc;
 	const char *pad;
 	const char *dataStr;
+	size_t dataStr_len, linear_len, len;
 	int length, aizeros;
-	char* ret;
-	size_t outStr_len = 0;
+	size_t out_len = 0;
 	const char* primary_data_out;
 
 	assert(ctx);
-
-	*ctx->outStr = '\0';
-
-	if ((cc = strchr(ctx->dataStr, '|')) != NULL)		// Delimit end of linear data
-		*cc++ = '\0';
+	assert(out || size == 0);
+	assert(re);
+
+	if (size == 0)
+		goto too_small;
+	*out = '\0';
+
+	// The linear data ends at any composite delimiter
+	dataStr_len = strlen(ctx->dataStr);
+	if ((cc = memchr(ctx->dataStr, '|', dataStr_len)) != NULL) {
+		linear_len = (size_t)(cc - ctx->dataStr);
+		cc++;
+	} else {
+		linear_len = dataStr_len;
+	}
 
 	switch (ctx->sym) {
 
@@ -249,17 +295,13 @@ char* gs1_generateScanData(gs1_encoder* const ctx) {
 		// DM:      "]d1" for plain data; "]d2" for GS1 data
 		// DotCode: "]J0" for plain data; "]J1" for GS1 data
 
-		// If plain data then put original faux CC delimiter back
-		if (*ctx->dataStr != '^' && cc) {
-			*--cc = '|';
-			cc = NULL;
-		}
+		// If plain data then the faux CC delimiter is data
+		if (*ctx->dataStr != '^')
+			linear_len = dataStr_len;
 
-		ctx->outStr[outStr_len++] = ']';
-		memcpy(ctx->outStr + outStr_len, lookupSymId(ctx), 2);
-		outStr_len += 2;
-		ctx->outStr[outStr_len] = '\0';
-		scancat(ctx->outStr, ctx->dataStr, outStr_len);
+		if (!scanputSymId(ctx, out, size, &out_len) ||
+		    !scancat(out, size, &out_len, ctx->dataStr, linear_len))
+			goto too_small;
 		break;
 
 	case gs1_encoder_sGS1_128_CCA:
@@ -268,14 +310,12 @@ char* gs1_generateScanData(gs1_encoder* const ctx) {
 		if (!cc) {
 			// "]C1" for linear-only GS1-128
 			if (*ctx->dataStr != '^') {
-				SET_ERR(MISSING_FNC1_IN_FIRST_POSITION);
-				goto fail;
+				RENDER_ERR(re, MISSING_FNC1_IN_FIRST_POSITION);
+				return false;
 			}
-			ctx->outStr[outStr_len++] = ']';
-			memcpy(ctx->outStr + outStr_len, lookupSymId(ctx), 2);
-			outStr_len += 2;
-			ctx->outStr[outStr_len] = '\0';
-			scancat(ctx->outStr, ctx->dataStr, outStr_len);
+			if (!scanputSymId(ctx, out, size, &out_len) ||
+			    !scancat(out, size, &out_len, ctx->dataStr, linear_len))
+				goto too_small;
 			break;
 		}
 
@@ -285,13 +325,12 @@ char* gs1_generateScanData(gs1_encoder* const ctx) {
 
 		// "]e0" followed by concatenated AI data from linear and CC
 		if (*ctx->dataStr != '^') {
-			SET_ERR(MISSING_FNC1_IN_FIRST_POSITION);
-			goto fail;
+			RENDER_ERR(re, MISSING_FNC1_IN_FIRST_POSITION);
+			return false;
 		}
-		memcpy(ctx->outStr + outStr_len, CC_SYM_ID, sizeof(CC_SYM_ID) - 1);
-		outStr_len += sizeof(CC_SYM_ID) - 1;
-		ctx->outStr[outStr_len] = '\0';
-		outStr_len = scancat(ctx->outStr, ctx->dataStr, outStr_len);
+		if (!scanput(out, size, &out_len, CC_SYM_ID, sizeof(CC_SYM_ID) - 1) ||
+		    !scancat(out, size, &out_len, ctx->dataStr, linear_len))
+			goto too_small;
 
 		if (cc) {
 
@@ -299,19 +338,18 @@ char* gs1_generateScanData(gs1_encoder* const ctx) {
 			int i;
 
 			if (*cc != '^') {
-				SET_ERR(MISSING_FNC1_IN_FIRST_POSITION);
-				goto fail;
+				RENDER_ERR(re, MISSING_FNC1_IN_FIRST_POSITION);
+				return false;
 			}
 
 			// Append GS if last AI of linear component isn't fixed-length
 			for (i = 0; i < ctx->numAIs && ctx->aiData[i].aiEntry; i++)
 				lastAIfnc1 = ctx->aiData[i].aiEntry->fnc1;
-			if (lastAIfnc1) {
-				ctx->outStr[outStr_len++] = '\x1D';
-				ctx->outStr[outStr_len] = '\0';
-			}
+			if (lastAIfnc1 && !scanput(out, size, &out_len, "\x1D", 1))
+				goto too_small;
 
-			scancat(ctx->outStr, cc, outStr_len);
+			if (!scancat(out, size, &out_len, cc, dataStr_len - (size_t)(cc - ctx->dataStr)))
+				goto too_small;
 
 		}
 
@@ -326,35 +364,36 @@ char* gs1_generateScanData(gs1_encoder* const ctx) {
 		// "]e0" followed by concatenated AI data from linear and CC
 
 		dataStr = ctx->dataStr;
-		if (strncmp(dataStr, "^01", 3) == 0)
+		len = linear_len;
+		if (len >= 3 && strncmp(dataStr, "^01", 3) == 0) {
 			dataStr += 3;
+			len -= 3;
+		}
 
-		ctx->outStr[outStr_len++] = ']';
-		memcpy(ctx->outStr + outStr_len, lookupSymId(ctx), 2);
-		outStr_len += 2;
-		memcpy(ctx->outStr + outStr_len, "01", 2);
-		outStr_len += 2;
-		ctx->outStr[outStr_len] = '\0';
+		if (!scanputSymId(ctx, out, size, &out_len) ||
+		    !scanput(out, size, &out_len, "01", 2))
+			goto too_small;
 
-		primary_data_out = ctx->outStr + outStr_len;
+		primary_data_out = out + out_len;
 
-		if (!checkAndNormalisePrimaryData(ctx, dataStr, ctx->outStr, &outStr_len, 14))
-			goto fail;
+		if (!checkAndNormalisePrimaryData(ctx, dataStr, len, out, size, &out_len, 14, re))
+			return false;
 
 		// GS1 DataBar Limited is restricted to low-valued inputs
 		if (ctx->sym == gs1_encoder_sDataBarLimited) {
 			if (primary_data_out[0] >= '2') {	// 14-digits must be less than 2 * 10^13
-				SET_ERR(PRIMARY_DATA_IS_TOO_LARGE);
-				goto fail;
+				RENDER_ERR(re, PRIMARY_DATA_IS_TOO_LARGE);
+				return false;
 			}
 		}
 
 		if (cc) {
 			if (*cc != '^') {
-				SET_ERR(MISSING_FNC1_IN_FIRST_POSITION);
-				goto fail;
+				RENDER_ERR(re, MISSING_FNC1_IN_FIRST_POSITION);
+				return false;
 			}
-			scancat(ctx->outStr, cc, outStr_len);
+			if (!scancat(out, size, &out_len, cc, dataStr_len - (size_t)(cc - ctx->dataStr)))
+				goto too_small;
 		}
 
 		break;
@@ -382,67 +421,67 @@ char* gs1_generateScanData(gs1_encoder* const ctx) {
 
 		// If AI data beginning (01) then skip leading zeros of the GTIN-14
 		dataStr = ctx->dataStr;
+		len = linear_len;
 		aizeros = 17 - length;
-		if (strncmp(dataStr, "^01000000", (size_t)aizeros) == 0)
+		if (len >= (size_t)aizeros && strncmp(dataStr, "^01000000", (size_t)aizeros) == 0) {
 			dataStr += aizeros;
+			len -= (size_t)aizeros;
+		}
 
-		ctx->outStr[outStr_len++] = ']';
-		memcpy(ctx->outStr + outStr_len, lookupSymId(ctx), 2);
-		outStr_len += 2;
-		if (*pad)
-			ctx->outStr[outStr_len++] = *pad;
-		ctx->outStr[outStr_len] = '\0';
+		if (!scanputSymId(ctx, out, size, &out_len) ||
+		    !scanput(out, size, &out_len, pad, strlen(pad)))
+			goto too_small;
 
-		if (!checkAndNormalisePrimaryData(ctx, dataStr, ctx->outStr, &outStr_len, length))
-			goto fail;
+		if (!checkAndNormalisePrimaryData(ctx, dataStr, len, out, size, &out_len, length, re))
+			return false;
 
 		if (cc) {
 			if (*cc != '^') {
-				SET_ERR(MISSING_FNC1_IN_FIRST_POSITION);
-				goto fail;
+				RENDER_ERR(re, MISSING_FNC1_IN_FIRST_POSITION);
+				return false;
 			}
-			ctx->outStr[outStr_len++] = '|';
-			memcpy(ctx->outStr + outStr_len, CC_SYM_ID, sizeof(CC_SYM_ID) - 1);
-			outStr_len += sizeof(CC_SYM_ID) - 1;
-			ctx->outStr[outStr_len] = '\0';		// "|" means start of new message
-			scancat(ctx->outStr, cc, outStr_len);
+			// "|" means start of new message
+			if (!scanput(out, size, &out_len, "|" CC_SYM_ID, sizeof(CC_SYM_ID)) ||
+			    !scancat(out, size, &out_len, cc, dataStr_len - (size_t)(cc - ctx->dataStr)))
+				goto too_small;
 		}
 		break;
 
 	case gs1_encoder_sNONE:
 	case gs1_encoder_sNUMSYMS:
-		SET_ERR(NO_SYMBOLOGY_SELECTED);
-		goto fail;
+		RENDER_ERR(re, NO_SYMBOLOGY_SELECTED);
+		return false;
 
 	}
 
-	ret = ctx->outStr;
-
-out:
-
-	if (cc) {
-//		*(cc-1) = '|';					// Put original separator back
-		ctx->dataStr[cc - ctx->dataStr - 1] = '|';	// Ugly hack generates same code as above to satiate GCC 11
-	}
-	return ret;
+	return true;
 
-fail:
+too_small:
 
-	ret = NULL;
-	goto out;
+	RENDER_ERR(re, OUTPUT_BUFFER_TOO_SMALL);
+	return false;
 
 }
 
 
-bool gs1_processScanData(gs1_encoder* const ctx, const char* scanData) {
+char* gs1_generateScanData(gs1_encoder* const ctx) {
 
-	gs1_encoder_symbologies_t sym;
-	aiMode_t aiMode;
-	char *p;
-	const char *q;
+	gs1_renderErr_t re = RENDER_ERR_TARGET(ctx->errMsg, sizeof(ctx->errMsg));
 
 	assert(ctx);
-	assert(scanData);
+
+	if (!gs1_renderScanData(ctx, ctx->outStr, sizeof(ctx->outStr), &re)) {
+		ctx->err = re.err;
+		*ctx->outStr = '\0';
+		return NULL;
+	}
+
+	return ctx->outStr;
+
+}
+
+
+static void clearScanMessage(gs1_encoder* const ctx) {
 
 	ctx->sym = gs1_encoder_sNONE;
 	*ctx->dataStr = '\0';
@@ -454,7 +493,22 @@ bool gs1_processScanData(gs1_encoder* const ctx, const char* scanData) {
 	ctx->linterErr = GS1_LINTER_OK;
 	*ctx->linterErrMarkup = '\0';
 
-	if (*scanData != ']' || strlen(scanData) < 3) {
+}
+
+
+bool gs1_processScanData(gs1_encoder* const ctx, const char* scanData) {
+
+	gs1_encoder_symbologies_t sym;
+	aiMode_t aiMode;
+	char *p;
+	const char *q;
+
+	assert(ctx);
+	assert(scanData);
+
+	clearScanMessage(ctx);
+
+	if (scanData[0] != ']' || scanData[1] == '\0' || scanData[2] == '\0') {
 		SET_ERR(MISSING_SYMBOLOGY_IDENTIFIER);
 		goto fail;
 	}
@@ -468,6 +522,45 @@ bool gs1_processScanData(gs1_encoder* const ctx, const char* scanData) {
 
 	scanData += 3;
 
+	/*
+	 *  Fast path for the identifiers that carry only AI data ("]C1", "]e0",
+	 *  "]d2", "]Q3" and "]J1"): convert the data in a single pass that also
+	 *  checks its length and rejects data "^" characters.
+	 *
+	 */
+	if (aiMode == aiMode_AI) {
+
+		const char* const end = ctx->dataStr + MAX_DATA;
+		bool carat = false;
+
+		ctx->sym = sym;
+		p = ctx->dataStr;
+		*p++ = '^';
+
+		for (q = scanData; *q; q++) {
+			if (p == end) {
+				SET_ERR_V(DATA_TOO_LONG, MAX_DATA - 1);
+				goto fail;
+			}
+			if (*q == '^')
+				carat = true;
+			*p++ = (*q == '\x1D') ? '^' : *q;	// GS character represents FNC1
+		}
+		*p = '\0';
+
+		// Forbid data "^" characters at this stage so we don't conflate with FNC1
+		if (carat) {
+			SET_ERR(SCAN_DATA_CONTAINS_ILLEGAL_CARAT);
+			goto fail;
+		}
+
+		if (!gs1_processAIdata(ctx, ctx->dataStr, true))	// Validate AI data and extract AIs
+			goto fail;
+
+		return true;
+
+	}
+
 	if (strnlen(scanData, MAX_DATA) >= MAX_DATA) {
 		SET_ERR_V(DATA_TOO_LONG, MAX_DATA - 1);
 		goto fail;
@@ -579,6 +672,208 @@ fail:
 
 
 
+/*
+ *  Incremental processing of a scan data stream, such as from a keyboard-wedge
+ *  scanner, in which each symbol is terminated by CR or LF.
+ *
+ *  The symbology identifier is looked up as soon as it is received. The data
+ *  of symbols that carry AI data is then converted as it arrives, exactly as
+ *  gs1_processScanData() would, so that once the terminator is received only
+ *  the AIs remain to be extracted. Other data, such as EAN/UPC primary data
+ *  or plain data, is buffered and processed as a whole. Errors are recorded
+ *  as they are detected and the remainder of the symbol discarded.
+ *
+ */
+void gs1_resetScanStream(gs1_encoder* const ctx) {
+
+	assert(ctx);
+
+	ctx->scanStreamState = scanStream_PREFIX;
+	ctx->scanStreamLen = 0;
+	ctx->scanStreamSym = gs1_encoder_sNONE;
+	ctx->scanStreamErr = gs1_encoder_eNO_ERROR;
+
+}
+
+
+static void discardScanStream(gs1_encoder* const ctx, const gs1_encoder_err_t err) {
+	ctx->scanStreamState = scanStream_DISCARD;
+	ctx->scanStreamErr = err;
+}
+
+
+/*
+ *  Consume input up to and including the terminator of a symbol, returning
+ *  true if a symbol was terminated. Empty lines, such as the LF of a CR LF
+ *  pair, are skipped.
+ *
+ */
+bool gs1_feedScanStream(gs1_encoder* const ctx, const char* const data, const size_t len, size_t* const consumed) {
+
+	char* const buf = ctx->scanStreamBuf;
+	size_t i;
+
+	assert(ctx);
+	assert(data || len == 0);
+	assert(consumed);
+
+	for (i = 0; i < len; i++) {
+
+		char c = data[i];
+
+		if (c == '\r' || c == '\n') {
+			if (ctx->scanStreamLen == 0 && ctx->scanStreamState == scanStream_PREFIX)
+				continue;
+			*consumed = i + 1;
+			return true;
+		}
+
+		if (c == '\0' && ctx->scanStreamState != scanStream_DISCARD) {
+			discardScanStream(ctx, gs1_encoder_eINPUT_CONTAINS_NUL);
+			continue;
+		}
+
+		switch (ctx->scanStreamState) {
+
+		case scanStream_PREFIX:
+			buf[ctx->scanStreamLen++] = c;
+			if (buf[0] != ']') {
+				discardScanStream(ctx, gs1_encoder_eMISSING_SYMBOLOGY_IDENTIFIER);
+				break;
+			}
+			if (ctx->scanStreamLen == 3) {
+				aiMode_t aiMode;
+				lookupSymAndModeBySymId(buf + 1, &ctx->scanStreamSym, &aiMode);
+				if (ctx->scanStreamSym == gs1_encoder_sNONE) {
+					discardScanStream(ctx, gs1_encoder_eUNSUPPORTED_SYMBOLOGY_IDENTIFIER);
+				} else if (aiMode == aiMode_AI) {
+					buf[0] = '^';		// Replaces the symbology identifier
+					ctx->scanStreamLen = 1;
+					ctx->scanStreamState = scanStream_AI;
+				} else {
+					ctx->scanStreamState = scanStream_RAW;
+				}
+			}
+			break;
+
+		case scanStream_AI:
+			if (c == '^') {			// Not to be conflated with FNC1
+				discardScanStream(ctx, gs1_encoder_eSCAN_DATA_CONTAINS_ILLEGAL_CARAT);
+				break;
+			}
+			if (ctx->scanStreamLen >= MAX_DATA) {	// "^" and MAX_DATA - 1 characters of data
+				discardScanStream(ctx, gs1_encoder_eDATA_TOO_LONG);
+				break;
+			}
+			buf[ctx->scanStreamLen++] = c == 0x1D ? '^' : c;	// GS character represents FNC1
+			break;
+
+		case scanStream_RAW:
+			if (ctx->scanStreamLen >= MAX_DATA + 2) {	// Symbology identifier and MAX_DATA - 1 characters of data
+				discardScanStream(ctx, gs1_encoder_eDATA_TOO_LONG);
+				break;
+			}
+			buf[ctx->scanStreamLen++] = c;
+			break;
+
+		case scanStream_DISCARD:
+			break;
+
+		}
+
+	}
+
+	*consumed = len;
+	return false;
+
+}
+
+
+/*
+ *  Whether a symbol is partly received, so that flushing the stream would
+ *  terminate it.
+ *
+ */
+bool gs1_endScanStream(const gs1_encoder* const ctx) {
+	assert(ctx);
+	return ctx->scanStreamLen > 0 || ctx->scanStreamState != scanStream_PREFIX;
+}
+
+
+/*
+ *  Process the terminated symbol as the message, readying the stream for the
+ *  next symbol.
+ *
+ */
+bool gs1_processScanStream(gs1_encoder* const ctx) {
+
+	char* const buf = ctx->scanStreamBuf;
+	const scanStreamState_t state = ctx->scanStreamState;
+	const gs1_encoder_err_t err = ctx->scanStreamErr;
+	const gs1_encoder_symbologies_t sym = ctx->scanStreamSym;
+	const size_t len = ctx->scanStreamLen;
+
+	assert(ctx);
+	assert(len <= MAX_DATA + 2);
+
+	gs1_resetScanStream(ctx);
+
+	if (state == scanStream_RAW) {
+		buf[len] = '\0';
+		return gs1_processScanData(ctx, buf);
+	}
+
+	clearScanMessage(ctx);
+
+	switch (state) {
+	case scanStream_PREFIX:
+		SET_ERR(MISSING_SYMBOLOGY_IDENTIFIER);	// Too short
+		goto fail;
+	case scanStream_DISCARD:
+		switch (err) {
+		case gs1_encoder_eMISSING_SYMBOLOGY_IDENTIFIER:
+			SET_ERR(MISSING_SYMBOLOGY_IDENTIFIER);
+			break;
+		case gs1_encoder_eUNSUPPORTED_SYMBOLOGY_IDENTIFIER:
+			SET_ERR(UNSUPPORTED_SYMBOLOGY_IDENTIFIER);
+			break;
+		case gs1_encoder_eSCAN_DATA_CONTAINS_ILLEGAL_CARAT:
+			SET_ERR(SCAN_DATA_CONTAINS_ILLEGAL_CARAT);
+			break;
+		case gs1_encoder_eDATA_TOO_LONG:
+			SET_ERR_V(DATA_TOO_LONG, MAX_DATA - 1);
+			break;
+		default:
+			assert(err == gs1_encoder_eINPUT_CONTAINS_NUL);
+			SET_ERR(INPUT_CONTAINS_NUL);
+			break;
+		}
+		goto fail;
+	default:
+		assert(state == scanStream_AI);
+		break;
+	}
+
+	// AI data that is already converted
+	ctx->sym = sym;
+	memcpy(ctx->dataStr, buf, len);
+	ctx->dataStr[len] = '\0';
+	if (!gs1_processAIdata(ctx, ctx->dataStr, true))
+		goto fail;
+
+	return true;
+
+fail:
+
+	*ctx->dataStr = '\0';
+	ctx->sym = gs1_encoder_sNONE;
+	ctx->numAIs = 0;
+	ctx->numSortedAIs = 0;
+	return false;
+
+}
+
+
 #ifdef UNIT_TESTS
 
 #define TEST_NO_MAIN
@@ -616,6 +911,42 @@ void test_scandata_validateParity(void) {
 }
 
 
+void test_scandata_symIdTables(void) {
+
+	gs1_encoder_symbologies_t sym, defSym;
+	aiMode_t aiMode, mode;
+	char symId[2];
+
+	/*
+	 *  Every identifier that we generate must be recognised when processing
+	 *  scan data, in the same mode, as a symbology that generates it
+	 *
+	 */
+	for (sym = gs1_encoder_sNONE + 1; sym < gs1_encoder_sNUMSYMS; sym++) {
+		for (mode = aiMode_AI; mode <= aiMode_NON_AI; mode++) {
+
+			if (*symIdBySym[sym][mode] == '\0') {
+				TEST_CHECK(mode == aiMode_NON_AI);
+				TEST_MSG("Symbology %d has no AI mode identifier", sym);
+				continue;
+			}
+
+			memcpy(symId, symIdBySym[sym][mode], 2);
+			lookupSymAndModeBySymId(symId, &defSym, &aiMode);
+			TEST_ASSERT(defSym != gs1_encoder_sNONE);
+			TEST_CHECK(memcmp(symIdBySym[defSym][aiMode], symId, 2) == 0);
+			TEST_MSG("Symbology %d: %.2s maps back to %d (%.2s)", sym, symId, defSym, symIdBySym[defSym][aiMode]);
+
+			// Where the modes have distinct identifiers, the mode is preserved
+			if (memcmp(symIdBySym[sym][aiMode_AI], symIdBySym[sym][aiMode_NON_AI], 2) != 0)
+				TEST_CHECK(aiMode == mode);
+
+		}
+	}
+
+}
+
+
 static void do_test_testGenerateScanData(gs1_encoder* const ctx, const char* const file, const int line, const gs1_encoder_err_t expect_err, const char* const name, const gs1_encoder_symbologies_t sym, const char* const dataStr, const char* const expect) {
 
 	char *out;
@@ -865,6 +1196,12 @@ void test_scandata_processScanData(void) {
 	test_testProcessScanData(MISSING_SYMBOLOGY_IDENTIFIER, "]", NONE, "");		// Short
 	test_testProcessScanData(MISSING_SYMBOLOGY_IDENTIFIER, "]X", NONE, "");		// Short
 	test_testProcessScanData(UNSUPPORTED_SYMBOLOGY_IDENTIFIER, "]XX", NONE, "");	// Unknown symbology identifier
+	test_testProcessScanData(UNSUPPORTED_SYMBOLOGY_IDENTIFIER, "]e9", NONE, "");	// Unknown modifier
+	test_testProcessScanData(UNSUPPORTED_SYMBOLOGY_IDENTIFIER, "]z9", NONE, "");	// Unknown, at the limits of the index
+	test_testProcessScanData(UNSUPPORTED_SYMBOLOGY_IDENTIFIER, "]@0", NONE, "");	// Outside of the index
+	test_testProcessScanData(UNSUPPORTED_SYMBOLOGY_IDENTIFIER, "]{0", NONE, "");
+	test_testProcessScanData(UNSUPPORTED_SYMBOLOGY_IDENTIFIER, "]C/", NONE, "");
+	test_testProcessScanData(UNSUPPORTED_SYMBOLOGY_IDENTIFIER, "]C:", NONE, "");
 
 	test_testProcessScanData(AI_DATA_EMPTY, "]e0", NONE, "");	// Empty GS1 data
 
@@ -992,10 +1329,21 @@ void test_scandata_processScanData(void) {
 		scanbuf[3 + MAX_DATA] = '\0';
 		TEST_CHECK(!gs1_encoder_setScanData(ctx, scanbuf));
 		TEST_CHECK(ctx->err == gs1_encoder_eDATA_TOO_LONG);
+
+		// Same limits for AI data, with the length reported ahead of any "^"
+		memcpy(scanbuf, "]Q3", 3);
+		scanbuf[3] = '^';
+		scanbuf[3 + MAX_DATA - 1] = '\0';
+		TEST_CHECK(!gs1_encoder_setScanData(ctx, scanbuf));
+		TEST_CHECK(ctx->err == gs1_encoder_eSCAN_DATA_CONTAINS_ILLEGAL_CARAT);
+		scanbuf[3 + MAX_DATA - 1] = 'a';
+		TEST_CHECK(!gs1_encoder_setScanData(ctx, scanbuf));
+		TEST_CHECK(ctx->err == gs1_encoder_eDATA_TOO_LONG);
 	}
 
 	/* Scan data with illegal carat in GS1-128 AI data */
 	test_testProcessScanData(SCAN_DATA_CONTAINS_ILLEGAL_CARAT, "]C101123123123133^10ABC", NONE, "");
+	test_testProcessScanData(SCAN_DATA_CONTAINS_ILLEGAL_CARAT, "]e0^", NONE, "");
 
 	/* Plain scan data with invalid DL URI (no primary AI) */
 	test_testProcessScanData(NO_GS1_DL_KEYS_FOUND_IN_PATH_INFO, "]Q1https://a/NOPRIMARYAI", NONE, "");
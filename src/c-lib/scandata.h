@@ -24,14 +24,20 @@
 
 #include "enc-private.h"
 
+bool gs1_renderScanData(const gs1_encoder *ctx, char *out, size_t size, gs1_renderErr_t *re);
 char* gs1_generateScanData(gs1_encoder *ctx);
 bool gs1_processScanData(gs1_encoder* ctx, const char* scanData);
+void gs1_resetScanStream(gs1_encoder* ctx);
+bool gs1_feedScanStream(gs1_encoder* ctx, const char* data, size_t len, size_t* consumed);
+bool gs1_endScanStream(const gs1_encoder* ctx);
+bool gs1_processScanStream(gs1_encoder* ctx);
 
 
 #ifdef UNIT_TESTS
 
 void test_scandata_validateParity(void);
 void test_scandata_generateScanData(void);
+void test_scandata_symIdTables(void);
 void test_scandata_processScanData(void);
 
 #endif
@@ -18,6 +18,8 @@
  *
  */
 
+#define GS1_ENCODERS_HEAP_SUBSYSTEM gs1_encoder_hSYNTAX_DICTIONARY	// For profile-heap.h
+
 
 #include <assert.h>
 #include <stdbool.h>
@@ -53,6 +55,27 @@ GS1_ENCODERS_STATIC_ASSERT(AI_TABLE_CAPACITY <= UINT16_MAX);
 
 #ifndef EXCLUDE_SYNTAX_DICTIONARY_LOADER
 
+/*
+ *  Resolve a linter name to its function. Application-provided linters take
+ *  precedence over the reference linters so that the latter may be replaced.
+ *
+ */
+static gs1_linter_t lookupLinter(gs1_encoder* const ctx, const char* const name) {
+
+	size_t i;
+
+	for (i = 0; i < ctx->numLinters; i++) {
+		const struct gs1_encoder_linter* const l = &ctx->linters[i];
+		if (l->name && l->fn && strcmp(l->name, name) == 0) {
+			STATS_LINTER_NAME(l->fn, l->name);	// Label by the application's name
+			return l->fn;
+		}
+	}
+
+	return gs1_linter_from_name(name);
+
+}
+
 static int processComponent(gs1_encoder* const ctx, char* const component, struct aiComponent* const part) {
 
 	const char *token, *p;
@@ -126,7 +149,7 @@ static int processComponent(gs1_encoder* const ctx, char* const component, struc
 		if (numlinters >= MAX_LINTERS - 1)
 			error_v(NUMBER_OF_LINTERS_EXCEEDS_IMPL_LIMIT, component);
 
-		if ((part->linters[numlinters] = gs1_linter_from_name(token)) == NULL)
+		if ((part->linters[numlinters] = lookupLinter(ctx, token)) == NULL)
 			error_v(UNKNOWN_LINTER, token);
 
 		numlinters++;
@@ -371,6 +394,7 @@ int parseSyntaxDictionaryEntry(gs1_encoder* const ctx, const char* const line, c
 	(*entry)->attrs = gs1_strdup_alloc(buf);
 	if (!(*entry)->attrs)
 		error(FAILED_TO_ALLOCATE_MEMORY_FOR_ATTRS);
+	STATS_ALLOC();
 
 	// Read until the end of line for the title
 	token = strtok_r(NULL, "", &saveptr);
@@ -385,11 +409,13 @@ int parseSyntaxDictionaryEntry(gs1_encoder* const ctx, const char* const line, c
 		(*entry)->title = gs1_strdup_alloc(token);
 		if (!(*entry)->title)
 			error(FAILED_TO_ALLOCATE_MEMORY_FOR_TITLE);
+		STATS_ALLOC();
 
 	} else {
 		(*entry)->title = gs1_strdup_alloc("");
 		if (!(*entry)->title)
 			error(FAILED_TO_ALLOCATE_MEMORY_FOR_TITLE);
+		STATS_ALLOC();
 	}
 
 	// Duplicate the initial entry to fill down to the end of the range
@@ -415,9 +441,11 @@ int parseSyntaxDictionaryEntry(gs1_encoder* const ctx, const char* const line, c
 		(*entry)->attrs = gs1_strdup_alloc(lastEntry->attrs);
 		if (!(*entry)->attrs)
 			error(FAILED_TO_ALLOCATE_MEMORY_FOR_ATTRS);
+		STATS_ALLOC();
 		(*entry)->title = gs1_strdup_alloc(lastEntry->title);
 		if (!(*entry)->title)
 			error(FAILED_TO_ALLOCATE_MEMORY_FOR_TITLE);
+		STATS_ALLOC();
 
 		(*entry)++;
 		lastEntry++;
@@ -451,6 +479,7 @@ struct aiEntry* gs1_loadSyntaxDictionaryFromFile(gs1_encoder* const ctx, FILE* c
 	sd = (struct aiEntry*)GS1_ENCODERS_MALLOC(cap * sizeof(struct aiEntry));
 	if (!sd)
 		error(FAILED_TO_ALLOCATE_AI_TABLE);
+	STATS_ALLOC();
 	sd[0].ai[0] = '\0';
 	sd[0].attrs = NULL;
 	sd[0].title = NULL;
@@ -127,6 +127,25 @@ gs1_linter_t gs1_linter_from_name(const char* const name) {
 }
 
 
+/*
+ * Return the name of a reference linter function, or NULL if the function is
+ * not a reference linter.
+ *
+ */
+const char* gs1_linter_name(const gs1_linter_t fn) {
+
+	size_t i;
+
+	for (i = 0; i < sizeof(name_function_map) / sizeof(name_function_map[0]); i++) {
+		if (name_function_map[i].fn == fn)
+			return name_function_map[i].name;
+	}
+
+	return NULL;
+
+}
+
+
 /*
  * Example mapping of gs1_lint_err_t entries to friendly strings in the English
  * language.
@@ -295,6 +314,20 @@ DIAG_POP
 
 }
 
+void test_gs1_linter_name(void)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(name_function_map) / sizeof(name_function_map[0]); i++) {
+		TEST_CHECK(gs1_linter_from_name(gs1_linter_name(name_function_map[i].fn)) == name_function_map[i].fn);
+		TEST_MSG("Linter: %s", name_function_map[i].name);
+	}
+
+	TEST_CHECK(strcmp(gs1_linter_name(gs1_lint_gcppos1), "gcppos1") == 0);
+	TEST_CHECK(gs1_linter_name(NULL) == NULL);
+
+}
+
 
 #ifdef GS1_LINTER_ERR_STR_EN
 void test_gs1_linter_err_str_en_size(void)
@@ -273,6 +273,7 @@ GS1_SYNTAX_DICTIONARY_API DEPRECATED gs1_lint_err_t gs1_lint_mmoptss(const char
 GS1_SYNTAX_DICTIONARY_API DEPRECATED gs1_lint_err_t gs1_lint_yymmddhh(const char *data, size_t data_len, size_t *err_pos, size_t *err_len);
 
 GS1_SYNTAX_DICTIONARY_API gs1_linter_t gs1_linter_from_name(const char *name);
+GS1_SYNTAX_DICTIONARY_API const char* gs1_linter_name(gs1_linter_t fn);
 
 #ifdef __cplusplus
 }
@@ -50,4 +50,16 @@
 	snprintf(ctx->errMsg, sizeof(ctx->errMsg), ERR_TR(x));			\
 } while (0)
 
+#define RENDER_ERR_V(re, x, ...) do {						\
+	(re)->err = gs1_encoder_e##x;						\
+	if ((re)->msgSize > 0)							\
+		snprintf((re)->msg, (re)->msgSize, ERR_TR(x), __VA_ARGS__);	\
+} while (0)
+
+#define RENDER_ERR(re, x) do {							\
+	(re)->err = gs1_encoder_e##x;						\
+	if ((re)->msgSize > 0)							\
+		snprintf((re)->msg, (re)->msgSize, ERR_TR(x));			\
+} while (0)
+
 #endif  /* TR_H */
@@ -129,5 +129,11 @@
 #define TR_EN_AI_VALUE_LENGTH_EXCEEDS_IMPL "AI value length exceeds implementation limit of %d characters"
 #define TR_EN_AI_TITLE_TOO_LONG "AI title exceeds implementation limit of %d characters"
 #define TR_EN_NO_SYMBOLOGY_SELECTED "No symbology selected"
+#define TR_EN_UNKNOWN_BATCH_FORMAT "Unknown batch input or output format"
+#define TR_EN_INPUT_CONTAINS_NUL "Input contains a NUL character"
+#define TR_EN_OUTPUT_BUFFER_TOO_SMALL "Output buffer is too small"
+#define TR_EN_SCAN_DATA_HAS_NO_AIS "Scan data does not contain GS1 AI data"
+#define TR_EN_MESSAGE_IS_NOT_AI_DATA "The message does not consist of GS1 AI data"
+#define TR_EN_SERIALISED_MESSAGE_IS_MALFORMED "Serialised message is malformed"
 
 #endif  /* TR_EN_H */
@@ -22,6 +22,7 @@
 #
 
 from gs1encoders import (
+    BatchOutput,
     GS1Encoder,
     GS1EncoderDigitalLinkException,
     GS1EncoderScanDataException,
@@ -92,6 +93,15 @@ def main():
         f"{gs1encoder.permit_zero_suppressed_gtin_in_dl_uris}"
     )
 
+    # Process a column of inputs with a single call per chunk
+    result = gs1encoder.process_batch(
+        ["(01)12312312312319(10)ABC123", "(01)12312312312310"],
+        outputs=[BatchOutput.DL_URI],
+    )
+    print("\nBatch:")
+    for dl_uri, error in zip(result["dl_uri"], result["error"]):
+        print(f"    {dl_uri or 'Failed: ' + (error or '')}")
+
 
 if __name__ == "__main__":
     main()
@@ -25,11 +25,15 @@
 
 from __future__ import annotations
 
+import concurrent.futures
 import ctypes
 import enum
 import warnings
+from typing import Any, Sequence
 
 __all__ = [
+    "BatchInput",
+    "BatchOutput",
     "GS1Encoder",
     "GS1EncoderDigitalLinkException",
     "GS1EncoderGeneralException",
@@ -69,6 +73,38 @@ class Validation(enum.IntEnum):
     UNKNOWN_AI_NOT_DL_ATTR = 4
 
 
+class BatchInput(enum.IntEnum):
+    """Input formats accepted by process_batch()."""
+
+    AI_DATA_STR = 0
+    DATA_STR = 1
+    SCAN_DATA = 2
+
+
+class BatchOutput(enum.IntEnum):
+    """Output formats generated by process_batch()."""
+
+    NONE = 0
+    DATA_STR = 1
+    AI_DATA_STR = 2
+    DL_URI = 3
+    SCAN_DATA = 4
+    HRI = 5
+
+
+# Outputs that fail only when the input is rejected, so that a failure while
+# generating them identifies an input error
+_INPUT_ERROR_OUTPUTS = (
+    BatchOutput.NONE,
+    BatchOutput.DATA_STR,
+    BatchOutput.AI_DATA_STR,
+    BatchOutput.HRI,
+)
+
+# Number of inputs processed by each call into the native library
+_BATCH_CHUNK = 16384
+
+
 class GS1Encoder:
     """Wrapper around the GS1 Barcode Syntax Engine native C library.
 
@@ -219,6 +255,20 @@ class GS1Encoder:
     ]
     __api.gs1_encoder_getHRI.restype = ctypes.c_int
 
+    # The results are passed as a flat array of (offset, length, ok) triples
+    # of 32-bit integers so that each field can be extracted with a slice.
+    __api.gs1_encoder_processBatch.argtypes = [
+        ctypes.POINTER(ctypes.c_void_p),
+        ctypes.c_int,
+        ctypes.c_int,
+        ctypes.c_char_p,
+        ctypes.c_size_t,
+        ctypes.c_char_p,
+        ctypes.c_size_t,
+        ctypes.POINTER(ctypes.c_int32),
+    ]
+    __api.gs1_encoder_processBatch.restype = ctypes.c_size_t
+
     def __init__(self) -> None:
         """Create a new GS1 encoder instance."""
         # A NULL return is a falsy pointer instance, never None
@@ -434,6 +484,191 @@ class GS1Encoder:
         return hri
 
 
+    def process_batch(
+        self,
+        values: Any,
+        input_format: BatchInput = BatchInput.AI_DATA_STR,
+        outputs: Sequence[BatchOutput] = (
+            BatchOutput.AI_DATA_STR,
+            BatchOutput.DL_URI,
+            BatchOutput.HRI,
+        ),
+        threads: int = 1,
+    ) -> Any:
+        """Process a column of inputs, returning a column for each output.
+
+        The values are a list (or other iterable) of strings, a pandas
+        Series or a pyarrow Array or ChunkedArray. Null entries of a Series
+        or Array are processed as empty strings.
+
+        The inputs are processed in chunks by gs1_encoder_processBatch(), so
+        the per-message loop runs in the native library with the GIL
+        released. With threads greater than one the inputs are divided
+        between that many threads, each using its own instance configured
+        with the options of this instance.
+
+        Each output is generated by its own pass over the inputs, and every
+        pass parses and validates each input again, so the cost grows with
+        the number of outputs: the default of three outputs costs about
+        three times as much as one. A further validation-only pass is made
+        when none of the outputs is "data_str", "ai_data_str" or "hri",
+        since these identify the rejected inputs. Request only the outputs
+        that are needed.
+
+        The result maps each output name ("data_str", "ai_data_str",
+        "dl_uri", "scan_data", "hri") to a column, together with an "error"
+        column holding the message for each rejected input, or None. An
+        output is None for a rejected input. The DL URI and scan data
+        outputs may also fail for an accepted input, in which case the
+        reason is in the "dl_uri_error" or "scan_data_error" column. HRI is
+        given as a list of lines.
+
+        The result is a dict of lists, or a pandas DataFrame with the index
+        of a Series, or a pyarrow Table for an Array.
+        """
+        kind, items = _column_to_list(values)
+        outputs = [BatchOutput(o) for o in outputs]
+        input_format = BatchInput(input_format)
+        if threads < 1:
+            raise ValueError("threads must be at least 1")
+        self.__checked_ctx()
+
+        threads = min(threads, max(1, len(items) // _BATCH_CHUNK))
+        if threads == 1:
+            columns = self.__process_items(items, input_format, outputs)
+        else:
+            per = -(-len(items) // threads)
+            parts = [items[i : i + per] for i in range(0, len(items), per)]
+            encoders = [self] + [self.__clone_options() for _ in parts[1:]]
+            try:
+                with concurrent.futures.ThreadPoolExecutor(max_workers=len(parts)) as executor:
+                    results = list(
+                        executor.map(
+                            lambda e, part: e.__process_items(part, input_format, outputs),
+                            encoders,
+                            parts,
+                        )
+                    )
+            finally:
+                for e in encoders[1:]:
+                    e.free()
+            columns = {name: [v for r in results for v in r[name]] for name in results[0]}
+
+        return _list_to_column(kind, values, columns)
+
+    # A new instance with the same options, for use by another thread
+    def __clone_options(self) -> "GS1Encoder":
+        clone = GS1Encoder()
+        clone.sym = self.sym
+        clone.add_check_digit = self.add_check_digit
+        clone.permit_unknown_ais = self.permit_unknown_ais
+        clone.permit_zero_suppressed_gtin_in_dl_uris = self.permit_zero_suppressed_gtin_in_dl_uris
+        clone.include_data_titles_in_hri = self.include_data_titles_in_hri
+        for validation in (Validation.REQUISITE_AIS, Validation.UNKNOWN_AI_NOT_DL_ATTR):
+            clone.set_validation_enabled(validation, self.get_validation_enabled(validation))
+        return clone
+
+    def __process_items(
+        self, items: list[str], input_format: BatchInput, outputs: list[BatchOutput]
+    ) -> dict[str, list]:
+        # The first pass must identify rejected inputs, so it generates an
+        # output that fails only for those, adding a pass if none is wanted.
+        passes = sorted(outputs, key=lambda o: o not in _INPUT_ERROR_OUTPUTS)
+        if not passes or passes[0] not in _INPUT_ERROR_OUTPUTS:
+            passes.insert(0, BatchOutput.NONE)
+
+        columns: dict[str, list] = {}
+        accepted: list[bool] = []
+        for output in passes:
+            strs, oks = self.__process_pass(items, input_format, output)
+            if not accepted:
+                accepted = [bool(ok) for ok in oks]
+                columns["error"] = [None if ok else s for s, ok in zip(strs, oks)]
+            if output == BatchOutput.NONE:
+                continue
+            name = output.name.lower()
+            if output == BatchOutput.HRI:
+                columns[name] = [
+                    (s.split("|") if s else []) if ok else None for s, ok in zip(strs, oks)
+                ]
+            else:
+                columns[name] = [s if ok else None for s, ok in zip(strs, oks)]
+            if output in (BatchOutput.DL_URI, BatchOutput.SCAN_DATA):
+                columns[name + "_error"] = [
+                    None if ok or not acc else s for s, ok, acc in zip(strs, oks, accepted)
+                ]
+
+        ordered = {"error": columns["error"]}
+        for output in outputs:
+            name = output.name.lower()
+            for key in (name, name + "_error"):
+                if key in columns:
+                    ordered[key] = columns[key]
+        return ordered
+
+    # Process the items in chunks, returning the output (or error message) and
+    # success flag of each
+    def __process_pass(
+        self, items: list[str], input_format: BatchInput, output: BatchOutput
+    ) -> tuple[list[str], list[int]]:
+        strs: list[str] = []
+        oks: list[int] = []
+        out_size = 1 << 16
+        start = 0
+        while start < len(items):
+            chunk = items[start : start + _BATCH_CHUNK]
+            data = ("\0".join(chunk) + "\0").encode("utf-8")
+            if data.count(b"\0") != len(chunk):
+                raise GS1EncoderParameterException("Input contains a NUL character")
+            # The library may modify the input in place while processing it
+            in_buf = ctypes.create_string_buffer(data, len(data))
+            out_size = max(out_size, 4 * len(data))
+            out_buf = ctypes.create_string_buffer(out_size)
+            results = (ctypes.c_int32 * (3 * len(chunk)))()
+            n: int = self.__api.gs1_encoder_processBatch(
+                self.__checked_ctx(),
+                int(input_format),
+                int(output),
+                in_buf,
+                len(chunk),
+                out_buf,
+                out_size,
+                results,
+            )
+            if n == 0:  # The first output did not fit
+                out_size *= 2
+                continue
+            # The outputs are consecutive NUL-terminated strings
+            end = results[3 * (n - 1)] + results[3 * (n - 1) + 1] + 1
+            strs.extend(ctypes.string_at(out_buf, end).decode("utf-8").split("\0")[:n])
+            oks.extend(results[2 : 3 * n : 3])
+            start += n
+        return strs, oks
+
+
+def _column_to_list(values: Any) -> tuple[str, list[str]]:
+    """Return the kind of column and its values as a list of strings."""
+    module = type(values).__module__.split(".")[0]
+    if module == "pandas":
+        return "pandas", ["" if v is None or v != v else v for v in values.tolist()]
+    if module == "pyarrow":
+        return "pyarrow", ["" if v is None else v for v in values.to_pylist()]
+    return "list", values if isinstance(values, list) else list(values)
+
+
+def _list_to_column(kind: str, values: Any, columns: dict[str, list]) -> Any:
+    """Return the result columns in the form that matches the input."""
+    if kind == "pandas":
+        import pandas
+
+        return pandas.DataFrame(columns, index=values.index)
+    if kind == "pyarrow":
+        import pyarrow
+
+        return pyarrow.table(columns)
+    return columns
+
+
 class GS1EncoderGeneralException(Exception):
     """Raised for general library initialisation failures."""
 
@@ -18,10 +18,13 @@
 """Tests for the Python 3 binding for the GS1 Barcode Syntax Engine."""
 
 import ctypes
+import importlib.util
 import unittest
 import unittest.mock
 
 from gs1encoders import (
+    BatchInput,
+    BatchOutput,
     GS1Encoder,
     GS1EncoderDigitalLinkException,
     GS1EncoderGeneralException,
@@ -274,6 +277,103 @@ class GS1EncoderTest(unittest.TestCase):
         with self.assertRaises(GS1EncoderGeneralException):
             gs1encoder.err_markup
 
+    def test_process_batch(self):
+        gs1encoder = GS1Encoder()
+
+        result = gs1encoder.process_batch(
+            [
+                "(01)12312312312319(99)TESTING123",
+                "(01)12312312312310",
+                "(99)ABC",
+                "(01)12312312312319|(99)X",
+            ]
+        )
+
+        self.assertEqual(list(result), ["error", "ai_data_str", "dl_uri", "dl_uri_error", "hri"])
+        self.assertEqual(result["error"], [None, "AI (01): The numeric check digit is incorrect.", None, None])
+        self.assertEqual(
+            result["ai_data_str"],
+            ["(01)12312312312319(99)TESTING123", None, "(99)ABC", "(01)12312312312319|(99)X"],
+        )
+        self.assertEqual(result["dl_uri"][0], "https://id.gs1.org/01/12312312312319?99=TESTING123")
+        self.assertEqual(result["dl_uri"][1:3], [None, None])
+        self.assertEqual(
+            result["dl_uri_error"],
+            [None, None, "Cannot create a DL URI without a primary key AI", None],
+        )
+        self.assertEqual(result["hri"][0], ["(01) 12312312312319", "(99) TESTING123"])
+        self.assertEqual(result["hri"][1], None)
+        self.assertEqual(result["hri"][3], ["(01) 12312312312319", "(99) X"])
+
+        # The inputs are not modified, so remain valid for another pass
+        self.assertEqual(
+            gs1encoder.process_batch(["(01)12312312312319|(99)X"], outputs=[BatchOutput.DATA_STR]),
+            {"error": [None], "data_str": ["^0112312312312319|^99X"]},
+        )
+
+        result = gs1encoder.process_batch(
+            ["]Q1TESTING", "]C1011231231231231999ABC", "]Z1X"],
+            BatchInput.SCAN_DATA,
+            [BatchOutput.DL_URI],
+        )
+        self.assertEqual(result["error"], [None, None, "Unsupported symbology identifier"])
+        self.assertEqual(result["dl_uri"], [None, "https://id.gs1.org/01/12312312312319?99=ABC", None])
+        self.assertEqual(
+            result["dl_uri_error"],
+            ["Cannot create a DL URI without a primary key AI", None, None],
+        )
+
+        self.assertEqual(
+            gs1encoder.process_batch([]),
+            {"error": [], "ai_data_str": [], "dl_uri": [], "dl_uri_error": [], "hri": []},
+        )
+
+        with self.assertRaises(GS1EncoderParameterException):
+            gs1encoder.process_batch(["(99)A\0B"])
+        with self.assertRaises(ValueError):
+            gs1encoder.process_batch(["(99)A"], threads=0)
+
+    def test_process_batch_threads(self):
+        gs1encoder = GS1Encoder()
+        gs1encoder.include_data_titles_in_hri = True
+
+        inputs = [f"(01)12312312312319(10)LOT{i}" for i in range(40000)]
+        inputs[30000] = "(01)12312312312310"
+
+        single = gs1encoder.process_batch(inputs, outputs=[BatchOutput.HRI])
+        threaded = gs1encoder.process_batch(inputs, outputs=[BatchOutput.HRI], threads=3)
+
+        self.assertEqual(single, threaded)
+        self.assertEqual(threaded["hri"][39999], ["GTIN (01) 12312312312319", "BATCH/LOT (10) LOT39999"])
+        self.assertIsNone(threaded["hri"][30000])
+        self.assertIsNotNone(threaded["error"][30000])
+
+    @unittest.skipUnless(importlib.util.find_spec("pandas"), "pandas is not installed")
+    def test_process_batch_pandas(self):
+        import pandas
+
+        gs1encoder = GS1Encoder()
+        series = pandas.Series(["(01)12312312312319", None, "(01)12312312312310"], index=[10, 20, 30])
+
+        frame = gs1encoder.process_batch(series, outputs=[BatchOutput.DL_URI])
+
+        self.assertEqual(list(frame.index), [10, 20, 30])
+        self.assertEqual(frame["dl_uri"][10], "https://id.gs1.org/01/12312312312319")
+        self.assertIsNotNone(frame["error"][20])
+        self.assertIsNotNone(frame["error"][30])
+
+    @unittest.skipUnless(importlib.util.find_spec("pyarrow"), "pyarrow is not installed")
+    def test_process_batch_pyarrow(self):
+        import pyarrow
+
+        gs1encoder = GS1Encoder()
+        array = pyarrow.chunked_array([["(01)12312312312319"], ["(01)12312312312310"]])
+
+        table = gs1encoder.process_batch(array, outputs=[BatchOutput.AI_DATA_STR])
+
+        self.assertEqual(table.column_names, ["error", "ai_data_str"])
+        self.assertEqual(table.column("ai_data_str").to_pylist(), ["(01)12312312312319", None])
+
 
 if __name__ == "__main__":
     unittest.main()
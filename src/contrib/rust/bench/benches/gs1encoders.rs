@@ -0,0 +1,97 @@
+/*
+ * Benchmarks for the Rust binding of the GS1 Barcode Syntax Engine.
+ *
+ * Compares the owned and borrowed getters, and processing a corpus serially
+ * with a parallel iterator, over the same messages as the C library
+ * benchmark ("make bench").
+ *
+ *
+ * @author Copyright (c) 2026 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+use criterion::{black_box, criterion_group, criterion_main, Criterion, Throughput};
+use gs1encoders::{GS1Encoder, GS1EncoderConfig, InputFormat, ParallelGS1Ext};
+use rayon::prelude::*;
+
+const CORPUS: &[&str] = &[
+    "(01)09521234543213(10)ABC123(99)TEST",
+    "(01)09521234543213(17)251231(10)BATCH42(21)SERIAL0001",
+    "(01)09521234543213(3103)000189(15)260101(10)LOT-7",
+    "(01)09521234543213(11)250101(17)271231(10)ABCDEFGHIJKLMNOPQRST(21)12345678901234567890",
+    "(00)095212345678901235(02)09521234543213(37)24",
+    "(414)9521234543213(254)A1B2",
+    "(8004)952123456789012345",
+];
+
+fn bench_getters(c: &mut Criterion) {
+    let mut gs1encoder = GS1Encoder::new().unwrap();
+    let mut group = c.benchmark_group("ai_data_to_dl_uri");
+    group.throughput(Throughput::Elements(CORPUS.len() as u64));
+
+    group.bench_function("owned", |b| {
+        b.iter(|| {
+            for input in CORPUS {
+                gs1encoder.set_ai_data_str(input).unwrap();
+                black_box(gs1encoder.get_dl_uri(None).unwrap());
+            }
+        })
+    });
+
+    group.bench_function("borrowed", |b| {
+        b.iter(|| {
+            for input in CORPUS {
+                gs1encoder.set_ai_data_str(input).unwrap();
+                black_box(gs1encoder.dl_uri(None).unwrap());
+            }
+        })
+    });
+
+    group.finish();
+}
+
+fn bench_parallel(c: &mut Criterion) {
+    let inputs: Vec<&str> = CORPUS.iter().copied().cycle().take(100_000).collect();
+    let config = GS1EncoderConfig::default();
+    let mut group = c.benchmark_group("validate_100k");
+    group.throughput(Throughput::Elements(inputs.len() as u64));
+    group.sample_size(10);
+
+    group.bench_function("serial", |b| {
+        let mut gs1encoder = config.build().unwrap();
+        b.iter(|| {
+            inputs
+                .iter()
+                .filter(|input| gs1encoder.set_ai_data_str(input).is_err())
+                .count()
+        })
+    });
+
+    group.bench_function("rayon", |b| {
+        b.iter(|| {
+            inputs
+                .par_iter()
+                .gs1_validate(&config, InputFormat::AiDataStr)
+                .filter(|r| r.is_err())
+                .count()
+        })
+    });
+
+    group.finish();
+}
+
+criterion_group!(benches, bench_getters, bench_parallel);
+criterion_main!(benches);
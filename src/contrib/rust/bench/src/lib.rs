@@ -0,0 +1 @@
+// Benchmarks for the gs1encoders binding are in benches/.
@@ -1,5 +1,12 @@
+use std::env;
+use std::path::Path;
+
 fn main() {
+    // Absolute, so that the path also holds when this crate is built as a
+    // dependency of another, such as the benchmarks
+    let manifest_dir = env::var("CARGO_MANIFEST_DIR").unwrap();
+    let lib_dir = Path::new(&manifest_dir).join("../../c-lib/build");
     println!("cargo:rustc-link-lib=gs1encoders");
-    println!("cargo:rustc-link-search=../../c-lib/build");
-    println!("cargo:rustc-env=LD_LIBRARY_PATH=../../c-lib/build");
+    println!("cargo:rustc-link-search={}", lib_dir.display());
+    println!("cargo:rustc-env=LD_LIBRARY_PATH={}", lib_dir.display());
 }
@@ -22,6 +22,23 @@
  *
  */
 
+//! Each `GS1Encoder` owns a native context. It may be moved to another
+//! thread (`Send`) but not shared between threads, since even the native
+//! getters write to buffers within the context.
+//!
+//! The `get_*` methods return owned copies of the outputs. The unprefixed
+//! accessors (`data_str()`, `ai_data_str()`, `dl_uri()`, etc.) instead
+//! return `&str` borrowed from the context's buffers, avoiding a copy. The
+//! borrow checker ensures that the borrowed output is no longer used once
+//! the encoder is next modified. Most of these accessors take `&mut self`
+//! because the native getters share a buffer.
+//!
+//! `GS1EncoderConfig` holds the settings of an encoder. It is `Send` and
+//! `Sync`, so one instance can be shared by the threads that build their
+//! own encoders from it. With the `rayon` feature, `ParallelGS1Ext` adds
+//! methods to a `ParallelIterator` that process the items using an encoder
+//! per worker thread built from a shared configuration.
+
 use std::ffi::{CStr, CString};
 use std::fmt;
 use std::os::raw::{c_char, c_int};
@@ -128,6 +145,17 @@ pub struct GS1Encoder {
     ctx: *mut gs1_encoder,
 }
 
+// SAFETY: A native context holds no references to thread-local state or to
+// other contexts, so it may be used from any thread provided that it is used
+// by only one thread at a time. The raw pointer keeps the type !Sync.
+unsafe impl Send for GS1Encoder {}
+
+// Borrow a NUL-terminated output of the native library for the lifetime of
+// the encoder borrow from which it was obtained.
+unsafe fn borrow_str<'a>(ptr: *const c_char) -> &'a str {
+    CStr::from_ptr(ptr).to_str().unwrap()
+}
+
 impl GS1Encoder {
     fn get_err_msg(&self) -> String {
         let c_str: &CStr = unsafe { CStr::from_ptr(gs1_encoder_getErrMsg(self.ctx)) };
@@ -364,6 +392,208 @@ impl GS1Encoder {
         }
         hri
     }
+
+    /// Returns the settings of this encoder, for building others like it.
+    pub fn config(&self) -> GS1EncoderConfig {
+        GS1EncoderConfig {
+            sym: self.get_sym(),
+            add_check_digit: self.get_add_check_digit(),
+            permit_unknown_ais: self.get_permit_unknown_ais(),
+            permit_zero_suppressed_gtin_in_dl_uris: self
+                .get_permit_zero_suppressed_gtin_in_dl_uris(),
+            include_data_titles_in_hri: self.get_include_data_titles_in_hri(),
+            validate_requisite_ais: self.get_validation_enabled(Validation::RequisiteAis),
+            validate_unknown_ai_not_dl_attr: self
+                .get_validation_enabled(Validation::UnknownAiNotDlAttr),
+        }
+    }
+
+    /// Borrows the raw data input buffer.
+    ///
+    /// Unlike the other borrowing accessors this takes `&self`, since the
+    /// buffer is changed only by the setters.
+    pub fn data_str(&self) -> &str {
+        unsafe { borrow_str(gs1_encoder_getDataStr(self.ctx)) }
+    }
+
+    /// Borrows the AI data string, or `None` if the input is not AI data.
+    pub fn ai_data_str(&mut self) -> Option<&str> {
+        let ptr = unsafe { gs1_encoder_getAIdataStr(self.ctx) };
+        if ptr.is_null() {
+            return None;
+        }
+        Some(unsafe { borrow_str(ptr) })
+    }
+
+    /// Borrows the scan data for the selected symbology.
+    pub fn scan_data(&mut self) -> Result<&str, GS1EncoderError> {
+        let ptr = unsafe { gs1_encoder_getScanData(self.ctx) };
+        if ptr.is_null() {
+            return Err(GS1EncoderError::GS1ScanDataError(self.get_err_msg()));
+        }
+        Ok(unsafe { borrow_str(ptr) })
+    }
+
+    /// Borrows a GS1 Digital Link URI for the AI data, with the given stem
+    /// or the canonical stem if `None`.
+    pub fn dl_uri(&mut self, stem: Option<&str>) -> Result<&str, GS1EncoderError> {
+        let c_stem = stem
+            .map(|s| {
+                CString::new(s).map_err(|_| {
+                    GS1EncoderError::GS1DigitalLinkError(
+                        "Stem must not contain a NUL character".to_string(),
+                    )
+                })
+            })
+            .transpose()?;
+        let stem_ptr = c_stem
+            .as_ref()
+            .map_or(ptr::null(), |s| s.as_ptr() as *const c_char);
+        let ptr = unsafe { gs1_encoder_getDLuri(self.ctx, stem_ptr) };
+        if ptr.is_null() {
+            return Err(GS1EncoderError::GS1DigitalLinkError(self.get_err_msg()));
+        }
+        Ok(unsafe { borrow_str(ptr) })
+    }
+
+    /// Borrows the lines of the Human Readable Interpretation.
+    pub fn hri(&mut self) -> Vec<&str> {
+        let mut lines: *mut *mut c_char = ptr::null_mut();
+        let size = unsafe { gs1_encoder_getHRI(self.ctx, &mut lines) };
+        (0..size)
+            .map(|i| unsafe { borrow_str(*lines.offset(i as isize)) })
+            .collect()
+    }
+
+    /// Borrows the error markup for the most recent linting failure.
+    pub fn err_markup(&mut self) -> &str {
+        unsafe { borrow_str(gs1_encoder_getErrMarkup(self.ctx)) }
+    }
+}
+
+/// The settings of a `GS1Encoder`, from which further encoders with the same
+/// settings can be built, for instance one for each worker thread.
+///
+/// The defaults are those of a new encoder. Each encoder built uses the
+/// embedded AI table, loaded into its own native context.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct GS1EncoderConfig {
+    pub sym: Symbology,
+    pub add_check_digit: bool,
+    pub permit_unknown_ais: bool,
+    pub permit_zero_suppressed_gtin_in_dl_uris: bool,
+    pub include_data_titles_in_hri: bool,
+    pub validate_requisite_ais: bool,
+    pub validate_unknown_ai_not_dl_attr: bool,
+}
+
+impl Default for GS1EncoderConfig {
+    fn default() -> Self {
+        GS1EncoderConfig {
+            sym: Symbology::None,
+            add_check_digit: false,
+            permit_unknown_ais: false,
+            permit_zero_suppressed_gtin_in_dl_uris: false,
+            include_data_titles_in_hri: false,
+            validate_requisite_ais: true,
+            validate_unknown_ai_not_dl_attr: true,
+        }
+    }
+}
+
+impl GS1EncoderConfig {
+    /// Builds a new encoder with these settings.
+    pub fn build(&self) -> Result<GS1Encoder, GS1EncoderError> {
+        let mut gs1encoder = GS1Encoder::new()?;
+        gs1encoder.set_sym(self.sym)?;
+        gs1encoder.set_add_check_digit(self.add_check_digit)?;
+        gs1encoder.set_permit_unknown_ais(self.permit_unknown_ais)?;
+        gs1encoder.set_permit_zero_suppressed_gtin_in_dl_uris(
+            self.permit_zero_suppressed_gtin_in_dl_uris,
+        )?;
+        gs1encoder.set_include_data_titles_in_hri(self.include_data_titles_in_hri)?;
+        gs1encoder.set_validation_enabled(Validation::RequisiteAis, self.validate_requisite_ais)?;
+        gs1encoder.set_validation_enabled(
+            Validation::UnknownAiNotDlAttr,
+            self.validate_unknown_ai_not_dl_attr,
+        )?;
+        Ok(gs1encoder)
+    }
+}
+
+/// The format of the inputs processed by `ParallelGS1Ext::gs1_validate()`.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum InputFormat {
+    AiDataStr,
+    DataStr,
+    ScanData,
+}
+
+impl GS1Encoder {
+    /// Sets the input in the given format.
+    pub fn set_input(&mut self, format: InputFormat, value: &str) -> Result<(), GS1EncoderError> {
+        match format {
+            InputFormat::AiDataStr => self.set_ai_data_str(value),
+            InputFormat::DataStr => self.set_data_str(value),
+            InputFormat::ScanData => self.set_scan_data(value),
+        }
+    }
+}
+
+#[cfg(feature = "rayon")]
+pub use parallel::ParallelGS1Ext;
+
+#[cfg(feature = "rayon")]
+mod parallel {
+    use super::{GS1Encoder, GS1EncoderConfig, GS1EncoderError, InputFormat};
+    use rayon::iter::ParallelIterator;
+
+    /// Processing of the items of a `ParallelIterator` with encoders built
+    /// from a shared configuration.
+    ///
+    /// An encoder is built for each split of the work that rayon makes, so
+    /// typically a few per worker thread, and reused for all of the items
+    /// of that split.
+    ///
+    /// # Panics
+    ///
+    /// If an encoder cannot be built, which happens only if the native
+    /// library cannot allocate a context.
+    pub trait ParallelGS1Ext: ParallelIterator + Sized {
+        /// Maps each item with an encoder that is exclusive to the calling
+        /// thread.
+        fn map_with_gs1_encoder<F, R>(
+            self,
+            config: &GS1EncoderConfig,
+            map_op: F,
+        ) -> impl ParallelIterator<Item = R>
+        where
+            F: Fn(&mut GS1Encoder, Self::Item) -> R + Sync + Send,
+            R: Send,
+        {
+            self.map_init(
+                move || config.build().expect("Failed to build a GS1Encoder"),
+                map_op,
+            )
+        }
+
+        /// Validates each item as input in the given format, giving the
+        /// error for each rejected item.
+        fn gs1_validate(
+            self,
+            config: &GS1EncoderConfig,
+            format: InputFormat,
+        ) -> impl ParallelIterator<Item = Result<(), GS1EncoderError>>
+        where
+            Self::Item: AsRef<str>,
+        {
+            self.map_with_gs1_encoder(config, move |gs1encoder, item| {
+                gs1encoder.set_input(format, item.as_ref())
+            })
+        }
+    }
+
+    impl<I: ParallelIterator> ParallelGS1Ext for I {}
 }
 
 impl Drop for GS1Encoder {
@@ -688,6 +918,128 @@ mod tests {
         gs1encoder.free(); // Moves the encoder; use afterwards is a compile error
     }
 
+    #[test]
+    fn test_send() {
+        let mut gs1encoder = GS1Encoder::new().unwrap();
+        gs1encoder.set_ai_data_str("(01)12312312312319").unwrap();
+
+        let uri = std::thread::spawn(move || gs1encoder.get_dl_uri(None).unwrap())
+            .join()
+            .unwrap();
+        assert_eq!(uri, "https://id.gs1.org/01/12312312312319");
+
+        fn assert_send_sync<T: Send + Sync>() {}
+        assert_send_sync::<GS1EncoderConfig>();
+    }
+
+    #[test]
+    fn test_borrowed_getters() {
+        let mut gs1encoder = GS1Encoder::new().unwrap();
+
+        gs1encoder
+            .set_ai_data_str("(01)12312312312319(99)TESTING123")
+            .unwrap();
+
+        assert_eq!(gs1encoder.data_str(), "^011231231231231999TESTING123");
+        assert_eq!(
+            gs1encoder.ai_data_str(),
+            Some("(01)12312312312319(99)TESTING123")
+        );
+        assert_eq!(
+            gs1encoder.dl_uri(Some("https://example.com")).unwrap(),
+            "https://example.com/01/12312312312319?99=TESTING123"
+        );
+        assert_eq!(
+            gs1encoder.hri(),
+            vec!["(01) 12312312312319", "(99) TESTING123"]
+        );
+        assert!(matches!(
+            gs1encoder.scan_data(),
+            Err(GS1EncoderError::GS1ScanDataError(_))
+        ));
+        gs1encoder.set_sym(Symbology::Dm).unwrap();
+        assert_eq!(
+            gs1encoder.scan_data().unwrap(),
+            "]d2011231231231231999TESTING123"
+        );
+
+        let data: &str = gs1encoder.data_str();
+        let again: &str = gs1encoder.data_str();
+        assert_eq!(data, again);
+
+        assert!(gs1encoder.set_ai_data_str("(01)12312312312310").is_err());
+        assert_eq!(gs1encoder.err_markup(), "(01)1231231231231|0|");
+
+        gs1encoder.set_data_str("TESTING").unwrap();
+        assert_eq!(gs1encoder.ai_data_str(), None);
+        assert!(matches!(
+            gs1encoder.dl_uri(None),
+            Err(GS1EncoderError::GS1DigitalLinkError(_))
+        ));
+    }
+
+    #[test]
+    fn test_config() {
+        let mut gs1encoder = GS1Encoder::new().unwrap();
+        assert_eq!(gs1encoder.config(), GS1EncoderConfig::default());
+
+        gs1encoder.set_sym(Symbology::Qr).unwrap();
+        gs1encoder.set_include_data_titles_in_hri(true).unwrap();
+        gs1encoder
+            .set_validation_enabled(Validation::RequisiteAis, false)
+            .unwrap();
+
+        let config = gs1encoder.config();
+        let mut built = config.build().unwrap();
+        assert_eq!(built.config(), config);
+
+        built
+            .set_input(InputFormat::DataStr, "^0212312312312319")
+            .unwrap();
+        assert_eq!(built.hri(), vec!["CONTENT (02) 12312312312319"]);
+        built
+            .set_input(InputFormat::ScanData, "]Q1TESTING")
+            .unwrap();
+        assert!(built.set_input(InputFormat::AiDataStr, "TESTING").is_err());
+    }
+
+    #[cfg(feature = "rayon")]
+    #[test]
+    fn test_parallel() {
+        use rayon::prelude::*;
+
+        let inputs: Vec<String> = (0..1000)
+            .map(|i| {
+                if i % 100 == 99 {
+                    "(01)12312312312310".to_string()
+                } else {
+                    format!("(01)12312312312319(10)LOT{i}")
+                }
+            })
+            .collect();
+        let config = GS1EncoderConfig::default();
+
+        let rejected = inputs
+            .par_iter()
+            .gs1_validate(&config, InputFormat::AiDataStr)
+            .filter(|r| r.is_err())
+            .count();
+        assert_eq!(rejected, 10);
+
+        let uris: Vec<Option<String>> = inputs
+            .par_iter()
+            .map_with_gs1_encoder(&config, |gs1encoder, input| {
+                gs1encoder.set_ai_data_str(input).ok()?;
+                gs1encoder.dl_uri(None).ok().map(str::to_owned)
+            })
+            .collect();
+        assert_eq!(
+            uris[0].as_deref(),
+            Some("https://id.gs1.org/01/12312312312319/10/LOT0")
+        );
+        assert_eq!(uris[99], None);
+    }
+
     #[test]
     fn test_interior_nul_is_error() {
         let mut gs1encoder = GS1Encoder::new().unwrap();
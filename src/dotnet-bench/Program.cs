@@ -0,0 +1,127 @@
+using System;
+using System.Text;
+using BenchmarkDotNet.Attributes;
+using BenchmarkDotNet.Running;
+using GS1.Encoders;
+
+namespace GS1EncodersBench
+{
+
+    /*
+     * Copyright (c) 2026 GS1 AISBL.
+     *
+     * Licensed under the Apache License, Version 2.0 (the "License");
+     * you may not use this file except in compliance with the License.
+     *
+     * You may obtain a copy of the License at
+     *
+     *     http://www.apache.org/licenses/LICENSE-2.0
+     *
+     * Unless required by applicable law or agreed to in writing, software
+     * distributed under the License is distributed on an "AS IS" BASIS,
+     * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+     * See the License for the specific language governing permissions and
+     * limitations under the License.
+     *
+     */
+
+    /*
+     *  Compares the string properties of the wrapper with the span-based
+     *  methods and the encoder pool, over the same corpus as the C library
+     *  benchmark ("make bench").
+     *
+     *  Build the native library first, then:
+     *
+     *    dotnet run -c Release --project src/dotnet-bench -- --filter '*'
+     *
+     *  The allocation columns reported by the memory diagnoser are the point
+     *  of interest: the span-based cases should report no allocation.
+     *
+     */
+    [MemoryDiagnoser]
+    public class AIdataBenchmarks
+    {
+
+        private static readonly string[] corpus = new string[] {
+            "(01)09521234543213(10)ABC123(99)TEST",
+            "(01)09521234543213(17)251231(10)BATCH42(21)SERIAL0001",
+            "(01)09521234543213(3103)000189(15)260101(10)LOT-7",
+            "(01)09521234543213(11)250101(17)271231(10)ABCDEFGHIJKLMNOPQRST(21)12345678901234567890",
+            "(00)095212345678901235(02)09521234543213(37)24",
+            "(414)9521234543213(254)A1B2",
+            "(8004)952123456789012345",
+        };
+
+        private byte[][] corpusBytes;
+        private readonly byte[] output = new byte[1024];
+        private GS1Encoder gs1encoder;
+        private GS1EncoderPool pool;
+        private int i;
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            corpusBytes = Array.ConvertAll(corpus, s => Encoding.ASCII.GetBytes(s));
+            gs1encoder = new GS1Encoder();
+            pool = new GS1EncoderPool(1);
+            pool.Rent().Dispose();
+        }
+
+        [GlobalCleanup]
+        public void Cleanup()
+        {
+            pool.Dispose();
+            gs1encoder.Dispose();
+        }
+
+        [Benchmark(Baseline = true)]
+        public int StringAIdataToDLuri()
+        {
+            gs1encoder.AIdataStr = corpus[i++ % corpus.Length];
+            return gs1encoder.GetDLuri(null).Length;
+        }
+
+        [Benchmark]
+        public int SpanAIdataToDLuri()
+        {
+            if (!gs1encoder.TrySetAIdataStr(corpusBytes[i++ % corpusBytes.Length]))
+                return gs1encoder.GetErrMsg(output);
+            return gs1encoder.GetDLuri(ReadOnlySpan<byte>.Empty, output);
+        }
+
+        [Benchmark]
+        public int PooledSpanAIdataToDLuri()
+        {
+            using (GS1EncoderPool.Lease lease = pool.Rent())
+            {
+                if (!lease.Encoder.TrySetAIdataStr(corpusBytes[i++ % corpusBytes.Length]))
+                    return lease.Encoder.GetErrMsg(output);
+                return lease.Encoder.GetDLuri(ReadOnlySpan<byte>.Empty, output);
+            }
+        }
+
+        [Benchmark]
+        public int StringAIdataToDataStr()
+        {
+            gs1encoder.AIdataStr = corpus[i++ % corpus.Length];
+            return gs1encoder.DataStr.Length;
+        }
+
+        [Benchmark]
+        public int SpanAIdataToDataStr()
+        {
+            gs1encoder.TrySetAIdataStr(corpusBytes[i++ % corpusBytes.Length]);
+            return gs1encoder.GetDataStr(output);
+        }
+
+    }
+
+    public static class Program
+    {
+        public static void Main(string[] args)
+        {
+            BenchmarkSwitcher.FromAssembly(typeof(Program).Assembly).Run(args);
+        }
+    }
+
+}
@@ -1,4 +1,6 @@
 ﻿using System;
+using System.Buffers;
+using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 
 namespace GS1.Encoders
@@ -30,7 +32,7 @@ namespace GS1.Encoders
     /// own GS1Encoder instance. This applies also to the property getters,
     /// which mutate internal buffers of the native context.
     /// </remarks>
-    public class GS1Encoder : IDisposable
+    public partial class GS1Encoder : IDisposable
     {
 
         /// <summary>
@@ -293,6 +295,31 @@ namespace GS1.Encoders
         [DllImport(gs1_dll, EntryPoint = "gs1_encoder_free", CallingConvention = CallingConvention.Cdecl)]
         private static extern void gs1_encoder_free(IntPtr ctx);
 
+        /*
+         *  Length-delimited setters used by the span-based methods. These are
+         *  source-generated so that passing a pinned buffer involves no
+         *  marshalling stub allocation or string conversion.
+         *
+         */
+        [LibraryImport(gs1_dll, EntryPoint = "gs1_encoder_setDataStrN")]
+        [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+        [return: MarshalAs(UnmanagedType.U1)]
+        private static unsafe partial bool gs1_encoder_setDataStrN(GS1EncoderHandle ctx, byte* dataStr, nuint len);
+
+        [LibraryImport(gs1_dll, EntryPoint = "gs1_encoder_setAIdataStrN")]
+        [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+        [return: MarshalAs(UnmanagedType.U1)]
+        private static unsafe partial bool gs1_encoder_setAIdataStrN(GS1EncoderHandle ctx, byte* aiData, nuint len);
+
+        [LibraryImport(gs1_dll, EntryPoint = "gs1_encoder_setScanDataN")]
+        [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+        [return: MarshalAs(UnmanagedType.U1)]
+        private static unsafe partial bool gs1_encoder_setScanDataN(GS1EncoderHandle ctx, byte* scanData, nuint len);
+
+        [LibraryImport(gs1_dll, EntryPoint = "gs1_encoder_getDLuri")]
+        [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+        private static unsafe partial IntPtr gs1_encoder_getDLuriUtf8(GS1EncoderHandle ctx, byte* stem);
+
 
         /*
          *  Methods to provide a wrapper around the functional interface imported from the native library
@@ -937,6 +964,208 @@ namespace GS1.Encoders
             }
         }
 
+        /*
+         *  Span-based methods
+         *
+         *  These mirror the string properties but operate on caller-owned
+         *  byte buffers holding the ASCII form of the data, so that a hot
+         *  path can process messages without allocating managed strings.
+         *  Setters pin the input and pass its length, so the input need not
+         *  be NUL-terminated. Getters copy the NUL-terminated output of the
+         *  native library into the destination and return the number of
+         *  bytes written, excluding any terminator.
+         *
+         */
+
+        /// <summary>
+        /// Set the barcode data input buffer from a span of bytes, without throwing on invalid data.
+        /// </summary>
+        /// <param name="dataStr">The data, as for <see cref="DataStr"/>, without a NUL terminator.</param>
+        /// <returns><c>true</c> if the data was accepted; otherwise <c>false</c>, in which case
+        /// the reason is available from <see cref="GetErrMsg(Span{byte})"/> and
+        /// <see cref="GetErrMarkup(Span{byte})"/>.</returns>
+        /// <seealso cref="DataStr"/>
+        public unsafe bool TrySetDataStr(ReadOnlySpan<byte> dataStr)
+        {
+            fixed (byte* p = dataStr)
+                return gs1_encoder_setDataStrN(ctx, p, (nuint)dataStr.Length);
+        }
+
+        /// <summary>
+        /// Set the barcode data input buffer using GS1 AI syntax from a span of bytes, without throwing on invalid data.
+        /// </summary>
+        /// <param name="aiData">The AI data, as for <see cref="AIdataStr"/>, without a NUL terminator.</param>
+        /// <returns><c>true</c> if the data was accepted; otherwise <c>false</c>.</returns>
+        /// <seealso cref="AIdataStr"/>
+        public unsafe bool TrySetAIdataStr(ReadOnlySpan<byte> aiData)
+        {
+            fixed (byte* p = aiData)
+                return gs1_encoder_setAIdataStrN(ctx, p, (nuint)aiData.Length);
+        }
+
+        /// <summary>
+        /// Process scan data from a span of bytes, without throwing on invalid data.
+        /// </summary>
+        /// <param name="scanData">The scan data, as for <see cref="ScanData"/>, without a NUL terminator.</param>
+        /// <returns><c>true</c> if the scan data was accepted; otherwise <c>false</c>.</returns>
+        /// <seealso cref="ScanData"/>
+        public unsafe bool TrySetScanData(ReadOnlySpan<byte> scanData)
+        {
+            fixed (byte* p = scanData)
+                return gs1_encoder_setScanDataN(ctx, p, (nuint)scanData.Length);
+        }
+
+        /// <summary>
+        /// Set the barcode data input buffer from a span of bytes.
+        /// </summary>
+        /// <param name="dataStr">The data, as for <see cref="DataStr"/>, without a NUL terminator.</param>
+        /// <exception cref="GS1EncoderParameterException">Thrown when the data is invalid.</exception>
+        public void SetDataStr(ReadOnlySpan<byte> dataStr)
+        {
+            if (!TrySetDataStr(dataStr))
+                throw new GS1EncoderParameterException(ErrMsg);
+        }
+
+        /// <summary>
+        /// Set the barcode data input buffer using GS1 AI syntax from a span of bytes.
+        /// </summary>
+        /// <param name="aiData">The AI data, as for <see cref="AIdataStr"/>, without a NUL terminator.</param>
+        /// <exception cref="GS1EncoderParameterException">Thrown when the AI data is invalid.</exception>
+        public void SetAIdataStr(ReadOnlySpan<byte> aiData)
+        {
+            if (!TrySetAIdataStr(aiData))
+                throw new GS1EncoderParameterException(ErrMsg);
+        }
+
+        /// <summary>
+        /// Process scan data from a span of bytes.
+        /// </summary>
+        /// <param name="scanData">The scan data, as for <see cref="ScanData"/>, without a NUL terminator.</param>
+        /// <exception cref="GS1EncoderScanDataException">Thrown when the scan data is invalid.</exception>
+        public void SetScanData(ReadOnlySpan<byte> scanData)
+        {
+            if (!TrySetScanData(scanData))
+                throw new GS1EncoderScanDataException(ErrMsg);
+        }
+
+        /// <summary>
+        /// Copy the barcode data input buffer into a span of bytes.
+        /// </summary>
+        /// <param name="destination">The buffer to receive the data.</param>
+        /// <returns>The number of bytes written.</returns>
+        /// <exception cref="ArgumentException">Thrown when the destination is too small.</exception>
+        /// <seealso cref="DataStr"/>
+        public int GetDataStr(Span<byte> destination)
+        {
+            return CopyOut(gs1_encoder_getDataStr(ctx), destination);
+        }
+
+        /// <summary>
+        /// Copy the barcode data input buffer in GS1 AI syntax into a span of bytes.
+        /// </summary>
+        /// <param name="destination">The buffer to receive the AI data.</param>
+        /// <returns>The number of bytes written, or -1 if the input data does not contain AI data.</returns>
+        /// <exception cref="ArgumentException">Thrown when the destination is too small.</exception>
+        /// <seealso cref="AIdataStr"/>
+        public int GetAIdataStr(Span<byte> destination)
+        {
+            IntPtr p = gs1_encoder_getAIdataStr(ctx);
+            if (p == IntPtr.Zero)
+                return -1;
+            return CopyOut(p, destination);
+        }
+
+        /// <summary>
+        /// Copy the expected scan data for the selected symbology into a span of bytes.
+        /// </summary>
+        /// <param name="destination">The buffer to receive the scan data.</param>
+        /// <returns>The number of bytes written.</returns>
+        /// <exception cref="GS1EncoderScanDataException">Thrown when no symbology is selected or the
+        /// current data cannot be represented in the selected symbology.</exception>
+        /// <exception cref="ArgumentException">Thrown when the destination is too small.</exception>
+        /// <seealso cref="ScanData"/>
+        public int GetScanData(Span<byte> destination)
+        {
+            IntPtr p = gs1_encoder_getScanData(ctx);
+            if (p == IntPtr.Zero)
+                throw new GS1EncoderScanDataException(ErrMsg);
+            return CopyOut(p, destination);
+        }
+
+        /// <summary>
+        /// Copy a GS1 Digital Link URI that represents the AI-based input data into a span of bytes.
+        /// </summary>
+        /// <param name="stem">A URI stem used as a prefix for the URI, without a NUL terminator.
+        /// If empty, the GS1 canonical stem (https://id.gs1.org/) will be used.</param>
+        /// <param name="destination">The buffer to receive the URI.</param>
+        /// <returns>The number of bytes written.</returns>
+        /// <exception cref="GS1EncoderDigitalLinkException">Thrown when invalid input was provided.</exception>
+        /// <exception cref="ArgumentException">Thrown when the destination is too small.</exception>
+        /// <seealso cref="GetDLuri(string)"/>
+        public unsafe int GetDLuri(ReadOnlySpan<byte> stem, Span<byte> destination)
+        {
+            IntPtr uri;
+            if (stem.IsEmpty)
+            {
+                uri = gs1_encoder_getDLuriUtf8(ctx, null);
+            }
+            else
+            {
+                byte[] rented = null;
+                Span<byte> stemZ = stem.Length < StackallocLimit
+                    ? stackalloc byte[StackallocLimit]
+                    : (rented = ArrayPool<byte>.Shared.Rent(stem.Length + 1));
+                try
+                {
+                    stem.CopyTo(stemZ);
+                    stemZ[stem.Length] = 0;
+                    fixed (byte* p = stemZ)
+                        uri = gs1_encoder_getDLuriUtf8(ctx, p);
+                }
+                finally
+                {
+                    if (rented != null)
+                        ArrayPool<byte>.Shared.Return(rented);
+                }
+            }
+            if (uri == IntPtr.Zero)
+                throw new GS1EncoderDigitalLinkException(ErrMsg);
+            return CopyOut(uri, destination);
+        }
+
+        /// <summary>
+        /// Copy the error message for the most recent failure into a span of bytes.
+        /// </summary>
+        /// <param name="destination">The buffer to receive the message.</param>
+        /// <returns>The number of bytes written, which is zero if there is no error.</returns>
+        /// <exception cref="ArgumentException">Thrown when the destination is too small.</exception>
+        public int GetErrMsg(Span<byte> destination)
+        {
+            return CopyOut(gs1_encoder_getErrMsg(ctx), destination);
+        }
+
+        /// <summary>
+        /// Copy the error markup for the most recent linting failure into a span of bytes.
+        /// </summary>
+        /// <param name="destination">The buffer to receive the markup.</param>
+        /// <returns>The number of bytes written, which is zero if there was no linting failure.</returns>
+        /// <exception cref="ArgumentException">Thrown when the destination is too small.</exception>
+        /// <seealso cref="ErrMarkup"/>
+        public int GetErrMarkup(Span<byte> destination)
+        {
+            return CopyOut(gs1_encoder_getErrMarkup(ctx), destination);
+        }
+
+        private const int StackallocLimit = 256;
+
+        private static unsafe int CopyOut(IntPtr p, Span<byte> destination)
+        {
+            ReadOnlySpan<byte> src = MemoryMarshal.CreateReadOnlySpanFromNullTerminated((byte*)p);
+            if (!src.TryCopyTo(destination))
+                throw new ArgumentException("Destination is too small", nameof(destination));
+            return src.Length;
+        }
+
         /// <summary>
         /// Releases the resources used by this GS1Encoder instance.
         /// </summary>
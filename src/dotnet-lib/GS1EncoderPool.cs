@@ -0,0 +1,201 @@
+using System;
+
+namespace GS1.Encoders
+{
+
+    /*
+     * Copyright (c) 2026 GS1 AISBL.
+     *
+     * Licensed under the Apache License, Version 2.0 (the "License");
+     * you may not use this file except in compliance with the License.
+     *
+     * You may obtain a copy of the License at
+     *
+     *     http://www.apache.org/licenses/LICENSE-2.0
+     *
+     * Unless required by applicable law or agreed to in writing, software
+     * distributed under the License is distributed on an "AS IS" BASIS,
+     * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+     * See the License for the specific language governing permissions and
+     * limitations under the License.
+     *
+     */
+
+    /// <summary>
+    /// A pool of <see cref="GS1Encoder"/> instances for use by concurrent request handlers.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// A GS1Encoder instance must only be used by one thread at a time and is
+    /// relatively costly to create, since it loads the AI table. The pool lets
+    /// each handler rent an instance for the duration of a request and then
+    /// return it for reuse, so that once the pool is warm no instances are
+    /// created and renting and returning allocate nothing.
+    /// </para>
+    /// <para>
+    /// Every instance is created with the same <see cref="GS1Encoder.InitOptions"/>
+    /// and is then passed to the optional configure callback. Instances are
+    /// returned to the pool as they are, so a handler that changes any option
+    /// of a rented instance must restore it before returning the instance.
+    /// </para>
+    /// <code>
+    /// using (GS1EncoderPool.Lease lease = pool.Rent())
+    /// {
+    ///     if (!lease.Encoder.TrySetAIdataStr(input))
+    ///         ...
+    /// }
+    /// </code>
+    /// </remarks>
+    public sealed class GS1EncoderPool : IDisposable
+    {
+
+        private readonly object sync = new object();
+        private readonly GS1Encoder[] retained;
+        private readonly GS1Encoder.InitOptions options;
+        private readonly Action<GS1Encoder> configure;
+        private int count;
+        private bool disposed;
+
+        /// <summary>
+        /// Initialises a new pool.
+        /// </summary>
+        /// <param name="maxRetained">The maximum number of idle instances held for reuse, or
+        /// zero for twice the number of processors. Instances returned to a full pool are disposed.</param>
+        /// <param name="options">Initialisation options for new instances, or null for defaults.</param>
+        /// <param name="configure">A callback applied to each new instance, or null.</param>
+        public GS1EncoderPool(int maxRetained = 0, GS1Encoder.InitOptions options = null, Action<GS1Encoder> configure = null)
+        {
+            if (maxRetained < 0)
+                throw new ArgumentOutOfRangeException(nameof(maxRetained));
+            if (maxRetained == 0)
+                maxRetained = 2 * Environment.ProcessorCount;
+            this.retained = new GS1Encoder[maxRetained];
+            this.options = options;
+            this.configure = configure;
+        }
+
+        /// <summary>
+        /// Get the number of idle instances currently held by the pool.
+        /// </summary>
+        public int Count
+        {
+            get
+            {
+                lock (sync)
+                    return count;
+            }
+        }
+
+        /// <summary>
+        /// Rent an instance, creating one if none is idle.
+        /// </summary>
+        /// <returns>A lease whose disposal returns the instance to the pool.</returns>
+        /// <exception cref="ObjectDisposedException">Thrown when the pool has been disposed.</exception>
+        /// <exception cref="GS1EncoderGeneralException">Thrown when a new instance fails to initialise.</exception>
+        public Lease Rent()
+        {
+            GS1Encoder encoder = null;
+            lock (sync)
+            {
+                ObjectDisposedException.ThrowIf(disposed, this);
+                if (count > 0)
+                {
+                    encoder = retained[--count];
+                    retained[count] = null;
+                }
+            }
+            if (encoder == null)
+            {
+                encoder = new GS1Encoder(options);
+                try
+                {
+                    configure?.Invoke(encoder);
+                }
+                catch
+                {
+                    encoder.Dispose();
+                    throw;
+                }
+            }
+            return new Lease(this, encoder);
+        }
+
+        /// <summary>
+        /// Return a rented instance to the pool.
+        /// </summary>
+        /// <param name="encoder">An instance obtained from <see cref="Rent"/>, which must not be used afterwards.</param>
+        /// <remarks>
+        /// Disposing the <see cref="Lease"/> does this. The instance is disposed
+        /// instead if the pool is full or has been disposed.
+        /// </remarks>
+        public void Return(GS1Encoder encoder)
+        {
+            if (encoder == null)
+                throw new ArgumentNullException(nameof(encoder));
+            lock (sync)
+            {
+                if (!disposed && count < retained.Length)
+                {
+                    retained[count++] = encoder;
+                    return;
+                }
+            }
+            encoder.Dispose();
+        }
+
+        /// <summary>
+        /// Dispose of the idle instances held by the pool.
+        /// </summary>
+        /// <remarks>
+        /// Instances that are rented at the time are disposed when they are returned.
+        /// </remarks>
+        public void Dispose()
+        {
+            lock (sync)
+            {
+                if (disposed)
+                    return;
+                disposed = true;
+                for (int i = 0; i < count; i++)
+                {
+                    retained[i].Dispose();
+                    retained[i] = null;
+                }
+                count = 0;
+            }
+        }
+
+        /// <summary>
+        /// A rented instance, which is returned to the pool when the lease is disposed.
+        /// </summary>
+        /// <remarks>
+        /// The lease is a value type so that renting allocates nothing. Dispose
+        /// it exactly once; copies of a lease refer to the same instance.
+        /// </remarks>
+        public readonly struct Lease : IDisposable
+        {
+            private readonly GS1EncoderPool pool;
+
+            internal Lease(GS1EncoderPool pool, GS1Encoder encoder)
+            {
+                this.pool = pool;
+                Encoder = encoder;
+            }
+
+            /// <summary>
+            /// The rented instance.
+            /// </summary>
+            public GS1Encoder Encoder { get; }
+
+            /// <summary>
+            /// Return the rented instance to the pool.
+            /// </summary>
+            public void Dispose()
+            {
+                pool?.Return(Encoder);
+            }
+        }
+
+    }
+
+}
@@ -1,3 +1,5 @@
+using System;
+using System.Text;
 using Microsoft.VisualStudio.TestTools.UnitTesting;
 using GS1.Encoders;
 
@@ -345,6 +347,124 @@ namespace GS1EncodersTest
             Assert.ThrowsExactly<System.ObjectDisposedException>(() => { _ = gs1encoder.ErrMarkup; });
         }
 
+        [TestMethod]
+        public void TestSpanSetters()
+        {
+            using (GS1Encoder gs1encoder = new GS1Encoder())
+            {
+                Span<byte> buf = stackalloc byte[256];
+                int len;
+
+                // Only the given length is consumed; no NUL terminator is needed
+                Assert.IsTrue(gs1encoder.TrySetAIdataStr("(01)12312312312319(99)TESTING123XXXX"u8.Slice(0, 32)));
+                len = gs1encoder.GetDataStr(buf);
+                Assert.AreEqual("^011231231231231999TESTING123", Encoding.ASCII.GetString(buf.Slice(0, len)));
+                len = gs1encoder.GetAIdataStr(buf);
+                Assert.AreEqual("(01)12312312312319(99)TESTING123", Encoding.ASCII.GetString(buf.Slice(0, len)));
+
+                gs1encoder.SetDataStr("https://id.example.org/test/01/12312312312319?99=TESTING123"u8);
+                len = gs1encoder.GetAIdataStr(buf);
+                Assert.AreEqual("(01)12312312312319(99)TESTING123", Encoding.ASCII.GetString(buf.Slice(0, len)));
+
+                gs1encoder.SetScanData("]Q3011231231231231999TESTING123"u8);
+                Assert.AreEqual(GS1Encoder.Symbology.QR, gs1encoder.Sym);
+                len = gs1encoder.GetScanData(buf);
+                Assert.AreEqual("]Q3011231231231231999TESTING123", Encoding.ASCII.GetString(buf.Slice(0, len)));
+
+                gs1encoder.SetDataStr("TESTING"u8);
+                Assert.AreEqual(-1, gs1encoder.GetAIdataStr(buf));
+            }
+        }
+
+        [TestMethod]
+        public void TestSpanSetterErrors()
+        {
+            using (GS1Encoder gs1encoder = new GS1Encoder())
+            {
+                byte[] buf = new byte[256];
+                int len;
+
+                Assert.IsFalse(gs1encoder.TrySetAIdataStr("(01)12312312312310"u8));
+                len = gs1encoder.GetErrMsg(buf);
+                Assert.IsTrue(len > 0);
+                Assert.AreEqual(gs1encoder.ErrMarkup, Encoding.ASCII.GetString(buf, 0, gs1encoder.GetErrMarkup(buf)));
+                Assert.AreEqual("(01)1231231231231|0|", gs1encoder.ErrMarkup);
+
+                Assert.IsFalse(gs1encoder.TrySetDataStr("^0112312312312319"u8.Slice(0, 16)));
+                Assert.IsFalse(gs1encoder.TrySetDataStr(new byte[] { (byte)'^', (byte)'9', (byte)'9', 0, (byte)'A' }));
+                Assert.IsFalse(gs1encoder.TrySetScanData("]Q3"u8.Slice(0, 2)));
+
+                Assert.ThrowsExactly<GS1EncoderParameterException>(() => { gs1encoder.SetAIdataStr("(01)12312312312310"u8); });
+                Assert.ThrowsExactly<GS1EncoderScanDataException>(() => { gs1encoder.SetScanData("]Z3"u8); });
+            }
+        }
+
+        [TestMethod]
+        public void TestSpanGetters()
+        {
+            using (GS1Encoder gs1encoder = new GS1Encoder())
+            {
+                byte[] buf = new byte[256];
+                int len;
+
+                gs1encoder.SetAIdataStr("(01)12312312312319(99)TESTING123"u8);
+
+                len = gs1encoder.GetDLuri(ReadOnlySpan<byte>.Empty, buf);
+                Assert.AreEqual("https://id.gs1.org/01/12312312312319?99=TESTING123", Encoding.ASCII.GetString(buf, 0, len));
+
+                len = gs1encoder.GetDLuri("https://id.example.org/stem"u8, buf);
+                Assert.AreEqual(gs1encoder.GetDLuri("https://id.example.org/stem"), Encoding.ASCII.GetString(buf, 0, len));
+
+                byte[] longStem = Encoding.ASCII.GetBytes("https://id.example.org/" + new string('x', 300));
+                len = gs1encoder.GetDLuri(longStem, new byte[512]);
+                Assert.IsTrue(len > 300);
+
+                Assert.ThrowsExactly<ArgumentException>(() => { gs1encoder.GetDataStr(new byte[5]); });
+                Assert.AreEqual(0, gs1encoder.GetErrMsg(buf));
+                Assert.AreEqual(0, gs1encoder.GetErrMarkup(buf));
+
+                gs1encoder.SetAIdataStr("(99)TESTING123"u8);
+                Assert.ThrowsExactly<GS1EncoderDigitalLinkException>(() => { gs1encoder.GetDLuri(ReadOnlySpan<byte>.Empty, buf); });
+
+                Assert.ThrowsExactly<GS1EncoderScanDataException>(() => { gs1encoder.GetScanData(buf); });
+            }
+        }
+
+        [TestMethod]
+        public void TestEncoderPool()
+        {
+            using (GS1EncoderPool pool = new GS1EncoderPool(2, null, e => e.IncludeDataTitlesInHRI = true))
+            {
+                GS1Encoder first;
+                using (GS1EncoderPool.Lease lease = pool.Rent())
+                {
+                    first = lease.Encoder;
+                    Assert.IsTrue(first.IncludeDataTitlesInHRI);
+                    Assert.IsTrue(first.TrySetAIdataStr("(01)12312312312319"u8));
+                }
+                Assert.AreEqual(1, pool.Count);
+
+                GS1EncoderPool.Lease a = pool.Rent();
+                GS1EncoderPool.Lease b = pool.Rent();
+                GS1EncoderPool.Lease c = pool.Rent();
+                Assert.AreSame(first, a.Encoder);
+                Assert.AreNotSame(a.Encoder, b.Encoder);
+                Assert.IsTrue(c.Encoder.IncludeDataTitlesInHRI);
+                Assert.AreEqual(0, pool.Count);
+
+                a.Dispose();
+                b.Dispose();
+                c.Dispose();
+                Assert.AreEqual(2, pool.Count);
+                Assert.ThrowsExactly<System.ObjectDisposedException>(() => { _ = c.Encoder.Sym; });
+
+                pool.Dispose();
+                Assert.AreEqual(0, pool.Count);
+                Assert.ThrowsExactly<System.ObjectDisposedException>(() => { _ = a.Encoder.Sym; });
+                Assert.ThrowsExactly<System.ObjectDisposedException>(() => { pool.Rent(); });
+            }
+        }
+
     }
 
 }
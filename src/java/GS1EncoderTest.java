@@ -20,6 +20,10 @@
 
 import org.gs1.gs1encoders.*;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+
 import static org.junit.jupiter.api.Assertions.*;
 import org.junit.jupiter.api.Test;
 
@@ -344,6 +348,68 @@ public class GS1EncoderTest {
         gs1encoder.free();
     }
 
+    private static String getBatchRecord(ByteBuffer out, int[] status) {
+        status[0] = out.getInt();
+        byte[] data = new byte[out.getInt()];
+        out.get(data);
+        return new String(data, StandardCharsets.UTF_8);
+    }
+
+    @Test
+    public void testProcessBatch() throws Exception {
+        GS1Encoder gs1encoder = new GS1Encoder();
+
+        String[] inputs = { "(01)12312312312319(99)TESTING123", "(01)12312312312318", "(01)12312312312333" };
+        ByteBuffer in = ByteBuffer.allocateDirect(256).order(ByteOrder.LITTLE_ENDIAN);
+        for (String input : inputs) {
+            byte[] bytes = input.getBytes(StandardCharsets.UTF_8);
+            in.putInt(bytes.length).put(bytes).put((byte) 0);
+        }
+        in.flip();
+
+        ByteBuffer out = ByteBuffer.allocateDirect(256).order(ByteOrder.LITTLE_ENDIAN);
+        assertEquals(3, gs1encoder.processBatch(GS1Encoder.BatchInput.AIdataStr, GS1Encoder.BatchOutput.DLuri, in, inputs.length, out));
+        assertFalse(in.hasRemaining());
+        out.flip();
+
+        int[] status = new int[1];
+        assertEquals("https://id.gs1.org/01/12312312312319?99=TESTING123", getBatchRecord(out, status));
+        assertEquals(1, status[0]);
+        assertTrue(getBatchRecord(out, status).contains("check digit"));
+        assertEquals(0, status[0]);
+        assertEquals("https://id.gs1.org/01/12312312312333", getBatchRecord(out, status));
+        assertEquals(1, status[0]);
+        assertFalse(out.hasRemaining());
+
+        // A full output buffer stops the batch, leaving the remaining inputs to be resubmitted
+        in.rewind();
+        out = ByteBuffer.allocateDirect(64).order(ByteOrder.LITTLE_ENDIAN);
+        assertEquals(1, gs1encoder.processBatch(GS1Encoder.BatchInput.AIdataStr, GS1Encoder.BatchOutput.DLuri, in, inputs.length, out));
+        assertTrue(in.hasRemaining());
+
+        // A record too large for the whole output buffer cannot be processed
+        in.rewind();
+        ByteBuffer small = ByteBuffer.allocateDirect(16).order(ByteOrder.LITTLE_ENDIAN);
+        assertThrows(GS1EncoderParameterException.class, () -> {
+            gs1encoder.processBatch(GS1Encoder.BatchInput.AIdataStr, GS1Encoder.BatchOutput.DLuri, in, inputs.length, small);
+        });
+        assertEquals(0, in.position());
+
+        // Inputs must be NUL-terminated
+        ByteBuffer unterminated = ByteBuffer.allocateDirect(16).order(ByteOrder.LITTLE_ENDIAN);
+        unterminated.putInt(4).put("ABCD".getBytes(StandardCharsets.UTF_8)).put((byte) 'E').flip();
+        assertThrows(GS1EncoderParameterException.class, () -> {
+            gs1encoder.processBatch(GS1Encoder.BatchInput.DataStr, GS1Encoder.BatchOutput.None, unterminated, 1, small);
+        });
+
+        assertThrows(GS1EncoderParameterException.class, () -> {
+            gs1encoder.processBatch(GS1Encoder.BatchInput.AIdataStr, GS1Encoder.BatchOutput.None,
+                                    ByteBuffer.allocate(16), 1, ByteBuffer.allocateDirect(16));
+        });
+
+        gs1encoder.free();
+    }
+
     @Test
     public void testNoEmbedded() {
         assertThrows(GS1EncoderGeneralException.class, () -> {
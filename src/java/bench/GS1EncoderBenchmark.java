@@ -0,0 +1,119 @@
+/**
+ *  JMH benchmark comparing per-message processing through the String-based
+ *  Java API with the bulk ByteBuffer API of the Java binding for the GS1
+ *  Barcode Syntax Engine.
+ *
+ *  To run: ant -f build.xml bench
+ *
+ *  Each benchmark processes the same corpus of AI element strings to GS1
+ *  Digital Link URIs and reports the time per message, so that the cost of
+ *  the JNI marshalling avoided by the bulk API can be read off directly.
+ *
+ *  Copyright (c) 2026 GS1 AISBL.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+package bench;
+
+import org.gs1.gs1encoders.*;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+import java.util.concurrent.TimeUnit;
+
+import org.openjdk.jmh.annotations.*;
+import org.openjdk.jmh.infra.Blackhole;
+
+@State(Scope.Thread)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.NANOSECONDS)
+@Warmup(iterations = 3, time = 1)
+@Measurement(iterations = 5, time = 1)
+@Fork(1)
+public class GS1EncoderBenchmark {
+
+    // Mirrors the corpus of the C library benchmark ("make bench")
+    private static final String[] CORPUS = {
+        "(01)09521234543213(10)ABC123(99)TEST",
+        "(01)09521234543213(17)251231(10)BATCH42(21)SERIAL0001",
+        "(01)09521234543213(3103)000189(15)260101(10)LOT-7",
+        "(01)09521234543213(11)250101(17)271231(10)ABCDEFGHIJKLMNOPQRST(21)12345678901234567890",
+        "(00)095212345678901235(02)09521234543213(37)24",
+        "(414)9521234543213(254)A1B2",
+        "(8004)952123456789012345",
+    };
+
+    private static final int BATCH = 1000;
+
+    private GS1Encoder gs1encoder;
+    private String[] messages;
+    private ByteBuffer in, out;
+
+    @Setup
+    public void setup() throws Exception {
+        gs1encoder = new GS1Encoder();
+        messages = new String[BATCH];
+        in = ByteBuffer.allocateDirect(BATCH * 128).order(ByteOrder.LITTLE_ENDIAN);
+        for (int i = 0; i < BATCH; i++) {
+            messages[i] = CORPUS[i % CORPUS.length];
+            byte[] bytes = messages[i].getBytes(StandardCharsets.UTF_8);
+            in.putInt(bytes.length).put(bytes).put((byte) 0);
+        }
+        in.flip();
+        out = ByteBuffer.allocateDirect(BATCH * 256).order(ByteOrder.LITTLE_ENDIAN);
+    }
+
+    @TearDown
+    public void tearDown() {
+        gs1encoder.close();
+    }
+
+    @Benchmark
+    @OperationsPerInvocation(BATCH)
+    public void perMessage(Blackhole bh) throws Exception {
+        for (String message : messages) {
+            gs1encoder.setAIdataStr(message);
+            bh.consume(gs1encoder.getDLuri(null));
+        }
+    }
+
+    @Benchmark
+    @OperationsPerInvocation(BATCH)
+    public void perMessageValidateOnly(Blackhole bh) throws Exception {
+        for (String message : messages) {
+            gs1encoder.setAIdataStr(message);
+        }
+        bh.consume(gs1encoder);
+    }
+
+    @Benchmark
+    @OperationsPerInvocation(BATCH)
+    public int batch() throws Exception {
+        in.rewind();
+        out.clear();
+        return gs1encoder.processBatch(GS1Encoder.BatchInput.AIdataStr, GS1Encoder.BatchOutput.DLuri, in, BATCH, out);
+    }
+
+    @Benchmark
+    @OperationsPerInvocation(BATCH)
+    public int batchValidateOnly() throws Exception {
+        in.rewind();
+        out.clear();
+        return gs1encoder.processBatch(GS1Encoder.BatchInput.AIdataStr, GS1Encoder.BatchOutput.None, in, BATCH, out);
+    }
+
+}
@@ -21,6 +21,8 @@
 
 #include <jni.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "gs1encoders.h"
 
 
@@ -353,3 +355,107 @@ JNIEXPORT jobjectArray JNICALL Java_org_gs1_gs1encoders_GS1Encoder_gs1encoderGet
     }
     return ret;
 }
+
+/*
+ * Bulk processing over direct ByteBuffers, avoiding a String conversion for
+ * each input and output. The input holds length-prefixed, NUL-terminated
+ * UTF-8 inputs that are passed to the library in place, and a record is
+ * appended to the output for each, as described by GS1Encoder.processBatch().
+ * Lengths are little-endian, regardless of the platform.
+ *
+ * pos is {inPos, inLimit, outPos, outLimit}; the positions are advanced past
+ * what was consumed and produced. Returns the number of inputs processed,
+ * which is short of num if the output is full or the next input is malformed.
+ * If no input can be processed then one of the BATCH_ERR_* codes is returned
+ * instead and the positions are unchanged.
+ */
+
+#define BATCH_LEN_SIZE 4
+#define BATCH_HDR_SIZE 8
+
+#define BATCH_ERR_MALFORMED   -1    /* An input is truncated or not NUL-terminated */
+#define BATCH_ERR_NO_SPACE    -2    /* The output has no space for the first record */
+#define BATCH_ERR_NOT_DIRECT  -3    /* Direct buffer access is unsupported by the VM */
+
+static uint32_t getLE32(const unsigned char *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void putLE32(unsigned char *p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+JNIEXPORT jint JNICALL Java_org_gs1_gs1encoders_GS1Encoder_gs1encoderProcessBatchJNI(
+        JNIEnv* env,
+        jobject obj,
+        jlong ctx,
+        jint input,
+        jint output,
+        jobject in,
+        jint num,
+        jobject out,
+        jintArray pos) {
+    unsigned char *inBuf, *outBuf;
+    jint p[4], inPos, inLimit, outPos, outLimit, i, err = BATCH_ERR_NO_SPACE;
+    gs1_encoder_batch_result_t result;
+    (void)obj;
+
+    inBuf = (*env)->GetDirectBufferAddress(env, in);
+    outBuf = (*env)->GetDirectBufferAddress(env, out);
+    if (inBuf == NULL || outBuf == NULL)
+        return BATCH_ERR_NOT_DIRECT;
+
+    (*env)->GetIntArrayRegion(env, pos, 0, 4, p);
+    if ((*env)->ExceptionCheck(env))
+        return 0;    /* ArrayIndexOutOfBoundsException pending */
+    inPos = p[0]; inLimit = p[1]; outPos = p[2]; outLimit = p[3];
+
+    for (i = 0; i < num; i++) {
+        const char *data;
+        uint32_t len;
+
+        if (inLimit - inPos < BATCH_LEN_SIZE) {
+            err = BATCH_ERR_MALFORMED;
+            break;
+        }
+        len = getLE32(inBuf + inPos);
+        data = (const char*)inBuf + inPos + BATCH_LEN_SIZE;
+        if (len >= (uint32_t)(inLimit - inPos - BATCH_LEN_SIZE) ||
+            memchr(data, '\0', len + 1) != data + len) {
+            err = BATCH_ERR_MALFORMED;
+            break;
+        }
+
+        /* Space for the record header and a terminating NUL, at least */
+        if (outLimit - outPos <= BATCH_HDR_SIZE)
+            break;
+
+        if (gs1_encoder_processBatch((gs1_encoder*)ctx,
+                                     (gs1_encoder_batch_inputs_t)input, (gs1_encoder_batch_outputs_t)output,
+                                     data, 1,
+                                     (char*)outBuf + outPos + BATCH_HDR_SIZE,
+                                     (size_t)(outLimit - outPos - BATCH_HDR_SIZE),
+                                     &result) != 1)
+            break;
+
+        putLE32(outBuf + outPos, (uint32_t)result.ok);
+        putLE32(outBuf + outPos + BATCH_LEN_SIZE, result.length);
+
+        inPos += BATCH_LEN_SIZE + (jint)len + 1;
+        outPos += BATCH_HDR_SIZE + (jint)result.length;
+    }
+
+    /* Report the first input that cannot be processed, rather than leave a
+     * caller that resubmits the remainder making no progress */
+    if (i == 0 && num > 0)
+        return err;
+
+    p[0] = inPos;
+    p[2] = outPos;
+    (*env)->SetIntArrayRegion(env, pos, 0, 4, p);
+
+    return i;
+}
@@ -58,6 +58,7 @@ JNIEXPORT jboolean     JNICALL Java_org_gs1_gs1encoders_GS1Encoder_gs1encoderSet
 JNIEXPORT jstring      JNICALL Java_org_gs1_gs1encoders_GS1Encoder_gs1encoderGetDLuriJNI(JNIEnv*, jobject, jlong, jstring);
 JNIEXPORT jobjectArray JNICALL Java_org_gs1_gs1encoders_GS1Encoder_gs1encoderGetHRIJNI(JNIEnv*, jobject, jlong);
 JNIEXPORT jobjectArray JNICALL Java_org_gs1_gs1encoders_GS1Encoder_gs1encoderGetDLignoredQueryParamsJNI(JNIEnv*, jobject, jlong);
+JNIEXPORT jint         JNICALL Java_org_gs1_gs1encoders_GS1Encoder_gs1encoderProcessBatchJNI(JNIEnv*, jobject, jlong, jint, jint, jobject, jint, jobject, jintArray);
 
 #define InitExJNI    Java_org_gs1_gs1encoders_GS1Encoder_gs1encoderInitExJNI
 #define FreeJNI      Java_org_gs1_gs1encoders_GS1Encoder_gs1encoderFreeJNI
@@ -67,6 +68,7 @@ JNIEXPORT jobjectArray JNICALL Java_org_gs1_gs1encoders_GS1Encoder_gs1encoderGet
 #define GetDLuriJNI  Java_org_gs1_gs1encoders_GS1Encoder_gs1encoderGetDLuriJNI
 #define GetHRIJNI    Java_org_gs1_gs1encoders_GS1Encoder_gs1encoderGetHRIJNI
 #define GetDLQPJNI   Java_org_gs1_gs1encoders_GS1Encoder_gs1encoderGetDLignoredQueryParamsJNI
+#define BatchJNI     Java_org_gs1_gs1encoders_GS1Encoder_gs1encoderProcessBatchJNI
 
 
 /*
@@ -254,6 +256,35 @@ static jboolean JNICALL mockGetBooleanField(JNIEnv *env, jobject obj, jfieldID f
 	return JNI_FALSE;
 }
 
+/* Direct buffer and primitive array mocks sufficient for the batch API: a
+ * direct buffer is a pointer to its storage, a jintArray a pointer to its
+ * elements */
+
+static jboolean directBuffersUnsupported;
+
+static void* JNICALL mockGetDirectBufferAddress(JNIEnv *env, jobject buf) {
+	(void)env;
+	unsafeCall(__func__);
+	return directBuffersUnsupported ? NULL : (void*)buf;
+}
+
+static void JNICALL mockGetIntArrayRegion(JNIEnv *env, jintArray array, jsize start, jsize len, jint *buf) {
+	(void)env;
+	unsafeCall(__func__);
+	memcpy(buf, (jint*)array + start, (size_t)len * sizeof(jint));
+}
+
+static void JNICALL mockSetIntArrayRegion(JNIEnv *env, jintArray array, jsize start, jsize len, const jint *buf) {
+	(void)env;
+	unsafeCall(__func__);
+	memcpy((jint*)array + start, buf, (size_t)len * sizeof(jint));
+}
+
+static jboolean JNICALL mockExceptionCheck(JNIEnv *env) {
+	(void)env;
+	return pendingException ? JNI_TRUE : JNI_FALSE;
+}
+
 
 #define CHECK(cond) do {						\
 	if (!(cond)) {							\
@@ -385,6 +416,90 @@ static void runArrayGetterOps(JNIEnv env) {
 }
 
 
+static size_t putBatchInput(unsigned char *p, const char *str) {
+	size_t len = strlen(str);
+	p[0] = (unsigned char)len;
+	p[1] = (unsigned char)(len >> 8);
+	p[2] = p[3] = 0;
+	memcpy(p + 4, str, len + 1);
+	return 4 + len + 1;
+}
+
+static unsigned int getLE32(const unsigned char *p) {
+	return (unsigned int)p[0] | (unsigned int)p[1] << 8 | (unsigned int)p[2] << 16 | (unsigned int)p[3] << 24;
+}
+
+/* The batch API reads length-prefixed, NUL-terminated inputs and writes
+ * status, length, data records, stopping short when the output fills */
+static void runBatchOps(JNIEnv env) {
+
+	static const char dlURI[] = "https://id.gs1.org/01/12312312312319?99=TESTING123";
+	unsigned char in[256], out[256];
+	jint pos[4];
+	size_t inLen = 0;
+	jlong ctx;
+
+	mode = MODE_COPY;
+	resetMock();
+
+	ctx = InitExJNI(&env, NULL, NULL, NULL);
+	CHECK(ctx != 0);
+
+	inLen += putBatchInput(in + inLen, "(01)12312312312319(99)TESTING123");
+	inLen += putBatchInput(in + inLen, "(01)12312312312318");
+	inLen += putBatchInput(in + inLen, "(01)12312312312319(99)TESTING123");
+
+	/* bAI_DATA_STR in, oDL_URI out */
+	pos[0] = 0; pos[1] = (jint)inLen; pos[2] = 0; pos[3] = (jint)sizeof(out);
+	CHECK(BatchJNI(&env, NULL, ctx, 0, 3, (jobject)in, 3, (jobject)out, (jintArray)pos) == 3);
+	CHECK(pos[0] == (jint)inLen);
+	CHECK(getLE32(out) == 1);
+	CHECK(getLE32(out + 4) == strlen(dlURI));
+	CHECK(memcmp(out + 8, dlURI, strlen(dlURI)) == 0);
+	CHECK(getLE32(out + 8 + strlen(dlURI)) == 0);		/* Bad check digit */
+	CHECK(pos[2] > (jint)(3 * 8 + 2 * strlen(dlURI)));
+	CHECK(disciplineErrors == 0);
+
+	/* Only the first record fits */
+	pos[0] = 0; pos[1] = (jint)inLen; pos[2] = 0; pos[3] = (jint)(8 + strlen(dlURI) + 1);
+	CHECK(BatchJNI(&env, NULL, ctx, 0, 3, (jobject)in, 3, (jobject)out, (jintArray)pos) == 1);
+	CHECK(pos[2] == (jint)(8 + strlen(dlURI)));
+
+	/* A record that does not fit in the whole output is an error, not an
+	 * empty batch that a resubmitting caller would repeat forever */
+	pos[0] = 0; pos[1] = (jint)inLen; pos[2] = 0; pos[3] = (jint)(8 + strlen(dlURI));
+	CHECK(BatchJNI(&env, NULL, ctx, 0, 3, (jobject)in, 3, (jobject)out, (jintArray)pos) == -2);
+	CHECK(pos[0] == 0 && pos[2] == 0);
+
+	/* Inputs before one that overruns the input are processed; the overrun
+	 * is then reported without advancing */
+	pos[0] = 0; pos[1] = (jint)inLen - 1; pos[2] = 0; pos[3] = (jint)sizeof(out);
+	CHECK(BatchJNI(&env, NULL, ctx, 0, 3, (jobject)in, 3, (jobject)out, (jintArray)pos) == 2);
+	CHECK(pos[0] > 0 && pos[2] > 0);
+	pos[2] = 0;
+	CHECK(BatchJNI(&env, NULL, ctx, 0, 3, (jobject)in, 1, (jobject)out, (jintArray)pos) == -1);
+	CHECK(pos[0] == (jint)(inLen - (4 + strlen("(01)12312312312319(99)TESTING123") + 1)) && pos[2] == 0);
+
+	/* An input without its NUL terminator, or with an embedded NUL */
+	in[4 + 3] = '\0';
+	pos[0] = 0; pos[1] = (jint)inLen; pos[2] = 0; pos[3] = (jint)sizeof(out);
+	CHECK(BatchJNI(&env, NULL, ctx, 0, 3, (jobject)in, 3, (jobject)out, (jintArray)pos) == -1);
+	in[4 + 3] = ')';
+	in[4 + strlen("(01)12312312312319(99)TESTING123")] = 'X';
+	CHECK(BatchJNI(&env, NULL, ctx, 0, 3, (jobject)in, 3, (jobject)out, (jintArray)pos) == -1);
+	CHECK(pos[0] == 0 && pos[2] == 0);
+	in[4 + strlen("(01)12312312312319(99)TESTING123")] = '\0';
+
+	directBuffersUnsupported = JNI_TRUE;
+	CHECK(BatchJNI(&env, NULL, ctx, 0, 3, (jobject)in, 3, (jobject)out, (jintArray)pos) == -3);
+	directBuffersUnsupported = JNI_FALSE;
+
+	printf("batch      : records written, partial, oversized and malformed batches handled\n");
+
+	FreeJNI(&env, NULL, ctx);
+}
+
+
 int main(void) {
 
 	struct JNINativeInterface_ fns;
@@ -406,6 +521,10 @@ int main(void) {
 	fns.GetFieldID            = mockGetFieldID;
 	fns.GetObjectField        = mockGetObjectField;
 	fns.GetBooleanField       = mockGetBooleanField;
+	fns.GetDirectBufferAddress = mockGetDirectBufferAddress;
+	fns.GetIntArrayRegion     = mockGetIntArrayRegion;
+	fns.SetIntArrayRegion     = mockSetIntArrayRegion;
+	fns.ExceptionCheck        = mockExceptionCheck;
 
 	resetMock();
 
@@ -473,6 +592,8 @@ int main(void) {
 
 	runArrayGetterOps(env);
 
+	runBatchOps(env);
+
 	CHECK(releaseErrors == 0);
 
 	if (fails) {
@@ -23,6 +23,7 @@ import java.io.FileOutputStream;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.OutputStream;
+import java.nio.ByteBuffer;
 import java.util.Objects;
 
 /**
@@ -64,6 +65,11 @@ public class GS1Encoder implements AutoCloseable {
     private static native String gs1encoderGetDLuriJNI(long ctx, String stem);
     private static native String[] gs1encoderGetHRIJNI(long ctx);
     private static native String[] gs1encoderGetDLignoredQueryParamsJNI(long ctx);
+    private static native int gs1encoderProcessBatchJNI(long ctx, int input, int output, ByteBuffer in, int num, ByteBuffer out, int[] pos);
+
+    // Negative returns of gs1encoderProcessBatchJNI; see gs1encoders_wrap.c
+    private static final int BATCH_ERR_MALFORMED = -1;
+    private static final int BATCH_ERR_NO_SPACE = -2;
 
     // Load the gs1encoders JNI library from the system library path, or, failing
     // that, from a per-platform copy bundled with the classes.
@@ -248,6 +254,81 @@ public class GS1Encoder implements AutoCloseable {
     }
 
 
+    /**
+     * Format of the inputs to {@link #processBatch(BatchInput, BatchOutput, ByteBuffer, int, ByteBuffer)}.
+     */
+    public enum BatchInput {
+            /**
+             * AI element strings, as for {@link #setAIdataStr(String)}
+             */
+            AIdataStr(0),
+
+            /**
+             * Barcode messages or GS1 Digital Link URIs, as for {@link #setDataStr(String)}
+             */
+            DataStr(1),
+
+            /**
+             * Scan data, as for {@link #setScanData(String)}
+             */
+            ScanData(2);
+
+            private final int value;
+            BatchInput(int value) { this.value = value; }
+
+            /**
+             * Returns the native library value for this input format.
+             * @return the integer value corresponding to the native enum
+             */
+            public int getValue() { return value; }
+    }
+
+
+    /**
+     * Output rendered for each input by {@link #processBatch(BatchInput, BatchOutput, ByteBuffer, int, ByteBuffer)}.
+     */
+    public enum BatchOutput {
+            /**
+             * No output; only the status is recorded
+             */
+            None(0),
+
+            /**
+             * The barcode message, as from {@link #getDataStr()}
+             */
+            DataStr(1),
+
+            /**
+             * The AI element string, as from {@link #getAIdataStr()}
+             */
+            AIdataStr(2),
+
+            /**
+             * The GS1 Digital Link URI with the default stem, as from {@link #getDLuri(String)}
+             */
+            DLuri(3),
+
+            /**
+             * The scan data, as from {@link #getScanData()}
+             */
+            ScanData(4),
+
+            /**
+             * The HRI text, as from {@link #getHRI()}, with lines separated by {@code "|"}
+             */
+            HRI(5);
+
+            private final int value;
+            BatchOutput(int value) { this.value = value; }
+
+            /**
+             * Returns the native library value for this output.
+             * @return the integer value corresponding to the native enum
+             */
+            public int getValue() { return value; }
+    }
+
+
     /**
      * Initialisation options for the GS1Encoder.
      * New setters may be added in future versions without breaking existing code.
@@ -865,6 +946,64 @@ public class GS1Encoder implements AutoCloseable {
         return gs1encoderGetDLignoredQueryParamsJNI(ctx());
     }
 
+    /**
+     * Process a batch of inputs held in a direct {@link ByteBuffer}, writing a
+     * record for each to a direct output {@code ByteBuffer}.
+     * <p>
+     * This avoids the conversion of each input and output to and from a
+     * {@code String}, and the native call for each setter and getter, that
+     * dominate the cost of processing short messages individually.
+     * <p>
+     * Each input, read from the position of {@code in}, is a 4-byte
+     * little-endian length followed by that many bytes of UTF-8 data and a
+     * terminating NUL byte, which allows the data to be passed to the native
+     * library in place. For each input processed a record is written from the
+     * position of {@code out}:
+     * <pre>
+     * int32 status   1 if the input was accepted; 0 if it was rejected
+     * int32 length   the number of bytes of data that follow
+     * byte[] data    the requested output if accepted; otherwise the error message
+     * </pre>
+     * with both integers little-endian. The positions of both buffers are
+     * advanced past the inputs consumed and the records written, so that the
+     * call can be repeated with the remaining inputs when the output buffer
+     * fills. A call that cannot process any input, because the next input is
+     * malformed or its record does not fit in the remaining output, throws
+     * rather than returning 0, so such a loop always progresses.
+     * <p>
+     * The instance is left holding the last input that was processed, and its
+     * options (such as {@link #setPermitUnknownAIs(boolean)}) apply to every
+     * input.
+     *
+     * @param input the format of the inputs
+     * @param output the output to record for each accepted input
+     * @param in a direct buffer holding the inputs
+     * @param num the number of inputs to process
+     * @param out a direct buffer receiving the records
+     * @return the number of inputs processed, which is less than {@code num} if the output buffer filled or the
+     *         next input is malformed
+     * @throws GS1EncoderParameterException if a buffer is not direct, the output is read-only, the next input
+     *         is truncated or not NUL-terminated, or the output buffer has no space for the next record
+     * @throws GS1EncoderGeneralException if the JVM does not support access to direct buffers
+     */
+    public int processBatch(BatchInput input, BatchOutput output, ByteBuffer in, int num, ByteBuffer out) throws GS1EncoderParameterException, GS1EncoderGeneralException {
+        if (!in.isDirect() || !out.isDirect())
+            throw new GS1EncoderParameterException("Batch buffers must be direct");
+        if (out.isReadOnly())
+            throw new GS1EncoderParameterException("Batch output buffer is read-only");
+        int[] pos = { in.position(), in.limit(), out.position(), out.limit() };
+        int done = gs1encoderProcessBatchJNI(ctx(), input.getValue(), output.getValue(), in, num, out, pos);
+        if (done == BATCH_ERR_MALFORMED)
+            throw new GS1EncoderParameterException("Batch input is truncated or not NUL-terminated");
+        if (done == BATCH_ERR_NO_SPACE)
+            throw new GS1EncoderParameterException("Batch output buffer has no space for the next record");
+        if (done < 0)
+            throw new GS1EncoderGeneralException("Direct buffer access is not supported by the JVM");
+        in.position(pos[0]);
+        out.position(pos[2]);
+        return done;
+    }
+
     /**
      * Loads the native JNI library that backs the enclosing {@link GS1Encoder}.
      *
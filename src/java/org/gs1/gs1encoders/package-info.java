@@ -429,6 +429,38 @@
  * represented by GS characters (ASCII 29). If this is not the case then the
  * scanned data should be pre-processed to meet this requirement.
  *
+ *
+ * <h3>Bulk processing</h3>
+ *
+ * In this example we convert many AI element strings to GS1 Digital Link URIs
+ * with a single native call, exchanging the data through direct
+ * {@code ByteBuffer}s rather than a {@code String} for each input and output.
+ *
+ * <pre>
+ * ByteBuffer in = ByteBuffer.allocateDirect(65536).order(ByteOrder.LITTLE_ENDIAN);
+ * for (String ai : aiDataStrs) {
+ *     byte[] bytes = ai.getBytes(StandardCharsets.UTF_8);
+ *     in.putInt(bytes.length).put(bytes).put((byte) 0);        // Length-prefixed, NUL-terminated inputs
+ * }
+ * in.flip();
+ *
+ * ByteBuffer out = ByteBuffer.allocateDirect(65536).order(ByteOrder.LITTLE_ENDIAN);
+ * int done = gs.processBatch(BatchInput.AIdataStr, BatchOutput.DLuri, in, aiDataStrs.length, out);
+ * out.flip();
+ *
+ * for (int i = 0; i < done; i++) {
+ *     boolean ok = out.getInt() == 1;                          // Record status
+ *     byte[] data = new byte[out.getInt()];                    // DL URI, or the error message
+ *     out.get(data);
+ * }
+ * </pre>
+ *
+ * <p>
+ * If fewer inputs are processed than were requested then the output buffer is
+ * full; the position of the input buffer is left at the next input to process.
+ * An exception is thrown if not even the next input can be processed, e.g.
+ * when its record is larger than the whole of the output buffer.
+ *
  * @author GS1 AISBL
  *
  */
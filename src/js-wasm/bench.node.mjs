@@ -0,0 +1,127 @@
+/*
+ *  Node.js benchmark comparing the builds of the GS1 Barcode Syntax Engine
+ *  that are available to the JavaScript wrapper.
+ *
+ *  Requirements:
+ *
+ *    - WASM build of the Syntax Engine in the current directory ("make wasm")
+ *
+ *    - Optionally, the SIMD build in the current directory ("make wasm-simd")
+ *
+ *  Usage:
+ *
+ *    node bench.node.mjs [--seconds=N]
+ *
+ *  Each case runs over a small bundled corpus of representative messages,
+ *  mirroring the C library benchmark ("make bench"), and reports ns/op for
+ *  each build along with the speedup of the SIMD build over the scalar build.
+ *
+ *
+ *  Copyright (c) 2022-2026 GS1 AISBL.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+"use strict";
+
+import { GS1encoder, BatchInput, BatchOutput } from "./gs1encoder.mjs";
+
+
+const secondsArg = process.argv.find(arg => arg.startsWith("--seconds="));
+const SECONDS = secondsArg ? Number(secondsArg.substring(10)) : 0.5;
+
+
+const corpusAIdata = [
+    "(01)09521234543213(10)ABC123(99)TEST",
+    "(01)09521234543213(17)251231(10)BATCH42(21)SERIAL0001",
+    "(01)09521234543213(3103)000189(15)260101(10)LOT-7",
+    "(01)09521234543213(11)250101(17)271231(10)ABCDEFGHIJKLMNOPQRST(21)12345678901234567890",
+    "(00)095212345678901235(02)09521234543213(37)24",
+    "(414)9521234543213(254)A1B2",
+    "(8004)952123456789012345",
+];
+
+
+/*
+ *  Derive the other corpora from the AI data so that each case processes the
+ *  same messages.
+ *
+ */
+async function deriveCorpora() {
+    const gs = await GS1encoder.create({ wasmVariant: "scalar" });
+    const corpusDLuri = [], corpusScanData = [];
+    gs.sym = GS1encoder.symbology.DM;
+    for (const ai of corpusAIdata) {
+        gs.aiDataStr = ai;
+        corpusDLuri.push(gs.getDLuri(null));
+        corpusScanData.push(gs.scanData);
+    }
+    gs.free();
+    return { corpusDLuri, corpusScanData };
+}
+
+
+const { corpusDLuri, corpusScanData } = await deriveCorpora();
+
+const batchAIdata = Array.from({ length: 1000 }, (_, i) => corpusAIdata[i % corpusAIdata.length]);
+
+const cases = [
+    { name: "aiDataStr (set)",          ops: 1,    run: (gs, i) => { gs.aiDataStr = corpusAIdata[i % corpusAIdata.length]; } },
+    { name: "dataStr (set, DL URI)",    ops: 1,    run: (gs, i) => { gs.dataStr = corpusDLuri[i % corpusDLuri.length]; } },
+    { name: "scanData (set)",           ops: 1,    run: (gs, i) => { gs.scanData = corpusScanData[i % corpusScanData.length]; } },
+    { name: "aiDataStr + getDLuri",     ops: 1,    run: (gs, i) => { gs.aiDataStr = corpusAIdata[i % corpusAIdata.length]; gs.getDLuri(null); } },
+    { name: "aiDataStr + hri",          ops: 1,    run: (gs, i) => { gs.aiDataStr = corpusAIdata[i % corpusAIdata.length]; gs.hri; } },
+    { name: "processBatch (DL URI)",    ops: batchAIdata.length,
+      run: gs => { gs.processBatch(batchAIdata, BatchInput.AIdataStr, BatchOutput.DLuri); } },
+];
+
+
+function time(gs, c) {
+    for (let i = 0; i < 1000 / c.ops; i++)      // Warm up
+        c.run(gs, i);
+    let iters = 0;
+    const deadline = process.hrtime.bigint() + BigInt(Math.round(SECONDS * 1e9));
+    const start = process.hrtime.bigint();
+    let now;
+    do {
+        for (let i = 0; i < 100; i++)
+            c.run(gs, iters + i);
+        iters += 100;
+        now = process.hrtime.bigint();
+    } while (now < deadline);
+    return Number(now - start) / (iters * c.ops);
+}
+
+
+const variants = [];
+for (const wasmVariant of ["scalar", "simd"]) {
+    try {
+        variants.push(await GS1encoder.create({ wasmVariant }));
+    } catch (e) {
+        console.log(`Skipping the ${wasmVariant} build: ${e.message}`);
+    }
+}
+
+console.log(`${"case".padEnd(28)}${variants.map(gs => (gs.wasmVariant + " ns/op").padStart(16)).join("")}` +
+            (variants.length > 1 ? "speedup".padStart(10) : ""));
+
+for (const c of cases) {
+    const results = variants.map(gs => time(gs, c));
+    console.log(`${c.name.padEnd(28)}${results.map(ns => ns.toFixed(1).padStart(16)).join("")}` +
+                (results.length > 1 ? (results[0] / results[1]).toFixed(2).padStart(9) + "x" : ""));
+}
+
+for (const gs of variants)
+    gs.free();
@@ -0,0 +1,153 @@
+/*
+ *  Request processing for the Node.js example web service that uses the WASM
+ *  or JS-only build of the GS1 Barcode Syntax Engine.
+ *
+ *  This module is used in two ways by example-web-service.node.mjs:
+ *
+ *    - Imported on the main thread, when the service runs without a worker
+ *      pool, for its processJob() function.
+ *
+ *    - Loaded as the script of each worker thread in the pool, each of which
+ *      initialises its own GS1encoder instance (with its own WASM instance)
+ *      and processes the jobs that are posted to it.
+ *
+ *  Copyright (c) 2022-2026 GS1 AISBL.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *
+ *  Jobs:
+ *
+ *    A job is an object of the form:
+ *
+ *      {
+ *        options: { includeDataTitlesInHRI, permitUnknownAIs,
+ *                   permitZeroSuppressedGTINinDLuris, noValidateRequisiteAIs },
+ *        items:   [ { type: "dataStr" | "aiDataStr" | "scanData", input }, ... ]
+ *      }
+ *
+ *    The options apply to every item. The result of a job is an array with a
+ *    result for each item, either:
+ *
+ *      { dataStr, aiDataStr, dlURI, hri [, dlURIerror] }
+ *
+ *    or, if the input was rejected:
+ *
+ *      { error [, markup] }
+ *
+ */
+
+"use strict";
+
+
+/*
+ *  To run this example with an instance of gs1encoder that you have installed
+ *  from npm change the following import to:
+ *
+ *    import { GS1encoder } from "gs1encoder";
+ *
+ */
+import { GS1encoder } from "./gs1encoder.mjs";
+import { isMainThread, parentPort, workerData } from 'worker_threads';
+
+
+export const itemTypes = ['dataStr', 'aiDataStr', 'scanData'];
+
+
+function applyOptions(gs1encoder, options) {
+    gs1encoder.includeDataTitlesInHRI = !!options.includeDataTitlesInHRI;
+    gs1encoder.permitUnknownAIs = !!options.permitUnknownAIs;
+    gs1encoder.permitZeroSuppressedGTINinDLuris = !!options.permitZeroSuppressedGTINinDLuris;
+    gs1encoder.setValidationEnabled(GS1encoder.validation.RequisiteAIs, !options.noValidateRequisiteAIs);
+}
+
+
+function processItem(gs1encoder, item) {
+
+    try {
+        switch (item.type) {
+            case 'dataStr':
+                gs1encoder.dataStr = item.input;
+                break;
+            case 'aiDataStr':
+                gs1encoder.aiDataStr = item.input;
+                break;
+            case 'scanData':
+                gs1encoder.scanData = item.input;
+                break;
+            default:
+                return { error: `Unknown type: ${item.type}` };
+        }
+    } catch (err) {
+        const markup = gs1encoder.errMarkup;
+        return markup ? { error: err.message, markup } : { error: err.message };
+    }
+
+    const result = {
+        dataStr: gs1encoder.dataStr,
+        aiDataStr: gs1encoder.aiDataStr,
+        dlURI: null,
+        hri: null,
+    };
+    try {
+        result.dlURI = gs1encoder.getDLuri(null);
+    } catch (err) {
+        result.dlURIerror = err.message;
+    }
+    result.hri = gs1encoder.hri;
+
+    return result;
+
+}
+
+
+/**
+ * Process a job with the given GS1encoder instance, returning a result for
+ * each item.
+ */
+export function processJob(gs1encoder, job) {
+    applyOptions(gs1encoder, job.options);
+    return job.items.map(item => processItem(gs1encoder, item));
+}
+
+
+/*
+ *  Worker thread: initialise an instance, report readiness, then process the
+ *  jobs posted by the pool, one at a time.
+ *
+ */
+if (!isMainThread && workerData && workerData.gs1encoderWorker) {
+
+    let gs1encoder;
+    try {
+        gs1encoder = await GS1encoder.create(workerData.initOptions);
+    } catch (err) {
+        parentPort.postMessage({ ready: false, error: err.message });
+        process.exit(1);
+    }
+
+    parentPort.on('message', job => {
+        const start = process.hrtime.bigint();
+        const results = processJob(gs1encoder, job);
+        const processingNs = Number(process.hrtime.bigint() - start);
+        parentPort.postMessage({ id: job.id, results, processingNs });
+    });
+
+    parentPort.postMessage({
+        ready: true,
+        wasmVariant: gs1encoder.wasmVariant,
+        initFallbackWarning: gs1encoder.initFallbackWarning,
+    });
+
+}
@@ -31,6 +31,15 @@
  *    /logfile=<filename>       Write logs to file instead of stdout.
  *    /bind=<address>           Bind address (default: 127.0.0.1). Use 0.0.0.0 for all interfaces.
  *    /port=<number>            Port number (default: 3030).
+ *    /workers=<number>         Process requests on a pool of this many worker
+ *                              threads, each with its own WASM instance
+ *                              (default: 0, process on the main thread).
+ *    /queue=<number>           Maximum number of jobs waiting for a worker,
+ *                              beyond which requests are refused with
+ *                              "503 Service Unavailable" (default: 1024).
+ *    /keepalive=<seconds>      Time that an idle keep-alive connection is held
+ *                              open (default: 5).
+ *    /maxbatch=<number>        Maximum number of lines in a batch (default: 10000).
  *
  *    /(un)installservice       Attempt to install/uninstall this example as a
  *                              Windows service. Any other arguments (e.g.
@@ -44,6 +53,7 @@
  *    $ node example-web-service.node.mjs /verbose
  *    $ node example-web-service.node.mjs /verbose /logfile=service.log
  *    $ node example-web-service.node.mjs /bind=0.0.0.0 /port=8080
+ *    $ node example-web-service.node.mjs /workers=4 /keepalive=65
  *
  *  Output format:
  *
@@ -63,9 +73,24 @@
  *
  *  Endpoints:
  *
- *    /dataStr      Process input as a barcode message or Digital Link URI.
- *    /aiDataStr    Process input as an AI element string.
- *    /scanData     Process input as raw scan data.
+ *    GET /dataStr      Process input as a barcode message or Digital Link URI.
+ *    GET /aiDataStr    Process input as an AI element string.
+ *    GET /scanData     Process input as raw scan data.
+ *
+ *    POST /batch       Process a batch of inputs given as NDJSON, one JSON
+ *                      object per line of the form:
+ *
+ *                        {"type": "aiDataStr", "input": "(01)12312312312319"}
+ *
+ *                      where "type" is one of "dataStr" (the default),
+ *                      "aiDataStr" or "scanData". The query parameters that
+ *                      set options apply to every line. The response is NDJSON
+ *                      with a line for each input, in order, holding either the
+ *                      JSON output or an "error" (and possibly "markup").
+ *
+ *    GET /metrics      Throughput and latency metrics for each worker, as JSON.
+ *                      Only available to clients connecting from the loopback
+ *                      interface.
  *
  *  Example calls:
  *
@@ -106,6 +131,11 @@
  *           (10) ABC123
  *           (21) SERIAL456
  *
+ *    $ printf '%s\n' '{"type":"aiDataStr","input":"(01)12312312312319"}' '{"input":"^0112312312312318"}' |
+ *        curl -s --data-binary @- 'http://127.0.0.1:3030/batch'
+ *    {"dataStr":"^0112312312312319","aiDataStr":"(01)12312312312319","dlURI":"https://id.gs1.org/01/12312312312319","hri":["(01) 12312312312319"]}
+ *    {"error":"AI (01): The numeric check digit is incorrect.","markup":"(01)1231231231231|8|"}
+ *
  */
 
 "use strict";
@@ -117,6 +147,12 @@
  */
 let bind = '127.0.0.1';  // "0.0.0.0" to allow remote connections
 let port = 3030;
+let numWorkers = 0;      // 0 to process requests on the main thread
+let maxQueue = 1024;     // Jobs waiting for a worker before requests are refused
+let keepAliveSeconds = 5;
+let maxBatch = 10000;    // Lines in a batch
+const maxBodyBytes = 16 * 1024 * 1024;
+const batchChunk = 256;  // Lines of a batch per job, so that a batch is spread over the workers
 
 
 /*
@@ -148,9 +184,26 @@ for (const arg of argv) {
             process.exit(1);
         }
         port = portNum;
+    } else if (arg.startsWith('/workers=')) {
+        numWorkers = parseIntArg(arg.substring(9), 0, 'number of workers');
+    } else if (arg.startsWith('/queue=')) {
+        maxQueue = parseIntArg(arg.substring(7), 1, 'queue size');
+    } else if (arg.startsWith('/keepalive=')) {
+        keepAliveSeconds = parseIntArg(arg.substring(11), 0, 'keep-alive timeout');
+    } else if (arg.startsWith('/maxbatch=')) {
+        maxBatch = parseIntArg(arg.substring(10), 1, 'batch size');
     }
 }
 
+function parseIntArg(value, min, what) {
+    const num = parseInt(value, 10);
+    if (isNaN(num) || num < min) {
+        console.error(`Error: Invalid ${what}. Must be at least ${min}.`);
+        process.exit(1);
+    }
+    return num;
+}
+
 // Setup logging
 import { createWriteStream } from 'fs';
 
@@ -234,22 +287,19 @@ function sendErrorResponse(res, statusCode, statusText, message, acceptHeader, r
     logRequestComplete(requestStartTime);
 }
 
-function buildJsonResponse(dataStr, aiDataStr, dlURI, dlURIerr, hri) {
-    const response = { dataStr, aiDataStr, dlURI, hri };
-    if (dlURIerr) {
-        response.dlURIerror = dlURIerr.message;
-    }
+function buildJsonResponse(result) {
     return {
         contentType: 'application/json',
-        body: JSON.stringify(response) + "\n"
+        body: JSON.stringify(result) + "\n"
     };
 }
 
-function buildPlaintextResponse(dataStr, aiDataStr, dlURI, dlURIerr, hri) {
+function buildPlaintextResponse(result) {
+    const { dataStr, aiDataStr, dlURI, dlURIerror, hri } = result;
     const plaintextLines = [];
     plaintextLines.push("Barcode message:      " + dataStr);
     plaintextLines.push("AI element string:    " + (aiDataStr ?? "⧚ Not AI-based data ⧚"));
-    plaintextLines.push("GS1 Digital Link URI: " + (dlURI ?? "⧚ " + dlURIerr.message + " ⧚"));
+    plaintextLines.push("GS1 Digital Link URI: " + (dlURI ?? "⧚ " + dlURIerror + " ⧚"));
     plaintextLines.push("HRI:                  " + (dataStr !== "" && hri.length === 0 ? "⧚ Not AI-based data ⧚": ""));
     hri.forEach(ai => plaintextLines.push("       " + ai));
     return {
@@ -268,6 +318,77 @@ function sendSuccessResponse(res, response, requestStartTime) {
 }
 
 
+/*
+ *  ------ Metrics -------
+ *
+ *  Counts and recent latencies for each worker (or for the main thread when
+ *  there is no pool). Latency runs from when a job is queued until its result
+ *  is received, so includes any wait for a worker; processing time is that
+ *  spent by the worker on the job.
+ *
+ */
+const METRICS_SAMPLES = 1024;
+const startTime = process.hrtime.bigint();
+
+class WorkerMetrics {
+
+    constructor(name) {
+        this.name = name;
+        this.jobs = 0;
+        this.items = 0;
+        this.rejectedItems = 0;
+        this.restarts = 0;
+        this.processingNs = 0;
+        this.samples = 0;
+        this.latency = new Float64Array(METRICS_SAMPLES);
+        this.processing = new Float64Array(METRICS_SAMPLES);
+    }
+
+    record(results, processingNs, latencyNs) {
+        const slot = this.samples++ % METRICS_SAMPLES;
+        this.jobs++;
+        this.items += results.length;
+        this.rejectedItems += results.reduce((n, result) => n + ('error' in result ? 1 : 0), 0);
+        this.processingNs += processingNs;
+        this.latency[slot] = latencyNs;
+        this.processing[slot] = processingNs;
+    }
+
+    snapshot(uptimeNs) {
+        return {
+            name: this.name,
+            jobs: this.jobs,
+            items: this.items,
+            rejectedItems: this.rejectedItems,
+            restarts: this.restarts,
+            itemsPerSecond: round(this.items / (uptimeNs / 1e9)),
+            utilisation: round(this.processingNs / uptimeNs),
+            latencyMs: summarise(this.latency, this.samples),
+            processingMs: summarise(this.processing, this.samples),
+        };
+    }
+
+}
+
+function round(value) {
+    return Math.round(value * 1000) / 1000;
+}
+
+function summarise(ring, samples) {
+    const n = Math.min(samples, ring.length);
+    if (n === 0)
+        return null;
+    const sorted = Array.from(ring.subarray(0, n)).sort((x, y) => x - y);
+    const ms = ns => round(ns / 1e6);
+    return {
+        mean: ms(sorted.reduce((sum, v) => sum + v, 0) / n),
+        p50: ms(sorted[Math.floor(0.50 * (n - 1))]),
+        p99: ms(sorted[Math.floor(0.99 * (n - 1))]),
+        max: ms(sorted[n - 1]),
+    };
+}
+
+
 /*
  *  ------ Main processing -------
  *
@@ -278,132 +399,380 @@ function sendSuccessResponse(res, response, requestStartTime) {
  *
  */
 import { GS1encoder } from "./gs1encoder.mjs";
+import { processJob, itemTypes } from "./example-web-service-worker.node.mjs";
+import { Worker } from 'worker_threads';
 
 // Load the GS1 Syntax Dictionary from local storage (here, the current
 // directory), falling back to the AI table embedded in the library if the file
 // is absent or malformed. Replacing the file with a newer revision of the
 // Syntax Dictionary lets the application adopt it without rebuilding.
-const gs1encoder = await GS1encoder.create({
+const initOptions = {
     syntaxDictionary: "gs1-syntax-dictionary.txt",
     fallbackOnSyndictError: true,
-});
+};
 
-if (gs1encoder.initFallbackWarning)
-    console.error("Warning: %s", gs1encoder.initFallbackWarning);
 
-import * as http from 'http';
+class QueueFullError extends Error {}
 
 
-http.createServer(function(req, res) {
+/*
+ *  Processes jobs on the main thread using a single instance.
+ *
+ */
+class InlineExecutor {
 
-    const requestStartTime = process.hrtime.bigint();
-    lastLogTime = null;
-    requestCounter++;
-    log(`Request #${requestCounter}: ${req.method} ${req.url}`);
+    async start() {
+        this.gs1encoder = await GS1encoder.create(initOptions);
+        this.metrics = [ new WorkerMetrics('main') ];
+        return this.gs1encoder.initFallbackWarning;
+    }
 
-    const urlObj = new URL(req.url, `http://${req.headers.host}`);
+    canAccept() {
+        return true;
+    }
 
-    const pathname = urlObj.pathname;
-    log(`  Pathname: ${pathname}`);
+    submit(job) {
+        const start = process.hrtime.bigint();
+        const results = processJob(this.gs1encoder, job);
+        const elapsedNs = Number(process.hrtime.bigint() - start);
+        this.metrics[0].record(results, elapsedNs, elapsedNs);
+        return Promise.resolve(results);
+    }
 
-    const params = Object.fromEntries(urlObj.searchParams);
-    log(`  Query params: ${JSON.stringify(params)}`);
+    queueLength() {
+        return 0;
+    }
 
-    if (req.method !== 'GET') {
-        sendErrorResponse(res, 405, 'Method Not Allowed', 'Method Not Allowed', req.headers['accept'], requestStartTime);
-        return;
+}
+
+
+/*
+ *  Processes jobs on a pool of worker threads, each with its own instance.
+ *  Jobs wait in a bounded FIFO queue for the next idle worker. A worker that
+ *  fails is replaced, failing only the job that it was processing.
+ *
+ */
+class WorkerPool {
+
+    constructor(size, maxQueue) {
+        this.size = size;
+        this.maxQueue = maxQueue;
+        this.queue = [];
+        this.idle = [];
+        this.slots = [];
+        this.metrics = Array.from({ length: size }, (_, i) => new WorkerMetrics(`worker-${i}`));
+        this.nextId = 0;
+        this.refused = 0;
+    }
+
+    async start() {
+        const ready = [];
+        for (let i = 0; i < this.size; i++)
+            ready.push(this.spawn(i));
+        const warnings = await Promise.all(ready);
+        return warnings.find(warning => warning) ?? null;
+    }
+
+    spawn(index) {
+        const worker = new Worker(new URL('./example-web-service-worker.node.mjs', import.meta.url), {
+            workerData: { gs1encoderWorker: true, initOptions },
+        });
+        const slot = { index, worker, entry: null, ready: false, failed: false };
+        this.slots[index] = slot;
+        return new Promise((resolve, reject) => {
+            worker.on('message', msg => {
+                if (!slot.ready) {
+                    if (!msg.ready) {
+                        reject(new Error(msg.error));
+                        return;
+                    }
+                    slot.ready = true;
+                    log(`Worker ${index} ready (${msg.wasmVariant})`);
+                    this.release(slot);
+                    resolve(msg.initFallbackWarning);
+                    return;
+                }
+                this.complete(slot, msg);
+            });
+            worker.on('error', err => this.fail(slot, err, reject));
+            worker.on('exit', code => this.fail(slot, new Error(`Worker exited with code ${code}`), reject));
+        });
+    }
+
+    fail(slot, err, reject) {
+        if (slot.failed)
+            return;
+        slot.failed = true;
+        this.idle = this.idle.filter(s => s !== slot);
+        if (!slot.ready) {
+            reject(err);
+            return;
+        }
+        console.error(`Worker ${slot.index} failed: ${err.message}`);
+        if (slot.entry)
+            slot.entry.reject(err);
+        this.metrics[slot.index].restarts++;
+        this.spawn(slot.index).catch(e => console.error(`Worker ${slot.index} restart failed: ${e.message}`));
+    }
+
+    // Jobs taken straight away by idle workers do not count against the limit
+    canAccept(jobs) {
+        return this.queue.length + jobs <= this.maxQueue + this.idle.length;
+    }
+
+    submit(job) {
+        if (!this.canAccept(1)) {
+            this.refused++;
+            return Promise.reject(new QueueFullError('Queue is full'));
+        }
+        return new Promise((resolve, reject) => {
+            this.queue.push({ job, resolve, reject, queued: process.hrtime.bigint() });
+            this.dispatch();
+        });
+    }
+
+    complete(slot, msg) {
+        const entry = slot.entry;
+        slot.entry = null;
+        const latencyNs = Number(process.hrtime.bigint() - entry.queued);
+        this.metrics[slot.index].record(msg.results, msg.processingNs, latencyNs);
+        entry.resolve(msg.results);
+        this.release(slot);
+    }
+
+    release(slot) {
+        this.idle.push(slot);
+        this.dispatch();
+    }
+
+    dispatch() {
+        while (this.idle.length > 0 && this.queue.length > 0) {
+            const slot = this.idle.pop();
+            const entry = this.queue.shift();
+            slot.entry = entry;
+            slot.worker.postMessage({ id: this.nextId++, ...entry.job });
+        }
+    }
+
+    queueLength() {
+        return this.queue.length;
     }
 
+}
+
+
+const executor = numWorkers > 0 ? new WorkerPool(numWorkers, maxQueue) : new InlineExecutor();
+let refusedRequests = 0;
+
+const initFallbackWarning = await executor.start();
+if (initFallbackWarning)
+    console.error("Warning: %s", initFallbackWarning);
+
+
+function requestOptions(params) {
+    const options = {
+        includeDataTitlesInHRI: "includeDataTitlesInHRI" in params,
+        permitUnknownAIs: "permitUnknownAIs" in params,
+        permitZeroSuppressedGTINinDLuris: "permitZeroSuppressedGTINinDLuris" in params,
+        noValidateRequisiteAIs: "noValidateRequisiteAIs" in params,
+    };
+    log(`  Options: ${JSON.stringify(options)}`);
+    return options;
+}
+
+function sendServiceUnavailable(res, acceptHeader, requestStartTime) {
+    refusedRequests++;
+    res.setHeader('Retry-After', '1');
+    sendErrorResponse(res, 503, 'Service Unavailable', 'Service Unavailable: too many requests are queued', acceptHeader, requestStartTime);
+}
+
+function isLoopback(address) {
+    return address === '127.0.0.1' || address === '::1' || address === '::ffff:127.0.0.1';
+}
+
+
+async function handleProcess(req, res, params, type, requestStartTime) {
+
+    const acceptHeader = req.headers['accept'];
+
     const inpStr = params.input;
     if (!inpStr) {
-        sendErrorResponse(res, 400, 'Bad Request', "Bad Request: 'input' query parameter must be defined", req.headers['accept'], requestStartTime);
+        sendErrorResponse(res, 400, 'Bad Request', "Bad Request: 'input' query parameter must be defined", acceptHeader, requestStartTime);
         return;
     }
 
-    try {
+    if (!executor.canAccept(1)) {
+        sendServiceUnavailable(res, acceptHeader, requestStartTime);
+        return;
+    }
+
+    log(`  Processing ${type}: "${inpStr}"`);
+    const [ result ] = await executor.submit({ options: requestOptions(params), items: [ { type, input: inpStr } ] });
+
+    if ('error' in result) {
+        log(`  GS1encoder error: ${result.error}`);
+        sendErrorResponse(res, 422, 'Unprocessable Entity', result.error, acceptHeader, requestStartTime, result.markup);
+        return;
+    }
+
+    log(`  GS1encoder results: ${JSON.stringify(result)}`);
+
+    // Determine output format from query parameter or Accept header
+    const wantsJson = params.output === 'json' || (acceptHeader || '').includes('application/json');
+
+    const response = wantsJson ? buildJsonResponse(result) : buildPlaintextResponse(result);
+
+    sendSuccessResponse(res, response, requestStartTime);
+
+}
+
+
+async function readBody(req) {
+    const chunks = [];
+    let length = 0;
+    for await (const chunk of req) {
+        length += chunk.length;
+        if (length > maxBodyBytes)
+            return null;
+        chunks.push(chunk);
+    }
+    return Buffer.concat(chunks).toString('utf8');
+}
+
+
+async function handleBatch(req, res, params, requestStartTime) {
+
+    const acceptHeader = req.headers['accept'];
+
+    const body = await readBody(req);
+    if (body === null) {
+        sendErrorResponse(res, 413, 'Payload Too Large', `Payload Too Large: limit is ${maxBodyBytes} bytes`, acceptHeader, requestStartTime);
+        return;
+    }
+
+    const lines = body.split('\n').filter(line => line.trim() !== '');
+    if (lines.length > maxBatch) {
+        sendErrorResponse(res, 413, 'Payload Too Large', `Payload Too Large: limit is ${maxBatch} lines`, acceptHeader, requestStartTime);
+        return;
+    }
 
-        /*
-         *  Example of setting options
-         *
-         */
-        log(`  Setting GS1encoder options:`);
-
-        gs1encoder.includeDataTitlesInHRI = "includeDataTitlesInHRI" in params;
-        log(`    includeDataTitlesInHRI: ${gs1encoder.includeDataTitlesInHRI}`);
-
-        gs1encoder.permitUnknownAIs = "permitUnknownAIs" in params;
-        log(`    permitUnknownAIs: ${gs1encoder.permitUnknownAIs}`);
-
-        gs1encoder.permitZeroSuppressedGTINinDLuris = "permitZeroSuppressedGTINinDLuris" in params;
-        log(`    permitZeroSuppressedGTINinDLuris: ${gs1encoder.permitZeroSuppressedGTINinDLuris}`);
-
-        gs1encoder.setValidationEnabled(GS1encoder.validation.RequisiteAIs, !("noValidateRequisiteAIs" in params));
-        log(`    validateRequisiteAIs: ${gs1encoder.getValidationEnabled(GS1encoder.validation.RequisiteAIs)}`);
-
-        /*
-         *  Set the data
-         *
-         */
-        switch (pathname) {
-            case '/dataStr':
-                log(`  Calling gs1encoder.dataStr = "${inpStr}"`);
-                gs1encoder.dataStr = inpStr;
-                break;
-            case '/aiDataStr':
-                log(`  Calling gs1encoder.aiDataStr = "${inpStr}"`);
-                gs1encoder.aiDataStr = inpStr;
-                break;
-            case '/scanData':
-                log(`  Calling gs1encoder.scanData = "${inpStr}"`);
-                gs1encoder.scanData = inpStr;
-                break;
-            default:
-                sendErrorResponse(res, 404, 'Not Found', 'Not Found', req.headers['accept'], requestStartTime);
-                return;
+    // Lines that cannot be processed are answered directly
+    const results = new Array(lines.length);
+    const items = [], positions = [];
+    lines.forEach((line, i) => {
+        let item;
+        try {
+            item = JSON.parse(line);
+        } catch (err) {
+            results[i] = { error: `Invalid JSON: ${err.message}` };
+            return;
+        }
+        const type = item.type ?? 'dataStr';
+        if (typeof item.input !== 'string' || item.input === '')
+            results[i] = { error: "'input' must be a non-empty string" };
+        else if (!itemTypes.includes(type))
+            results[i] = { error: `Unknown type: ${type}` };
+        else {
+            items.push({ type, input: item.input });
+            positions.push(i);
         }
+    });
 
-    } catch (err) {
-        log(`  GS1encoder error: ${err.message}`);
-        const markup = gs1encoder.errMarkup;
-        sendErrorResponse(res, 422, 'Unprocessable Entity', err.message, req.headers['accept'], requestStartTime, markup);
+    const numJobs = Math.ceil(items.length / batchChunk);
+    if (!executor.canAccept(numJobs)) {
+        sendServiceUnavailable(res, acceptHeader, requestStartTime);
         return;
     }
 
-    log(`  GS1encoder results:`);
+    log(`  Batch of ${lines.length} lines as ${numJobs} jobs`);
+    const options = requestOptions(params);
+    const jobs = [];
+    for (let i = 0; i < items.length; i += batchChunk)
+        jobs.push(executor.submit({ options, items: items.slice(i, i + batchChunk) }));
+    (await Promise.all(jobs)).flat().forEach((result, i) => { results[positions[i]] = result; });
 
-    const dataStr = gs1encoder.dataStr;
-    log(`    dataStr: ${dataStr}`);
+    sendSuccessResponse(res, {
+        contentType: 'application/x-ndjson',
+        body: results.map(result => JSON.stringify(result) + "\n").join(''),
+    }, requestStartTime);
 
-    const aiDataStr = gs1encoder.aiDataStr;
-    log(`    aiDataStr: ${aiDataStr ?? "(null)"}`);
+}
 
-    let dlURI;
-    let dlURIerr;
-    try {
-        dlURI = gs1encoder.getDLuri(null);
-    } catch (err) {
-        dlURI = null;
-        dlURIerr = err;
-        log(`  getDLuri error: ${err.message}`);
+
+async function handleMetrics(res, requestStartTime) {
+    const uptimeNs = Number(process.hrtime.bigint() - startTime);
+    sendSuccessResponse(res, buildJsonResponse({
+        uptimeSeconds: round(uptimeNs / 1e9),
+        workers: executor.metrics.map(metrics => metrics.snapshot(uptimeNs)),
+        queue: { length: executor.queueLength(), max: numWorkers > 0 ? maxQueue : null },
+        refusedRequests,
+    }), requestStartTime);
+}
+
+
+import * as http from 'http';
+
+
+const server = http.createServer({ keepAlive: true, noDelay: true }, function(req, res) {
+
+    const requestStartTime = process.hrtime.bigint();
+    lastLogTime = null;
+    requestCounter++;
+    log(`Request #${requestCounter}: ${req.method} ${req.url}`);
+
+    const urlObj = new URL(req.url, `http://${req.headers.host}`);
+
+    const pathname = urlObj.pathname;
+    log(`  Pathname: ${pathname}`);
+
+    const params = Object.fromEntries(urlObj.searchParams);
+    log(`  Query params: ${JSON.stringify(params)}`);
+
+    const type = pathname.substring(1);
+    let handler;
+    let method = 'GET';
+    if (itemTypes.includes(type)) {
+        handler = () => handleProcess(req, res, params, type, requestStartTime);
+    } else if (pathname === '/batch') {
+        method = 'POST';
+        handler = () => handleBatch(req, res, params, requestStartTime);
+    } else if (pathname === '/metrics' && isLoopback(req.socket.remoteAddress)) {
+        handler = () => handleMetrics(res, requestStartTime);
+    } else {
+        sendErrorResponse(res, 404, 'Not Found', 'Not Found', req.headers['accept'], requestStartTime);
+        return;
     }
-    log(`    dlURI: ${dlURI ?? "(error)"}`);
 
-    const hri = gs1encoder.hri;
-    log(`    hri: ${JSON.stringify(hri)}`);
+    if (req.method !== method) {
+        res.setHeader('Allow', method);
+        sendErrorResponse(res, 405, 'Method Not Allowed', 'Method Not Allowed', req.headers['accept'], requestStartTime);
+        return;
+    }
 
-    // Determine output format from query parameter or Accept header
-    const acceptHeader = req.headers['accept'] || '';
-    const wantsJson = params.output === 'json' || acceptHeader.includes('application/json');
+    handler().catch(err => {
+        console.error(`Request #${requestCounter} failed: ${err.message}`);
+        if (err instanceof QueueFullError)
+            sendServiceUnavailable(res, req.headers['accept'], requestStartTime);
+        else if (!res.headersSent)
+            sendErrorResponse(res, 500, 'Internal Server Error', 'Internal Server Error', req.headers['accept'], requestStartTime);
+        else
+            res.destroy();
+    });
 
-    const response = wantsJson
-        ? buildJsonResponse(dataStr, aiDataStr, dlURI, dlURIerr, hri)
-        : buildPlaintextResponse(dataStr, aiDataStr, dlURI, dlURIerr, hri);
+});
 
-    sendSuccessResponse(res, response, requestStartTime);
+// Idle keep-alive connections are held for the configured time. The headers
+// timeout must exceed it, so that a request arriving on a connection that is
+// about to be closed is not cut off.
+server.keepAliveTimeout = keepAliveSeconds * 1000;
+server.headersTimeout = server.keepAliveTimeout + 1000;
 
-}).listen(port, bind);
+server.listen(port, bind);
 
 console.log("Web service is running on %s:%d", bind, port);
+if (numWorkers > 0) {
+    console.log("Processing on %d worker threads (queue limit %d jobs)", numWorkers, maxQueue);
+}
 if (verbose) {
     console.log("Verbose logging enabled" + (logFile ? ` (output to ${logFile})` : " (output to stdout)"));
 }
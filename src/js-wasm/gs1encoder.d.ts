@@ -9,7 +9,9 @@ export class GS1encoder {
      * @param {string} [options.syntaxDictionary]        path to a GS1 Syntax Dictionary file. In Node.js this is a real host filesystem path. In the browser there is no host filesystem, so paths will fail to load; omit this option to use the embedded AI table.
      * @param {boolean} [options.fallbackOnSyndictError] fall back to the embedded AI table if the Syntax Dictionary cannot be loaded
      * @param {boolean} [options.noEmbedded]             refuse to use the embedded AI table (fails initialisation if no other table can be loaded)
+     * @param {string} [options.wasmVariant]             build of the library to load: <code>"auto"</code> (default) for the SIMD build where it is deployed and supported by the runtime, otherwise the scalar build; <code>"scalar"</code>; or <code>"simd"</code>
      * @returns {Promise<GS1encoder>} a fully-initialised GS1encoder instance
+     * @throws {GS1encoderParameterException} if the requested build is unknown or unavailable
      * @throws {GS1encoderGeneralException} if the library fails to initialise
      * @async
      */
@@ -17,6 +19,7 @@ export class GS1encoder {
         syntaxDictionary?: string;
         fallbackOnSyndictError?: boolean;
         noEmbedded?: boolean;
+        wasmVariant?: string;
     }): Promise<GS1encoder>;
     /**
      * @private
@@ -26,6 +29,11 @@ export class GS1encoder {
      * @private
      */
     private _nodefsMounts;
+    /**
+     * WASM heap arena reused by {@link GS1encoder#processBatch}
+     * @private
+     */
+    private _batchArena;
     /**
      * If init succeeded but the C library fell back to the embedded AI
      * table because the supplied `syntaxDictionary` could not be loaded
@@ -34,6 +42,13 @@ export class GS1encoder {
      * @type {string|null}
      */
     initFallbackWarning: string | null;
+    /**
+     * The build of the library that was loaded by init: <code>"simd"</code>
+     * for the build with WASM SIMD128 enabled, otherwise
+     * <code>"scalar"</code>. <code>null</code> before initialisation.
+     * @type {string|null}
+     */
+    wasmVariant: string | null;
     /**
      * Initialises a new instance of the GS1Encoder.
      *
@@ -41,7 +56,9 @@ export class GS1encoder {
      * @param {string} [options.syntaxDictionary]
      * @param {boolean} [options.fallbackOnSyndictError]
      * @param {boolean} [options.noEmbedded]
+     * @param {string} [options.wasmVariant]
      * @returns {Promise<void>}
+     * @throws {GS1encoderParameterException} if the requested build is unknown or unavailable
      * @throws {GS1encoderGeneralException} if the library fails to initialise
      * @async
      */
@@ -49,6 +66,7 @@ export class GS1encoder {
         syntaxDictionary?: string;
         fallbackOnSyndictError?: boolean;
         noEmbedded?: boolean;
+        wasmVariant?: string;
     }): Promise<void>;
     /**
      *  Load the WASM
@@ -409,10 +427,51 @@ export class GS1encoder {
      * @returns {string[]}
      */
     get dlIgnoredQueryParams(): string[];
+    /**
+     * Process a batch of inputs with a single call into the library.
+     * <p>
+     * This is equivalent to setting each input in turn using the property given by
+     * <code>input</code> and reading the property given by <code>output</code>, but
+     * avoids the cost of a call and a string copy in each direction per input, which
+     * dominates when validating large volumes of short messages.
+     * <p>
+     * The inputs are packed into a single buffer on the WASM heap, which is retained
+     * by the instance for reuse. The outputs are returned in a single packed buffer
+     * of NUL-terminated UTF-8 strings, and are decoded only on request.
+     * <p>
+     * Inputs that are rejected do not throw. Instead the corresponding
+     * <code>ok</code> entry is <code>0</code> and the output is the error message.
+     * <p>
+     * Example:
+     * <pre>
+     * const res = encoder.processBatch(["(01)12312312312333", "(01)12312312312334"],
+     *                                  GS1encoder.batchInput.AIdataStr,
+     *                                  GS1encoder.batchOutput.DLuri);
+     * for (let i = 0; i < res.length; i++)
+     *     console.log(res.ok[i] ? "OK" : "ERROR", res.get(i));
+     * </pre>
+     * <p>
+     * After processing, the instance holds the last of the inputs.
+     *
+     * @param {string[]} inputs - The inputs to process
+     * @param {BatchInput} [input] - Format of the inputs (default: {@link GS1encoder.batchInput AIdataStr})
+     * @param {BatchOutput} [output] - Format of the outputs (default: {@link GS1encoder.batchOutput DataStr})
+     * @returns {BatchResult} the outcome and output for each input
+     * @throws {GS1encoderParameterException} if the format is unknown or an input contains a NUL character
+     */
+    processBatch(inputs: string[], input?: BatchInput, output?: BatchOutput): BatchResult;
+    /**
+     * Ensures that the batch arena is at least the given size, preserving the
+     * given number of leading bytes when it is replaced.
+     * @private
+     */
+    private _reserveBatchArena;
 }
 export namespace GS1encoder {
     let symbology: Readonly<SymbologyEnum>;
     let validation: Readonly<ValidationEnum>;
+    let batchInput: Readonly<BatchInputEnum>;
+    let batchOutput: Readonly<BatchOutputEnum>;
 }
 /**
  * - Numeric symbology identifier
@@ -422,6 +481,14 @@ export type Symbology = number;
  * - Numeric validation identifier
  */
 export type Validation = number;
+/**
+ * - Numeric batch input format identifier
+ */
+export type BatchInput = number;
+/**
+ * - Numeric batch output format identifier
+ */
+export type BatchOutput = number;
 export type SymbologyEnum = {
     /**
      * None defined
@@ -518,6 +585,86 @@ export type ValidationEnum = {
      */
     NUMVALIDATIONS: Validation;
 };
+export type BatchInputEnum = {
+    /**
+     * Bracketed AI element strings, as for {@link GS1encoder#aiDataStr}
+     */
+    AIdataStr: BatchInput;
+    /**
+     * Barcode message data, as for {@link GS1encoder#dataStr}
+     */
+    DataStr: BatchInput;
+    /**
+     * Scan data, as for {@link GS1encoder#scanData}
+     */
+    ScanData: BatchInput;
+    /**
+     * Value is the number of batch input formats
+     */
+    NUMINPUTS: BatchInput;
+};
+export type BatchOutputEnum = {
+    /**
+     * No output: inputs are only validated
+     */
+    None: BatchOutput;
+    /**
+     * Barcode message data, as for {@link GS1encoder#dataStr}
+     */
+    DataStr: BatchOutput;
+    /**
+     * Bracketed AI element string, as for {@link GS1encoder#aiDataStr} (empty if not GS1 data)
+     */
+    AIdataStr: BatchOutput;
+    /**
+     * GS1 Digital Link URI with the default stem, as for {@link GS1encoder#getDLuri}
+     */
+    DLuri: BatchOutput;
+    /**
+     * Scan data, as for {@link GS1encoder#scanData}
+     */
+    ScanData: BatchOutput;
+    /**
+     * HRI lines separated by "|", as for {@link GS1encoder#hri}
+     */
+    HRI: BatchOutput;
+    /**
+     * Value is the number of batch output formats
+     */
+    NUMOUTPUTS: BatchOutput;
+};
+/**
+ * Outcome of {@link GS1encoder#processBatch}.
+ * <p>
+ * The outputs are held as NUL-terminated UTF-8 strings within a single packed
+ * buffer, located by the <code>offsets</code> and <code>lengths</code> arrays.
+ */
+export type BatchResult = {
+    /**
+     * Number of inputs processed
+     */
+    length: number;
+    /**
+     * 1 for each input that was processed successfully, otherwise 0 and the output is the error message
+     */
+    ok: Uint8Array;
+    /**
+     * Offset of each output within the buffer
+     */
+    offsets: Uint32Array;
+    /**
+     * Length of each output in bytes, excluding the NUL terminator
+     */
+    lengths: Uint32Array;
+    /**
+     * The packed outputs
+     */
+    buffer: Uint8Array;
+    /**
+     * Decode the output for the input with the given index
+     */
+    get: (arg0: number) => string;
+};
 /**
  * Exception thrown when a general library error occurs, such as initialisation failure.
  * @extends Error
@@ -599,4 +746,37 @@ declare const symbology: SymbologyEnum;
  */
 /** @type {ValidationEnum} */
 declare const validation: ValidationEnum;
-export { symbology as Symbology, validation as Validation };
+/**
+ * Input formats accepted by {@link GS1encoder#processBatch}.
+ *
+ * @typedef {number} BatchInput - Numeric batch input format identifier
+ */
+/**
+ * @typedef {object} BatchInputEnum
+ * @property {BatchInput} AIdataStr Bracketed AI element strings, as for {@link GS1encoder#aiDataStr}
+ * @property {BatchInput} DataStr Barcode message data, as for {@link GS1encoder#dataStr}
+ * @property {BatchInput} ScanData Scan data, as for {@link GS1encoder#scanData}
+ * @property {BatchInput} NUMINPUTS Value is the number of batch input formats
+ * @readonly
+ */
+/** @type {BatchInputEnum} */
+declare const batchInput: BatchInputEnum;
+/**
+ * Output formats generated by {@link GS1encoder#processBatch}.
+ *
+ * @typedef {number} BatchOutput - Numeric batch output format identifier
+ */
+/**
+ * @typedef {object} BatchOutputEnum
+ * @property {BatchOutput} None No output: inputs are only validated
+ * @property {BatchOutput} DataStr Barcode message data, as for {@link GS1encoder#dataStr}
+ * @property {BatchOutput} AIdataStr Bracketed AI element string, as for {@link GS1encoder#aiDataStr} (empty if not GS1 data)
+ * @property {BatchOutput} DLuri GS1 Digital Link URI with the default stem, as for {@link GS1encoder#getDLuri}
+ * @property {BatchOutput} ScanData Scan data, as for {@link GS1encoder#scanData}
+ * @property {BatchOutput} HRI HRI lines separated by "|", as for {@link GS1encoder#hri}
+ * @property {BatchOutput} NUMOUTPUTS Value is the number of batch output formats
+ * @readonly
+ */
+/** @type {BatchOutputEnum} */
+declare const batchOutput: BatchOutputEnum;
+export { symbology as Symbology, validation as Validation, batchInput as BatchInput, batchOutput as BatchOutput };
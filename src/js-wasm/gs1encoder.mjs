@@ -27,6 +27,11 @@
  *  running "make wasm" in the src/c-lib directory, provided that the EMSDK is
  *  installed and activated.
  *
+ *  The optional gs1encoder-wasm-simd.mjs and gs1encoder-wasm-simd.wasm,
+ *  built with WASM SIMD128 enabled, are generated by running
+ *  "make wasm-simd". Where present, they are loaded in preference to the
+ *  scalar build if the runtime supports SIMD128.
+ *
  *  Most browsers require that the .wasm is served with the MIME type set as
  *  "application/wasm".
  *
@@ -40,6 +45,56 @@ import createGS1encoderModule from './gs1encoder-wasm.mjs';
 const _registry = new FinalizationRegistry(release => release());
 
 
+/**
+ * @private
+ */
+let _simdModuleFactory = null;
+
+
+/**
+ * Determines whether the runtime supports the WASM SIMD128 feature that is
+ * required by the SIMD build.
+ * @private
+ */
+function _simdSupported() {
+    try {
+        if (typeof WebAssembly !== 'object')
+            return false;
+        // Minimal module whose function body uses v128 instructions
+        return WebAssembly.validate(new Uint8Array([
+            0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60,
+            0x00, 0x01, 0x7b, 0x03, 0x02, 0x01, 0x00, 0x0a, 0x0a, 0x01, 0x08, 0x00,
+            0x41, 0x00, 0xfd, 0x0f, 0xfd, 0x62, 0x0b,
+        ]));
+    } catch (e) {
+        return false;
+    }
+}
+
+
+/**
+ * Resolves to the module factory of the SIMD build, or null if it is not
+ * deployed alongside the wrapper.
+ * @private
+ */
+function _loadSimdModuleFactory() {
+    if (_simdModuleFactory === null)
+        _simdModuleFactory = import('./gs1encoder-wasm-simd.mjs').then(m => m.default, () => null);
+    return _simdModuleFactory;
+}
+
+
+/**
+ * @private
+ */
+const _textEncoder = new TextEncoder();
+
+/**
+ * @private
+ */
+const _textDecoder = new TextDecoder();
+
+
 /**
  * Main class for processing GS1 barcode data, including validation, format conversion, and generation of outputs such as GS1 Digital Link URIs and Human-Readable Interpretation text.
  */
@@ -57,6 +112,11 @@ export class GS1encoder {
          * @private
          */
         this._nodefsMounts = null;
+        /**
+         * WASM heap arena reused by {@link GS1encoder#processBatch}
+         * @private
+         */
+        this._batchArena = { ptr: 0, size: 0 };
         /**
          * If init succeeded but the C library fell back to the embedded AI
          * table because the supplied `syntaxDictionary` could not be loaded
@@ -65,6 +125,13 @@ export class GS1encoder {
          * @type {string|null}
          */
         this.initFallbackWarning = null;
+        /**
+         * The build of the library that was loaded by init: <code>"simd"</code>
+         * for the build with WASM SIMD128 enabled, otherwise
+         * <code>"scalar"</code>. <code>null</code> before initialisation.
+         * @type {string|null}
+         */
+        this.wasmVariant = null;
     }
 
     /**
@@ -74,7 +141,9 @@ export class GS1encoder {
      * @param {string} [options.syntaxDictionary]        path to a GS1 Syntax Dictionary file. In Node.js this is a real host filesystem path. In the browser there is no host filesystem, so paths will fail to load; omit this option to use the embedded AI table.
      * @param {boolean} [options.fallbackOnSyndictError] fall back to the embedded AI table if the Syntax Dictionary cannot be loaded
      * @param {boolean} [options.noEmbedded]             refuse to use the embedded AI table (fails initialisation if no other table can be loaded)
+     * @param {string} [options.wasmVariant]             build of the library to load: <code>"auto"</code> (default) for the SIMD build where it is deployed and supported by the runtime, otherwise the scalar build; <code>"scalar"</code>; or <code>"simd"</code>
      * @returns {Promise<GS1encoder>} a fully-initialised GS1encoder instance
+     * @throws {GS1encoderParameterException} if the requested build is unknown or unavailable
      * @throws {GS1encoderGeneralException} if the library fails to initialise
      * @async
      */
@@ -91,7 +160,9 @@ export class GS1encoder {
      * @param {string} [options.syntaxDictionary]
      * @param {boolean} [options.fallbackOnSyndictError]
      * @param {boolean} [options.noEmbedded]
+     * @param {string} [options.wasmVariant]
      * @returns {Promise<void>}
+     * @throws {GS1encoderParameterException} if the requested build is unknown or unavailable
      * @throws {GS1encoderGeneralException} if the library fails to initialise
      * @async
      */
@@ -100,11 +171,21 @@ export class GS1encoder {
         if (this.ctx)
             throw new GS1encoderGeneralException("GS1encoder instance is already initialised");
 
+        const variant = (options && options.wasmVariant) || "auto";
+        let factory = null;
+        if (variant !== "auto" && variant !== "scalar" && variant !== "simd")
+            throw new GS1encoderParameterException("Unknown WASM variant: " + variant);
+        if (variant !== "scalar" && _simdSupported())
+            factory = await _loadSimdModuleFactory();
+        if (variant === "simd" && factory === null)
+            throw new GS1encoderParameterException("The SIMD build is not available or is not supported by this runtime");
+
         /**
          *  Load the WASM
          *  @private
          */
-        this.module = await createGS1encoderModule();
+        this.module = await (factory || createGS1encoderModule)();
+        this.wasmVariant = factory ? "simd" : "scalar";
 
         /**
          *  Public API functions implemented by the WASM build of the GS1
@@ -164,6 +245,9 @@ export class GS1encoder {
                 this.module.cwrap('gs1_encoder_getHRI', 'number', ['number', 'number']),
             gs1_encoder_getDLignoredQueryParams:
                 this.module.cwrap('gs1_encoder_getDLignoredQueryParams', 'number', ['number', 'number']),
+            gs1_encoder_processBatch:
+                this.module.cwrap('gs1_encoder_processBatch', 'number',
+                                  ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']),
         };
 
         /*
@@ -306,6 +390,10 @@ export class GS1encoder {
             _registry.unregister(this);
             this.api.gs1_encoder_free(this.ctx);
         }
+        if (this._batchArena.ptr !== 0) {
+            this.module._free(this._batchArena.ptr);
+            this._batchArena = { ptr: 0, size: 0 };
+        }
         this.ctx = null;
     }
 
@@ -764,6 +852,158 @@ export class GS1encoder {
         return qp;
     }
 
+
+    /**
+     * Process a batch of inputs with a single call into the library.
+     * <p>
+     * This is equivalent to setting each input in turn using the property given by
+     * <code>input</code> and reading the property given by <code>output</code>, but
+     * avoids the cost of a call and a string copy in each direction per input, which
+     * dominates when validating large volumes of short messages.
+     * <p>
+     * The inputs are packed into a single buffer on the WASM heap, which is retained
+     * by the instance for reuse. The outputs are returned in a single packed buffer
+     * of NUL-terminated UTF-8 strings, and are decoded only on request.
+     * <p>
+     * Inputs that are rejected do not throw. Instead the corresponding
+     * <code>ok</code> entry is <code>0</code> and the output is the error message.
+     * <p>
+     * Example:
+     * <pre>
+     * const res = encoder.processBatch(["(01)12312312312333", "(01)12312312312334"],
+     *                                  GS1encoder.batchInput.AIdataStr,
+     *                                  GS1encoder.batchOutput.DLuri);
+     * for (let i = 0; i < res.length; i++)
+     *     console.log(res.ok[i] ? "OK" : "ERROR", res.get(i));
+     * </pre>
+     * <p>
+     * After processing, the instance holds the last of the inputs.
+     *
+     * @param {string[]} inputs - The inputs to process
+     * @param {BatchInput} [input] - Format of the inputs (default: {@link GS1encoder.batchInput AIdataStr})
+     * @param {BatchOutput} [output] - Format of the outputs (default: {@link GS1encoder.batchOutput DataStr})
+     * @returns {BatchResult} the outcome and output for each input
+     * @throws {GS1encoderParameterException} if the format is unknown or an input contains a NUL character
+     */
+    processBatch(inputs, input = batchInput.AIdataStr, output = batchOutput.DataStr) {
+
+        const RESULT_SIZE   = 3 * Uint32Array.BYTES_PER_ELEMENT;   // offset, length, ok
+        const MIN_OUT_SIZE  = 4096;
+
+        const ctx = this._checkedCtx();
+
+        if (!Array.isArray(inputs))
+            throw new TypeError("inputs must be an array of strings");
+        if (!Number.isInteger(input) || input < 0 || input >= batchInput.NUMINPUTS ||
+            !Number.isInteger(output) || output < 0 || output >= batchOutput.NUMOUTPUTS)
+            throw new GS1encoderParameterException("Unknown batch input or output format");
+
+        const num = inputs.length;
+        let inSize = 0;
+        for (const value of inputs) {
+            if (typeof value !== "string")
+                throw new TypeError("inputs must be an array of strings");
+            if (value.includes("\0"))
+                throw new GS1encoderParameterException("Batch inputs must not contain NUL characters");
+            inSize += value.length * 3 + 1;                 // UTF-8 worst case
+        }
+
+        // Arena layout: [results][inputs][outputs]
+        const resSize = num * RESULT_SIZE;
+        let outSize = Math.max(MIN_OUT_SIZE, 2 * inSize);
+        let arena = this._reserveBatchArena(resSize + inSize + outSize, 0);
+        let inPtr = arena.ptr + resSize;
+
+        const inOffsets = new Uint32Array(num + 1);
+        let heap = this.module.HEAPU8;
+        let pos = 0;
+        for (let i = 0; i < num; i++) {
+            inOffsets[i] = pos;
+            pos += _textEncoder.encodeInto(inputs[i], heap.subarray(inPtr + pos, inPtr + inSize)).written;
+            heap[inPtr + pos++] = 0;
+        }
+        inOffsets[num] = pos;
+        const inUsed = pos;
+
+        const ok = new Uint8Array(num);
+        const offsets = new Uint32Array(num);
+        const lengths = new Uint32Array(num);
+        let buffer = new Uint8Array(0);
+        let bufferUsed = 0;
+
+        for (let done = 0; done < num; ) {
+
+            const resPtr = arena.ptr;
+            inPtr = resPtr + resSize;
+            const outPtr = inPtr + inUsed;
+            outSize = arena.size - resSize - inUsed;
+            const processed = this.api.gs1_encoder_processBatch(ctx, input, output,
+                inPtr + inOffsets[done], num - done, outPtr, outSize, resPtr + done * RESULT_SIZE);
+
+            if (processed === 0) {          // Output too long for the buffer, so retry with a larger one
+                arena = this._reserveBatchArena(resSize + inUsed + 2 * outSize, resSize + inUsed);
+                continue;
+            }
+
+            // The heap views are replaced if memory grows, so are reacquired after each call
+            heap = this.module.HEAPU8;
+            const heap32 = this.module.HEAPU32;
+            let outUsed = 0;
+            for (let i = done, r = (resPtr + done * RESULT_SIZE) >> 2; i < done + processed; i++, r += 3) {
+                offsets[i] = bufferUsed + heap32[r];
+                lengths[i] = heap32[r + 1];
+                ok[i] = heap32[r + 2];
+                outUsed = heap32[r] + heap32[r + 1] + 1;
+            }
+
+            if (bufferUsed + outUsed > buffer.length) {
+                const grown = new Uint8Array(Math.max(2 * buffer.length, bufferUsed + outUsed));
+                grown.set(buffer.subarray(0, bufferUsed));
+                buffer = grown;
+            }
+            buffer.set(heap.subarray(outPtr, outPtr + outUsed), bufferUsed);
+            bufferUsed += outUsed;
+            done += processed;
+
+        }
+
+        buffer = buffer.subarray(0, bufferUsed);
+
+        return {
+            length: num,
+            ok,
+            offsets,
+            lengths,
+            buffer,
+            get(i) {
+                return _textDecoder.decode(buffer.subarray(offsets[i], offsets[i] + lengths[i]));
+            },
+        };
+
+    }
+
+
+    /**
+     * Ensures that the batch arena is at least the given size, preserving the
+     * given number of leading bytes when it is replaced.
+     * @private
+     */
+    _reserveBatchArena(size, keep) {
+        const arena = this._batchArena;
+        if (arena.size >= size)
+            return arena;
+        const ptr = this.module._malloc(size);
+        if (ptr === 0)
+            throw new GS1encoderGeneralException("Failed to allocate memory for batch");
+        if (arena.ptr !== 0) {
+            if (keep > 0)
+                this.module.HEAPU8.copyWithin(ptr, arena.ptr, arena.ptr + keep);
+            this.module._free(arena.ptr);
+        }
+        this._batchArena = { ptr, size };
+        return this._batchArena;
+    }
+
 }
 
 
@@ -857,6 +1097,80 @@ const validation = {
 GS1encoder.validation = Object.freeze(validation);
 
 
+/**
+ * Input formats accepted by {@link GS1encoder#processBatch}.
+ *
+ * @typedef {number} BatchInput - Numeric batch input format identifier
+ */
+
+/**
+ * @typedef {object} BatchInputEnum
+ * @property {BatchInput} AIdataStr Bracketed AI element strings, as for {@link GS1encoder#aiDataStr}
+ * @property {BatchInput} DataStr Barcode message data, as for {@link GS1encoder#dataStr}
+ * @property {BatchInput} ScanData Scan data, as for {@link GS1encoder#scanData}
+ * @property {BatchInput} NUMINPUTS Value is the number of batch input formats
+ * @readonly
+ */
+
+/** @type {BatchInputEnum} */
+const batchInput = {
+    AIdataStr: 0,
+    DataStr: 1,
+    ScanData: 2,
+    NUMINPUTS: 3,
+};
+
+GS1encoder.batchInput = Object.freeze(batchInput);
+
+
+/**
+ * Output formats generated by {@link GS1encoder#processBatch}.
+ *
+ * @typedef {number} BatchOutput - Numeric batch output format identifier
+ */
+
+/**
+ * @typedef {object} BatchOutputEnum
+ * @property {BatchOutput} None No output: inputs are only validated
+ * @property {BatchOutput} DataStr Barcode message data, as for {@link GS1encoder#dataStr}
+ * @property {BatchOutput} AIdataStr Bracketed AI element string, as for {@link GS1encoder#aiDataStr} (empty if not GS1 data)
+ * @property {BatchOutput} DLuri GS1 Digital Link URI with the default stem, as for {@link GS1encoder#getDLuri}
+ * @property {BatchOutput} ScanData Scan data, as for {@link GS1encoder#scanData}
+ * @property {BatchOutput} HRI HRI lines separated by "|", as for {@link GS1encoder#hri}
+ * @property {BatchOutput} NUMOUTPUTS Value is the number of batch output formats
+ * @readonly
+ */
+
+/** @type {BatchOutputEnum} */
+const batchOutput = {
+    None: 0,
+    DataStr: 1,
+    AIdataStr: 2,
+    DLuri: 3,
+    ScanData: 4,
+    HRI: 5,
+    NUMOUTPUTS: 6,
+};
+
+GS1encoder.batchOutput = Object.freeze(batchOutput);
+
+
+/**
+ * Outcome of {@link GS1encoder#processBatch}.
+ * <p>
+ * The outputs are held as NUL-terminated UTF-8 strings within a single packed
+ * buffer, located by the <code>offsets</code> and <code>lengths</code> arrays.
+ *
+ * @typedef {object} BatchResult
+ * @property {number} length Number of inputs processed
+ * @property {Uint8Array} ok 1 for each input that was processed successfully, otherwise 0 and the output is the error message
+ * @property {Uint32Array} offsets Offset of each output within the buffer
+ * @property {Uint32Array} lengths Length of each output in bytes, excluding the NUL terminator
+ * @property {Uint8Array} buffer The packed outputs
+ * @property {function(number): string} get Decode the output for the input with the given index
+ */
+
+
 /**
  * Exception thrown when a general library error occurs, such as initialisation failure.
  * @extends Error
@@ -904,4 +1218,4 @@ class GS1encoderScanDataException extends Error {
     }
 }
 
-export { GS1encoderGeneralException, GS1encoderParameterException, GS1encoderDigitalLinkException, GS1encoderScanDataException, symbology as Symbology, validation as Validation };
+export { GS1encoderGeneralException, GS1encoderParameterException, GS1encoderDigitalLinkException, GS1encoderScanDataException, symbology as Symbology, validation as Validation, batchInput as BatchInput, batchOutput as BatchOutput };
@@ -21,7 +21,7 @@
 
 "use strict";
 
-import { GS1encoder, GS1encoderGeneralException, GS1encoderParameterException, GS1encoderDigitalLinkException, GS1encoderScanDataException } from "./gs1encoder.mjs";
+import { GS1encoder, GS1encoderGeneralException, GS1encoderParameterException, GS1encoderDigitalLinkException, GS1encoderScanDataException, BatchInput, BatchOutput } from "./gs1encoder.mjs";
 
 const SYNDICT_HOST_PATH = "../c-lib/gs1-syntax-dictionary.txt";
 
@@ -342,3 +342,85 @@ test('non-string data setter arguments throw', async () => {
   expect(enc.getDLuri()).toMatch(/^https:\/\/id\.gs1\.org\//);
   enc.free();
 });
+
+test('processBatch', async () => {
+  const enc = await GS1encoder.create();
+
+  const inputs = [
+    "(01)12312312312319(99)TESTING123",
+    "(01)12312312312318",                       // Bad check digit
+    "(01)12312312312319|(99)XYZ(TM) CORP",
+    "(99)\u00e9",
+  ];
+
+  let res = enc.processBatch(inputs, BatchInput.AIdataStr, BatchOutput.DataStr);
+  expect(res.length).toBe(4);
+  expect(Array.from(res.ok)).toStrictEqual([1, 0, 1, 0]);
+  expect(res.get(0)).toBe("^011231231231231999TESTING123");
+  expect(res.get(1)).toMatch(/^AI \(01\): /);
+  expect(res.get(2)).toBe("^0112312312312319|^99XYZ(TM) CORP");
+  expect(res.lengths[3]).toBeGreaterThan(0);
+  expect(res.lengths[0]).toBe(res.get(0).length);
+  expect(res.buffer[res.offsets[0] + res.lengths[0]]).toBe(0);
+
+  res = enc.processBatch(inputs.slice(0, 1), BatchInput.AIdataStr, BatchOutput.DLuri);
+  expect(res.get(0)).toBe("https://id.gs1.org/01/12312312312319?99=TESTING123");
+  expect(enc.dataStr).toBe("^011231231231231999TESTING123");               // Holds the last input
+  res = enc.processBatch(inputs.slice(0, 1), BatchInput.AIdataStr, BatchOutput.HRI);
+  expect(res.get(0)).toBe("(01) 12312312312319|(99) TESTING123");
+  res = enc.processBatch(["https://id.gs1.org/01/12312312312319", "TESTING"], BatchInput.DataStr, BatchOutput.AIdataStr);
+  expect(res.get(0)).toBe("(01)12312312312319");
+  expect(res.get(1)).toBe("");
+  res = enc.processBatch(["]Q3011231231231231999TESTING123"], BatchInput.ScanData, BatchOutput.ScanData);
+  expect(res.get(0)).toBe("]Q3011231231231231999TESTING123");
+  res = enc.processBatch(inputs, BatchInput.AIdataStr, BatchOutput.None);
+  expect(Array.from(res.lengths)).toStrictEqual([0, res.lengths[1], 0, res.lengths[3]]);
+
+  // Enough outputs to exceed the initial output buffer
+  const many = Array.from({ length: 5000 }, (_, i) => "(01)12312312312319(10)" + i);
+  res = enc.processBatch(many, BatchInput.AIdataStr, BatchOutput.DLuri);
+  expect(res.length).toBe(5000);
+  expect(res.ok.every(ok => ok === 1)).toBe(true);
+  expect(res.get(4999)).toBe("https://id.gs1.org/01/12312312312319/10/4999");
+
+  expect(enc.processBatch([]).length).toBe(0);
+  expect(() => enc.processBatch("(01)12312312312319")).toThrow(TypeError);
+  expect(() => enc.processBatch([123])).toThrow(TypeError);
+  expect(() => enc.processBatch(["(99)A\0B"])).toThrow(GS1encoderParameterException);
+  expect(() => enc.processBatch(inputs, BatchInput.NUMINPUTS)).toThrow(GS1encoderParameterException);
+  expect(() => enc.processBatch(inputs, BatchInput.AIdataStr, BatchOutput.NUMOUTPUTS)).toThrow(GS1encoderParameterException);
+
+  enc.free();
+  expect(() => enc.processBatch(inputs)).toThrow(GS1encoderGeneralException);
+});
+
+test('wasmVariant', async () => {
+  const auto = await GS1encoder.create();
+  expect(["scalar", "simd"]).toContain(auto.wasmVariant);
+  auto.free();
+
+  const scalar = await GS1encoder.create({ wasmVariant: "scalar" });
+  expect(scalar.wasmVariant).toBe("scalar");
+  scalar.aiDataStr = "(01)12312312312319";
+  expect(scalar.dataStr).toBe("^0112312312312319");
+  scalar.free();
+
+  // The SIMD build is optional, but must behave identically where it loads
+  let simd = null;
+  try {
+    simd = await GS1encoder.create({ wasmVariant: "simd" });
+  } catch (e) {
+    expect(e).toBeInstanceOf(GS1encoderParameterException);
+  }
+  if (simd) {
+    expect(simd.wasmVariant).toBe("simd");
+    simd.aiDataStr = "(01)12312312312319";
+    expect(simd.dataStr).toBe("^0112312312312319");
+    const res = simd.processBatch(["(01)12312312312319", "(01)12312312312318"], BatchInput.AIdataStr, BatchOutput.DLuri);
+    expect(res.get(0)).toBe("https://id.gs1.org/01/12312312312319");
+    expect(res.ok[1]).toBe(0);
+    simd.free();
+  }
+
+  await expect(GS1encoder.create({ wasmVariant: "bogus" })).rejects.toThrow(GS1encoderParameterException);
+});
@@ -174,6 +174,30 @@
  * <a href="https://github.com/gs1/gs1-syntax-engine/blob/main/src/js-wasm/example.mjs">example.mjs</a>.
  *
  *
+ * <h2 id="simd-build">SIMD build</h2>
+ *
+ * In addition to the scalar build in <code>gs1encoder-wasm.wasm</code>, the
+ * library may be deployed with a build compiled with WASM SIMD128 enabled, in
+ * <code>gs1encoder-wasm-simd.mjs</code> and
+ * <code>gs1encoder-wasm-simd.wasm</code>. This is generated by running
+ * <code>make wasm-simd</code> in the <code>src/c-lib</code> directory.
+ *
+ * <p>
+ * When an instance is initialised, the wrapper detects whether the runtime
+ * supports WASM SIMD128 and, if so, loads the SIMD build where it is deployed.
+ * Otherwise it falls back to the scalar build. The build that was loaded is
+ * reported by {@link GS1encoder#wasmVariant wasmVariant} and a particular build
+ * can be requested with the <code>wasmVariant</code> option of
+ * {@link GS1encoder.create create()}.
+ *
+ * <p>
+ * Each instance is single-threaded, so an application that processes
+ * data concurrently should use an instance per worker.
+ *
+ * <p>
+ * The builds can be compared using <code>node bench.node.mjs</code>.
+ *
+ *
  * <h2 id="typescript-support">TypeScript Support</h2>
  *
  * This library includes type definitions (<code>.d.ts</code> file) for the wrapper that
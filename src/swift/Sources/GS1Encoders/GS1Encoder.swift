@@ -112,6 +112,51 @@ public class GS1Encoder {
         case NUMVALIDATIONS = 5
     }
 
+    /// Format of the inputs to `processBatch(_:input:output:)`.
+    public enum BatchInput: UInt32, Sendable {
+
+        /// Bracketed AI element strings, as for `setAIdataStr(_:)`
+        case AIdataStr = 0
+
+        /// Barcode messages or GS1 Digital Link URIs, as for `setDataStr(_:)`
+        case DataStr = 1
+
+        /// Scan data, as for `setScanData(_:)`
+        case ScanData = 2
+    }
+
+    /// Output rendered for each input by `processBatch(_:input:output:)`.
+    public enum BatchOutput: UInt32, Sendable {
+
+        /// No output: inputs are only validated
+        case NONE = 0
+
+        /// The barcode message data, as from `getDataStr()`
+        case DataStr = 1
+
+        /// The bracketed AI element string, as from `getAIdataStr()`
+        case AIdataStr = 2
+
+        /// The GS1 Digital Link URI with the default stem, as from `getDLuri(_:)`
+        case DLuri = 3
+
+        /// The scan data, as from `getScanData()`
+        case ScanData = 4
+
+        /// The HRI text, as from `getHRI()`, with lines separated by `|`
+        case HRI = 5
+    }
+
+    /// Outcome of processing one input with `processBatch(_:input:output:)`.
+    public struct BatchResult: Sendable, Equatable {
+
+        /// `true` if the input was processed successfully
+        public let ok: Bool
+
+        /// The requested output if the input was processed successfully, otherwise the error message
+        public let output: String
+    }
+
     /// An opaque pointer used by the native code to represent an
     /// "instance" of the library. It is hidden behind the object
     /// interface that is provided to users of this wrapper.
@@ -122,6 +167,12 @@ public class GS1Encoder {
     /// (only when `fallbackOnSyndictError` was set). `nil` on plain success.
     public private(set) var initFallbackWarning: String? = nil
 
+    /// Buffers used by `processBatch(_:input:output:)`, retained so that
+    /// subsequent batches do not allocate them again.
+    private var batchIn = [UInt8]()
+    private var batchOut = [CChar]()
+    private var batchResults = [gs1_encoder_batch_result_t]()
+
     // This Swift wrapper library throws an exception containing the error message whenever
     // an error is returned by the native library. Therefore direct access to the native
     // error message is not necessary.
@@ -579,6 +630,104 @@ public class GS1Encoder {
         return out
     }
 
+    private static let batchOutInitialSize = 64 * 1024
+    private static let batchOutMaxSize = 16 * 1024 * 1024
+
+    /// Process a batch of inputs, calling into the native library once for
+    /// each buffer full of outputs rather than once for each input.
+    ///
+    /// This is equivalent to calling the setter for the given input format on
+    /// each input in turn followed by the getter for the given output format.
+    /// The inputs are packed as UTF-8 into a buffer that the instance retains
+    /// for subsequent batches, so no C string is bridged for each input, and
+    /// each output is decoded directly from the native output buffer.
+    ///
+    /// A rejected input does not throw: its result carries the error message
+    /// instead. The instance is left holding the last input that was processed.
+    ///
+    /// - Parameters:
+    ///   - inputs: The inputs to process
+    ///   - input: The format of the inputs
+    ///   - output: The output to render for each input
+    /// - Returns: The result for each input, in input order
+    /// - Throws: `GS1EncoderError.generalError` if the native library cannot process the batch
+    /// - SeeAlso: `GS1EncoderPool`, which spreads a batch over several instances
+    public func processBatch<C: Collection>(_ inputs: C, input: BatchInput, output: BatchOutput) throws -> [BatchResult] where C.Element == String {
+        let ctx = checkedCtx()
+
+        // An input containing NUL cannot be delimited within the packed
+        // inputs, so is rejected here as it would be by the setters
+        var results = [BatchResult]()
+        results.reserveCapacity(inputs.count)
+        var packedAt = [Int]()      // Index within results of each packed input
+        var starts = [Int]()        // Offset of each packed input within batchIn
+        batchIn.removeAll(keepingCapacity: true)
+        for value in inputs {
+            if value.utf8.contains(0) {
+                results.append(BatchResult(ok: false, output: "Input must not contain a NUL character"))
+                continue
+            }
+            packedAt.append(results.count)
+            starts.append(batchIn.count)
+            results.append(BatchResult(ok: false, output: ""))
+            batchIn.append(contentsOf: value.utf8)
+            batchIn.append(0)
+        }
+        if packedAt.isEmpty {
+            return results
+        }
+
+        if batchOut.isEmpty {
+            batchOut = [CChar](repeating: 0, count: GS1Encoder.batchOutInitialSize)
+        }
+        if batchResults.count < packedAt.count {
+            batchResults = [gs1_encoder_batch_result_t](repeating: gs1_encoder_batch_result_t(), count: packedAt.count)
+        }
+
+        var done = 0
+        while done < packedAt.count {
+            let start = starts[done]
+            let remaining = packedAt.count - done
+            let n = batchIn.withUnsafeBufferPointer { inBytes in
+                inBytes.withMemoryRebound(to: CChar.self) { inChars in
+                    batchOut.withUnsafeMutableBufferPointer { outBuf in
+                        batchResults.withUnsafeMutableBufferPointer { resBuf in
+                            gs1_encoder_processBatch(ctx,
+                                                     gs1_encoder_batch_inputs_t(input.rawValue),
+                                                     gs1_encoder_batch_outputs_t(output.rawValue),
+                                                     inChars.baseAddress! + start, remaining,
+                                                     outBuf.baseAddress!, outBuf.count,
+                                                     resBuf.baseAddress!)
+                        }
+                    }
+                }
+            }
+
+            // Nothing processed means the next output does not fit
+            if n == 0 {
+                if batchOut.count >= GS1Encoder.batchOutMaxSize {
+                    let msg = self.getErrMsg()
+                    throw GS1EncoderError.generalError(msg: msg.isEmpty ? "Batch output exceeds the maximum buffer size" : msg)
+                }
+                batchOut = [CChar](repeating: 0, count: batchOut.count * 2)
+                continue
+            }
+
+            batchOut.withUnsafeBufferPointer { outBuf in
+                let base = UnsafeRawPointer(outBuf.baseAddress!)
+                for i in 0..<n {
+                    let res = batchResults[i]
+                    let bytes = UnsafeRawBufferPointer(start: base + Int(res.offset), count: Int(res.length))
+                    results[packedAt[done + i]] = BatchResult(ok: res.ok != 0,
+                                                              output: String(decoding: bytes, as: UTF8.self))
+                }
+            }
+            done += n
+        }
+
+        return results
+    }
+
 }
 
 /// Custom error types for GS1 Encoder operations.
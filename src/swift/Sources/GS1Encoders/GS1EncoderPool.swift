@@ -0,0 +1,201 @@
+/*
+ * A pool of GS1Encoder instances for processing batches of inputs
+ * concurrently using Swift structured concurrency
+ *
+ * Copyright (c) 2026 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+import Foundation
+
+/// A pool of `GS1Encoder` instances that processes batches of inputs off the
+/// calling actor, spread over a bounded number of concurrent tasks.
+///
+/// A `GS1Encoder` instance must only be used by one task at a time and is
+/// relatively costly to create, since it loads the AI table. The pool creates
+/// instances on demand, up to `maxConcurrency` of them, and retains them for
+/// reuse. A task that needs an instance when all of them are in use waits
+/// for one to be returned, so no more than `maxConcurrency` inputs are ever
+/// processed at once, however many batches are submitted.
+///
+/// Every instance is created with the same initialisation options and is then
+/// passed to the optional `configure` closure.
+///
+/// ```swift
+/// let pool = GS1EncoderPool(maxConcurrency: 4)
+/// let results = try await pool.processBatch(scans, input: .ScanData, output: .AIdataStr)
+/// ```
+public actor GS1EncoderPool {
+
+    /// An instance that is owned by the pool or by the one task that has
+    /// checked it out, but never by more than one at a time, which is what
+    /// makes it safe to pass between them.
+    private final class Context: @unchecked Sendable {
+        let encoder: GS1Encoder
+        init(_ encoder: GS1Encoder) { self.encoder = encoder }
+    }
+
+    /// Number of inputs processed by each call into the native library, after
+    /// which a task yields to let other work make progress.
+    private static let chunkSize = 64
+
+    /// The maximum number of instances, and so of tasks processing inputs at once.
+    public let maxConcurrency: Int
+
+    private let syntaxDictionary: String?
+    private let fallbackOnSyndictError: Bool
+    private let noEmbedded: Bool
+    private let configure: (@Sendable (GS1Encoder) throws -> Void)?
+
+    private var idle = [Context]()
+    private var created = 0
+    private var waiters = [CheckedContinuation<Context, Never>]()
+
+    /// Initialises a new pool. No instances are created until they are needed.
+    ///
+    /// - Parameter maxConcurrency: The maximum number of instances. Defaults to the number of active processors.
+    /// - Parameter syntaxDictionary: Path to a GS1 Syntax Dictionary file for each instance. If nil, the embedded AI table is used.
+    /// - Parameter fallbackOnSyndictError: Fall back to the embedded AI table if the Syntax Dictionary cannot be loaded.
+    /// - Parameter noEmbedded: Refuse to use the embedded AI table.
+    /// - Parameter configure: A closure applied to each new instance, for example to set options. It must not retain the instance.
+    public init(maxConcurrency: Int = ProcessInfo.processInfo.activeProcessorCount,
+                syntaxDictionary: String? = nil,
+                fallbackOnSyndictError: Bool = false,
+                noEmbedded: Bool = false,
+                configure: (@Sendable (GS1Encoder) throws -> Void)? = nil) {
+        precondition(maxConcurrency > 0, "maxConcurrency must be positive")
+        self.maxConcurrency = maxConcurrency
+        self.syntaxDictionary = syntaxDictionary
+        self.fallbackOnSyndictError = fallbackOnSyndictError
+        self.noEmbedded = noEmbedded
+        self.configure = configure
+    }
+
+    /// The number of instances that have been created and are not in use.
+    public var idleCount: Int {
+        return idle.count
+    }
+
+    private func checkOut() async throws -> Context {
+        if let context = idle.popLast() {
+            return context
+        }
+        if created < maxConcurrency {
+            let encoder = try GS1Encoder(syntaxDictionary: syntaxDictionary,
+                                         fallbackOnSyndictError: fallbackOnSyndictError,
+                                         noEmbedded: noEmbedded)
+            try configure?(encoder)
+            created += 1
+            return Context(encoder)
+        }
+        return await withCheckedContinuation { continuation in
+            waiters.append(continuation)
+        }
+    }
+
+    private func checkIn(_ context: Context) {
+        if waiters.isEmpty {
+            idle.append(context)
+        } else {
+            waiters.removeFirst().resume(returning: context)
+        }
+    }
+
+    /// Run a closure with exclusive use of an instance from the pool.
+    ///
+    /// The closure runs off the pool's actor, so several may run at once.
+    /// Instances are returned to the pool as they are, so a closure that
+    /// changes any option of the instance must restore it.
+    ///
+    /// - Parameter body: The closure, which must not retain the instance
+    /// - Returns: The value returned by the closure
+    /// - Throws: `GS1EncoderError.generalError` if a new instance fails to initialise, or any error thrown by the closure
+    public nonisolated func withEncoder<T: Sendable>(_ body: @Sendable (GS1Encoder) throws -> T) async throws -> T {
+        let context = try await checkOut()
+        let result = Result { try body(context.encoder) }
+        await checkIn(context)
+        return try result.get()
+    }
+
+    /// Process a batch of inputs, spread over up to `maxConcurrency` tasks.
+    ///
+    /// The inputs are divided into contiguous shares, one for each task, and
+    /// each task passes its share to `GS1Encoder.processBatch(_:input:output:)`
+    /// in chunks, yielding between them. Processing stops early with
+    /// `CancellationError` if the calling task is cancelled.
+    ///
+    /// - Parameters:
+    ///   - inputs: The inputs to process
+    ///   - input: The format of the inputs
+    ///   - output: The output to render for each input
+    /// - Returns: The result for each input, in input order
+    /// - Throws: `GS1EncoderError.generalError` if a new instance fails to initialise or the native library cannot process the batch
+    public nonisolated func processBatch(_ inputs: [String],
+                                         input: GS1Encoder.BatchInput,
+                                         output: GS1Encoder.BatchOutput) async throws -> [GS1Encoder.BatchResult] {
+        if inputs.isEmpty {
+            return []
+        }
+
+        // Do not divide the work more finely than one chunk for each task
+        let tasks = min(maxConcurrency, (inputs.count + GS1EncoderPool.chunkSize - 1) / GS1EncoderPool.chunkSize)
+        let share = (inputs.count + tasks - 1) / tasks
+
+        return try await withThrowingTaskGroup(of: (Int, [GS1Encoder.BatchResult]).self,
+                                             returning: [GS1Encoder.BatchResult].self) { group in
+            for task in 0..<tasks {
+                let range = min(inputs.count, task * share) ..< min(inputs.count, (task + 1) * share)
+                if range.isEmpty {
+                    break
+                }
+                group.addTask {
+                    let context = try await self.checkOut()
+                    do {
+                        var results = [GS1Encoder.BatchResult]()
+                        results.reserveCapacity(range.count)
+                        var start = range.lowerBound
+                        while start < range.upperBound {
+                            try Task.checkCancellation()
+                            let end = min(start + GS1EncoderPool.chunkSize, range.upperBound)
+                            results += try context.encoder.processBatch(inputs[start..<end], input: input, output: output)
+                            start = end
+                            if start < range.upperBound {
+                                await Task.yield()
+                            }
+                        }
+                        await self.checkIn(context)
+                        return (task, results)
+                    } catch {
+                        await self.checkIn(context)
+                        throw error
+                    }
+                }
+            }
+
+            var shares = [[GS1Encoder.BatchResult]](repeating: [], count: tasks)
+            for try await (task, results) in group {
+                shares[task] = results
+            }
+            var results = [GS1Encoder.BatchResult]()
+            results.reserveCapacity(inputs.count)
+            for part in shares {
+                results += part
+            }
+            return results
+        }
+    }
+
+}
@@ -0,0 +1,153 @@
+/*
+ * Tests for the pool of GS1Encoder instances.
+ *
+ * Copyright (c) 2026 GS1 AISBL.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+import Foundation
+import XCTest
+@testable import GS1Encoders
+
+/// Holds the outcome of an asynchronous operation for a synchronous waiter.
+private final class BlockingResult<T: Sendable>: @unchecked Sendable {
+    let done = DispatchSemaphore(value: 0)
+    var result: Result<T, Error>? = nil
+}
+
+/// Run an asynchronous operation to completion from synchronous code, such
+/// as the block passed to `measure`, which cannot itself await. The task is
+/// detached so that it cannot need the actor of the thread that waits for it.
+private func runBlocking<T: Sendable>(_ body: @escaping @Sendable () async throws -> T) throws -> T {
+    let box = BlockingResult<T>()
+    Task.detached {
+        do {
+            box.result = .success(try await body())
+        } catch {
+            box.result = .failure(error)
+        }
+        box.done.signal()
+    }
+    box.done.wait()
+    return try box.result!.get()
+}
+
+final class GS1EncoderPoolTests: XCTestCase {
+
+    static let corpus = [
+        "(01)09521234543213(10)ABC123(99)TEST",
+        "(01)09521234543213(17)251231(10)BATCH42(21)SERIAL0001",
+        "(01)09521234543213(3103)000189(15)260101(10)LOT-7",
+        "(01)09521234543213(11)250101(17)271231(10)ABCDEFGHIJKLMNOPQRST(21)12345678901234567890",
+        "(00)095212345678901235(02)09521234543213(37)24",
+        "(414)9521234543213(254)A1B2",
+        "(8004)952123456789012345",
+        "(01)09521234543212",                                   // Bad check digit
+    ]
+
+    static func makeBatch(_ count: Int) -> [String] {
+        return (0..<count).map { corpus[$0 % corpus.count] }
+    }
+
+    func testProcessBatchPreservesInputOrder() async throws {
+        let inputs = GS1EncoderPoolTests.makeBatch(1000)
+
+        let gs1encoder = try GS1Encoder()
+        let expected = try gs1encoder.processBatch(inputs, input: .AIdataStr, output: .DLuri)
+        gs1encoder.free()
+
+        let pool = GS1EncoderPool(maxConcurrency: 4)
+        let results = try await pool.processBatch(inputs, input: .AIdataStr, output: .DLuri)
+        XCTAssertEqual(results, expected)
+        XCTAssertTrue(results[0].ok)
+        XCTAssertFalse(results[7].ok)
+
+        let idle = await pool.idleCount
+        XCTAssertLessThanOrEqual(idle, 4)
+        XCTAssertGreaterThan(idle, 0)
+    }
+
+    func testProcessBatchSmallAndEmpty() async throws {
+        let pool = GS1EncoderPool(maxConcurrency: 2)
+
+        let empty = try await pool.processBatch([], input: .AIdataStr, output: .AIdataStr)
+        XCTAssertEqual(empty, [])
+
+        let one = try await pool.processBatch(["^011231231231233310ABC123"], input: .DataStr, output: .AIdataStr)
+        XCTAssertEqual(one, [GS1Encoder.BatchResult(ok: true, output: "(01)12312312312333(10)ABC123")])
+    }
+
+    // More batches than instances: tasks wait for an instance to be returned
+    func testConcurrentBatchesShareBoundedInstances() async throws {
+        let pool = GS1EncoderPool(maxConcurrency: 2)
+        let inputs = GS1EncoderPoolTests.makeBatch(500)
+
+        let counts = try await withThrowingTaskGroup(of: Int.self, returning: [Int].self) { group in
+            for _ in 0..<8 {
+                group.addTask {
+                    try await pool.processBatch(inputs, input: .AIdataStr, output: .NONE).count
+                }
+            }
+            var counts = [Int]()
+            for try await count in group {
+                counts.append(count)
+            }
+            return counts
+        }
+        XCTAssertEqual(counts, [Int](repeating: 500, count: 8))
+
+        let idle = await pool.idleCount
+        XCTAssertLessThanOrEqual(idle, 2)
+        XCTAssertGreaterThan(idle, 0)
+    }
+
+    func testConfigureIsAppliedToInstances() async throws {
+        let pool = GS1EncoderPool(maxConcurrency: 2) { gs1encoder in
+            try gs1encoder.setValidationEnabled(validation: .RequisiteAIs, enabled: false)
+        }
+
+        let results = try await pool.processBatch(["^0212312312312319"], input: .DataStr, output: .AIdataStr)
+        XCTAssertEqual(results, [GS1Encoder.BatchResult(ok: true, output: "(02)12312312312319")])
+
+        let enabled = try await pool.withEncoder { gs1encoder in
+            gs1encoder.getValidationEnabled(.RequisiteAIs)
+        }
+        XCTAssertFalse(enabled)
+    }
+
+    func testInitialisationFailureIsThrown() async throws {
+        let pool = GS1EncoderPool(maxConcurrency: 2, noEmbedded: true)
+        do {
+            _ = try await pool.processBatch(["(01)12312312312333"], input: .AIdataStr, output: .NONE)
+            XCTFail("Expected generalError")
+        } catch GS1EncoderError.generalError {
+        }
+    }
+
+    func testProcessBatchPerformance() throws {
+        let pool = GS1EncoderPool()
+        let inputs = GS1EncoderPoolTests.makeBatch(1000)
+
+        // Create the instances outside of the measurement
+        _ = try runBlocking { try await pool.processBatch(inputs, input: .AIdataStr, output: .DLuri) }
+
+        measure {
+            let results = try? runBlocking { try await pool.processBatch(inputs, input: .AIdataStr, output: .DLuri) }
+            XCTAssertEqual(results?.count, inputs.count)
+        }
+    }
+
+}
@@ -334,4 +334,29 @@ final class GS1EncoderTests: XCTestCase {
         gs1encoder.free()
     }
 
+    func testProcessBatch() throws {
+        let gs1encoder = try GS1Encoder()
+
+        let results = try gs1encoder.processBatch([
+            "(01)12312312312319(99)TESTING123",
+            "(01)12312312312318",
+            "(99)bad\0data",
+            "(01)12312312312333(10)ABC123",
+        ], input: .AIdataStr, output: .DLuri)
+        XCTAssertEqual(results.count, 4)
+        XCTAssertEqual(results[0], GS1Encoder.BatchResult(ok: true, output: "https://id.gs1.org/01/12312312312319?99=TESTING123"))
+        XCTAssertFalse(results[1].ok)
+        XCTAssertTrue(results[1].output.contains("check digit"), "Error message should contain 'check digit'")
+        XCTAssertFalse(results[2].ok)
+        XCTAssertTrue(results[2].output.contains("NUL"), "Error message should mention NUL")
+        XCTAssertEqual(results[3], GS1Encoder.BatchResult(ok: true, output: "https://id.gs1.org/01/12312312312333/10/ABC123"))
+
+        let hri = try gs1encoder.processBatch(["^011231231231233310ABC123"], input: .DataStr, output: .HRI)
+        XCTAssertEqual(hri, [GS1Encoder.BatchResult(ok: true, output: "(01) 12312312312333|(10) ABC123")])
+
+        XCTAssertEqual(try gs1encoder.processBatch([String](), input: .ScanData, output: .NONE), [])
+
+        gs1encoder.free()
+    }
+
 }